@@ -1,17 +1,10 @@
 #include "App.hpp"
 
-#include <glm/gtc/matrix_transform.hpp>
-
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
-
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-
 #include <set>
+#include <algorithm>
 #include <chrono>
-#include <fstream>
+#include <cmath>
+#include <cstring>
 #include <limits>
 #include <iostream>
 #include <memory>
@@ -22,6 +15,8 @@ NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
 
 void App::Run()
 {
+  m_StartTime = std::chrono::steady_clock::now();
+
   InitWindow();
   InitVulkan();
   MainLoop();
@@ -56,6 +51,10 @@ void App::Run()
 
   CreateLogicalDevice();
 
+  /* Decoding starts as soon as the device is known and overlaps with creating the swap chain and the pipelines. The jobs read
+   * what the device supports (block compression, the transfer queue, direct uploads), so they must not start before it. */
+  SubmitAssetLoads();
+
   CreateSwapChain();
 
   CreateSwapChainImageViews();
@@ -76,11 +75,9 @@ void App::Run()
 
   LoadAndCreateTextures();
 
-  LoadObjModel();
-
-  CreateVertexBuffer();
+  CreateDrawBuffer();
 
-  CreateIndexBuffer();
+  CreateIndirectDrawBuffers();
 
   CreateMvpUniformBuffer();
 
@@ -88,13 +85,24 @@ void App::Run()
 
   CreateMaterialUniformBuffer();
 
+  CreateTextureFeedbackBuffers();
+
+  CreateVirtualTextures();
+
   CreateDescriptorPool();
 
   CreateDescriptorSets();
 
+  CreateTimestampQueryPool();
+
+  CreateOverlay();
+
   CreateDrawingCommandBuffers();
 
   CreateSyncObjects();
+
+  m_FileWatcher.Start({m_VertexShaderPath, GetFragmentShaderPath(), m_OverlayVertexShaderPath, m_OverlayFragmentShaderPath, m_ModelPath,
+                       m_AlbedoTexturePath, m_NormalTexturePath, m_MetallicTexturePath, m_RoughnessTexturePath, m_AoTexturePath});
 }
 
 /* App */void App::MainLoop()
@@ -102,8 +110,13 @@ void App::Run()
   static uint64_t Frame = 0;
   static auto PrevTime = std::chrono::high_resolution_clock::now();
   static auto CurrTime = std::chrono::high_resolution_clock::now();
+  static auto FrameStartTime = std::chrono::high_resolution_clock::now();
   static double DeltaTime = 0.0;
-  static constexpr double TitleUpdateTime = 1.0 / 10.0;
+  static constexpr double FpsUpdateTime = 1.0 / 10.0;
+
+  //All per-frame statistics are shown by the overlay, so the title only has to be set once.
+  std::string Title = m_Title + " (" + m_GpuName + ")";
+  glfwSetWindowTitle(m_pWindow, Title.c_str());
 
   while(!glfwWindowShouldClose(m_pWindow))
   {
@@ -112,36 +125,45 @@ void App::Run()
 
     ++Frame;
     CurrTime = std::chrono::high_resolution_clock::now();
+    m_CpuFrameTime = std::chrono::duration<double, std::chrono::milliseconds::period>(CurrTime - FrameStartTime).count();
+    FrameStartTime = CurrTime;
     DeltaTime = std::chrono::duration<double, std::chrono::seconds::period>(CurrTime - PrevTime).count();
 
-    if(DeltaTime >= TitleUpdateTime)
+    if(DeltaTime >= FpsUpdateTime)
     {
       m_FPS = static_cast<double>(Frame) / DeltaTime;
       PrevTime = CurrTime;
       Frame = 0;
-
-      glm::vec3 Eye = m_Camera.GetCachedEye();
-
-      char Buffer[256];
-      sprintf_s(Buffer, "%s (%s) [Vertices: %d, Faces: %d | Eye: (%.2f, %.2f, %.2f) | %s] || FPS: %d",
-                m_Title.c_str(),
-                m_GpuName.c_str(),
-                static_cast<int32_t>(m_VertexNum),
-                static_cast<int32_t>(m_FacetNum),
-                Eye.x, Eye.y, Eye.z,
-                m_GraphicsPipelinesDescription[m_GraphicsPipelineDisplayMode | m_GraphicsPipelineCullMode],
-                static_cast<int32_t>(m_FPS));
-      glfwSetWindowTitle(m_pWindow, Buffer);
     }
   }
 
   vkDeviceWaitIdle(m_Device);
+
+  if(m_GpuFrameTimeNum > 0)
+    std::cout << "Main subpass: " << m_GpuFrameTimeSum / static_cast<double>(m_GpuFrameTimeNum) << " ms on the GPU on average over " << m_GpuFrameTimeNum << " frames, colors encoded "
+              << (m_bSrgbSwapChain ? "by the sRGB swap chain." : "by the fragment shader.") << std::endl;
 }
 
 /* App */void App::Draw()
 {
+  if(m_FileWatcher.HasChanges())
+    ReloadChangedFiles();
+
+  if(m_AssetLoader.HasCompleted())
+    PublishAssets();
+
+  ResizeStreamedTextures();
+
   vkWaitForFences(m_Device, 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
 
+  //A fence also signals that everything submitted to the queue before its frame has completed.
+  m_CompletedFrameNum = std::max(m_CompletedFrameNum, m_InFlightFrameNums[m_CurrentFrame]);
+  DestroyRetiredResources(false);
+
+  //The tiles the frame copied last time are in their caches now.
+  if(m_bVirtualTexturing)
+    m_TileUploader.Release(static_cast<uint32_t>(m_CurrentFrame));
+
   uint32_t ImageIndex;
   VkResult Result = vkAcquireNextImageKHR(m_Device, m_SwapChainInfo.SwapChain, std::numeric_limits<uint64_t>::max(), m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &ImageIndex);
 
@@ -153,8 +175,32 @@ void App::Run()
   else if(Result != VK_SUCCESS)
     throw std::runtime_error("Failed to acquire swap chain image!");
 
+  //A previous frame may still be rendering into this image, its per-image resources must not be touched before it has finished.
+  if(m_ImagesInFlight[ImageIndex] != VK_NULL_HANDLE)
+    vkWaitForFences(m_Device, 1, &m_ImagesInFlight[ImageIndex], VK_TRUE, std::numeric_limits<uint64_t>::max());
+  m_ImagesInFlight[ImageIndex] = m_InFlightFences[m_CurrentFrame];
+
+  //Resources replaced since the image was drawn last are bound to it now that no frame uses its descriptor set and command buffer.
+  if(m_ImagesOutdated[ImageIndex])
+    RefreshImage(ImageIndex);
+
+  ReadTimestampQueries(ImageIndex);
+
+  ReadTextureFeedback(ImageIndex);
+
+  UpdateTextureResidency();
+
+  SubmitTextureStreams();
+
+  SubmitTileStreams();
+
   UpdateUniformBuffer(ImageIndex);
 
+  UpdateDrawCommands(ImageIndex);
+
+  if(m_bShowOverlay)
+    UpdateOverlay(ImageIndex);
+
   VkSubmitInfo SubmitInfo = {};
   SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -163,8 +209,11 @@ void App::Run()
   SubmitInfo.waitSemaphoreCount = 1;
   SubmitInfo.pWaitSemaphores = WaitSemaphores;
   SubmitInfo.pWaitDstStageMask = WaitStages;
-  SubmitInfo.commandBufferCount = 1;
-  SubmitInfo.pCommandBuffers = &m_DrawingCommandBuffers[ImageIndex];
+
+  //The copies into the tile caches go first, their barriers make the fragment shader of the frame wait for them.
+  VkCommandBuffer CommandBuffers[] = {RecordTileUploads(), m_DrawingCommandBuffers[ImageIndex]};
+  SubmitInfo.commandBufferCount = CommandBuffers[0] != VK_NULL_HANDLE ? 2 : 1;
+  SubmitInfo.pCommandBuffers = CommandBuffers[0] != VK_NULL_HANDLE ? CommandBuffers : &CommandBuffers[1];
 
   VkSemaphore SignalSemaphores[] = {m_RenderFinishedSemaphores[m_CurrentFrame]};
   SubmitInfo.signalSemaphoreCount = 1;
@@ -175,6 +224,11 @@ void App::Run()
   if(vkQueueSubmit(m_GraphicsQueue, 1, &SubmitInfo, m_InFlightFences[m_CurrentFrame]) != VK_SUCCESS)
     throw std::runtime_error("Failed to submit draw command buffer!");
 
+  m_InFlightFrameNums[m_CurrentFrame] = ++m_SubmittedFrameNum;
+
+  if(m_bTimestampSupported)
+    m_TimestampsWritten[ImageIndex] = true;
+
   VkPresentInfoKHR PresentInfo = {};
   PresentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
   PresentInfo.waitSemaphoreCount = 1;
@@ -188,6 +242,12 @@ void App::Run()
 
   Result = vkQueuePresentKHR(m_PresentQueue, &PresentInfo);
 
+  if(m_TimeToFirstFrame < 0.0)
+  {
+    m_TimeToFirstFrame = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_StartTime).count();
+    std::cout << "First frame presented after " << m_TimeToFirstFrame << " ms, " << m_AssetLoader.GetPendingNum() << " assets still loading." << std::endl;
+  }
+
   if(Result == VK_ERROR_OUT_OF_DATE_KHR || Result == VK_SUBOPTIMAL_KHR || m_bFramebufferResized)
   {
     m_bFramebufferResized = false;
@@ -203,6 +263,11 @@ void App::Run()
 
 /* App */void App::Destroy()
 {
+  m_FileWatcher.Stop();
+
+  //A job that is still running may be writing into the members it publishes to.
+  m_AssetLoader.Stop();
+
   for(size_t i = 0; i < m_MaxFramesInFlights; ++i)
   {
     vkDestroySemaphore(m_Device, m_ImageAvailableSemaphores[i], nullptr);
@@ -212,10 +277,31 @@ void App::Run()
 
   DestroySwapChainAndRelevantObject();
 
+  m_Overlay.Destroy(m_Device);
+
+  vkDestroyQueryPool(m_Device, m_TimestampQueryPool, nullptr);
+
   vkDestroyDescriptorPool(m_Device, m_DescriptorPool, nullptr);
 
   vkDestroyDescriptorSetLayout(m_Device, m_DescriptorSetLayout, nullptr);
 
+  for(size_t i = 0; i < m_TextureFeedbackBuffers.size(); ++i)
+  {
+    vkUnmapMemory(m_Device, m_TextureFeedbackBuffers[i].Memory);
+    DestroyBuffer(m_Device, m_TextureFeedbackBuffers[i]);
+  }
+
+  for(size_t i = 0; i < m_TileFeedbackBuffers.size(); ++i)
+  {
+    vkUnmapMemory(m_Device, m_TileFeedbackBuffers[i].Memory);
+    DestroyBuffer(m_Device, m_TileFeedbackBuffers[i]);
+  }
+
+  for(size_t i = 0; i < m_VirtualTextureUniformBuffers.size(); ++i)
+    DestroyBuffer(m_Device, m_VirtualTextureUniformBuffers[i]);
+
+  m_TileUploader.Destroy();
+
   for(size_t i = 0; i < m_SwapChainInfo.BufferCount(); ++i)
     DestroyBuffer(m_Device, m_MaterialUniformBuffers[i]);
 
@@ -225,14 +311,17 @@ void App::Run()
   for(size_t i = 0; i < m_SwapChainInfo.BufferCount(); ++i)
     DestroyBuffer(m_Device, m_MvpUniformBuffers[i]);
 
-  DestroyBuffer(m_Device, m_IndexBuffer);
-  DestroyBuffer(m_Device, m_VertexBuffer);
+  DestroyModelBuffers();
+
+  m_OrmTexture.reset();
+  m_NormalTexture.reset();
+  m_AlbedoTexture.reset();
 
-  DestroyTexture(m_Device, m_AoTexture);
-  DestroyTexture(m_Device, m_RoughnessTexture);
-  DestroyTexture(m_Device, m_MetallicTexture);
-  DestroyTexture(m_Device, m_NormalTexture);
-  DestroyTexture(m_Device, m_AlbedoTexture);
+  //The device is idle since the main loop ended.
+  DestroyRetiredResources(true);
+
+  //Frees the acquires it recorded into the graphics command pool.
+  m_TransferQueue.Destroy();
 
   vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
 
@@ -258,19 +347,12 @@ void App::Run()
   float DeltaTime = std::chrono::duration<float, std::chrono::seconds::period>(CurrentTime - StartTime).count();
   DeltaTime *= 10.0f;
 
-  static glm::vec3 Eye, Target, Up;
-  static float NearZ, FarZ;
-  static glm::vec2 Fov;
-
-  m_Camera.RetriveData(Target, Eye, Up, Fov, NearZ, FarZ);
-
   MvpUniformBufferObject Transformation = {};
   Transformation.Model = glm::mat4(1.0f);
   Transformation.ModelInvTranspose = glm::transpose(glm::inverse(Transformation.Model));
-  Transformation.View = glm::lookAt(Eye, Target, Up);
-  Transformation.Projection = glm::perspective(Fov.y, static_cast<float>(m_SwapChainInfo.SwapChainExtent.width) / static_cast<float>(m_SwapChainInfo.SwapChainExtent.height), NearZ, FarZ);
-  //GLM was originally designed for OpenGL, where the y-coordinate of the clip coordinates is inverted.
-  Transformation.Projection[1][1] *= -1.0f;
+  m_Camera.RetriveMatrices(static_cast<float>(m_SwapChainInfo.SwapChainExtent.width) / static_cast<float>(m_SwapChainInfo.SwapChainExtent.height), Transformation.View, Transformation.Projection);
+  Transformation.PositionScale = glm::vec4(m_PositionScale, 0.0f);
+  Transformation.PositionOffset = glm::vec4(m_PositionOffset, 0.0f);
 
   MapMemory(m_Device, m_MvpUniformBuffers[CurrentImage].Memory, sizeof(Transformation), &Transformation);
 
@@ -296,14 +378,890 @@ void App::Run()
 
   MapMemory(m_Device, m_LightUniformBuffers[CurrentImage].Memory, sizeof(Lighting), &Lighting);
 
-  //Update material information.
-  MaterialUniformBufferObject Material = {};
-  Material.Albedo = glm::vec4(1.0f, 1.0f, 1.0f, 1.0);
-  Material.Ao = 1.0f;
-  Material.Metallic = 1.0f;
-  Material.Roughness = 1.0f;
+  //Update the virtual textures, the pixel that writes the feedback moves on every frame.
+  VirtualTextureUniformBufferObject VirtualTextures = {};
+  for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
+  {
+    const VirtualTextureLayout& Layout = m_TileCaches[Slot].GetLayout();
+    VirtualTextures.Textures[Slot].Size = glm::uvec2(Layout.Width, Layout.Height);
+    VirtualTextures.Textures[Slot].LevelNum = m_bVirtualTexturing ? Layout.LevelNum : 0;
+    VirtualTextures.Textures[Slot].FeedbackOffset = Slot * m_TileFeedbackWordNum;
+    //Streamed levels are only sampled once their request has completed, the image was bound with the texture.
+    if(m_bTextureStreaming)
+      VirtualTextures.Textures[Slot].MinLod = static_cast<float>(m_TextureStreamer.GetResidentLevel(Slot) - m_TextureStreamer.GetAllocatedLevel(Slot));
+  }
+  VirtualTextures.CacheTexelSize = glm::vec2(m_TileUploader.GetCacheTexelSize());
+  VirtualTextures.FeedbackPixel = m_FeedbackPixel;
+  m_FeedbackPixel = (m_FeedbackPixel + 1) % 16;
+
+  MapMemory(m_Device, m_VirtualTextureUniformBuffers[CurrentImage].Memory, sizeof(VirtualTextures), &VirtualTextures);
+}
+
+/* App Helper */void App::UpdateDrawCommands(uint32_t ImageIndex)
+{
+  if(!m_bDrawIndirectFirstInstance)
+    return;
+
+  glm::vec3 Target, Eye, Up;
+  glm::vec2 Fov;
+  float NearZ, FarZ;
+  m_Camera.RetriveData(Target, Eye, Up, Fov, NearZ, FarZ);
+
+  glm::mat4 View, Projection;
+  m_Camera.RetriveMatrices(static_cast<float>(m_SwapChainInfo.SwapChainExtent.width) / static_cast<float>(m_SwapChainInfo.SwapChainExtent.height), View, Projection);
+  const glm::mat4 ViewProjection = Projection * View;
+
+  //The height in pixels of something one unit tall at a distance of one unit.
+  const float PixelScale = static_cast<float>(m_SwapChainInfo.SwapChainExtent.height) / (2.0f * std::tan(0.5f * Fov.y));
+
+  //Meshlets facing away are only culled when the pipeline would cull all of their triangles anyway.
+  float ConeSign = 0.0f;
+  if(m_bCullMeshlets && m_GraphicsPipelineCullMode == GRAPHICS_PIPELINE_TYPE_BACK_CULL)
+    ConeSign = 1.0f;
+  else if(m_bCullMeshlets && m_GraphicsPipelineCullMode == GRAPHICS_PIPELINE_TYPE_FRONT_CULL)
+    ConeSign = -1.0f;
+
+  m_LodFacetNum.assign(MaxLodNum, 0);
+  m_DrawnFacetNum = 0;
+  m_MeshletNum = 0;
+
+  auto* pCommands = static_cast<VkDrawIndexedIndirectCommand*>(m_pMappedIndirectDraws[ImageIndex]);
+  uint32_t CommandNum = 0;
+  for(size_t Draw = 0; Draw < m_Scene.DrawNum(); ++Draw)
+  {
+    uint32_t Mesh = m_Scene.DrawMesh[Draw];
+    uint32_t FirstLod = m_Scene.MeshFirstLod[Mesh];
+    uint32_t Lod = 0;
+
+    const glm::mat4& World = m_Scene.NodeWorldTransform[m_Scene.DrawNode[Draw]];
+
+    /* The coarsest level whose error, projected at the point of the bounding sphere nearest to the eye, stays below the
+     * pixel threshold. The errors grow with every level, so the search stops at the first one that is too coarse. */
+    if(m_bSelectLods)
+    {
+      float Scale = std::max(std::max(glm::length(glm::vec3(World[0])), glm::length(glm::vec3(World[1]))), glm::length(glm::vec3(World[2])));
+      glm::vec3 Center = glm::vec3(World * glm::vec4(m_Scene.MeshBoundsCenter[Mesh], 1.0f));
+      float Distance = std::max(glm::length(Center - Eye) - m_Scene.MeshBoundsRadius[Mesh] * Scale, NearZ);
+
+      while(Lod + 1 < m_Scene.MeshLodNum[Mesh] && m_Scene.LodError[FirstLod + Lod + 1] * Scale * PixelScale / Distance <= m_LodPixelError)
+        ++Lod;
+    }
+
+    uint32_t FirstMeshlet = m_Scene.LodFirstMeshlet[FirstLod + Lod];
+    uint32_t MeshletNum = m_Scene.LodMeshletNum[FirstLod + Lod];
+    m_MeshletNum += MeshletNum;
+
+    /* The frustum planes and the eye are moved into model space, where the bounding spheres and normal cones are, which is
+     * exact even for non-uniform scales. A mirroring transform turns the triangles around, so their cones flip as well. */
+    std::array<glm::vec4, 6> Planes;
+    bool bVisible = true;
+    glm::vec3 ModelEye = Eye;
+    float Sign = ConeSign;
+    if(m_bCullMeshlets)
+    {
+      ExtractFrustumPlanes(ViewProjection * World, Planes);
+      ModelEye = glm::vec3(glm::inverse(World) * glm::vec4(Eye, 1.0f));
+      if(glm::determinant(glm::mat3(World)) < 0.0f)
+        Sign = -Sign;
+
+      bVisible = IsSphereInFrustum(Planes, glm::vec4(m_Scene.MeshBoundsCenter[Mesh], m_Scene.MeshBoundsRadius[Mesh]));
+    }
+
+    for(uint32_t Meshlet = FirstMeshlet; bVisible && Meshlet < FirstMeshlet + MeshletNum; ++Meshlet)
+    {
+      if(m_bCullMeshlets)
+      {
+        const glm::vec4& Bounds = m_Scene.MeshletBounds[Meshlet];
+        if(!IsSphereInFrustum(Planes, Bounds))
+          continue;
+
+        const glm::vec4& Cone = m_Scene.MeshletCone[Meshlet];
+        glm::vec3 ToCenter = glm::vec3(Bounds) - ModelEye;
+        if(Sign != 0.0f && glm::dot(ToCenter, Sign * glm::vec3(Cone)) >= Cone.w * glm::length(ToCenter) + Bounds.w)
+          continue;
+      }
+
+      VkDrawIndexedIndirectCommand& Command = pCommands[CommandNum++];
+      Command.indexCount = m_Scene.MeshletIndexNum[Meshlet];
+      Command.instanceCount = 1;
+      Command.firstIndex = m_Scene.MeshletFirstIndex[Meshlet];
+      Command.vertexOffset = m_Scene.MeshBaseVertex[Mesh];
+      Command.firstInstance = static_cast<uint32_t>(Draw);
+
+      m_LodFacetNum[Lod] += Command.indexCount / 3;
+      m_DrawnFacetNum += Command.indexCount / 3;
+    }
+  }
+
+  //The commands written last time behind the visible ones become empty draws again.
+  if(CommandNum < m_IndirectDrawNum[ImageIndex])
+    std::memset(pCommands + CommandNum, 0, sizeof(VkDrawIndexedIndirectCommand) * (m_IndirectDrawNum[ImageIndex] - CommandNum));
+  m_IndirectDrawNum[ImageIndex] = CommandNum;
+  m_DrawnMeshletNum = CommandNum;
+}
+
+/* App Helper */void App::UpdateOverlay(uint32_t ImageIndex)
+{
+  Overlay::FrameStatistics Statistics;
+  Statistics.FPS = m_FPS;
+  Statistics.CpuFrameTime = m_CpuFrameTime;
+  Statistics.GpuFrameTime = m_GpuFrameTime;
+  Statistics.OverlayGpuTime = m_OverlayGpuTime;
+  Statistics.bGpuTimeAvailable = m_bGpuTimeAvailable;
+  Statistics.DeviceMemorySize = GetAllocatedMemorySize();
+  Statistics.DrawCallNum = m_DrawCallNum;
+  Statistics.VertexNum = m_VertexNum;
+  Statistics.FacetNum = m_bDrawIndirectFirstInstance ? m_DrawnFacetNum : m_FacetNum;
+  if(m_bDrawIndirectFirstInstance)
+  {
+    Statistics.LodFacetNum = m_LodFacetNum;
+    Statistics.MeshletNum = m_MeshletNum;
+    Statistics.DrawnMeshletNum = m_DrawnMeshletNum;
+  }
+  Statistics.Eye = m_Camera.GetCachedEye();
+  Statistics.GpuName = m_GpuName;
+  Statistics.Mode = m_GraphicsPipelinesDescription[m_GraphicsPipelineDisplayMode | m_GraphicsPipelineCullMode];
+  if(m_bTextureStreaming)
+  {
+    for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
+      Statistics.TextureLevels.push_back(m_TextureStreamer.GetResidentLevel(Slot));
+    Statistics.StreamedTextureSize = m_TextureStreamer.GetStreamedSize();
+    Statistics.EvictedLevelNum = m_TextureStreamer.GetEvictedLevelNum();
+    Statistics.EvictedTextureSize = m_TextureStreamer.GetEvictedSize();
+  }
+  if(m_bVirtualTexturing)
+  {
+    for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
+    {
+      Statistics.ResidentTileNums.push_back(m_TileCaches[Slot].GetResidentNum());
+      Statistics.StreamedTileNum += m_TileCaches[Slot].GetStreamedNum();
+      Statistics.EvictedTileNum += m_TileCaches[Slot].GetEvictedNum();
+    }
+    Statistics.TileSlotNum = m_TileCaches[0].GetSlotNum();
+  }
+  Statistics.TextureMemorySize = m_ResidencyManager.GetTextureUsage();
+  Statistics.TextureMemoryBudget = m_ResidencyManager.GetTextureBudget();
+
+  m_Overlay.Update(ImageIndex, Statistics);
+}
+
+/* App Helper */void App::PublishAssets()
+{
+  /* Assets replace resources that frames in flight may still be using, those are retired rather than destroyed. Nothing waits
+   * for the device: every image is pointed at the new resources before it is drawn next, see "RefreshImage()". Streams that
+   * fill levels into the images the textures already have replace nothing. */
+  m_AssetLoader.PublishCompleted();
+
+  if(m_AssetLoader.GetPendingNum() == 0 && m_TimeToFullyLoaded < 0.0)
+  {
+    m_TimeToFullyLoaded = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_StartTime).count();
+    std::cout << "All assets loaded after " << m_TimeToFullyLoaded << " ms (first frame after " << m_TimeToFirstFrame << " ms)." << std::endl;
+
+    //Every directly written byte is one that needed no staging memory and was not copied again by the GPU.
+    UploadStatistics Uploads = GetUploadStatistics();
+    const char* PathNames[UPLOAD_PATH_NUM] = {"direct (no staging)", "staged on the graphics queue", "staged on the transfer queue"};
+    std::cout << "Uploads:";
+    for(int Path = 0; Path < UPLOAD_PATH_NUM; ++Path)
+      std::cout << (Path > 0 ? ", " : " ") << Uploads.Num[Path] << " " << PathNames[Path] << " (" << Uploads.Size[Path] / (1024.0 * 1024.0) << " MiB in " << Uploads.Time[Path] << " ms)";
+    std::cout << "." << std::endl;
+
+    std::cout << "Texture cache: " << m_TextureSourceCache.GetHitNum() << " decodes and " << m_TextureCache.GetHitNum() << " uploads skipped, "
+              << m_TextureCache.GetValueNum() << " images and " << GetSamplerNum() << " samplers in use." << std::endl;
+  }
+}
+
+/* App Helper */void App::SubmitAssetLoads()
+{
+  //Without an archive, or with a broken one, everything is loaded from the source files.
+  if(std::filesystem::exists(m_AssetArchivePath))
+  {
+    try
+    {
+      m_AssetArchive.Open(m_AssetArchivePath);
+      std::cout << "Loading the assets baked into \"" << m_AssetArchivePath << "\"." << std::endl;
+    }
+    catch(const std::exception& Error)
+    {
+      std::cerr << Error.what() << " Loading the source files instead." << std::endl;
+    }
+  }
+
+  m_AssetLoader.Start();
+
+  //The model is submitted first, it takes the longest.
+  SubmitModelLoad(false);
+
+  SubmitTextureLoad({m_AlbedoTexturePath}, MIP_CONTENT_SRGB, STREAMED_TEXTURE_ALBEDO, false);
+  SubmitTextureLoad({m_NormalTexturePath}, MIP_CONTENT_NORMAL, STREAMED_TEXTURE_NORMAL, false);
+  SubmitTextureLoad({m_AoTexturePath, m_RoughnessTexturePath, m_MetallicTexturePath}, MIP_CONTENT_LINEAR, STREAMED_TEXTURE_ORM, false);
+}
+
+/* App Helper */void App::SubmitModelLoad(bool bReload)
+{
+  m_bModelLoading = true;
+
+  //A model that fails to load at start up stops the application, one that fails to reload is reported and the old one stays.
+  auto Model = std::make_shared<LoadedModel>();
+  m_AssetLoader.Submit([this, Model, bReload]()
+                       {
+                         try
+                         {
+                           if(bReload || !LoadArchivedModel(*Model))
+                             LoadObjModel(*Model);
+
+                           //With a transfer queue the buffers are copied right here, next to rendering.
+                           if(IsBufferUploadOnTransferQueue())
+                           {
+                             CreateVertexBuffer(*Model);
+
+                             CreateIndexBuffer(*Model);
+                           }
+                         }
+                         catch(const std::exception& Error)
+                         {
+                           if(!bReload)
+                             throw;
+
+                           std::cerr << "Failed to reload \"" << m_ModelPath << "\": " << Error.what() << std::endl;
+                           Model->bFailed = true;
+                         }
+                       },
+                       [this, Model]()
+                       {
+                         m_bModelLoading = false;
+
+                         //Take over what was uploaded on the transfer queue, a reload that failed half-way may have uploaded one of the buffers.
+                         if(IsBufferUploadOnTransferQueue())
+                         {
+                           m_TransferQueue.Acquire(m_GraphicsQueue, m_CommandPool, Model->VertexTransfer);
+                           m_TransferQueue.Acquire(m_GraphicsQueue, m_CommandPool, Model->IndexTransfer);
+                         }
+
+                         if(Model->bFailed)
+                         {
+                           DestroyBuffer(m_Device, Model->VertexBuffer);
+                           DestroyBuffer(m_Device, Model->IndexBuffer);
+                           m_GltfFile.Close();
+                         }
+                         else
+                         {
+                           DestroyModelBuffers();
+
+                           if(!IsBufferUploadOnTransferQueue())
+                           {
+                             CreateVertexBuffer(*Model);
+
+                             CreateIndexBuffer(*Model);
+                           }
+
+                           //Both buffers are uploaded, the mapping of a GLB model is not needed anymore.
+                           m_GltfFile.Close();
+
+                           m_VertexBuffer = Model->VertexBuffer;
+                           m_IndexBuffer = Model->IndexBuffer;
+                           m_Scene = std::move(Model->ModelScene);
+                           m_PositionScale = Model->PositionScale;
+                           m_PositionOffset = Model->PositionOffset;
+                           m_VertexNum = Model->VertexNum;
+                           m_IndexNum = Model->IndexNum;
+                           m_FacetNum = Model->FacetNum;
+
+                           CreateDrawBuffer();
+
+                           CreateIndirectDrawBuffers();
+
+                           RecreateDrawingCommandBuffer();
+                         }
+
+                         //The file changed again while it was loading, only one job at a time may use "m_GltfFile".
+                         if(m_bModelReloadRequested)
+                         {
+                           m_bModelReloadRequested = false;
+                           SubmitModelLoad(true);
+                         }
+                       });
+}
+
+/* App Helper */void App::SubmitTextureLoad(const std::vector<std::string>& Paths, MIP_CONTENT Content, STREAMED_TEXTURE Slot, bool bReload)
+{
+  //With a transfer queue the loading job also copies the texture into its image, publishing it only takes the image over.
+  auto Loaded = std::make_shared<LoadedTexture>();
+  std::string Name = GetPackedTextureName(Paths);
+  uint64_t CurrentKey = m_TextureKeys[Slot];
+
+  const ArchiveSection* pSection = bReload || !m_AssetArchive.IsOpen() ? nullptr : m_AssetArchive.Find(Name, ARCHIVE_SECTION_TEXTURE);
+  //A device without BC support loads the source files instead of a block compressed texture of the archive.
+  if(pSection != nullptr && IsBlockCompressed(static_cast<TEXTURE_ENCODING>(pSection->Format)) && !m_bTextureCompression)
+    pSection = nullptr;
+  //Virtual textures also need the tiles of the archive, in the format of its levels, or the files are tiled again.
+  const ArchiveSection* pTileSection = pSection != nullptr && m_bVirtualTexturing ? m_AssetArchive.Find(Name, ARCHIVE_SECTION_TILES) : nullptr;
+  if(m_bVirtualTexturing && (pTileSection == nullptr || pTileSection->Format != pSection->Format))
+    pSection = pTileSection = nullptr;
+
+  //A file that cannot be decoded (yet) at start up still becomes the white fallback, on reload the old texture stays.
+  auto bDecoded = std::make_shared<bool>(true);
+  m_AssetLoader.Submit([this, pSection, pTileSection, bDecoded, Loaded, Name, Paths, Content, CurrentKey, bReload]()
+                       {
+                         /* The source is keyed by the bytes it is made from and how they are processed, so the same content is decoded
+                          * once however often it is loaded. Hashing the section of the archive also reads its pages in, so the render
+                          * thread does not wait on the disk when the levels are uploaded. */
+                         std::vector<std::vector<char>> Files(Paths.size());
+                         TEXTURE_ENCODING Encoding = GetTextureEncoding(Content, Paths.size() > 1 ? static_cast<uint32_t>(Paths.size()) : 4, m_bTextureCompression);
+                         uint64_t Key = 0;
+                         if(pSection != nullptr)
+                           Key = HashCombine(HashContent(m_AssetArchive.GetData(*pSection), static_cast<size_t>(pSection->Size)), pSection->Format);
+                         else
+                         {
+                           Key = HashCombine(HashCombine(Key, Content), Encoding);
+                           for(size_t i = 0; i < Paths.size(); ++i)
+                           {
+                             //A file that cannot be read is decoded into the fallback below.
+                             try
+                             {
+                               Files[i] = ReadFile(Paths[i]);
+                             }
+                             catch(const std::runtime_error&)
+                             {
+                             }
+                             Key = HashCombine(Key, HashContent(Files[i].data(), Files[i].size()));
+                           }
+                         }
+
+                         if(bReload && Key == CurrentKey)
+                         {
+                           Loaded->bUnchanged = true;
+                           return;
+                         }
+
+                         Loaded->Source = m_TextureSourceCache.Find(Key);
+                         if(Loaded->Source == nullptr)
+                         {
+                           auto Source = std::make_shared<TextureSource>();
+                           Source->Key = Key;
+
+                           //The mip levels of the archive are uploaded as they are.
+                           if(pSection != nullptr)
+                           {
+                             Source->Mips.resize(pSection->MipLevels);
+                             for(uint32_t Level = 0; Level < pSection->MipLevels; ++Level)
+                             {
+                               const ArchiveMip& Mip = m_AssetArchive.GetMip(*pSection, Level);
+                               Source->Mips[Level].pData = m_AssetArchive.GetData(Mip);
+                               Source->Mips[Level].Size = Mip.Size;
+                               Source->Mips[Level].Width = Mip.Width;
+                               Source->Mips[Level].Height = Mip.Height;
+                             }
+                             Source->Format = static_cast<VkFormat>(pSection->Format);
+
+                             if(pTileSection != nullptr)
+                             {
+                               GetVirtualTextureLayout(pSection->Width, pSection->Height, pSection->MipLevels, Source->TileLayout);
+                               Source->TileSize = GetEncodedSize(static_cast<TEXTURE_ENCODING>(pSection->Format), VirtualTileStride, VirtualTileStride);
+                               if(pTileSection->Size != Source->TileSize * Source->TileLayout.PageNum)
+                                 throw std::runtime_error("The tiles of \"" + Name + "\" do not match its texture in the asset archive!");
+                               Source->pTiles = m_AssetArchive.GetData(*pTileSection);
+                             }
+                           }
+                           else
+                           {
+                             //Several files are scalar maps packed into the channels of one texture, PNGs of the same size are decoded right into them.
+                             ImageData Image;
+                             if(Paths.size() == 1 || !PackPngChannels(Files, Image.Pixels, Image.Width, Image.Height))
+                             {
+                               std::vector<ImageData> Images(Paths.size());
+                               for(size_t i = 0; i < Paths.size(); ++i)
+                                 *bDecoded = DecodeImage(Files[i].data(), Files[i].size(), Images[i]) && *bDecoded;
+                               if(!*bDecoded && bReload)
+                                 return;
+
+                               //A file that failed to decode is white.
+                               if(Paths.size() > 1)
+                               {
+                                 std::vector<PackSource> Sources;
+                                 for(const auto& Decoded : Images)
+                                   Sources.push_back({Decoded.Pixels.data(), Decoded.Width, Decoded.Height});
+                                 PackChannels(Sources, Image.Pixels, Image.Width, Image.Height);
+                               }
+                               else
+                                 Image = std::move(Images[0]);
+                             }
+
+                             //All levels are filtered on this thread and copied at once, nothing is left for the graphics queue.
+                             GenerateMipChain(Image.Pixels.data(), Image.Width, Image.Height, Content, MIP_FILTER_KAISER, Source->Chain);
+                             //The tiles are cut from the RGBA8 levels, every one of them is encoded on its own.
+                             if(m_bVirtualTexturing)
+                             {
+                               GetVirtualTextureLayout(Source->Chain.Widths[0], Source->Chain.Heights[0], static_cast<uint32_t>(Source->Chain.Levels.size()), Source->TileLayout);
+                               SplitIntoTiles(Source->Chain, Source->TileLayout, Encoding, Source->Tiles);
+                               Source->TileSize = GetEncodedSize(Encoding, VirtualTileStride, VirtualTileStride);
+                               Source->pTiles = Source->Tiles.data();
+                             }
+                             EncodeMipChain(Source->Chain, Encoding);
+                             Source->Format = static_cast<VkFormat>(Encoding);
+                             Source->Mips = GetMips(Source->Chain);
+                           }
+
+                           //The fallback of a file that failed to decode is not shared, the file may be readable the next time.
+                           Loaded->Source = *bDecoded ? m_TextureSourceCache.Add(Key, Source) : Source;
+                         }
+
+                         /* A streamed texture starts with the small levels at the end of its chain, the others are kept for later. A virtual
+                          * texture only keeps the levels from the one that fits into a single tile on, for pixels whose tiles are not resident. */
+                         if(m_bVirtualTexturing)
+                         {
+                           Loaded->FirstLevel = Loaded->Source->TileLayout.BaseLevel + Loaded->Source->TileLayout.LevelNum - 1;
+                           Loaded->AllocatedLevel = Loaded->FirstLevel;
+                         }
+                         //The image of a streamed texture has the whole chain, the levels above the first one are filled in later.
+                         else if(m_bTextureStreaming)
+                           Loaded->FirstLevel = m_TextureStreamer.GetStartLevel(Loaded->Source->GetLevelSizes());
+
+                         //An image with the same levels that is still bound is shared instead of uploaded again.
+                         if(!m_bTextureStreaming)
+                           Loaded->Texture = m_TextureCache.Find(Loaded->GetKey());
+                         if(Loaded->Texture == nullptr && m_TransferQueue.IsCreated())
+                           m_TransferQueue.UploadTexture(Loaded->Source->Format, Loaded->GetUploadMips(), Loaded->Uploaded, Loaded->Transfer);
+                       },
+                       [this, bDecoded, Loaded, Name, Slot, bReload]()
+                       {
+                         if(bReload && !*bDecoded)
+                         {
+                           std::cerr << "Failed to reload \"" << Name << "\"." << std::endl;
+                           return;
+                         }
+
+                         if(Loaded->bUnchanged)
+                           return;
+
+                         PublishTexture(*Loaded, GetStreamedTexture(Slot));
+                         m_TextureKeys[Slot] = Loaded->Source->Key;
+
+                         //A stream of the replaced texture that is still pending is dropped when it is published.
+                         if(m_bTextureStreaming)
+                         {
+                           m_StreamedSources[Slot] = Loaded->Source;
+                           m_TextureStreamer.SetTexture(Slot, Loaded->Source->GetLevelSizes(), Loaded->FirstLevel, Loaded->AllocatedLevel);
+                         }
+
+                         //The tiles of the replaced texture are dropped, the descriptor sets are updated with the new images after publishing.
+                         if(m_bVirtualTexturing)
+                         {
+                           m_StreamedSources[Slot] = Loaded->Source;
+                           m_TileCaches[Slot].SetLayout(Loaded->Source->TileLayout);
+                           m_TileUploader.SetTexture(Slot, Loaded->Source->Format, Loaded->Source->TileLayout);
+                         }
+                       });
+}
+
+/* App Helper */void App::PublishTexture(LoadedTexture& Loaded, std::shared_ptr<TextureInfo>& Texture)
+{
+  //The cache had the image when the job ran, it has been bound since and only has to be shared.
+  if(Loaded.Texture == nullptr)
+  {
+    TextureInfo Uploaded;
+
+    //Without a transfer queue nothing has been copied yet, the levels are uploaded on the graphics queue now.
+    if(!m_TransferQueue.IsCreated())
+      CreateTextureFromMips(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, Loaded.Source->Format, Loaded.GetUploadMips(), Uploaded);
+    else
+    {
+      m_TransferQueue.Acquire(m_GraphicsQueue, m_CommandPool, Loaded.Transfer);
+      Uploaded = Loaded.Uploaded;
+      CreateTextureViewAndSampler(m_Device, Loaded.Source->Format, Uploaded);
+    }
+
+    Loaded.Texture = m_bTextureStreaming ? MakeTextureHandle(Uploaded) : m_TextureCache.Add(Loaded.GetKey(), MakeTextureHandle(Uploaded));
+  }
+
+  //The texture it replaces is destroyed with its last handle, which is kept until the frames in flight that may sample it have completed.
+  std::shared_ptr<TextureInfo> Replaced = std::move(Texture);
+  RetireResource([Replaced]() {});
+  Texture = Loaded.Texture;
+
+  RecreateDrawingCommandBuffer();
+}
+
+/* App Helper */std::shared_ptr<TextureInfo> App::MakeTextureHandle(const TextureInfo& Texture)
+{
+  VkDevice Device = m_Device;
+  return std::shared_ptr<TextureInfo>(new TextureInfo(Texture), [Device](TextureInfo* pTexture)
+                                      {
+                                        DestroyTexture(Device, *pTexture);
+                                        delete pTexture;
+                                      });
+}
+
+/* App Helper */std::shared_ptr<TextureInfo>& App::GetStreamedTexture(STREAMED_TEXTURE Slot)
+{
+  switch(Slot)
+  {
+    case STREAMED_TEXTURE_ALBEDO:
+      return m_AlbedoTexture;
+    case STREAMED_TEXTURE_NORMAL:
+      return m_NormalTexture;
+    default:
+      return m_OrmTexture;
+  }
+}
+
+/* App Helper */void App::ReadTextureFeedback(uint32_t ImageIndex)
+{
+  //The fence of the image has already been waited on, the shader has finished writing.
+  if(m_bVirtualTexturing)
+  {
+    auto* pPageBits = static_cast<uint32_t*>(m_pMappedTileFeedback[ImageIndex]);
+    for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
+      m_TileCaches[Slot].ReportPages(pPageBits + Slot * m_TileFeedbackWordNum);
+
+    std::memset(pPageBits, 0, sizeof(uint32_t) * m_TileFeedbackWordNum * STREAMED_TEXTURE_NUM);
+  }
+
+  if(!m_bTextureStreaming)
+    return;
+
+  auto* pFeedback = static_cast<TextureFeedbackStorageBufferObject*>(m_pMappedTextureFeedback[ImageIndex]);
+  for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
+    m_TextureStreamer.ReportDetail(Slot, pFeedback->TextureDetail[Slot]);
+
+  std::memset(pFeedback, 0, sizeof(TextureFeedbackStorageBufferObject));
+}
+
+/* App Helper */void App::SubmitTextureStreams()
+{
+  if(!m_bTextureStreaming)
+    return;
+
+  std::vector<StreamRequest> Requests;
+  m_TextureStreamer.Schedule(Requests);
+
+  for(const auto& Request : Requests)
+  {
+    //The job keeps the source alive even if the texture is reloaded in the meantime.
+    std::shared_ptr<const TextureSource> Source = m_StreamedSources[Request.Texture];
+
+    //The image is grown or shrunk on the GPU, the levels a grown image is missing are filled in by the next requests.
+    if(Request.AllocatedLevel != m_TextureStreamer.GetAllocatedLevel(Request.Texture))
+    {
+      m_TextureResizes.emplace_back(Request, Source);
+      continue;
+    }
+
+    /* Levels the image does not have yet are uploaded into it, nothing is replaced. The shader samples them once the request
+     * has completed, the acquire is submitted before the frame that does. */
+    auto Streamed = std::make_shared<LoadedTexture>();
+    Streamed->Source = Source;
+    Streamed->FirstLevel = Request.FirstLevel;
+    Streamed->AllocatedLevel = Request.AllocatedLevel;
+    Streamed->EndLevel = m_TextureStreamer.GetResidentLevel(Request.Texture);
+    Streamed->Texture = GetStreamedTexture(static_cast<STREAMED_TEXTURE>(Request.Texture));
+
+    m_AssetLoader.Submit([this, Streamed]()
+                         {
+                           if(m_TransferQueue.IsCreated())
+                             m_TransferQueue.UploadTextureLevels(Streamed->GetUploadMips(), *Streamed->Texture, Streamed->Transfer);
+                         },
+                         [this, Source, Streamed, Request]()
+                         {
+                           //Without a transfer queue the levels are uploaded on the graphics queue now.
+                           if(m_TransferQueue.IsCreated())
+                             m_TransferQueue.Acquire(m_GraphicsQueue, m_CommandPool, Streamed->Transfer);
+                           else if(m_StreamedSources[Request.Texture] == Source)
+                             FillTextureLevels(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, Streamed->GetUploadMips(), *Streamed->Texture);
+
+                           //The levels of a file that has been reloaded since went into the image it replaced, which is kept until the acquire has executed.
+                           if(m_StreamedSources[Request.Texture] == Source)
+                             m_TextureStreamer.Complete(Request);
+                           else
+                           {
+                             std::shared_ptr<TextureInfo> Replaced = std::move(Streamed->Texture);
+                             RetireResource([Replaced]() {}, true);
+                           }
+                         });
+  }
+}
+
+/* App Helper */void App::ResizeStreamedTextures()
+{
+  bool bResized = false;
+  for(const auto& Resize : m_TextureResizes)
+  {
+    const StreamRequest& Request = Resize.first;
+    const TextureSource& Source = *Resize.second;
+    //A texture that has been reloaded since has an image of its own already.
+    if(m_StreamedSources[Request.Texture] != Resize.second)
+      continue;
+
+    std::shared_ptr<TextureInfo>& Texture = GetStreamedTexture(static_cast<STREAMED_TEXTURE>(Request.Texture));
+    uint32_t AllocatedLevel = m_TextureStreamer.GetAllocatedLevel(Request.Texture);
+
+    TextureInfo Resized;
+    Resized.MipLevels = static_cast<uint32_t>(Source.Mips.size()) - Request.AllocatedLevel;
+    CreateImage(m_PhysicalDevice, m_Device, Source.Mips[Request.AllocatedLevel].Width, Source.Mips[Request.AllocatedLevel].Height, Resized.MipLevels, VK_SAMPLE_COUNT_1_BIT,
+                Source.Format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Resized.TextureImage, Resized.TextureImageMemory);
+
+    VkCommandBuffer CommandBuffer = BeginSingleTimeCommands(m_Device, m_CommandPool);
+    RecordTextureLevelCopy(CommandBuffer, Source.Mips, Request.FirstLevel, Texture->TextureImage, AllocatedLevel, Resized.TextureImage, Request.AllocatedLevel);
+    vkEndCommandBuffer(CommandBuffer);
+
+    VkSubmitInfo SubmitInfo = {};
+    SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    SubmitInfo.commandBufferCount = 1;
+    SubmitInfo.pCommandBuffers = &CommandBuffer;
+
+    //Nothing waits for the copy, the graphics queue executes it before the frame that samples the new image.
+    if(vkQueueSubmit(m_GraphicsQueue, 1, &SubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+      throw std::runtime_error("Failed to submit the copy of a streamed texture!");
+
+    CreateTextureViewAndSampler(m_Device, Source.Format, Resized);
+
+    /* The image it replaces is still read by the copy, it is kept (and counted against the memory budget) until the frame
+     * submitted after it has completed. */
+    std::shared_ptr<TextureInfo> Replaced = std::move(Texture);
+    Texture = MakeTextureHandle(Resized);
+    uint64_t ReplacedSize = m_TextureStreamer.Complete(Request);
+    RetireResource([this, Replaced, CommandBuffer, ReplacedSize]()
+                   {
+                     vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &CommandBuffer);
+                     m_TextureStreamer.Release(ReplacedSize);
+                   },
+                   true);
+    bResized = true;
+  }
+  m_TextureResizes.clear();
 
-  MapMemory(m_Device, m_MaterialUniformBuffers[CurrentImage].Memory, sizeof(Material), &Material);
+  if(bResized)
+    RecreateDrawingCommandBuffer();
+}
+
+/* App Helper */void App::SubmitTileStreams()
+{
+  if(!m_bVirtualTexturing)
+    return;
+
+  //Every request takes a staging slot, the textures take turns at going first so none of them starves the others.
+  uint32_t Budget = std::min(m_TileFrameBudget, m_TileUploader.GetFreeStagingNum());
+  std::vector<TileRequest> Requests;
+  for(uint32_t i = 0; i < STREAMED_TEXTURE_NUM; ++i)
+    m_TileCaches[(i + m_FeedbackPixel) % STREAMED_TEXTURE_NUM].Schedule(Budget, Requests);
+
+  for(const auto& Request : Requests)
+  {
+    //The job keeps the source alive even if the texture is reloaded in the meantime.
+    const std::shared_ptr<const TextureSource>& Source = m_StreamedSources[Request.Texture];
+    m_TileUploader.Load(Request, Source, Source->pTiles + Request.Page * Source->TileSize, Source->TileSize);
+  }
+}
+
+/* App Helper */VkCommandBuffer App::RecordTileUploads()
+{
+  if(!m_bVirtualTexturing)
+    return VK_NULL_HANDLE;
+
+  uint32_t Frame = static_cast<uint32_t>(m_CurrentFrame);
+
+  //The tiles of a texture that has been reloaded since they were requested are not copied.
+  std::vector<LoadedTile> Tiles;
+  m_TileUploader.TakeLoaded(Tiles);
+  for(auto& Tile : Tiles)
+    Tile.bCopy = m_TileCaches[Tile.Request.Texture].Complete(Tile.Request);
+
+  //Evicted tiles leave the page tables in the same submit that overwrites their slots at the latest.
+  std::vector<uint32_t> Entries;
+  for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
+  {
+    if(!m_TileCaches[Slot].HasPageTableChanged())
+      continue;
+
+    m_TileCaches[Slot].BuildPageTable(Entries);
+    m_TileUploader.WritePageTable(Frame, Slot, Entries);
+  }
+
+  return m_TileUploader.Record(Frame, Tiles);
+}
+
+/* App Helper */void App::UpdateTextureResidency()
+{
+  std::vector<const TextureInfo*> Textures = {m_AlbedoTexture.get(), m_NormalTexture.get(), m_OrmTexture.get()};
+  if(m_bVirtualTexturing)
+  {
+    for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
+    {
+      Textures.push_back(&m_TileUploader.GetCache(Slot));
+      Textures.push_back(&m_TileUploader.GetPageTable(Slot));
+    }
+  }
+  m_ResidencyManager.Update(Textures);
+
+  if(!m_bTextureStreaming)
+    return;
+
+  //The streaming counts the bytes of the levels the images have, the alignment of the images comes on top of them.
+  VkDeviceSize Overhead = m_ResidencyManager.GetTextureUsage() - std::min(m_ResidencyManager.GetTextureUsage(), m_TextureStreamer.GetAllocatedSize());
+  VkDeviceSize Budget = m_ResidencyManager.GetTextureBudget();
+  m_TextureStreamer.SetMemoryBudget(Budget - std::min(Budget, Overhead));
+}
+
+/* App Helper */void App::SubmitShaderLoad(bool bOverlay)
+{
+  const std::string& VertexPath = bOverlay ? m_OverlayVertexShaderPath : m_VertexShaderPath;
+  const std::string& FragmentPath = bOverlay ? m_OverlayFragmentShaderPath : GetFragmentShaderPath();
+
+  auto Code = std::make_shared<std::array<std::vector<char>, 2>>();
+  m_AssetLoader.Submit([Code, VertexPath, FragmentPath]()
+                       {
+                         try
+                         {
+                           (*Code)[0] = ReadFile(VertexPath);
+                           (*Code)[1] = ReadFile(FragmentPath);
+                         }
+                         catch(const std::exception&)
+                         {
+                           Code->fill({});
+                         }
+                       },
+                       [this, Code, VertexPath, FragmentPath, bOverlay]()
+                       {
+                         if(!IsSpirVCode((*Code)[0]) || !IsSpirVCode((*Code)[1]))
+                         {
+                           std::cerr << "Failed to reload \"" << VertexPath << "\" and \"" << FragmentPath << "\", they are not valid SPIR-V." << std::endl;
+                           return;
+                         }
+
+                         //Only the pipelines built from the shaders are replaced, the render pass and the layouts stay. Frames in flight may still use the old ones.
+                         if(bOverlay)
+                         {
+                           VkPipeline Pipeline = VK_NULL_HANDLE;
+                           VkPipelineLayout PipelineLayout = VK_NULL_HANDLE;
+                           m_Overlay.TakePipeline(Pipeline, PipelineLayout);
+                           RetireResource([this, Pipeline, PipelineLayout]()
+                                          {
+                                            vkDestroyPipeline(m_Device, Pipeline, nullptr);
+                                            vkDestroyPipelineLayout(m_Device, PipelineLayout, nullptr);
+                                          });
+
+                           m_OverlayVertexShaderCode = std::move((*Code)[0]);
+                           m_OverlayFragmentShaderCode = std::move((*Code)[1]);
+                           m_Overlay.CreatePipeline(m_Device, m_RenderPass, 1, m_SwapChainInfo.SwapChainExtent, m_bSrgbSwapChain, m_OverlayVertexShaderCode, m_OverlayFragmentShaderCode);
+                         }
+                         else
+                         {
+                           std::vector<VkPipeline> Pipelines;
+                           for(auto& Kv : m_GraphicsPipelines)
+                             Pipelines.push_back(Kv.second);
+                           m_GraphicsPipelines.clear();
+                           RetireResource([this, Pipelines]()
+                                          {
+                                            for(VkPipeline Pipeline : Pipelines)
+                                              vkDestroyPipeline(m_Device, Pipeline, nullptr);
+                                          });
+
+                           m_VertexShaderCode = std::move((*Code)[0]);
+                           m_FragmentShaderCode = std::move((*Code)[1]);
+                           CreateGraphicsPipeline();
+                         }
+
+                         RecreateDrawingCommandBuffer();
+                       });
+}
+
+/* App Helper */std::vector<char> App::ReadShaderCode(const std::string& Path) const
+{
+  const ArchiveSection* pSection = m_AssetArchive.IsOpen() ? m_AssetArchive.Find(Path, ARCHIVE_SECTION_SHADER) : nullptr;
+  if(pSection == nullptr)
+    return ReadFile(Path);
+
+  const auto* pCode = reinterpret_cast<const char*>(m_AssetArchive.GetData(*pSection));
+  return std::vector<char>(pCode, pCode + pSection->Size);
+}
+
+/* App Helper */void App::ReloadChangedFiles()
+{
+  std::vector<std::string> ChangedPaths;
+  m_FileWatcher.PollChanges(ChangedPaths);
+
+  bool bShaderChanged = false, bOverlayShaderChanged = false, bOrmChanged = false;
+  for(const auto& Path : ChangedPaths)
+  {
+    std::cout << "\"" << Path << "\" changed, reloading it." << std::endl;
+
+    if(Path == m_VertexShaderPath || Path == GetFragmentShaderPath())
+      bShaderChanged = true;
+    else if(Path == m_OverlayVertexShaderPath || Path == m_OverlayFragmentShaderPath)
+      bOverlayShaderChanged = true;
+    else if(Path == m_ModelPath)
+    {
+      if(m_bModelLoading)
+        m_bModelReloadRequested = true;
+      else
+        SubmitModelLoad(true);
+    }
+    else if(Path == m_AlbedoTexturePath)
+      SubmitTextureLoad({Path}, MIP_CONTENT_SRGB, STREAMED_TEXTURE_ALBEDO, true);
+    else if(Path == m_NormalTexturePath)
+      SubmitTextureLoad({Path}, MIP_CONTENT_NORMAL, STREAMED_TEXTURE_NORMAL, true);
+    else if(Path == m_AoTexturePath || Path == m_RoughnessTexturePath || Path == m_MetallicTexturePath)
+      bOrmChanged = true;
+  }
+
+  //Both stages are read again together, so a pair that is compiled one after the other is built into one set of pipelines.
+  if(bShaderChanged)
+    SubmitShaderLoad(false);
+  if(bOverlayShaderChanged)
+    SubmitShaderLoad(true);
+  //The packed texture is built from all three maps, it is rebuilt once however many of them changed.
+  if(bOrmChanged)
+    SubmitTextureLoad({m_AoTexturePath, m_RoughnessTexturePath, m_MetallicTexturePath}, MIP_CONTENT_LINEAR, STREAMED_TEXTURE_ORM, true);
+}
+
+/* App Helper */void App::DestroyGraphicsPipelines()
+{
+  for(auto& Kv : m_GraphicsPipelines)
+    vkDestroyPipeline(m_Device, Kv.second, nullptr);
+
+  m_GraphicsPipelines.clear();
+}
+
+/* App Helper */void App::DestroyModelBuffers()
+{
+  for(size_t i = 0; i < m_IndirectDrawBuffers.size(); ++i)
+    vkUnmapMemory(m_Device, m_IndirectDrawBuffers[i].Memory);
+
+  //Frames in flight may still draw the model, the buffers are destroyed once they have completed.
+  std::vector<BufferInfo> Buffers = m_IndirectDrawBuffers;
+  Buffers.push_back(m_DrawBuffer);
+  Buffers.push_back(m_IndexBuffer);
+  Buffers.push_back(m_VertexBuffer);
+  RetireResource([this, Buffers]() mutable
+                 {
+                   for(auto& Buffer : Buffers)
+                     DestroyBuffer(m_Device, Buffer);
+                 });
+
+  m_IndirectDrawBuffers.clear();
+  m_pMappedIndirectDraws.clear();
+  m_DrawBuffer = BufferInfo();
+  m_IndexBuffer = BufferInfo();
+  m_VertexBuffer = BufferInfo();
+}
+
+/* App Helper */void App::ReadTimestampQueries(uint32_t ImageIndex)
+{
+  if(!m_bTimestampSupported || !m_TimestampsWritten[ImageIndex])
+    return;
+
+  //The fence of the image has already been waited on, so the results are available without "VK_QUERY_RESULT_WAIT_BIT".
+  uint64_t Timestamps[m_TimestampQueryNum] = {};
+  if(vkGetQueryPoolResults(m_Device, m_TimestampQueryPool, ImageIndex * m_TimestampQueryNum, m_TimestampQueryNum, sizeof(Timestamps), Timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+    return;
+
+  //"timestampPeriod" is the number of nanoseconds per tick, masking the difference handles counters with less than 64 valid bits wrapping around.
+  m_GpuFrameTime = static_cast<double>((Timestamps[1] - Timestamps[0]) & m_TimestampMask) * m_TimestampPeriod / 1000000.0;
+  m_OverlayGpuTime = static_cast<double>((Timestamps[2] - Timestamps[1]) & m_TimestampMask) * m_TimestampPeriod / 1000000.0;
+  m_bGpuTimeAvailable = true;
+
+  m_GpuFrameTimeSum += m_GpuFrameTime;
+  ++m_GpuFrameTimeNum;
 }
 
 /* App Helper */void App::RecreateSwapChainAndRelevantObject()
@@ -317,6 +1275,8 @@ void App::Run()
 
   vkDeviceWaitIdle(m_Device);
 
+  DestroyRetiredResources(true);
+
   DestroySwapChainAndRelevantObject();
 
   CreateSwapChain();
@@ -327,32 +1287,49 @@ void App::Run()
 
   CreateGraphicsPipeline();
 
+  m_Overlay.CreatePipeline(m_Device, m_RenderPass, 1, m_SwapChainInfo.SwapChainExtent, m_bSrgbSwapChain, m_OverlayVertexShaderCode, m_OverlayFragmentShaderCode);
+
   CreateColorResource();
 
   CreateDepthResource();
 
   CreateFramebuffers();
 
+  //The device is idle, so the images still referring to replaced resources are brought up to date right away.
+  for(size_t i = 0; i < m_ImagesOutdated.size(); ++i)
+  {
+    if(m_ImagesOutdated[i])
+    {
+      UpdateDescriptorSet(i);
+      UpdateMaterialUniformBuffer(i);
+    }
+  }
+
   CreateDrawingCommandBuffers();
+
+  m_ImagesInFlight.assign(m_SwapChainInfo.BufferCount(), VK_NULL_HANDLE);
+  m_ImagesOutdated.assign(m_SwapChainInfo.BufferCount(), false);
 }
 
 /* App Helper */void App::DestroySwapChainAndRelevantObject()
 {
   vkDestroyImageView(m_Device, m_SwapChainInfo.DepthImageView, nullptr);
   vkDestroyImage(m_Device, m_SwapChainInfo.DepthImage, nullptr);
-  vkFreeMemory(m_Device, m_SwapChainInfo.DepthImageMemory, nullptr);
+  FreeMemory(m_Device, m_SwapChainInfo.DepthImageMemory);
 
   vkDestroyImageView(m_Device, m_SwapChainInfo.ColorImageView, nullptr);
   vkDestroyImage(m_Device, m_SwapChainInfo.ColorImage, nullptr);
-  vkFreeMemory(m_Device, m_SwapChainInfo.ColorImageMemory, nullptr);
+  FreeMemory(m_Device, m_SwapChainInfo.ColorImageMemory);
 
   for(auto& Framebuffer : m_SwapChainInfo.SwapChainFramebuffers)
     vkDestroyFramebuffer(m_Device, Framebuffer, nullptr);
 
-  for(auto& Kv : m_GraphicsPipelines)
-    vkDestroyPipeline(m_Device, Kv.second, nullptr);
+  DestroyGraphicsPipelines();
+
+  m_Overlay.DestroyPipeline(m_Device);
 
   vkDestroyPipelineLayout(m_Device, m_PipelineLayout, nullptr);
+  m_PipelineLayout = VK_NULL_HANDLE;
 
   vkDestroyRenderPass(m_Device, m_RenderPass, nullptr);
 
@@ -366,11 +1343,43 @@ void App::Run()
 
 void App::RecreateDrawingCommandBuffer()
 {
-  vkQueueWaitIdle(m_GraphicsQueue);
+  //Frames in flight may still execute the command buffers, each one is recorded again once its image is not in use anymore.
+  m_ImagesOutdated.assign(m_ImagesOutdated.size(), true);
+}
 
-  vkFreeCommandBuffers(m_Device, m_CommandPool, static_cast<uint32_t>(m_DrawingCommandBuffers.size()), m_DrawingCommandBuffers.data());
+/* App Helper */void App::RefreshImage(uint32_t ImageIndex)
+{
+  UpdateDescriptorSet(ImageIndex);
 
-  CreateDrawingCommandBuffers();
+  UpdateMaterialUniformBuffer(ImageIndex);
+
+  vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &m_DrawingCommandBuffers[ImageIndex]);
+
+  RecordDrawingCommandBuffer(ImageIndex);
+
+  m_ImagesOutdated[ImageIndex] = false;
+}
+
+/* App Helper */void App::RetireResource(std::function<void()> Destroy, bool bQueued)
+{
+  RetiredResource Retired;
+  Retired.FrameNum = m_SubmittedFrameNum + (bQueued ? 1 : 0);
+  Retired.Destroy = std::move(Destroy);
+  m_RetiredResources.push_back(std::move(Retired));
+}
+
+/* App Helper */void App::DestroyRetiredResources(bool bAll)
+{
+  auto Destroyed = [this, bAll](RetiredResource& Retired)
+  {
+    if(!bAll && Retired.FrameNum > m_CompletedFrameNum)
+      return false;
+
+    Retired.Destroy();
+    return true;
+  };
+
+  m_RetiredResources.erase(std::remove_if(m_RetiredResources.begin(), m_RetiredResources.end(), Destroyed), m_RetiredResources.end());
 }
 
 /* Vulkan Init */void App::CreateInstance()
@@ -392,6 +1401,11 @@ void App::RecreateDrawingCommandBuffer()
 
   auto Extensions = GetRequiredExtensions(m_bEnableValidationLayers);
 
+  //Only needed to query the memory budget of the device.
+  m_bPhysicalDeviceProperties2 = CheckInstanceExtensionsSupport({VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME});
+  if(m_bPhysicalDeviceProperties2)
+    Extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+
   CreateInfo.enabledExtensionCount = static_cast<uint32_t>(Extensions.size());
   CreateInfo.ppEnabledExtensionNames = Extensions.data();
 
@@ -475,6 +1489,12 @@ void App::RecreateDrawingCommandBuffer()
 
   if(m_PhysicalDevice == VK_NULL_HANDLE)
     throw std::runtime_error("Failed to find a supported GPU!");
+
+  //Where the host can write device local memory, buffers skip the staging buffer, the copy and its submit.
+  m_MemoryTopology = GetMemoryTopology(m_PhysicalDevice);
+  m_bDirectUpload = m_bDirectUploadEnabled && m_MemoryTopology != MEMORY_TOPOLOGY_DISCRETE;
+  std::cout << "Memory topology: " << GetMemoryTopologyName(m_MemoryTopology) << ", buffers are uploaded "
+            << (m_bDirectUpload ? "directly into device local memory." : "through staging buffers.") << std::endl;
 }
 
 /* Vulkan Init */void App::CreateLogicalDevice()
@@ -488,6 +1508,8 @@ void App::RecreateDrawingCommandBuffer()
     Indices.GraphicsFamily.value(),
     Indices.PresentFamily.value()
   };
+  if(Indices.TransferFamily.has_value())
+    UniqueQueueFamilies.insert(Indices.TransferFamily.value());
 
   for(uint32_t QueueFamily : UniqueQueueFamilies)
   {
@@ -499,18 +1521,45 @@ void App::RecreateDrawingCommandBuffer()
     QueueCreateInfos.push_back(QueueCreateInfo);
   }
 
+  VkPhysicalDeviceFeatures SupportedFeatures = {};
+  vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &SupportedFeatures);
+
+  VkPhysicalDeviceProperties Properties = {};
+  vkGetPhysicalDeviceProperties(m_PhysicalDevice, &Properties);
+
+  //Indirect draws with a draw count above one need "multiDrawIndirect", otherwise every draw is issued on its own.
+  m_bMultiDrawIndirect = SupportedFeatures.multiDrawIndirect == VK_TRUE;
+  m_bDrawIndirectFirstInstance = SupportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+  m_MaxDrawIndirectCount = m_bMultiDrawIndirect ? std::max(Properties.limits.maxDrawIndirectCount, 1u) : 1;
+  m_bTextureCompression = m_bTextureCompressionEnabled && SupportedFeatures.textureCompressionBC == VK_TRUE;
+  //The feedback of the streaming and of virtual texturing is written by the fragment shader, the tiles replace the levels.
+  m_bVirtualTexturing = m_bVirtualTexturingEnabled && SupportedFeatures.fragmentStoresAndAtomics == VK_TRUE;
+  m_bTextureStreaming = m_bTextureStreamingEnabled && SupportedFeatures.fragmentStoresAndAtomics == VK_TRUE && !m_bVirtualTexturing;
+  if((m_bVirtualTexturingEnabled || m_bTextureStreamingEnabled) && SupportedFeatures.fragmentStoresAndAtomics != VK_TRUE)
+    std::cout << "The device lacks \"fragmentStoresAndAtomics\" for the feedback of the fragment shader, virtual texturing and texture streaming are disabled and all levels are loaded at once." << std::endl;
+  m_TextureStreamer.Init(STREAMED_TEXTURE_NUM, m_StreamingStartSize, m_StreamingFrameBudget);
+
+  std::vector<const char*> DeviceExtensions = m_DeviceExtensions;
+  m_bMemoryBudget = m_bPhysicalDeviceProperties2 && CheckPhysicalDeviceExtensionsSupport(m_PhysicalDevice, {VK_EXT_MEMORY_BUDGET_EXTENSION_NAME});
+  if(m_bMemoryBudget)
+    DeviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
   VkPhysicalDeviceFeatures DeviceFeatures = {};
   DeviceFeatures.samplerAnisotropy = VK_TRUE;
   DeviceFeatures.sampleRateShading = VK_TRUE;
   DeviceFeatures.fillModeNonSolid = VK_TRUE;
+  DeviceFeatures.multiDrawIndirect = SupportedFeatures.multiDrawIndirect;
+  DeviceFeatures.drawIndirectFirstInstance = SupportedFeatures.drawIndirectFirstInstance;
+  DeviceFeatures.textureCompressionBC = m_bTextureCompression ? VK_TRUE : VK_FALSE;
+  DeviceFeatures.fragmentStoresAndAtomics = m_bTextureStreaming || m_bVirtualTexturing ? VK_TRUE : VK_FALSE;
 
   VkDeviceCreateInfo CreateInfo = {};
   CreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   CreateInfo.pQueueCreateInfos = QueueCreateInfos.data();
   CreateInfo.queueCreateInfoCount = static_cast<uint32_t>(QueueCreateInfos.size());
   CreateInfo.pEnabledFeatures = &DeviceFeatures;
-  CreateInfo.ppEnabledExtensionNames = m_DeviceExtensions.data();
-  CreateInfo.enabledExtensionCount = static_cast<uint32_t>(m_DeviceExtensions.size());
+  CreateInfo.ppEnabledExtensionNames = DeviceExtensions.data();
+  CreateInfo.enabledExtensionCount = static_cast<uint32_t>(DeviceExtensions.size());
 
   if(m_bEnableValidationLayers)
   {
@@ -525,12 +1574,29 @@ void App::RecreateDrawingCommandBuffer()
 
   vkGetDeviceQueue(m_Device, Indices.GraphicsFamily.value(), 0, &m_GraphicsQueue);
   vkGetDeviceQueue(m_Device, Indices.PresentFamily.value(), 0, &m_PresentQueue);
+
+  m_TransferQueue.Create(m_PhysicalDevice, m_Device, Indices);
+  if(m_TransferQueue.IsCreated())
+    std::cout << "Transfer queue: family " << Indices.TransferFamily.value() << ", textures" << (m_bDirectUpload ? "" : " and buffers") << " are uploaded next to rendering." << std::endl;
+  else
+    std::cout << "Transfer queue: none, every upload runs on the graphics queue." << std::endl;
+
+  std::cout << "Texture compression: " << (m_bTextureCompression ? "BC4, BC5 and BC7." : "none, textures are uploaded as RGBA8.") << std::endl;
+  if(m_bVirtualTexturing)
+    std::cout << "Texture streaming: virtual texturing, the tiles the fragment shader samples are copied into tile caches." << std::endl;
+  else
+    std::cout << "Texture streaming: " << (m_bTextureStreaming ? "levels are added as the fragment shader samples them." : "none, all levels are loaded at once.") << std::endl;
+
+  m_ResidencyManager.Create(m_Instance, m_PhysicalDevice, m_bMemoryBudget, m_TextureMemoryBudget);
+  const HeapBudget& TextureHeap = m_ResidencyManager.GetHeaps()[m_ResidencyManager.GetTextureHeap()];
+  std::cout << "Texture memory: at most " << m_TextureMemoryBudget / (1024 * 1024) << " MB of heap " << m_ResidencyManager.GetTextureHeap() << " (" << TextureHeap.Size / (1024 * 1024) << " MB), "
+            << (m_bMemoryBudget ? "the driver reports the budget of the heap." : "the budget of the heap is estimated from its size.") << std::endl;
 }
 
 /* Vulkan Init */void App::CreateSwapChain()
 {
   SwapChainSupportDetails SwapChainSupport = QuerySwapChainSupport(m_PhysicalDevice, m_Surface);
-  VkSurfaceFormatKHR SurfaceFormat = ChooseSwapSurfaceFormat(SwapChainSupport.Formats);
+  VkSurfaceFormatKHR SurfaceFormat = ChooseSwapSurfaceFormat(SwapChainSupport.Formats, m_bSrgbSwapChainEnabled);
   VkPresentModeKHR PresentMode = ChooseSwapPresentMode(SwapChainSupport.PresentModes);
   VkExtent2D Extent = ChooseSwapExtent(m_pWindow, SwapChainSupport.Capabilities, m_InitWidth, m_InitHeight);
 
@@ -583,6 +1649,7 @@ void App::RecreateDrawingCommandBuffer()
 
   m_SwapChainInfo.SwapChainImageFormat = SurfaceFormat.format;
   m_SwapChainInfo.SwapChainExtent = Extent;
+  m_bSrgbSwapChain = IsSrgbFormat(SurfaceFormat.format);
 }
 
 /* Vulkan Init */void App::CreateSwapChainImageViews()
@@ -638,12 +1705,18 @@ void App::RecreateDrawingCommandBuffer()
   ColorAttachmentResolveRef.attachment = 2;
   ColorAttachmentResolveRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-  VkSubpassDescription Subpass = {};
-  Subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-  Subpass.colorAttachmentCount = 1;
-  Subpass.pColorAttachments = &ColorAttachmentRef;
-  Subpass.pDepthStencilAttachment = &DepthAttachmentRef;
-  Subpass.pResolveAttachments = &ColorAttachmentResolveRef;
+  std::array<VkSubpassDescription, 2> Subpasses = {};
+
+  Subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  Subpasses[0].colorAttachmentCount = 1;
+  Subpasses[0].pColorAttachments = &ColorAttachmentRef;
+  Subpasses[0].pDepthStencilAttachment = &DepthAttachmentRef;
+  Subpasses[0].pResolveAttachments = &ColorAttachmentResolveRef;
+
+  //The overlay is drawn in a second subpass straight into the resolved, single-sampled image.
+  Subpasses[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  Subpasses[1].colorAttachmentCount = 1;
+  Subpasses[1].pColorAttachments = &ColorAttachmentResolveRef;
 
   std::array<VkAttachmentDescription, 3> Attachments =
   {
@@ -652,22 +1725,32 @@ void App::RecreateDrawingCommandBuffer()
     ColorAttachmentResolve
   };
 
-  VkSubpassDependency Dependency = {};
-  Dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-  Dependency.dstSubpass = 0;
-  Dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  Dependency.srcAccessMask = 0;
-  Dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  Dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  std::array<VkSubpassDependency, 2> Dependencies = {};
+
+  Dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+  Dependencies[0].dstSubpass = 0;
+  Dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  Dependencies[0].srcAccessMask = 0;
+  Dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  Dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+  //The overlay blends on top of the resolve result of the main subpass.
+  Dependencies[1].srcSubpass = 0;
+  Dependencies[1].dstSubpass = 1;
+  Dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  Dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  Dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  Dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  Dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
   VkRenderPassCreateInfo CreateInfo = {};
   CreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
   CreateInfo.attachmentCount = static_cast<uint32_t>(Attachments.size());
   CreateInfo.pAttachments = Attachments.data();
-  CreateInfo.subpassCount = 1;
-  CreateInfo.pSubpasses = &Subpass;
-  CreateInfo.dependencyCount = 1;
-  CreateInfo.pDependencies = &Dependency;
+  CreateInfo.subpassCount = static_cast<uint32_t>(Subpasses.size());
+  CreateInfo.pSubpasses = Subpasses.data();
+  CreateInfo.dependencyCount = static_cast<uint32_t>(Dependencies.size());
+  CreateInfo.pDependencies = Dependencies.data();
 
   if(vkCreateRenderPass(m_Device, &CreateInfo, nullptr, &m_RenderPass) != VK_SUCCESS)
     throw std::runtime_error("Failed to create render pass!");
@@ -710,37 +1793,71 @@ void App::RecreateDrawingCommandBuffer()
   NormalSamplerLayoutBinding.pImmutableSamplers = nullptr;
   NormalSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-  VkDescriptorSetLayoutBinding MetallicSamplerLayoutBinding = {};
-  MetallicSamplerLayoutBinding.binding = 5;
-  MetallicSamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  MetallicSamplerLayoutBinding.descriptorCount = 1;
-  MetallicSamplerLayoutBinding.pImmutableSamplers = nullptr;
-  MetallicSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-  VkDescriptorSetLayoutBinding RoughnessSamplerLayoutBinding = {};
-  RoughnessSamplerLayoutBinding.binding = 6;
-  RoughnessSamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  RoughnessSamplerLayoutBinding.descriptorCount = 1;
-  RoughnessSamplerLayoutBinding.pImmutableSamplers = nullptr;
-  RoughnessSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-  VkDescriptorSetLayoutBinding AoSamplerLayoutBinding = {};
-  AoSamplerLayoutBinding.binding = 7;
-  AoSamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  AoSamplerLayoutBinding.descriptorCount = 1;
-  AoSamplerLayoutBinding.pImmutableSamplers = nullptr;
-  AoSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-  std::array<VkDescriptorSetLayoutBinding, 8> Bindings =
+  //Ambient occlusion, roughness and metallic packed into one texture.
+  VkDescriptorSetLayoutBinding OrmSamplerLayoutBinding = {};
+  OrmSamplerLayoutBinding.binding = 5;
+  OrmSamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  OrmSamplerLayoutBinding.descriptorCount = 1;
+  OrmSamplerLayoutBinding.pImmutableSamplers = nullptr;
+  OrmSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  VkDescriptorSetLayoutBinding DrawSsboLayoutBinding = {};
+  DrawSsboLayoutBinding.binding = 6;
+  DrawSsboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  DrawSsboLayoutBinding.descriptorCount = 1;
+  DrawSsboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  DrawSsboLayoutBinding.pImmutableSamplers = nullptr;
+
+  VkDescriptorSetLayoutBinding TextureFeedbackSsboLayoutBinding = {};
+  TextureFeedbackSsboLayoutBinding.binding = 7;
+  TextureFeedbackSsboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  TextureFeedbackSsboLayoutBinding.descriptorCount = 1;
+  TextureFeedbackSsboLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  TextureFeedbackSsboLayoutBinding.pImmutableSamplers = nullptr;
+
+  VkDescriptorSetLayoutBinding TileFeedbackSsboLayoutBinding = {};
+  TileFeedbackSsboLayoutBinding.binding = 8;
+  TileFeedbackSsboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  TileFeedbackSsboLayoutBinding.descriptorCount = 1;
+  TileFeedbackSsboLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  TileFeedbackSsboLayoutBinding.pImmutableSamplers = nullptr;
+
+  VkDescriptorSetLayoutBinding VirtualTextureUboLayoutBinding = {};
+  VirtualTextureUboLayoutBinding.binding = 9;
+  VirtualTextureUboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  VirtualTextureUboLayoutBinding.descriptorCount = 1;
+  VirtualTextureUboLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  VirtualTextureUboLayoutBinding.pImmutableSamplers = nullptr;
+
+  //The page tables and the tile caches of albedo, normal and ORM.
+  VkDescriptorSetLayoutBinding PageTableSamplerLayoutBinding = {};
+  PageTableSamplerLayoutBinding.binding = 10;
+  PageTableSamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  PageTableSamplerLayoutBinding.descriptorCount = STREAMED_TEXTURE_NUM;
+  PageTableSamplerLayoutBinding.pImmutableSamplers = nullptr;
+  PageTableSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  VkDescriptorSetLayoutBinding TileCacheSamplerLayoutBinding = {};
+  TileCacheSamplerLayoutBinding.binding = 11;
+  TileCacheSamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  TileCacheSamplerLayoutBinding.descriptorCount = STREAMED_TEXTURE_NUM;
+  TileCacheSamplerLayoutBinding.pImmutableSamplers = nullptr;
+  TileCacheSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  std::array<VkDescriptorSetLayoutBinding, 12> Bindings =
   {
     MvpUboLayoutBinding,
     LightUboLayoutBinding,
     MaterialUboLayoutBinding,
     AlbedoSamplerLayoutBinding,
     NormalSamplerLayoutBinding,
-    MetallicSamplerLayoutBinding,
-    RoughnessSamplerLayoutBinding,
-    AoSamplerLayoutBinding
+    OrmSamplerLayoutBinding,
+    DrawSsboLayoutBinding,
+    TextureFeedbackSsboLayoutBinding,
+    TileFeedbackSsboLayoutBinding,
+    VirtualTextureUboLayoutBinding,
+    PageTableSamplerLayoutBinding,
+    TileCacheSamplerLayoutBinding
   };
 
   VkDescriptorSetLayoutCreateInfo LayoutCreateInfo = {};
@@ -755,23 +1872,59 @@ void App::RecreateDrawingCommandBuffer()
 /* Vulkan Init */void App::CreateGraphicsPipeline()
 {
   //Shader modules:
-  auto VertShaderCode = ReadFile(m_VertexShaderPath);
-  auto FragShaderCode = ReadFile(m_FragmentShaderPath);
+  if(m_VertexShaderCode.empty())
+    m_VertexShaderCode = ReadShaderCode(m_VertexShaderPath);
+  if(m_FragmentShaderCode.empty())
+    m_FragmentShaderCode = ReadShaderCode(GetFragmentShaderPath());
+
+  VkShaderModule VertShaderModule = CreateShaderModule(m_Device, m_VertexShaderCode);
+  VkShaderModule FragShaderModule = CreateShaderModule(m_Device, m_FragmentShaderCode);
+
+  //The vertex shader decodes the vertex layout selected by this constant.
+  VkBool32 bCompactVertex = m_VertexFormat == VERTEX_FORMAT_COMPACT ? VK_TRUE : VK_FALSE;
+
+  VkSpecializationMapEntry VertSpecializationMapEntry = {};
+  VertSpecializationMapEntry.constantID = 0;
+  VertSpecializationMapEntry.offset = 0;
+  VertSpecializationMapEntry.size = sizeof(bCompactVertex);
+
+  VkSpecializationInfo VertSpecializationInfo = {};
+  VertSpecializationInfo.mapEntryCount = 1;
+  VertSpecializationInfo.pMapEntries = &VertSpecializationMapEntry;
+  VertSpecializationInfo.dataSize = sizeof(bCompactVertex);
+  VertSpecializationInfo.pData = &bCompactVertex;
+
+  /* The fragment shader only writes the feedback of the streaming if the device lets it store from the fragment stage, only
+   * encodes its output itself if the swap chain does not and only samples through the page tables with virtual texturing. */
+  VkBool32 FragConstants[] = {m_bTextureStreaming ? VK_TRUE : VK_FALSE, m_bSrgbSwapChain ? VK_TRUE : VK_FALSE, m_bVirtualTexturing ? VK_TRUE : VK_FALSE};
+
+  VkSpecializationMapEntry FragSpecializationMapEntries[3] = {};
+  for(uint32_t i = 0; i < 3; ++i)
+  {
+    FragSpecializationMapEntries[i].constantID = i;
+    FragSpecializationMapEntries[i].offset = i * sizeof(VkBool32);
+    FragSpecializationMapEntries[i].size = sizeof(VkBool32);
+  }
 
-  VkShaderModule VertShaderModule = CreateShaderModule(m_Device, VertShaderCode);
-  VkShaderModule FragShaderModule = CreateShaderModule(m_Device, FragShaderCode);
+  VkSpecializationInfo FragSpecializationInfo = {};
+  FragSpecializationInfo.mapEntryCount = 3;
+  FragSpecializationInfo.pMapEntries = FragSpecializationMapEntries;
+  FragSpecializationInfo.dataSize = sizeof(FragConstants);
+  FragSpecializationInfo.pData = FragConstants;
 
   VkPipelineShaderStageCreateInfo VertShaderStageCreateInfo = {};
   VertShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
   VertShaderStageCreateInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
   VertShaderStageCreateInfo.module = VertShaderModule;
   VertShaderStageCreateInfo.pName = "main";
+  VertShaderStageCreateInfo.pSpecializationInfo = &VertSpecializationInfo;
 
   VkPipelineShaderStageCreateInfo FragShaderStageCreateInfo = {};
   FragShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
   FragShaderStageCreateInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
   FragShaderStageCreateInfo.module = FragShaderModule;
   FragShaderStageCreateInfo.pName = "main";
+  FragShaderStageCreateInfo.pSpecializationInfo = &FragSpecializationInfo;
 
   VkPipelineShaderStageCreateInfo ShaderStageCreateInfos[] =
   {
@@ -783,6 +1936,12 @@ void App::RecreateDrawingCommandBuffer()
   auto BindingDescription = Vertex::GetBindingDescription();
   auto AttributeDescription = Vertex::GetAttributeDescription();
 
+  if(m_VertexFormat == VERTEX_FORMAT_COMPACT)
+  {
+    BindingDescription = CompactVertex::GetBindingDescription();
+    AttributeDescription = CompactVertex::GetAttributeDescription();
+  }
+
   VkPipelineVertexInputStateCreateInfo VertexInputStateCreateInfo = {};
   VertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
   VertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
@@ -886,7 +2045,8 @@ void App::RecreateDrawingCommandBuffer()
   PipelineLayoutCreateInfo.pushConstantRangeCount = 0;
   PipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
 
-  if(vkCreatePipelineLayout(m_Device, &PipelineLayoutCreateInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+  //Reloaded shaders keep the layout, only the pipelines are created again.
+  if(m_PipelineLayout == VK_NULL_HANDLE && vkCreatePipelineLayout(m_Device, &PipelineLayoutCreateInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
     throw std::runtime_error("Failed to create pipeline layout!");
 
   VkGraphicsPipelineCreateInfo GraphicsPipelineCreateInfo = {};
@@ -1040,107 +2200,228 @@ void App::RecreateDrawingCommandBuffer()
 
 /* Vulkan Init */void App::LoadAndCreateTextures()
 {
-  CreateTextureFromFile(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, m_AlbedoTexturePath.c_str(), m_AlbedoTexture);
-
-  CreateTextureFromFile(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, m_NormalTexturePath.c_str(), m_NormalTexture);
+  /* The files are decoded by the asset loader, until they are published the textures are single texels that leave the
+   * material factors unchanged: white, and a normal pointing straight out of the surface. */
+  TextureInfo Placeholder;
+  CreateTexture(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, MakeSolidImage(255, 255, 255, 255), MIP_CONTENT_SRGB, Placeholder);
+  m_AlbedoTexture = MakeTextureHandle(Placeholder);
 
-  CreateTextureFromFile(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, m_MetallicTexturePath.c_str(), m_MetallicTexture);
+  CreateTexture(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, MakeSolidImage(128, 128, 255, 255), MIP_CONTENT_NORMAL, Placeholder);
+  m_NormalTexture = MakeTextureHandle(Placeholder);
 
-  CreateTextureFromFile(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, m_RoughnessTexturePath.c_str(), m_RoughnessTexture);
-
-  CreateTextureFromFile(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, m_AoTexturePath.c_str(), m_AoTexture);
+  CreateTexture(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, MakeSolidImage(255, 255, 255, 255), MIP_CONTENT_LINEAR, Placeholder);
+  m_OrmTexture = MakeTextureHandle(Placeholder);
 }
 
-void App::LoadObjModel()
+/* Vulkan Init */void App::LoadObjModel(LoadedModel& Model)
 {
-  Assimp::Importer Import;
-  const aiScene* pScene = Import.ReadFile(m_ModelPath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_OptimizeMeshes);
-
-  if(!pScene || pScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !pScene->mRootNode)
-    throw std::runtime_error(Import.GetErrorString());
-
-  m_VertexNum = pScene->mMeshes[0]->mNumVertices;
-  m_FacetNum = pScene->mMeshes[0]->mNumFaces;
-
-  m_Vertices.clear();
-  m_Indices.clear();
-
-  m_Vertices.reserve(m_VertexNum);
-  m_Indices.reserve(m_FacetNum * 3);
-
-  for(uint32_t i = 0; i < m_VertexNum; ++i)
+  if(IsGlbFile(m_ModelPath))
   {
-    Vertex Vertex = {};
+    auto OpenStart = std::chrono::steady_clock::now();
+    m_GltfFile.Open(m_ModelPath, Model.ModelScene);
+    double OpenTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - OpenStart).count();
+
+    Model.VertexNum = m_GltfFile.GetVertexNum();
+    Model.IndexNum = m_GltfFile.GetIndexNum();
+    Model.FacetNum = Model.IndexNum / 3;
+
+    //The bounds come from the accessors, the vertices are quantized while they are written into the staging buffer.
+    glm::vec3 Min, Max;
+    m_GltfFile.GetBounds(Min, Max);
+    ComputeQuantization(Min, Max, Model.PositionScale, Model.PositionOffset);
+
+    std::cout << "Mapped \"" << m_ModelPath << "\" and parsed its JSON in " << OpenTime << " ms." << std::endl;
+    std::cout << "Meshes: " << Model.ModelScene.MeshNum() << ", nodes: " << Model.ModelScene.NodeNum() << ", draws: " << Model.ModelScene.DrawNum() << ", materials: " << Model.ModelScene.MaterialNum() << std::endl;
+    std::cout << "Vertices: " << Model.VertexNum << ", triangles: " << Model.FacetNum << std::endl;
+    return;
+  }
 
-    Vertex.Position.x = pScene->mMeshes[0]->mVertices[i].x;
-    Vertex.Position.y = pScene->mMeshes[0]->mVertices[i].y;
-    Vertex.Position.z = pScene->mMeshes[0]->mVertices[i].z;
+  MeshImportStatistics Statistics;
+  LoadScene(m_ModelPath, Model.ModelScene, Statistics, m_MeshImporter);
 
-    Vertex.Color = {1.0f, 1.0f, 1.0f};
+  Model.VertexNum = Model.ModelScene.Vertices.size();
+  Model.IndexNum = Model.ModelScene.Indices.size();
+  Model.FacetNum = Model.ModelScene.FacetNum();
 
-    if(pScene->mMeshes[0]->HasNormals())
-    {
-      Vertex.Normal.x = pScene->mMeshes[0]->mNormals[i].x;
-      Vertex.Normal.y = pScene->mMeshes[0]->mNormals[i].y;
-      Vertex.Normal.z = pScene->mMeshes[0]->mNormals[i].z;
-    }
+  //The whole scene is quantized to its common bounds, so all draws share one dequantization.
+  if(m_VertexFormat == VERTEX_FORMAT_COMPACT)
+    QuantizeVertices(Model.ModelScene.Vertices, Model.CompactVertices, Model.PositionScale, Model.PositionOffset);
 
-    if(pScene->mMeshes[0]->HasTangentsAndBitangents())
-    {
-      Vertex.Tangent.x = pScene->mMeshes[0]->mTangents[i].x;
-      Vertex.Tangent.y = pScene->mMeshes[0]->mTangents[i].y;
-      Vertex.Tangent.z = pScene->mMeshes[0]->mTangents[i].z;
-    }
+  if(Statistics.bLoadedFromCache)
+    std::cout << "Loaded \"" << m_ModelPath << "\" from its mesh cache in " << Statistics.ImportTime << " ms." << std::endl;
+  else
+    std::cout << "Imported \"" << m_ModelPath << "\" in " << Statistics.ImportTime << " ms, welded and optimized it in " << Statistics.WeldTime << " ms and " << Statistics.OptimizeTime << " ms." << std::endl;
 
-    if(pScene->mMeshes[0]->HasTextureCoords(0))
-    {
-      Vertex.TexCoord.x = pScene->mMeshes[0]->mTextureCoords[0][i].x;
-      Vertex.TexCoord.y = pScene->mMeshes[0]->mTextureCoords[0][i].y;
-    }
+  std::cout << "Meshes: " << Model.ModelScene.MeshNum() << ", nodes: " << Model.ModelScene.NodeNum() << ", draws: " << Model.ModelScene.DrawNum() << ", materials: " << Model.ModelScene.MaterialNum() << std::endl;
 
-    m_Vertices.push_back(Vertex);
-  }
+  std::cout << "Vertices: " << Statistics.SourceVertexNum << " -> " << Statistics.WeldedVertexNum << " ("
+            << 100.0 * (1.0 - static_cast<double>(Statistics.WeldedVertexNum) / static_cast<double>(std::max<size_t>(Statistics.SourceVertexNum, 1))) << " % fewer), "
+            << "ACMR: " << Statistics.AcmrBefore << " -> " << Statistics.AcmrAfter << ", ATVR: " << Statistics.AtvrBefore << " -> " << Statistics.AtvrAfter << std::endl;
 
-  for(uint32_t i = 0; i < m_FacetNum; ++i)
+  //The triangles of the whole scene if every mesh was drawn at the given level, or at its coarsest one if it has fewer levels.
+  std::vector<size_t> LodFacetNum(MaxLodNum, 0);
+  for(size_t Mesh = 0; Mesh < Model.ModelScene.MeshNum(); ++Mesh)
   {
-    m_Indices.push_back(pScene->mMeshes[0]->mFaces[i].mIndices[0]);
-    m_Indices.push_back(pScene->mMeshes[0]->mFaces[i].mIndices[1]);
-    m_Indices.push_back(pScene->mMeshes[0]->mFaces[i].mIndices[2]);
+    for(uint32_t Lod = 0; Lod < MaxLodNum; ++Lod)
+      LodFacetNum[Lod] += Model.ModelScene.LodIndexNum[Model.ModelScene.MeshFirstLod[Mesh] + std::min(Lod, Model.ModelScene.MeshLodNum[Mesh] - 1)] / 3;
   }
+
+  std::cout << "Levels of detail: " << Model.ModelScene.LodNum() << " for " << Model.ModelScene.MeshNum() << " meshes";
+  if(!Statistics.bLoadedFromCache)
+    std::cout << ", simplified in " << Statistics.SimplifyTime << " ms";
+  std::cout << ", triangles per level:";
+  for(size_t Lod = 0; Lod < LodFacetNum.size(); ++Lod)
+    std::cout << (Lod > 0 ? ", " : " ") << LodFacetNum[Lod];
+  std::cout << std::endl;
+
+  size_t MeshletNum = 0;
+  for(size_t Mesh = 0; Mesh < Model.ModelScene.MeshNum(); ++Mesh)
+    MeshletNum += Model.ModelScene.LodMeshletNum[Model.ModelScene.MeshFirstLod[Mesh]];
+  std::cout << "Meshlets: " << MeshletNum << " at LOD 0 (at most " << MESHLET_MAX_VERTEX_NUM << " vertices and " << MESHLET_MAX_TRIANGLE_NUM << " triangles each), "
+            << Model.ModelScene.MeshletNum() << " over all levels." << std::endl;
+
+  std::cout << "Vertex format: " << (m_VertexFormat == VERTEX_FORMAT_COMPACT ? "compact, " : "full, ")
+            << (m_VertexFormat == VERTEX_FORMAT_COMPACT ? sizeof(CompactVertex) : sizeof(Vertex)) << " bytes per vertex." << std::endl;
 }
 
-/* Vulkan Init */void App::CreateVertexBuffer()
+/* Vulkan Init */bool App::LoadArchivedModel(LoadedModel& Model)
 {
-  VkDeviceSize BufferSize = sizeof(m_Vertices[0]) * m_Vertices.size();
+  if(!m_AssetArchive.IsOpen())
+    return false;
+
+  //Vertices baked in the other format cannot be used, the model is imported again then.
+  const ArchiveSection* pScene = m_AssetArchive.Find(m_ModelPath, ARCHIVE_SECTION_SCENE);
+  const ArchiveSection* pVertices = m_AssetArchive.Find(m_ModelPath, ARCHIVE_SECTION_VERTICES);
+  const ArchiveSection* pIndices = m_AssetArchive.Find(m_ModelPath, ARCHIVE_SECTION_INDICES);
+  if(pScene == nullptr || pVertices == nullptr || pIndices == nullptr || pScene->Format != m_VertexFormat || pScene->Size < sizeof(ArchivedModel))
+    return false;
+
+  auto ReadStart = std::chrono::steady_clock::now();
+
+  ArchivedModel Archived;
+  std::memcpy(&Archived, m_AssetArchive.GetData(*pScene), sizeof(Archived));
+
+  size_t VertexSize = m_VertexFormat == VERTEX_FORMAT_COMPACT ? sizeof(CompactVertex) : sizeof(Vertex);
+  if(!ReadSceneData(m_AssetArchive.GetData(*pScene) + sizeof(Archived), pScene->Size - sizeof(Archived), Model.ModelScene) ||
+     Archived.VertexNum * VertexSize > pVertices->Size || Archived.IndexNum * sizeof(uint32_t) > pIndices->Size)
+    throw std::runtime_error("The model \"" + m_ModelPath + "\" in \"" + m_AssetArchivePath + "\" is corrupted!");
+
+  Model.VertexNum = static_cast<size_t>(Archived.VertexNum);
+  Model.IndexNum = static_cast<size_t>(Archived.IndexNum);
+  Model.FacetNum = Model.ModelScene.FacetNum();
+  Model.PositionScale = glm::vec3(Archived.PositionScale[0], Archived.PositionScale[1], Archived.PositionScale[2]);
+  Model.PositionOffset = glm::vec3(Archived.PositionOffset[0], Archived.PositionOffset[1], Archived.PositionOffset[2]);
+  Model.pArchivedVertices = m_AssetArchive.GetData(*pVertices);
+  Model.pArchivedIndices = m_AssetArchive.GetData(*pIndices);
+
+  //Read the pages in here, the render thread only copies them into the staging buffers.
+  TouchPages(Model.pArchivedVertices, pVertices->Size);
+  TouchPages(Model.pArchivedIndices, pIndices->Size);
+
+  double ReadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - ReadStart).count();
+  std::cout << "Loaded \"" << m_ModelPath << "\" from \"" << m_AssetArchivePath << "\" in " << ReadTime << " ms." << std::endl;
+  std::cout << "Meshes: " << Model.ModelScene.MeshNum() << ", nodes: " << Model.ModelScene.NodeNum() << ", draws: " << Model.ModelScene.DrawNum() << ", materials: " << Model.ModelScene.MaterialNum() << std::endl;
+  std::cout << "Vertices: " << Model.VertexNum << ", triangles: " << Model.FacetNum << ", levels of detail: " << Model.ModelScene.LodNum() << ", meshlets: " << Model.ModelScene.MeshletNum() << std::endl;
+
+  return true;
+}
 
-  BufferInfo StagingBuffer;
+/* Vulkan Init */void App::CreateVertexBuffer(LoadedModel& Model)
+{
+  if(Model.VertexNum == 0)
+    return;
 
-  CreateBuffer(m_PhysicalDevice, m_Device, BufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, StagingBuffer);
+  VkDeviceSize BufferSize = (m_VertexFormat == VERTEX_FORMAT_COMPACT ? sizeof(CompactVertex) : sizeof(Vertex)) * Model.VertexNum;
+  const void* pVertexData = m_VertexFormat == VERTEX_FORMAT_COMPACT ? static_cast<const void*>(Model.CompactVertices.data()) : Model.ModelScene.Vertices.data();
+  if(Model.pArchivedVertices != nullptr)
+    pVertexData = Model.pArchivedVertices;
+
+  auto Write = [this, &Model, BufferSize, pVertexData](void* pMappedData)
+               {
+                 if(m_GltfFile.IsOpen())
+                   m_GltfFile.WriteVertices(pMappedData, m_VertexFormat, Model.PositionScale, Model.PositionOffset);
+                 else
+                   std::memcpy(pMappedData, pVertexData, static_cast<size_t>(BufferSize));
+               };
+
+  if(IsBufferUploadOnTransferQueue())
+    m_TransferQueue.UploadBuffer(BufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, Write, Model.VertexBuffer, Model.VertexTransfer);
+  else
+    CreateDeviceLocalBuffer(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, BufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_bDirectUpload, Write, Model.VertexBuffer);
+}
 
-  MapMemory(m_Device, StagingBuffer.Memory, BufferSize, m_Vertices.data());
+/* Vulkan Init */void App::CreateIndexBuffer(LoadedModel& Model)
+{
+  if(Model.IndexNum == 0)
+    return;
 
-  CreateBuffer(m_PhysicalDevice, m_Device, BufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VertexBuffer);
+  VkDeviceSize BufferSize = sizeof(uint32_t) * Model.IndexNum;
+  const void* pIndexData = Model.pArchivedIndices != nullptr ? Model.pArchivedIndices : Model.ModelScene.Indices.data();
+
+  auto Write = [this, BufferSize, pIndexData](void* pMappedData)
+               {
+                 if(m_GltfFile.IsOpen())
+                 {
+                   size_t CopiedSize = m_GltfFile.WriteIndices(static_cast<uint32_t*>(pMappedData));
+                   std::cout << "Index buffer: " << CopiedSize << " of " << BufferSize << " bytes copied unconverted from the mapped file." << std::endl;
+                 }
+                 else
+                   std::memcpy(pMappedData, pIndexData, static_cast<size_t>(BufferSize));
+               };
+
+  if(IsBufferUploadOnTransferQueue())
+    m_TransferQueue.UploadBuffer(BufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, Write, Model.IndexBuffer, Model.IndexTransfer);
+  else
+    CreateDeviceLocalBuffer(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, BufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_bDirectUpload, Write, Model.IndexBuffer);
+}
+
+/* Vulkan Init */void App::CreateDrawBuffer()
+{
+  //An empty storage buffer is not allowed, so there is always at least one entry.
+  std::vector<DrawStorageBufferObject> Draws(std::max<size_t>(m_Scene.DrawNum(), 1));
+  for(size_t i = 0; i < m_Scene.DrawNum(); ++i)
+  {
+    Draws[i].Model = m_Scene.NodeWorldTransform[m_Scene.DrawNode[i]];
+    Draws[i].ModelInvTranspose = glm::transpose(glm::inverse(Draws[i].Model));
+    Draws[i].Material = std::min(m_Scene.MeshMaterial[m_Scene.DrawMesh[i]], m_MaxMaterialNum - 1);
+  }
 
-  CopyBuffer(m_Device, m_CommandPool, m_GraphicsQueue, StagingBuffer, m_VertexBuffer, BufferSize);
+  VkDeviceSize BufferSize = sizeof(Draws[0]) * Draws.size();
 
-  DestroyBuffer(m_Device, StagingBuffer);
+  CreateDeviceLocalBuffer(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, BufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_bDirectUpload,
+                          [&Draws, BufferSize](void* pMappedData) {std::memcpy(pMappedData, Draws.data(), static_cast<size_t>(BufferSize));}, m_DrawBuffer);
 }
 
-/* Vulkan Init */void App::CreateIndexBuffer()
+/* Vulkan Init */void App::CreateIndirectDrawBuffers()
 {
-  VkDeviceSize BufferSize = sizeof(m_Indices[0]) * m_Indices.size();
+  if(!m_bDrawIndirectFirstInstance)
+    return;
 
-  BufferInfo StagingBuffer;
+  //Every draw may need a command for each meshlet of its largest LOD.
+  m_IndirectDrawCapacity = 0;
+  for(size_t Draw = 0; Draw < m_Scene.DrawNum(); ++Draw)
+  {
+    uint32_t Mesh = m_Scene.DrawMesh[Draw];
+    uint32_t MaxMeshletNum = 0;
+    for(uint32_t Lod = m_Scene.MeshFirstLod[Mesh]; Lod < m_Scene.MeshFirstLod[Mesh] + m_Scene.MeshLodNum[Mesh]; ++Lod)
+      MaxMeshletNum = std::max(MaxMeshletNum, m_Scene.LodMeshletNum[Lod]);
 
-  CreateBuffer(m_PhysicalDevice, m_Device, BufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, StagingBuffer);
+    m_IndirectDrawCapacity += MaxMeshletNum;
+  }
 
-  MapMemory(m_Device, StagingBuffer.Memory, BufferSize, m_Indices.data());
+  VkDeviceSize BufferSize = sizeof(VkDrawIndexedIndirectCommand) * std::max<uint32_t>(m_IndirectDrawCapacity, 1);
 
-  CreateBuffer(m_PhysicalDevice, m_Device, BufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_IndexBuffer);
+  m_IndirectDrawBuffers.resize(m_SwapChainInfo.BufferCount());
+  m_pMappedIndirectDraws.resize(m_SwapChainInfo.BufferCount());
+  m_IndirectDrawNum.assign(m_SwapChainInfo.BufferCount(), 0);
 
-  CopyBuffer(m_Device, m_CommandPool, m_GraphicsQueue, StagingBuffer, m_IndexBuffer, BufferSize);
+  for(size_t i = 0; i < m_SwapChainInfo.BufferCount(); ++i)
+  {
+    CreateBuffer(m_PhysicalDevice, m_Device, BufferSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_IndirectDrawBuffers[i]);
 
-  DestroyBuffer(m_Device, StagingBuffer);
+    vkMapMemory(m_Device, m_IndirectDrawBuffers[i].Memory, 0, VK_WHOLE_SIZE, 0, &m_pMappedIndirectDraws[i]);
+    std::memset(m_pMappedIndirectDraws[i], 0, static_cast<size_t>(BufferSize));
+  }
 }
 
 /* Vulkan Init */void App::CreateMvpUniformBuffer()
@@ -1170,12 +2451,79 @@ void App::CreateMaterialUniformBuffer()
   m_MaterialUniformBuffers.resize(m_SwapChainInfo.BufferCount());
 
   for(size_t i = 0; i < m_SwapChainInfo.BufferCount(); ++i)
+  {
     CreateBuffer(m_PhysicalDevice, m_Device, BufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_MaterialUniformBuffers[i]);
+
+    UpdateMaterialUniformBuffer(i);
+  }
+}
+
+/* Vulkan Init */void App::CreateTextureFeedbackBuffers()
+{
+  VkDeviceSize BufferSize = sizeof(TextureFeedbackStorageBufferObject);
+
+  m_TextureFeedbackBuffers.resize(m_SwapChainInfo.BufferCount());
+  m_pMappedTextureFeedback.resize(m_SwapChainInfo.BufferCount());
+
+  for(size_t i = 0; i < m_SwapChainInfo.BufferCount(); ++i)
+  {
+    CreateBuffer(m_PhysicalDevice, m_Device, BufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_TextureFeedbackBuffers[i]);
+
+    vkMapMemory(m_Device, m_TextureFeedbackBuffers[i].Memory, 0, VK_WHOLE_SIZE, 0, &m_pMappedTextureFeedback[i]);
+    std::memset(m_pMappedTextureFeedback[i], 0, static_cast<size_t>(BufferSize));
+  }
+}
+
+/* Vulkan Init */void App::CreateVirtualTextures()
+{
+  //The copies into the tile caches are submitted on the graphics queue together with the frames.
+  QueueFamilyIndices Indices = FindQueueFamilies(m_PhysicalDevice, m_Surface);
+  m_TileUploader.Create(m_PhysicalDevice, m_Device, m_GraphicsQueue, Indices.GraphicsFamily.value(), STREAMED_TEXTURE_NUM, m_TileCacheSlotsPerSide, m_MaxFramesInFlights, m_TileStagingNum);
+  for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
+    m_TileCaches[Slot].Init(Slot, m_TileCacheSlotsPerSide, m_TileRecentFrameNum);
+
+  //Larger textures start at a smaller level, the layout of the largest one has the most pages.
+  VirtualTextureLayout LargestLayout;
+  GetVirtualTextureLayout(MaxVirtualTextureSize, MaxVirtualTextureSize, 32, LargestLayout);
+  m_TileFeedbackWordNum = (LargestLayout.PageNum + 31) / 32;
+  VkDeviceSize FeedbackSize = sizeof(uint32_t) * m_TileFeedbackWordNum * STREAMED_TEXTURE_NUM;
+
+  m_TileFeedbackBuffers.resize(m_SwapChainInfo.BufferCount());
+  m_pMappedTileFeedback.resize(m_SwapChainInfo.BufferCount());
+  m_VirtualTextureUniformBuffers.resize(m_SwapChainInfo.BufferCount());
+
+  for(size_t i = 0; i < m_SwapChainInfo.BufferCount(); ++i)
+  {
+    CreateBuffer(m_PhysicalDevice, m_Device, FeedbackSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_TileFeedbackBuffers[i]);
+
+    vkMapMemory(m_Device, m_TileFeedbackBuffers[i].Memory, 0, VK_WHOLE_SIZE, 0, &m_pMappedTileFeedback[i]);
+    std::memset(m_pMappedTileFeedback[i], 0, static_cast<size_t>(FeedbackSize));
+
+    CreateBuffer(m_PhysicalDevice, m_Device, sizeof(VirtualTextureUniformBufferObject), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 m_VirtualTextureUniformBuffers[i]);
+  }
+}
+
+/* App Helper */void App::UpdateMaterialUniformBuffer(size_t ImageIndex)
+{
+  VkDeviceSize BufferSize = sizeof(MaterialUniformBufferObject);
+
+  //The materials only change with the model, so they are written when it is published instead of every frame. Their factors scale the texture values.
+  auto Materials = std::make_unique<MaterialUniformBufferObject>();
+  for(size_t i = 0; i < std::min<size_t>(m_Scene.MaterialNum(), m_MaxMaterialNum); ++i)
+  {
+    Materials->Materials[i].Albedo = m_Scene.MaterialBaseColorFactor[i];
+    Materials->Materials[i].Metallic = m_Scene.MaterialMetallicFactor[i];
+    Materials->Materials[i].Roughness = m_Scene.MaterialRoughnessFactor[i];
+    Materials->Materials[i].Ao = 1.0f;
+  }
+
+  MapMemory(m_Device, m_MaterialUniformBuffers[ImageIndex].Memory, BufferSize, Materials.get());
 }
 
 /* Vulkan Init */void App::CreateDescriptorPool()
 {
-  std::array<VkDescriptorPoolSize, 8> PoolSizes = {};
+  std::array<VkDescriptorPoolSize, 12> PoolSizes = {};
 
   PoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
   PoolSizes[0].descriptorCount = static_cast<uint32_t>(m_SwapChainInfo.BufferCount());
@@ -1195,12 +2543,24 @@ void App::CreateMaterialUniformBuffer()
   PoolSizes[5].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
   PoolSizes[5].descriptorCount = static_cast<uint32_t>(m_SwapChainInfo.BufferCount());
 
-  PoolSizes[6].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  PoolSizes[6].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
   PoolSizes[6].descriptorCount = static_cast<uint32_t>(m_SwapChainInfo.BufferCount());
 
-  PoolSizes[7].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  PoolSizes[7].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
   PoolSizes[7].descriptorCount = static_cast<uint32_t>(m_SwapChainInfo.BufferCount());
 
+  PoolSizes[8].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  PoolSizes[8].descriptorCount = static_cast<uint32_t>(m_SwapChainInfo.BufferCount());
+
+  PoolSizes[9].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  PoolSizes[9].descriptorCount = static_cast<uint32_t>(m_SwapChainInfo.BufferCount());
+
+  PoolSizes[10].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  PoolSizes[10].descriptorCount = static_cast<uint32_t>(m_SwapChainInfo.BufferCount()) * STREAMED_TEXTURE_NUM;
+
+  PoolSizes[11].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  PoolSizes[11].descriptorCount = static_cast<uint32_t>(m_SwapChainInfo.BufferCount()) * STREAMED_TEXTURE_NUM;
+
   VkDescriptorPoolCreateInfo PoolCreateInfo = {};
   PoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
   PoolCreateInfo.poolSizeCount = static_cast<uint32_t>(PoolSizes.size());
@@ -1224,157 +2584,309 @@ void App::CreateMaterialUniformBuffer()
   if(vkAllocateDescriptorSets(m_Device, &AllocInfo, m_DescriptorSets.data()) != VK_SUCCESS)
     throw std::runtime_error("Failed to allocate descriptor sets!");
 
+  UpdateDescriptorSets();
+}
+
+/* App Helper */void App::UpdateDescriptorSets()
+{
   for(size_t i = 0; i < m_SwapChainInfo.BufferCount(); ++i)
+    UpdateDescriptorSet(i);
+}
+
+/* App Helper */void App::UpdateDescriptorSet(size_t i)
+{
+  VkDescriptorBufferInfo MvpBufferInfo = m_MvpUniformBuffers[i].GetDescriptorBufferInfo<MvpUniformBufferObject>();
+  VkDescriptorBufferInfo LightBufferInfo = m_LightUniformBuffers[i].GetDescriptorBufferInfo<LightUniformBufferObject>();
+  VkDescriptorBufferInfo MaterialBufferInfo = m_MaterialUniformBuffers[i].GetDescriptorBufferInfo<MaterialUniformBufferObject>();
+  VkDescriptorImageInfo AlbedoImageInfo = m_AlbedoTexture->GetDescriptorImageInfo();
+  VkDescriptorImageInfo NormalImageInfo = m_NormalTexture->GetDescriptorImageInfo();
+  VkDescriptorImageInfo OrmImageInfo = m_OrmTexture->GetDescriptorImageInfo();
+
+  VkDescriptorBufferInfo DrawBufferInfo = {};
+  DrawBufferInfo.buffer = m_DrawBuffer.Buffer;
+  DrawBufferInfo.offset = 0;
+  DrawBufferInfo.range = VK_WHOLE_SIZE;
+
+  VkDescriptorBufferInfo TextureFeedbackBufferInfo = m_TextureFeedbackBuffers[i].GetDescriptorBufferInfo<TextureFeedbackStorageBufferObject>();
+
+  VkDescriptorBufferInfo TileFeedbackBufferInfo = {};
+  TileFeedbackBufferInfo.buffer = m_TileFeedbackBuffers[i].Buffer;
+  TileFeedbackBufferInfo.offset = 0;
+  TileFeedbackBufferInfo.range = VK_WHOLE_SIZE;
+
+  VkDescriptorBufferInfo VirtualTextureBufferInfo = m_VirtualTextureUniformBuffers[i].GetDescriptorBufferInfo<VirtualTextureUniformBufferObject>();
+
+  std::array<VkDescriptorImageInfo, STREAMED_TEXTURE_NUM> PageTableImageInfos;
+  std::array<VkDescriptorImageInfo, STREAMED_TEXTURE_NUM> TileCacheImageInfos;
+  for(uint32_t Slot = 0; Slot < STREAMED_TEXTURE_NUM; ++Slot)
   {
-    VkDescriptorBufferInfo MvpBufferInfo = m_MvpUniformBuffers[i].GetDescriptorBufferInfo<MvpUniformBufferObject>();
-    VkDescriptorBufferInfo LightBufferInfo = m_LightUniformBuffers[i].GetDescriptorBufferInfo<LightUniformBufferObject>();
-    VkDescriptorBufferInfo MaterialBufferInfo = m_MaterialUniformBuffers[i].GetDescriptorBufferInfo<MaterialUniformBufferObject>();
-    VkDescriptorImageInfo AlbedoImageInfo = m_AlbedoTexture.GetDescriptorImageInfo();
-    VkDescriptorImageInfo NormalImageInfo = m_NormalTexture.GetDescriptorImageInfo();
-    VkDescriptorImageInfo MetallicImageInfo = m_MetallicTexture.GetDescriptorImageInfo();
-    VkDescriptorImageInfo RoughnessImageInfo = m_RoughnessTexture.GetDescriptorImageInfo();
-    VkDescriptorImageInfo AoImageInfo = m_AoTexture.GetDescriptorImageInfo();
-
-    std::array<VkWriteDescriptorSet, 8> DescriptorWrites = {};
-
-    DescriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[0].dstSet = m_DescriptorSets[i];
-    DescriptorWrites[0].dstBinding = 0;
-    DescriptorWrites[0].dstArrayElement = 0;
-    DescriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    DescriptorWrites[0].descriptorCount = 1;
-    DescriptorWrites[0].pBufferInfo = &MvpBufferInfo;
-    DescriptorWrites[0].pImageInfo = nullptr;
-    DescriptorWrites[0].pTexelBufferView = nullptr;
-
-    DescriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[1].dstSet = m_DescriptorSets[i];
-    DescriptorWrites[1].dstBinding = 1;
-    DescriptorWrites[1].dstArrayElement = 0;
-    DescriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    DescriptorWrites[1].descriptorCount = 1;
-    DescriptorWrites[1].pBufferInfo = &LightBufferInfo;
-    DescriptorWrites[1].pImageInfo = nullptr;
-    DescriptorWrites[1].pTexelBufferView = nullptr;
-
-    DescriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[2].dstSet = m_DescriptorSets[i];
-    DescriptorWrites[2].dstBinding = 2;
-    DescriptorWrites[2].dstArrayElement = 0;
-    DescriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    DescriptorWrites[2].descriptorCount = 1;
-    DescriptorWrites[2].pBufferInfo = &MaterialBufferInfo;
-    DescriptorWrites[2].pImageInfo = nullptr;
-    DescriptorWrites[2].pTexelBufferView = nullptr;
-
-    DescriptorWrites[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[3].dstSet = m_DescriptorSets[i];
-    DescriptorWrites[3].dstBinding = 3;
-    DescriptorWrites[3].dstArrayElement = 0;
-    DescriptorWrites[3].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    DescriptorWrites[3].descriptorCount = 1;
-    DescriptorWrites[3].pBufferInfo = nullptr;
-    DescriptorWrites[3].pImageInfo = &AlbedoImageInfo;
-    DescriptorWrites[3].pTexelBufferView = nullptr;
-
-    DescriptorWrites[4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[4].dstSet = m_DescriptorSets[i];
-    DescriptorWrites[4].dstBinding = 4;
-    DescriptorWrites[4].dstArrayElement = 0;
-    DescriptorWrites[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    DescriptorWrites[4].descriptorCount = 1;
-    DescriptorWrites[4].pBufferInfo = nullptr;
-    DescriptorWrites[4].pImageInfo = &NormalImageInfo;
-    DescriptorWrites[4].pTexelBufferView = nullptr;
-
-    DescriptorWrites[5].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[5].dstSet = m_DescriptorSets[i];
-    DescriptorWrites[5].dstBinding = 5;
-    DescriptorWrites[5].dstArrayElement = 0;
-    DescriptorWrites[5].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    DescriptorWrites[5].descriptorCount = 1;
-    DescriptorWrites[5].pBufferInfo = nullptr;
-    DescriptorWrites[5].pImageInfo = &MetallicImageInfo;
-    DescriptorWrites[5].pTexelBufferView = nullptr;
-
-    DescriptorWrites[6].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[6].dstSet = m_DescriptorSets[i];
-    DescriptorWrites[6].dstBinding = 6;
-    DescriptorWrites[6].dstArrayElement = 0;
-    DescriptorWrites[6].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    DescriptorWrites[6].descriptorCount = 1;
-    DescriptorWrites[6].pBufferInfo = nullptr;
-    DescriptorWrites[6].pImageInfo = &RoughnessImageInfo;
-    DescriptorWrites[6].pTexelBufferView = nullptr;
-
-    DescriptorWrites[7].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[7].dstSet = m_DescriptorSets[i];
-    DescriptorWrites[7].dstBinding = 7;
-    DescriptorWrites[7].dstArrayElement = 0;
-    DescriptorWrites[7].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    DescriptorWrites[7].descriptorCount = 1;
-    DescriptorWrites[7].pBufferInfo = nullptr;
-    DescriptorWrites[7].pImageInfo = &AoImageInfo;
-    DescriptorWrites[7].pTexelBufferView = nullptr;
-
-    vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(DescriptorWrites.size()), DescriptorWrites.data(), 0, nullptr);
+    PageTableImageInfos[Slot] = m_TileUploader.GetPageTable(Slot).GetDescriptorImageInfo();
+    TileCacheImageInfos[Slot] = m_TileUploader.GetCache(Slot).GetDescriptorImageInfo();
   }
+
+  std::array<VkWriteDescriptorSet, 12> DescriptorWrites = {};
+
+  DescriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[0].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[0].dstBinding = 0;
+  DescriptorWrites[0].dstArrayElement = 0;
+  DescriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  DescriptorWrites[0].descriptorCount = 1;
+  DescriptorWrites[0].pBufferInfo = &MvpBufferInfo;
+  DescriptorWrites[0].pImageInfo = nullptr;
+  DescriptorWrites[0].pTexelBufferView = nullptr;
+
+  DescriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[1].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[1].dstBinding = 1;
+  DescriptorWrites[1].dstArrayElement = 0;
+  DescriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  DescriptorWrites[1].descriptorCount = 1;
+  DescriptorWrites[1].pBufferInfo = &LightBufferInfo;
+  DescriptorWrites[1].pImageInfo = nullptr;
+  DescriptorWrites[1].pTexelBufferView = nullptr;
+
+  DescriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[2].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[2].dstBinding = 2;
+  DescriptorWrites[2].dstArrayElement = 0;
+  DescriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  DescriptorWrites[2].descriptorCount = 1;
+  DescriptorWrites[2].pBufferInfo = &MaterialBufferInfo;
+  DescriptorWrites[2].pImageInfo = nullptr;
+  DescriptorWrites[2].pTexelBufferView = nullptr;
+
+  DescriptorWrites[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[3].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[3].dstBinding = 3;
+  DescriptorWrites[3].dstArrayElement = 0;
+  DescriptorWrites[3].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  DescriptorWrites[3].descriptorCount = 1;
+  DescriptorWrites[3].pBufferInfo = nullptr;
+  DescriptorWrites[3].pImageInfo = &AlbedoImageInfo;
+  DescriptorWrites[3].pTexelBufferView = nullptr;
+
+  DescriptorWrites[4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[4].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[4].dstBinding = 4;
+  DescriptorWrites[4].dstArrayElement = 0;
+  DescriptorWrites[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  DescriptorWrites[4].descriptorCount = 1;
+  DescriptorWrites[4].pBufferInfo = nullptr;
+  DescriptorWrites[4].pImageInfo = &NormalImageInfo;
+  DescriptorWrites[4].pTexelBufferView = nullptr;
+
+  DescriptorWrites[5].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[5].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[5].dstBinding = 5;
+  DescriptorWrites[5].dstArrayElement = 0;
+  DescriptorWrites[5].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  DescriptorWrites[5].descriptorCount = 1;
+  DescriptorWrites[5].pBufferInfo = nullptr;
+  DescriptorWrites[5].pImageInfo = &OrmImageInfo;
+  DescriptorWrites[5].pTexelBufferView = nullptr;
+
+  DescriptorWrites[6].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[6].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[6].dstBinding = 6;
+  DescriptorWrites[6].dstArrayElement = 0;
+  DescriptorWrites[6].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  DescriptorWrites[6].descriptorCount = 1;
+  DescriptorWrites[6].pBufferInfo = &DrawBufferInfo;
+  DescriptorWrites[6].pImageInfo = nullptr;
+  DescriptorWrites[6].pTexelBufferView = nullptr;
+
+  DescriptorWrites[7].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[7].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[7].dstBinding = 7;
+  DescriptorWrites[7].dstArrayElement = 0;
+  DescriptorWrites[7].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  DescriptorWrites[7].descriptorCount = 1;
+  DescriptorWrites[7].pBufferInfo = &TextureFeedbackBufferInfo;
+  DescriptorWrites[7].pImageInfo = nullptr;
+  DescriptorWrites[7].pTexelBufferView = nullptr;
+
+  DescriptorWrites[8].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[8].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[8].dstBinding = 8;
+  DescriptorWrites[8].dstArrayElement = 0;
+  DescriptorWrites[8].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  DescriptorWrites[8].descriptorCount = 1;
+  DescriptorWrites[8].pBufferInfo = &TileFeedbackBufferInfo;
+  DescriptorWrites[8].pImageInfo = nullptr;
+  DescriptorWrites[8].pTexelBufferView = nullptr;
+
+  DescriptorWrites[9].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[9].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[9].dstBinding = 9;
+  DescriptorWrites[9].dstArrayElement = 0;
+  DescriptorWrites[9].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  DescriptorWrites[9].descriptorCount = 1;
+  DescriptorWrites[9].pBufferInfo = &VirtualTextureBufferInfo;
+  DescriptorWrites[9].pImageInfo = nullptr;
+  DescriptorWrites[9].pTexelBufferView = nullptr;
+
+  DescriptorWrites[10].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[10].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[10].dstBinding = 10;
+  DescriptorWrites[10].dstArrayElement = 0;
+  DescriptorWrites[10].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  DescriptorWrites[10].descriptorCount = STREAMED_TEXTURE_NUM;
+  DescriptorWrites[10].pBufferInfo = nullptr;
+  DescriptorWrites[10].pImageInfo = PageTableImageInfos.data();
+  DescriptorWrites[10].pTexelBufferView = nullptr;
+
+  DescriptorWrites[11].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrites[11].dstSet = m_DescriptorSets[i];
+  DescriptorWrites[11].dstBinding = 11;
+  DescriptorWrites[11].dstArrayElement = 0;
+  DescriptorWrites[11].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  DescriptorWrites[11].descriptorCount = STREAMED_TEXTURE_NUM;
+  DescriptorWrites[11].pBufferInfo = nullptr;
+  DescriptorWrites[11].pImageInfo = TileCacheImageInfos.data();
+  DescriptorWrites[11].pTexelBufferView = nullptr;
+
+  vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(DescriptorWrites.size()), DescriptorWrites.data(), 0, nullptr);
+}
+
+/* Vulkan Init */void App::CreateTimestampQueryPool()
+{
+  QueueFamilyIndices Indices = FindQueueFamilies(m_PhysicalDevice, m_Surface);
+
+  uint32_t QueueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &QueueFamilyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> QueueFamilies(QueueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &QueueFamilyCount, QueueFamilies.data());
+
+  //A queue family without valid timestamp bits cannot write timestamps, the overlay then only shows CPU timings.
+  uint32_t ValidBits = QueueFamilies[Indices.GraphicsFamily.value()].timestampValidBits;
+  m_bTimestampSupported = ValidBits != 0;
+
+  if(!m_bTimestampSupported)
+    return;
+
+  VkPhysicalDeviceProperties PhysicalDeviceProperties;
+  vkGetPhysicalDeviceProperties(m_PhysicalDevice, &PhysicalDeviceProperties);
+
+  m_TimestampPeriod = PhysicalDeviceProperties.limits.timestampPeriod;
+  m_TimestampMask = ValidBits >= 64 ? ~0ull : (1ull << ValidBits) - 1;
+  m_TimestampsWritten.assign(m_SwapChainInfo.BufferCount(), false);
+
+  VkQueryPoolCreateInfo CreateInfo = {};
+  CreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  CreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  CreateInfo.queryCount = m_TimestampQueryNum * static_cast<uint32_t>(m_SwapChainInfo.BufferCount());
+
+  if(vkCreateQueryPool(m_Device, &CreateInfo, nullptr, &m_TimestampQueryPool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create timestamp query pool!");
+}
+
+/* Vulkan Init */void App::CreateOverlay()
+{
+  m_Overlay.Create(m_PhysicalDevice, m_Device, m_CommandPool, m_GraphicsQueue, m_SwapChainInfo.BufferCount());
+
+  m_OverlayVertexShaderCode = ReadShaderCode(m_OverlayVertexShaderPath);
+  m_OverlayFragmentShaderCode = ReadShaderCode(m_OverlayFragmentShaderPath);
+
+  m_Overlay.CreatePipeline(m_Device, m_RenderPass, 1, m_SwapChainInfo.SwapChainExtent, m_bSrgbSwapChain, m_OverlayVertexShaderCode, m_OverlayFragmentShaderCode);
 }
 
 /* Vulkan Init */void App::CreateDrawingCommandBuffers()
 {
   m_DrawingCommandBuffers.resize(m_SwapChainInfo.BufferCount());
 
+  for(size_t i = 0; i < m_DrawingCommandBuffers.size(); ++i)
+    RecordDrawingCommandBuffer(i);
+}
+
+/* Vulkan Init */void App::RecordDrawingCommandBuffer(size_t i)
+{
+  //Only the main subpass is counted, the overlay is not part of the scene.
+  m_DrawCallNum = static_cast<uint32_t>(m_Scene.DrawNum());
+
   VkCommandBufferAllocateInfo CmdBufferAllocInfo = {};
   CmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
   CmdBufferAllocInfo.commandPool = m_CommandPool;
   CmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  CmdBufferAllocInfo.commandBufferCount = static_cast<uint32_t>(m_DrawingCommandBuffers.size());
+  CmdBufferAllocInfo.commandBufferCount = 1;
 
-  if(vkAllocateCommandBuffers(m_Device, &CmdBufferAllocInfo, m_DrawingCommandBuffers.data()) != VK_SUCCESS)
+  if(vkAllocateCommandBuffers(m_Device, &CmdBufferAllocInfo, &m_DrawingCommandBuffers[i]) != VK_SUCCESS)
     throw std::runtime_error("Failed to allocate command buffers!");
 
-  for(size_t i = 0; i < m_DrawingCommandBuffers.size(); ++i)
-  {
-    VkCommandBufferBeginInfo CmdBufferBeginInfo = {};
-    CmdBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    CmdBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-    CmdBufferBeginInfo.pInheritanceInfo = nullptr;
+  VkCommandBufferBeginInfo CmdBufferBeginInfo = {};
+  CmdBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  CmdBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+  CmdBufferBeginInfo.pInheritanceInfo = nullptr;
 
-    if(vkBeginCommandBuffer(m_DrawingCommandBuffers[i], &CmdBufferBeginInfo) != VK_SUCCESS)
-      throw std::runtime_error("Failed to begin recording command buffer!");
+  if(vkBeginCommandBuffer(m_DrawingCommandBuffers[i], &CmdBufferBeginInfo) != VK_SUCCESS)
+    throw std::runtime_error("Failed to begin recording command buffer!");
 
-    VkRenderPassBeginInfo PassBeginInfo = {};
-    PassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    PassBeginInfo.renderPass = m_RenderPass;
-    PassBeginInfo.framebuffer = m_SwapChainInfo.SwapChainFramebuffers[i];
-    PassBeginInfo.renderArea.offset = {0, 0};
-    PassBeginInfo.renderArea.extent = m_SwapChainInfo.SwapChainExtent;
+  uint32_t FirstQuery = static_cast<uint32_t>(i) * m_TimestampQueryNum;
+  if(m_bTimestampSupported)
+  {
+    vkCmdResetQueryPool(m_DrawingCommandBuffers[i], m_TimestampQueryPool, FirstQuery, m_TimestampQueryNum);
+    vkCmdWriteTimestamp(m_DrawingCommandBuffers[i], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TimestampQueryPool, FirstQuery);
+  }
+
+  VkRenderPassBeginInfo PassBeginInfo = {};
+  PassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  PassBeginInfo.renderPass = m_RenderPass;
+  PassBeginInfo.framebuffer = m_SwapChainInfo.SwapChainFramebuffers[i];
+  PassBeginInfo.renderArea.offset = {0, 0};
+  PassBeginInfo.renderArea.extent = m_SwapChainInfo.SwapChainExtent;
 
-    std::array<VkClearValue, 2> ClearColors = {};
-    ClearColors[0].color = {0.309f, 0.658f, 0.219f, 1.0f}; //A fancy green
-    ClearColors[1].depthStencil = {1.0f, 0};
+  std::array<VkClearValue, 2> ClearColors = {};
+  ClearColors[0].color = {0.309f, 0.658f, 0.219f, 1.0f}; //A fancy green
+  ClearColors[1].depthStencil = {1.0f, 0};
 
-    PassBeginInfo.clearValueCount = static_cast<uint32_t>(ClearColors.size());
-    PassBeginInfo.pClearValues = ClearColors.data();
+  PassBeginInfo.clearValueCount = static_cast<uint32_t>(ClearColors.size());
+  PassBeginInfo.pClearValues = ClearColors.data();
 
-    vkCmdBeginRenderPass(m_DrawingCommandBuffers[i], &PassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+  vkCmdBeginRenderPass(m_DrawingCommandBuffers[i], &PassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-    vkCmdBindPipeline(m_DrawingCommandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelines[m_GraphicsPipelineDisplayMode | m_GraphicsPipelineCullMode]);
+  vkCmdBindPipeline(m_DrawingCommandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelines[m_GraphicsPipelineDisplayMode | m_GraphicsPipelineCullMode]);
 
+  //Nothing is drawn until the model has been published.
+  if(m_VertexBuffer.Buffer != VK_NULL_HANDLE && m_IndexBuffer.Buffer != VK_NULL_HANDLE)
+  {
     VkBuffer VertexBuffers[] = {m_VertexBuffer.Buffer};
     VkDeviceSize Offsets[] = {0};
     vkCmdBindVertexBuffers(m_DrawingCommandBuffers[i], 0, 1, VertexBuffers, Offsets);
     vkCmdBindIndexBuffer(m_DrawingCommandBuffers[i], m_IndexBuffer.Buffer, 0, VK_INDEX_TYPE_UINT32);
-    vkCmdBindDescriptorSets(m_DrawingCommandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &m_DescriptorSets[i], 0, nullptr);
+  }
+  vkCmdBindDescriptorSets(m_DrawingCommandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &m_DescriptorSets[i], 0, nullptr);
+
+  //The buffers are bound once, every draw only selects its index range and passes its index as the first instance.
+  if(m_bDrawIndirectFirstInstance)
+  {
+    for(uint32_t Command = 0; Command < m_IndirectDrawCapacity; Command += m_MaxDrawIndirectCount)
+      vkCmdDrawIndexedIndirect(m_DrawingCommandBuffers[i], m_IndirectDrawBuffers[i].Buffer, sizeof(VkDrawIndexedIndirectCommand) * Command,
+                               std::min(m_IndirectDrawCapacity - Command, m_MaxDrawIndirectCount), sizeof(VkDrawIndexedIndirectCommand));
+  }
+  else
+  {
+    for(size_t Draw = 0; Draw < m_Scene.DrawNum(); ++Draw)
+    {
+      uint32_t Mesh = m_Scene.DrawMesh[Draw];
+      vkCmdDrawIndexed(m_DrawingCommandBuffers[i], m_Scene.MeshIndexNum[Mesh], 1, m_Scene.MeshFirstIndex[Mesh], m_Scene.MeshBaseVertex[Mesh], static_cast<uint32_t>(Draw));
+    }
+  }
 
-    vkCmdDrawIndexed(m_DrawingCommandBuffers[i], static_cast<uint32_t>(m_Indices.size()), 1, 0, 0, 0);
+  vkCmdNextSubpass(m_DrawingCommandBuffers[i], VK_SUBPASS_CONTENTS_INLINE);
 
-    vkCmdEndRenderPass(m_DrawingCommandBuffers[i]);
+  if(m_bTimestampSupported)
+    vkCmdWriteTimestamp(m_DrawingCommandBuffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampQueryPool, FirstQuery + 1);
 
-    if(vkEndCommandBuffer(m_DrawingCommandBuffers[i]) != VK_SUCCESS)
-      throw std::runtime_error("Failed to record command buffer!");
-  }
+  if(m_bShowOverlay)
+    m_Overlay.RecordDrawCommands(m_DrawingCommandBuffers[i], static_cast<uint32_t>(i));
+
+  vkCmdEndRenderPass(m_DrawingCommandBuffers[i]);
+
+  if(m_bTimestampSupported)
+    vkCmdWriteTimestamp(m_DrawingCommandBuffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampQueryPool, FirstQuery + 2);
+
+  if(vkEndCommandBuffer(m_DrawingCommandBuffers[i]) != VK_SUCCESS)
+    throw std::runtime_error("Failed to record command buffer!");
 }
 
 /* Vulkan Init */void App::CreateSyncObjects()
@@ -1382,6 +2894,9 @@ void App::CreateMaterialUniformBuffer()
   m_ImageAvailableSemaphores.resize(m_MaxFramesInFlights);
   m_RenderFinishedSemaphores.resize(m_MaxFramesInFlights);
   m_InFlightFences.resize(m_MaxFramesInFlights);
+  m_ImagesInFlight.assign(m_SwapChainInfo.BufferCount(), VK_NULL_HANDLE);
+  m_ImagesOutdated.assign(m_SwapChainInfo.BufferCount(), false);
+  m_InFlightFrameNums.assign(m_MaxFramesInFlights, 0);
 
   VkSemaphoreCreateInfo SemaphoreCreateInfo = {};
   SemaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -1505,79 +3020,24 @@ void App::CreateMaterialUniformBuffer()
     pApp->RecreateDrawingCommandBuffer();
   }
 
-  //[Esc]: Exit the application.
-  if(Key == GLFW_KEY_ESCAPE && Action == GLFW_RELEASE)
-    glfwSetWindowShouldClose(pApp->m_pWindow, true);
-}
-
-/* Helper */std::vector<char> App::ReadFile(const std::string& Filename)
-{
-  std::ifstream File(Filename, std::ios::ate | std::ios::binary);
-  if(!File.is_open())
-    throw std::runtime_error("Failed to open file!");
-
-  size_t FileSize = static_cast<size_t>(File.tellg());
-  std::vector<char> Buffer(FileSize);
-  File.seekg(0);
-  File.read(Buffer.data(), Buffer.size());
-  File.close();
-
-  return Buffer;
-}
-
-size_t App::VertexHash::operator()(const Vertex& Rhs) const
-{
-  return ((std::hash<glm::vec3>()(Rhs.Position) ^
-          (std::hash<glm::vec3>()(Rhs.Color) << 1)) >> 1) ^
-          (std::hash<glm::vec2>()(Rhs.TexCoord) << 1);
-}
-
-bool App::VertexEqual::operator()(const Vertex& Lhs, const Vertex& Rhs) const
-{
-  return Lhs.Position == Rhs.Position &&
-         Lhs.Color == Rhs.Color &&
-         Lhs.TexCoord == Rhs.TexCoord;
-}
-
-VkVertexInputBindingDescription App::Vertex::GetBindingDescription()
-{
-  VkVertexInputBindingDescription BindingDescription = {};
-  BindingDescription.binding = 0;
-  BindingDescription.stride = sizeof(Vertex);
-  BindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-  return BindingDescription;
-}
-
-std::array<VkVertexInputAttributeDescription, 5> App::Vertex::GetAttributeDescription()
-{
-  std::array<VkVertexInputAttributeDescription, 5> AttributeDescriptions = {};
-
-  AttributeDescriptions[0].binding = 0;
-  AttributeDescriptions[0].location = 0;
-  AttributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-  AttributeDescriptions[0].offset = offsetof(Vertex, Position);
-
-  AttributeDescriptions[1].binding = 0;
-  AttributeDescriptions[1].location = 1;
-  AttributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-  AttributeDescriptions[1].offset = offsetof(Vertex, Color);
-
-  AttributeDescriptions[2].binding = 0;
-  AttributeDescriptions[2].location = 2;
-  AttributeDescriptions[2].format = VK_FORMAT_R32G32B32_SFLOAT;
-  AttributeDescriptions[2].offset = offsetof(Vertex, Normal);
+  //[L]: Select levels of detail by distance, or draw everything at full detail.
+  if(Key == GLFW_KEY_L && Action == GLFW_RELEASE)
+    pApp->m_bSelectLods = !pApp->m_bSelectLods;
 
-  AttributeDescriptions[3].binding = 0;
-  AttributeDescriptions[3].location = 3;
-  AttributeDescriptions[3].format = VK_FORMAT_R32G32_SFLOAT;
-  AttributeDescriptions[3].offset = offsetof(Vertex, Tangent);
+  //[M]: Cull meshlets, or draw all meshlets of every draw.
+  if(Key == GLFW_KEY_M && Action == GLFW_RELEASE)
+    pApp->m_bCullMeshlets = !pApp->m_bCullMeshlets;
 
-  AttributeDescriptions[4].binding = 0;
-  AttributeDescriptions[4].location = 4;
-  AttributeDescriptions[4].format = VK_FORMAT_R32G32_SFLOAT;
-  AttributeDescriptions[4].offset = offsetof(Vertex, TexCoord);
+  //[H]: Show or hide the overlay.
+  if(Key == GLFW_KEY_H && Action == GLFW_RELEASE)
+  {
+    pApp->m_bShowOverlay = !pApp->m_bShowOverlay;
+    pApp->RecreateDrawingCommandBuffer();
+  }
 
-  return AttributeDescriptions;
+  //[Esc]: Exit the application.
+  if(Key == GLFW_KEY_ESCAPE && Action == GLFW_RELEASE)
+    glfwSetWindowShouldClose(pApp->m_pWindow, true);
 }
 
 NAMESPACE_END
\ No newline at end of file
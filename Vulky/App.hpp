@@ -22,12 +22,32 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <chrono>
 #include <optional>
+#include <memory>
+#include <functional>
 #include <unordered_map>
+#include <utility>
 
 #include "Namespace.hpp"
 #include "Camera.hpp"
 #include "VulkanHelper.hpp"
+#include "FileHelper.hpp"
+#include "Mesh.hpp"
+#include "Scene.hpp"
+#include "GltfLoader.hpp"
+#include "Overlay.hpp"
+#include "AssetLoader.hpp"
+#include "AssetArchive.hpp"
+#include "BlockCompressor.hpp"
+#include "TexturePacker.hpp"
+#include "TextureStreamer.hpp"
+#include "VirtualTexture.hpp"
+#include "TileUploader.hpp"
+#include "ResidencyManager.hpp"
+#include "ContentCache.hpp"
+#include "TransferQueue.hpp"
+#include "FileWatcher.hpp"
 
 NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
 
@@ -50,15 +70,109 @@ class App
   protected:
   /* App Helper */void UpdateUniformBuffer(uint32_t CurrentImage);
 
+  /* Select the level of detail of every draw from its projected error, cull its meshlets against the view frustum and,
+   * if the pipeline culls faces, their normal cones, and write the indirect draw commands of the image. */
+  /* App Helper */void UpdateDrawCommands(uint32_t ImageIndex);
+
   //Recreate the swapchain and all the objects depending on it, called when resizing.
   /* App Helper */void RecreateSwapChainAndRelevantObject();
 
   //Destroy the objects that are to be recreated in the "RecreateSwapChain()", called when resizing.
   /* App Helper */void DestroySwapChainAndRelevantObject();
 
-  //Recreate the drawing command buffer, called when display mode or cull mode is changed.
+  //Record the drawing command buffers again, each one before its image is drawn next. Called when display mode or cull mode is changed and when assets are published.
   /* App Helper */void RecreateDrawingCommandBuffer();
 
+  //Point the descriptor set of the image at the current resources and record its drawing command buffer again, once its fence has been waited on.
+  /* App Helper */void RefreshImage(uint32_t ImageIndex);
+
+  /* Destroy the resource once the frames submitted so far have completed, they may still use it. Replaces waiting for the device
+   * to be idle. With "bQueued" the graphics queue has been given commands for it since the last frame, the next one has to complete too. */
+  /* App Helper */void RetireResource(std::function<void()> Destroy, bool bQueued = false);
+
+  //Destroy the retired resources no frame uses anymore, or all of them once the device is idle.
+  /* App Helper */void DestroyRetiredResources(bool bAll);
+
+  //Fetch the GPU timings recorded the last time the given swap chain image was rendered.
+  /* App Helper */void ReadTimestampQueries(uint32_t ImageIndex);
+
+  /* App Helper */void UpdateOverlay(uint32_t ImageIndex);
+
+  //Hand the assets that finished loading in the background to the renderer, replacing their placeholders.
+  /* App Helper */void PublishAssets();
+
+  /* App Helper */void SubmitAssetLoads();
+
+  /* App Helper */void SubmitModelLoad(bool bReload);
+
+  //The textures of the material, in the order the fragment shader reports the levels it samples of them in.
+  enum STREAMED_TEXTURE
+  {
+    STREAMED_TEXTURE_ALBEDO,
+    STREAMED_TEXTURE_NORMAL,
+    STREAMED_TEXTURE_ORM,
+    STREAMED_TEXTURE_NUM
+  };
+
+  /* The content decides how the mip levels of a decoded file are filtered, see "MipGenerator.hpp". Several files are scalar maps
+   * whose red channels are packed into one texture. With streaming only the levels at the end of the chain are uploaded. Files
+   * that have been loaded before with the same content are neither decoded nor uploaded again. */
+  /* App Helper */void SubmitTextureLoad(const std::vector<std::string>& Paths, MIP_CONTENT Content, STREAMED_TEXTURE Slot, bool bReload);
+
+  struct LoadedTexture;
+
+  //Take over a texture uploaded on the transfer queue (or share the one of the texture cache) and replace the given one with it.
+  /* App Helper */void PublishTexture(LoadedTexture& Loaded, std::shared_ptr<TextureInfo>& Texture);
+
+  //A handle that destroys the texture when the last copy of it is released, a texture that frames in flight may sample is retired first.
+  /* App Helper */std::shared_ptr<TextureInfo> MakeTextureHandle(const TextureInfo& Texture);
+
+  /* App Helper */std::shared_ptr<TextureInfo>& GetStreamedTexture(STREAMED_TEXTURE Slot);
+
+  //Pass the levels the fragment shader sampled in the last frame rendered into the image on to the streaming and clear them.
+  /* App Helper */void ReadTextureFeedback(uint32_t ImageIndex);
+
+  //Upload the levels the streaming asks for this frame into the images of the textures, an image is only replaced if it has to grow or shrink.
+  /* App Helper */void SubmitTextureStreams();
+
+  /* Replace the images the streaming grows or shrinks with images the resident levels are copied into on the graphics queue.
+   * Runs before the images are refreshed, so no frame samples an image with the resident levels of another. */
+  /* App Helper */void ResizeStreamedTextures();
+
+  //Request the tiles the fragment shader sampled that are not in the tile caches yet, the uploader copies them into staging.
+  /* App Helper */void SubmitTileStreams();
+
+  //Mark the tiles that are in staging as resident and record their copies and those of the changed page tables, "VK_NULL_HANDLE" if there are none.
+  /* App Helper */VkCommandBuffer RecordTileUploads();
+
+  //Add the memory of the textures up and pass what they may take up on to the streaming, which evicts levels to stay within it.
+  /* App Helper */void UpdateTextureResidency();
+
+  //Buffers that can be written directly never need a queue, otherwise they go to the transfer queue if there is one.
+  /* App Helper */bool IsBufferUploadOnTransferQueue() const {return !m_bDirectUpload && m_TransferQueue.IsCreated();}
+
+  /* App Helper */const std::string& GetFragmentShaderPath() const {return m_bTextureStreaming || m_bVirtualTexturing ? m_FeedbackFragmentShaderPath : m_FragmentShaderPath;}
+
+  /* App Helper */void SubmitShaderLoad(bool bOverlay);
+
+  //The SPIR-V baked into the asset archive, or the file if the archive does not have it.
+  /* App Helper */std::vector<char> ReadShaderCode(const std::string& Path) const;
+
+  //Load the files the watcher found changed again in the background, they are swapped in when they are published.
+  /* App Helper */void ReloadChangedFiles();
+
+  /* App Helper */void DestroyGraphicsPipelines();
+
+  //Point the descriptor sets at the current buffers and textures, each image is updated again by "RefreshImage()" when one of them is replaced.
+  /* App Helper */void UpdateDescriptorSets();
+
+  /* App Helper */void UpdateDescriptorSet(size_t ImageIndex);
+
+  /* App Helper */void UpdateMaterialUniformBuffer(size_t ImageIndex);
+
+  //Retire the buffers whose size depends on the model, before it is replaced and when the application exits.
+  /* App Helper */void DestroyModelBuffers();
+
   protected:
   /* Vulkan Init */void CreateInstance();
 
@@ -90,11 +204,22 @@ class App
 
   /* Vulkan Init */void LoadAndCreateTextures();
 
-  /* Vulkan Init */void LoadObjModel();
+  struct LoadedModel;
+
+  //Runs on a worker thread of the asset loader, so it must only write into "Model" (and "m_GltfFile").
+  /* Vulkan Init */void LoadObjModel(LoadedModel& Model);
+
+  //Take the model from the asset archive instead, returns false if it has none baked in the current vertex format.
+  /* Vulkan Init */bool LoadArchivedModel(LoadedModel& Model);
+
+  //Create the buffers of the model, on the transfer queue if "IsBufferUploadOnTransferQueue()", which is what the loading job does then.
+  /* Vulkan Init */void CreateVertexBuffer(LoadedModel& Model);
+
+  /* Vulkan Init */void CreateIndexBuffer(LoadedModel& Model);
 
-  /* Vulkan Init */void CreateVertexBuffer();
+  /* Vulkan Init */void CreateDrawBuffer();
 
-  /* Vulkan Init */void CreateIndexBuffer();
+  /* Vulkan Init */void CreateIndirectDrawBuffers();
 
   /* Vulkan Init */void CreateMvpUniformBuffer();
 
@@ -102,12 +227,23 @@ class App
 
   /* Vulkan Init */void CreateMaterialUniformBuffer();
 
+  /* Vulkan Init */void CreateTextureFeedbackBuffers();
+
+  //The tile caches, the page tables and the buffers of the virtual textures, created without virtual texturing as well so the descriptors are valid.
+  /* Vulkan Init */void CreateVirtualTextures();
+
   /* Vulkan Init */void CreateDescriptorPool();
 
   /* Vulkan Init */void CreateDescriptorSets();
 
+  /* Vulkan Init */void CreateTimestampQueryPool();
+
+  /* Vulkan Init */void CreateOverlay();
+
   /* Vulkan Init */void CreateDrawingCommandBuffers();
 
+  /* Vulkan Init */void RecordDrawingCommandBuffer(size_t ImageIndex);
+
   /* Vulkan Init */void CreateSyncObjects();
 
   protected:
@@ -124,8 +260,6 @@ class App
 
   /* Callback */static void KeyboardCallback(GLFWwindow* pWindow, int Key, int ScanCode, int Action, int Mods);
 
-  /* Helper */static std::vector<char> ReadFile(const std::string& Filename);
-
   protected: //App
   GLFWwindow* m_pWindow = nullptr;
   uint32_t m_InitWidth = WINDOW_INIT_WIDTH;
@@ -134,8 +268,32 @@ class App
   std::string m_AppName = "VulkanApp";
   std::string m_EngineName = "VulkanEngine";
   std::string m_GpuName = "";
+  MEMORY_TOPOLOGY m_MemoryTopology = MEMORY_TOPOLOGY_DISCRETE;
+  //Turn off to compare with uploading everything through staging buffers, e.g. with the upload statistics printed once all assets are loaded.
+  const bool m_bDirectUploadEnabled = true;
+  bool m_bDirectUpload = false;
+  //Turn off to compare with uncompressed textures, block compressed ones are also only used if the device supports BC.
+  const bool m_bTextureCompressionEnabled = true;
+  bool m_bTextureCompression = false;
+  //Turn off to load all levels of the textures at once, streaming also needs "fragmentStoresAndAtomics" for the feedback.
+  const bool m_bTextureStreamingEnabled = true;
+  bool m_bTextureStreaming = false;
+  //Turn off to stream whole mip levels instead of the tiles the fragment shader samples, virtual texturing takes precedence over the level streaming. It also needs "fragmentStoresAndAtomics".
+  const bool m_bVirtualTexturingEnabled = true;
+  bool m_bVirtualTexturing = false;
+  //Turn off to compare with encoding the output in the fragment shader, e.g. with the average GPU time of the main subpass printed at exit.
+  const bool m_bSrgbSwapChainEnabled = true;
+  bool m_bSrgbSwapChain = false;
+  //The heaps report their budget with "VK_EXT_memory_budget", which also needs "VK_KHR_get_physical_device_properties2".
+  bool m_bPhysicalDeviceProperties2 = false;
+  bool m_bMemoryBudget = false;
   bool m_bFramebufferResized = false;
   double m_FPS = 0.0;
+  double m_CpuFrameTime = 0.0;
+  std::chrono::steady_clock::time_point m_StartTime;
+  //In milliseconds since "Run()" was called, negative until the first frame was presented and all assets were published.
+  double m_TimeToFirstFrame = -1.0;
+  double m_TimeToFullyLoaded = -1.0;
 
   protected: //Vulkan pipeline
 #ifdef NDEBUG
@@ -148,6 +306,15 @@ class App
 
   const std::string m_VertexShaderPath = "Shaders/Shader.vert.spv";
   const std::string m_FragmentShaderPath = "Shaders/Shader.frag.spv";
+  //The same shader with the stores of the texture and tile feedback, which need "fragmentStoresAndAtomics".
+  const std::string m_FeedbackFragmentShaderPath = "Shaders/ShaderFeedback.frag.spv";
+  const std::string m_OverlayVertexShaderPath = "Shaders/Overlay.vert.spv";
+  const std::string m_OverlayFragmentShaderPath = "Shaders/Overlay.frag.spv";
+  //The SPIR-V the graphics pipelines are created from, kept so recreating the swap chain does not read the files again.
+  std::vector<char> m_VertexShaderCode;
+  std::vector<char> m_FragmentShaderCode;
+  std::vector<char> m_OverlayVertexShaderCode;
+  std::vector<char> m_OverlayFragmentShaderCode;
 
   VkDebugUtilsMessengerEXT m_DebugMessenger = VK_NULL_HANDLE;
   VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
@@ -203,35 +370,182 @@ class App
   std::vector<VkSemaphore> m_ImageAvailableSemaphores;
   std::vector<VkSemaphore> m_RenderFinishedSemaphores;
   std::vector<VkFence> m_InFlightFences;
+  //The fence of the frame that is currently rendering into each swap chain image.
+  std::vector<VkFence> m_ImagesInFlight;
   size_t m_CurrentFrame = 0;
+  //The images whose descriptor set and drawing command buffer still refer to replaced resources, see "RefreshImage()".
+  std::vector<bool> m_ImagesOutdated;
+  //The frames submitted so far, per frame in flight how many had been submitted once its fence signals, and how many have completed.
+  uint64_t m_SubmittedFrameNum = 0;
+  std::vector<uint64_t> m_InFlightFrameNums;
+  uint64_t m_CompletedFrameNum = 0;
+
+  //A resource the frames submitted before it was replaced may still use.
+  struct RetiredResource
+  {
+    uint64_t FrameNum = 0;
+    std::function<void()> Destroy;
+  };
 
-  protected: //Mesh
-  struct Vertex
+  std::vector<RetiredResource> m_RetiredResources;
+
+  protected: //Asset
+  /* Textures and the model are decoded on the worker threads of the loader while the window already renders, at first with
+   * placeholder textures and without a model. Every asset is published on the render thread at the start of a frame. */
+  AssetLoader m_AssetLoader;
+
+  //Everything about the model that is loaded in the background, the render thread takes it over when it is published.
+  struct LoadedModel
+  {
+    Scene ModelScene;
+    std::vector<CompactVertex> CompactVertices;
+    glm::vec3 PositionScale = glm::vec3(1.0f);
+    glm::vec3 PositionOffset = glm::vec3(0.0f);
+    size_t VertexNum = 0;
+    size_t IndexNum = 0;
+    size_t FacetNum = 0;
+    //The vertices and indices of an archived model, in the mapped archive.
+    const void* pArchivedVertices = nullptr;
+    const void* pArchivedIndices = nullptr;
+    BufferInfo VertexBuffer;
+    BufferInfo IndexBuffer;
+    TransferTicket VertexTransfer;
+    TransferTicket IndexTransfer;
+    bool bFailed = false;
+  };
+
+  //All levels of a texture in the format it is uploaded in.
+  struct TextureSource
   {
-    glm::vec3 Position;
-    glm::vec3 Color;
-    glm::vec3 Normal;
-    glm::vec3 Tangent;
-    glm::vec2 TexCoord;
-
-    static VkVertexInputBindingDescription GetBindingDescription();
-    static std::array<VkVertexInputAttributeDescription, 5> GetAttributeDescription();
+    //The content of the files (or of the section of the archive) combined with how they are processed.
+    uint64_t Key = 0;
+    VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
+    //The levels generated from decoded files, "Mips" points into them or into the mapped archive.
+    MipChain Chain;
+    std::vector<MipData> Mips;
+    //With virtual texturing, the tiles of the layout cut from the chain (or in the mapped archive), "TileSize" bytes each.
+    VirtualTextureLayout TileLayout;
+    std::vector<uint8_t> Tiles;
+    const uint8_t* pTiles = nullptr;
+    size_t TileSize = 0;
+
+    std::vector<uint64_t> GetLevelSizes() const
+    {
+      std::vector<uint64_t> Sizes;
+      for(const auto& Mip : Mips)
+        Sizes.push_back(Mip.Size);
+      return Sizes;
+    }
   };
 
-  struct VertexHash {size_t operator()(const Vertex& Rhs) const;};
+  struct LoadedTexture
+  {
+    std::shared_ptr<const TextureSource> Source;
+    //The texture is created with the levels from this one to the end of the chain, the others are left for streaming.
+    uint32_t FirstLevel = 0;
+    //The image has the levels from this one on, the streaming fills those up to "FirstLevel" in later.
+    uint32_t AllocatedLevel = 0;
+    //Only the levels up to this one are uploaded, the image already has the others.
+    uint32_t EndLevel = UINT32_MAX;
+    /* The image of the texture cache if it has these levels of the source, otherwise the one the job uploaded. A stream that
+     * fills levels in place keeps the image it uploads into alive here. */
+    std::shared_ptr<TextureInfo> Texture;
+    TextureInfo Uploaded;
+    TransferTicket Transfer;
+    //A file saved again with the content the texture already has changes nothing.
+    bool bUnchanged = false;
+
+    uint64_t GetKey() const {return HashCombine(Source->Key, FirstLevel);}
+
+    //The levels of the image, only those that are uploaded have data.
+    std::vector<MipData> GetUploadMips() const
+    {
+      std::vector<MipData> Mips(Source->Mips.begin() + AllocatedLevel, Source->Mips.end());
+      for(uint32_t Level = AllocatedLevel; Level < Source->Mips.size(); ++Level)
+      {
+        if(Level < FirstLevel || Level >= EndLevel)
+          Mips[Level - AllocatedLevel].pData = nullptr;
+      }
+
+      return Mips;
+    }
+  };
+
+  /* Textures are shared by content. The sources are kept for as long as a job or the streaming uses them, the images for as long
+   * as a texture is bound to them; until then, loading the same content again takes them from the caches. All textures share
+   * the samplers of the same state, see "AcquireSampler()". */
+  ContentCache<const TextureSource> m_TextureSourceCache;
+  ContentCache<TextureInfo> m_TextureCache;
+
+  //Uploads from the loading jobs run on a queue of their own if the device has one, see "TransferQueue.hpp".
+  TransferQueue m_TransferQueue;
 
-  struct VertexEqual {bool operator()(const Vertex& Lhs, const Vertex& Rhs) const;};
+  /* Shaders, textures and the model are taken from this archive (see "AssetArchive.hpp") if it exists and has them, which
+   * skips importing, decoding and generating mips at start up. Reloads always read the source files. */
+  const std::string m_AssetArchivePath = "Assets.vka";
+  AssetArchive m_AssetArchive;
 
+  //Shaders, textures and the model are reloaded when their files change.
+  FileWatcher m_FileWatcher;
+  bool m_bModelLoading = false;
+  bool m_bModelReloadRequested = false;
+
+  protected: //Mesh
   const std::string m_ModelPath = "Models/Cerberus.obj";
-  std::vector<Vertex> m_Vertices;
-  std::vector<uint32_t> m_Indices;
+  //OBJ models are parsed by the multithreaded "LoadObj()" instead of Assimp unless this is "MESH_IMPORTER_ASSIMP".
+  MESH_IMPORTER m_MeshImporter = MESH_IMPORTER_OBJ;
+  //All meshes of the model share one vertex and one index buffer, each draw covers the range of one mesh.
+  Scene m_Scene;
+  /* GLB models are not imported into "m_Scene.Vertices" and "m_Scene.Indices", they are written from the mapped file straight
+   * into the staging buffers. The file is opened by the loading job (which also writes the buffers if they are uploaded on the
+   * transfer queue) and only touched by the render thread once it is published. */
+  GltfFile m_GltfFile;
+
+  //The layout the vertex buffer is created with, the compact one needs less than half of the memory and bandwidth.
+  VERTEX_FORMAT m_VertexFormat = VERTEX_FORMAT_COMPACT;
+  glm::vec3 m_PositionScale = glm::vec3(1.0f);
+  glm::vec3 m_PositionOffset = glm::vec3(0.0f);
 
   size_t m_VertexNum = 0;
+  //All levels of detail included.
+  size_t m_IndexNum = 0;
+  //Triangles at LOD 0.
   size_t m_FacetNum = 0;
 
   BufferInfo m_VertexBuffer;
   BufferInfo m_IndexBuffer;
 
+  //Per-draw data, indexed with the instance index in the vertex shader, the first instance of every draw is its index.
+  struct DrawStorageBufferObject
+  {
+    alignas(16) glm::mat4 Model;
+    alignas(16) glm::mat4 ModelInvTranspose;
+    alignas(16) uint32_t Material;
+  };
+
+  BufferInfo m_DrawBuffer;
+
+  /* Levels of detail are selected and meshlets are culled on the CPU every frame, every visible meshlet is one command in
+   * a persistently mapped, host-visible indirect buffer (one per swap chain image), so the prerecorded command buffers stay
+   * valid. The commands of the visible meshlets are packed at the front, the rest of the buffer holds empty draws. Without
+   * "drawIndirectFirstInstance" the draw index cannot be passed as the first instance, everything is drawn at LOD 0 then. */
+  std::vector<BufferInfo> m_IndirectDrawBuffers;
+  std::vector<void*> m_pMappedIndirectDraws;
+  //The number of commands the indirect buffers have room for and are recorded with, and how many of them were written last time.
+  uint32_t m_IndirectDrawCapacity = 0;
+  std::vector<uint32_t> m_IndirectDrawNum;
+  bool m_bMultiDrawIndirect = false;
+  bool m_bDrawIndirectFirstInstance = false;
+  uint32_t m_MaxDrawIndirectCount = 1;
+  bool m_bSelectLods = true;
+  //The largest distance between a level of detail and the full mesh that may show on screen, in pixels.
+  float m_LodPixelError = 1.0f;
+  bool m_bCullMeshlets = true;
+  std::vector<size_t> m_LodFacetNum;
+  size_t m_DrawnFacetNum = 0;
+  size_t m_MeshletNum = 0;
+  size_t m_DrawnMeshletNum = 0;
+
   protected: //UBO
   struct MvpUniformBufferObject
   {
@@ -239,6 +553,9 @@ class App
     alignas(16) glm::mat4 ModelInvTranspose;
     alignas(16) glm::mat4 View;
     alignas(16) glm::mat4 Projection;
+    //Dequantization of compact vertex positions.
+    alignas(16) glm::vec4 PositionScale;
+    alignas(16) glm::vec4 PositionOffset;
   };
 
   static const uint32_t m_LightNum = 8;
@@ -249,12 +566,19 @@ class App
     alignas(16) glm::vec3 ViewPosition;
   };
 
+  //Materials beyond this are drawn with the last one, 256 of them fit into the smallest "maxUniformBufferRange" of 16 KiB.
+  static const uint32_t m_MaxMaterialNum = 256;
   struct MaterialUniformBufferObject
   {
-    alignas(16) glm::vec4 Albedo;
-    alignas(4) float Metallic;
-    alignas(4) float Roughness;
-    alignas(4) float Ao;
+    struct alignas(16) Material
+    {
+      alignas(16) glm::vec4 Albedo;
+      alignas(4) float Metallic;
+      alignas(4) float Roughness;
+      alignas(4) float Ao;
+    };
+
+    Material Materials[m_MaxMaterialNum];
   };
 
   VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
@@ -268,24 +592,107 @@ class App
 
   protected: //Texture
   const std::string m_AlbedoTexturePath = "Textures/Cerberus/Cerberus_A.png";
-  TextureInfo m_AlbedoTexture;
+  std::shared_ptr<TextureInfo> m_AlbedoTexture;
 
   const std::string m_NormalTexturePath = "Textures/Cerberus/Cerberus_N.png";
-  TextureInfo m_NormalTexture;
+  std::shared_ptr<TextureInfo> m_NormalTexture;
 
+  //Ambient occlusion, roughness and metallic are packed into the red, green and blue channels of one texture, see "TexturePacker.hpp".
+  const std::string m_AoTexturePath = "Textures/Cerberus/Cerberus_AO.png";
+  const std::string m_RoughnessTexturePath = "Textures/Cerberus/Cerberus_R.png";
   const std::string m_MetallicTexturePath = "Textures/Cerberus/Cerberus_M.png";
-  TextureInfo m_MetallicTexture;
+  std::shared_ptr<TextureInfo> m_OrmTexture;
+  //The keys of the sources of the textures, zero for the placeholders.
+  std::array<uint64_t, STREAMED_TEXTURE_NUM> m_TextureKeys = {};
 
-  const std::string m_RoughnessTexturePath = "Textures/Cerberus/Cerberus_R.png";
-  TextureInfo m_RoughnessTexture;
+  /* Written by the fragment shader for a sample of its pixels: per texture the largest number of levels above its smallest one
+   * it needed plus one, zero if it was not sampled (which tells the eviction how recently it was). */
+  struct TextureFeedbackStorageBufferObject
+  {
+    uint32_t TextureDetail[STREAMED_TEXTURE_NUM];
+  };
 
-  const std::string m_AoTexturePath = "Textures/Cerberus/Cerberus_AO.png";
-  TextureInfo m_AoTexture;
+  /* Textures start with the levels at the end of their chains and gain the higher ones as the feedback asks for them. The
+   * feedback buffers (one per swap chain image, persistently mapped) are read once the fence of the image has been waited on,
+   * which never stalls. The decoded chains stay in memory, the higher levels are uploaded from them into the images, which are
+   * allocated with the whole chain; "MinLod" of "VirtualTextureUniformBufferObject" keeps the shader off the missing levels.
+   * Streamed images are changed in place, so they are not shared through the texture cache. */
+  TextureStreamer m_TextureStreamer;
+  std::array<std::shared_ptr<const TextureSource>, STREAMED_TEXTURE_NUM> m_StreamedSources;
+  //The requests that grow or shrink an image, with the source they were scheduled for. They are carried out in the next frame.
+  std::vector<std::pair<StreamRequest, std::shared_ptr<const TextureSource>>> m_TextureResizes;
+  std::vector<BufferInfo> m_TextureFeedbackBuffers;
+  std::vector<void*> m_pMappedTextureFeedback;
+  //The largest level a texture starts with and the bytes that may be requested per frame.
+  const uint64_t m_StreamingStartSize = 64 * 1024;
+  const uint64_t m_StreamingFrameBudget = 8 * 1024 * 1024;
+  /* The most the textures may take up, less if the heap they are allocated from has less left. Levels above the start level are
+   * evicted from the least recently sampled textures to stay within it and streamed in again from the sources when sampled. */
+  ResidencyManager m_ResidencyManager;
+  const VkDeviceSize m_TextureMemoryBudget = 256 * 1024 * 1024;
+
+  /* With virtual texturing the fragment shader samples the textures through their page tables from the tiles in their tile
+   * caches (see "VirtualTexture.hpp" and "TileUploader.hpp"), the textures above only keep the levels from the one that fits
+   * into a single tile on, for the pixels whose tiles are not resident yet. Every frame one pixel of every 4 x 4 (a different
+   * one each frame) sets the bits of the pages it samples in the feedback buffer of the image, which are read and cleared once
+   * the fence of the image has been waited on. The tiles the caches request are copied into staging on the worker of the
+   * uploader, the copies into the caches are submitted together with the frame. */
+  struct VirtualTextureUniformBufferObject
+  {
+    struct alignas(16) Texture
+    {
+      alignas(8) glm::uvec2 Size;
+      //Zero until the texture has been loaded, it is sampled like the others then.
+      alignas(4) uint32_t LevelNum;
+      //The first word of the texture in the feedback buffer.
+      alignas(4) uint32_t FeedbackOffset;
+      //The first level of its image that is resident, the levels above it are streamed in later.
+      alignas(4) float MinLod;
+    };
+
+    Texture Textures[STREAMED_TEXTURE_NUM];
+    alignas(8) glm::vec2 CacheTexelSize;
+    //The pixel of every 4 x 4 that writes the feedback, "X + 4 * Y".
+    alignas(4) uint32_t FeedbackPixel;
+  };
+
+  TileUploader m_TileUploader;
+  std::array<TileCache, STREAMED_TEXTURE_NUM> m_TileCaches;
+  std::vector<BufferInfo> m_TileFeedbackBuffers;
+  std::vector<void*> m_pMappedTileFeedback;
+  std::vector<BufferInfo> m_VirtualTextureUniformBuffers;
+  //The words of the feedback of a texture, enough for the pages of the largest layout.
+  uint32_t m_TileFeedbackWordNum = 0;
+  uint32_t m_FeedbackPixel = 0;
+  //A cache of 16 x 16 tiles per texture, 2176 x 2176 texels. The tiles a frame may request and how many may be in staging at once.
+  const uint32_t m_TileCacheSlotsPerSide = 16;
+  const uint32_t m_TileFrameBudget = 32;
+  const uint32_t m_TileStagingNum = 96;
+  //Tiles sampled during a full round of the feedback pixels are not evicted.
+  const uint32_t m_TileRecentFrameNum = 16;
 
   protected: //Camera
   Camera m_Camera;
   int m_MouseButton = -1;
   int m_MouseAction = -1;
+
+  protected: //Overlay
+  Overlay m_Overlay;
+  bool m_bShowOverlay = true;
+  uint32_t m_DrawCallNum = 0;
+
+  //Timestamps per swap chain image: frame start, end of the main subpass and end of the overlay subpass.
+  static const uint32_t m_TimestampQueryNum = 3;
+  VkQueryPool m_TimestampQueryPool = VK_NULL_HANDLE;
+  bool m_bTimestampSupported = false;
+  double m_TimestampPeriod = 0.0;
+  uint64_t m_TimestampMask = ~0ull;
+  std::vector<bool> m_TimestampsWritten;
+  bool m_bGpuTimeAvailable = false;
+  double m_GpuFrameTime = 0.0;
+  double m_OverlayGpuTime = 0.0;
+  double m_GpuFrameTimeSum = 0.0;
+  uint64_t m_GpuFrameTimeNum = 0;
 };
 
 NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "AssetArchive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  uint64_t AlignOffset(uint64_t Offset, uint64_t Alignment) {return (Offset + Alignment - 1) / Alignment * Alignment;}
+
+  ArchiveSection MakeSection(const std::string& Name, ARCHIVE_SECTION_TYPE Type, uint32_t Format)
+  {
+    if(Name.size() > ArchiveMaxNameLength)
+      throw std::runtime_error("Asset archive section name \"" + Name + "\" is too long!");
+
+    ArchiveSection Section = {};
+    std::memcpy(Section.Name, Name.data(), Name.size());
+    Section.Type = Type;
+    Section.Format = Format;
+    return Section;
+  }
+}
+
+void AssetArchiveWriter::AddSection(const std::string& Name, ARCHIVE_SECTION_TYPE Type, uint32_t Format, const void* pData, size_t Size)
+{
+  PendingSection Pending;
+  Pending.Section = MakeSection(Name, Type, Format);
+  Pending.Parts.emplace_back(static_cast<const uint8_t*>(pData), static_cast<const uint8_t*>(pData) + Size);
+  m_Sections.push_back(std::move(Pending));
+}
+
+void AssetArchiveWriter::AddTexture(const std::string& Name, uint32_t Format, const std::vector<std::vector<uint8_t>>& Levels, const std::vector<uint32_t>& Widths, const std::vector<uint32_t>& Heights)
+{
+  if(Levels.empty() || Levels.size() != Widths.size() || Levels.size() != Heights.size())
+    throw std::runtime_error("Asset archive texture \"" + Name + "\" has no or inconsistent mip levels!");
+
+  PendingSection Pending;
+  Pending.Section = MakeSection(Name, ARCHIVE_SECTION_TEXTURE, Format);
+  Pending.Section.Width = Widths[0];
+  Pending.Section.Height = Heights[0];
+  Pending.Section.MipLevels = static_cast<uint32_t>(Levels.size());
+  Pending.Parts = Levels;
+
+  for(size_t i = 0; i < Levels.size(); ++i)
+  {
+    ArchiveMip Mip = {};
+    Mip.Size = Levels[i].size();
+    Mip.Width = Widths[i];
+    Mip.Height = Heights[i];
+    Pending.Mips.push_back(Mip);
+  }
+
+  m_Sections.push_back(std::move(Pending));
+}
+
+uint64_t AssetArchiveWriter::Write(const std::string& Path) const
+{
+  //Lay out the table of contents first, the data follows it.
+  std::vector<ArchiveSection> Sections;
+  std::vector<ArchiveMip> Mips;
+  for(const auto& Pending : m_Sections)
+  {
+    Sections.push_back(Pending.Section);
+    Sections.back().FirstMip = static_cast<uint32_t>(Mips.size());
+    Mips.insert(Mips.end(), Pending.Mips.begin(), Pending.Mips.end());
+  }
+
+  ArchiveHeader Header = {};
+  Header.Magic = ArchiveMagic;
+  Header.Version = ArchiveVersion;
+  Header.SectionNum = static_cast<uint32_t>(Sections.size());
+  Header.MipNum = static_cast<uint32_t>(Mips.size());
+
+  uint64_t Offset = sizeof(Header) + sizeof(ArchiveSection) * Sections.size() + sizeof(ArchiveMip) * Mips.size();
+  for(size_t i = 0; i < Sections.size(); ++i)
+  {
+    Offset = AlignOffset(Offset, ArchiveSectionAlignment);
+    Sections[i].Offset = Offset;
+
+    const auto& Parts = m_Sections[i].Parts;
+    for(size_t Part = 0; Part < Parts.size(); ++Part)
+    {
+      Offset = AlignOffset(Offset, ArchiveMipAlignment);
+      if(!m_Sections[i].Mips.empty())
+        Mips[Sections[i].FirstMip + Part].Offset = Offset;
+      Offset += Parts[Part].size();
+    }
+
+    Sections[i].Size = Offset - Sections[i].Offset;
+  }
+
+  std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+  if(!File.is_open())
+    throw std::runtime_error("Failed to create asset archive \"" + Path + "\"!");
+
+  File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+  File.write(reinterpret_cast<const char*>(Sections.data()), sizeof(ArchiveSection) * Sections.size());
+  File.write(reinterpret_cast<const char*>(Mips.data()), sizeof(ArchiveMip) * Mips.size());
+
+  //The gaps are filled with zeros, the stream position always equals the offset.
+  auto PadTo = [&File](uint64_t Target)
+  {
+    static const char Zeros[ArchiveSectionAlignment] = {};
+    for(uint64_t Position = static_cast<uint64_t>(File.tellp()); Position < Target; Position += std::min<uint64_t>(Target - Position, sizeof(Zeros)))
+      File.write(Zeros, std::min<uint64_t>(Target - Position, sizeof(Zeros)));
+  };
+
+  for(size_t i = 0; i < Sections.size(); ++i)
+  {
+    PadTo(Sections[i].Offset);
+
+    const auto& Parts = m_Sections[i].Parts;
+    for(const auto& Part : Parts)
+    {
+      PadTo(AlignOffset(static_cast<uint64_t>(File.tellp()), ArchiveMipAlignment));
+      File.write(reinterpret_cast<const char*>(Part.data()), Part.size());
+    }
+  }
+
+  if(!File)
+    throw std::runtime_error("Failed to write asset archive \"" + Path + "\"!");
+
+  return static_cast<uint64_t>(File.tellp());
+}
+
+void AssetArchive::Open(const std::string& Path)
+{
+  Close();
+
+  m_File.Open(Path);
+
+  const auto* pData = reinterpret_cast<const uint8_t*>(m_File.GetData());
+  size_t Size = m_File.GetSize();
+
+  ArchiveHeader Header = {};
+  if(Size < sizeof(Header))
+  {
+    Close();
+    throw std::runtime_error("\"" + Path + "\" is not an asset archive!");
+  }
+
+  std::memcpy(&Header, pData, sizeof(Header));
+  uint64_t TableSize = sizeof(Header) + sizeof(ArchiveSection) * static_cast<uint64_t>(Header.SectionNum) + sizeof(ArchiveMip) * static_cast<uint64_t>(Header.MipNum);
+  if(Header.Magic != ArchiveMagic || Header.Version != ArchiveVersion || TableSize > Size)
+  {
+    Close();
+    throw std::runtime_error("\"" + Path + "\" is not an asset archive of this version!");
+  }
+
+  //The mapping starts at a page boundary and all entries are multiples of 8 bytes, so they can be used where they are.
+  m_pSections = reinterpret_cast<const ArchiveSection*>(pData + sizeof(Header));
+  m_pMips = reinterpret_cast<const ArchiveMip*>(pData + sizeof(Header) + sizeof(ArchiveSection) * Header.SectionNum);
+  m_SectionNum = Header.SectionNum;
+
+  for(uint32_t i = 0; i < m_SectionNum; ++i)
+  {
+    const ArchiveSection& Section = m_pSections[i];
+    bool bValid = Section.Offset <= Size && Section.Size <= Size - Section.Offset && Section.Name[ArchiveMaxNameLength] == '\0' &&
+                  static_cast<uint64_t>(Section.FirstMip) + Section.MipLevels <= Header.MipNum;
+
+    for(uint32_t Level = 0; bValid && Level < Section.MipLevels; ++Level)
+    {
+      const ArchiveMip& Mip = m_pMips[Section.FirstMip + Level];
+      bValid = Mip.Offset >= Section.Offset && Mip.Offset <= Section.Offset + Section.Size && Mip.Size <= Section.Offset + Section.Size - Mip.Offset;
+    }
+
+    if(!bValid)
+    {
+      Close();
+      throw std::runtime_error("Asset archive \"" + Path + "\" is corrupted!");
+    }
+  }
+}
+
+void AssetArchive::Close()
+{
+  m_File.Close();
+  m_pSections = nullptr;
+  m_pMips = nullptr;
+  m_SectionNum = 0;
+}
+
+const ArchiveSection* AssetArchive::Find(const std::string& Name, ARCHIVE_SECTION_TYPE Type) const
+{
+  for(uint32_t i = 0; i < m_SectionNum; ++i)
+  {
+    if(m_pSections[i].Type == static_cast<uint32_t>(Type) && Name == m_pSections[i].Name)
+      return &m_pSections[i];
+  }
+
+  return nullptr;
+}
+
+void TouchPages(const void* pData, uint64_t Size)
+{
+  //The sum is written to a volatile, so the reads cannot be optimized away.
+  const auto* pBytes = static_cast<const volatile uint8_t*>(pData);
+  uint8_t Sum = 0;
+  for(uint64_t Offset = 0; Offset < Size; Offset += ArchiveSectionAlignment)
+    Sum += pBytes[Offset];
+
+  volatile uint8_t Result = Sum;
+  (void)Result;
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "MappedFile.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* An asset archive (.vka) holds everything the application loads at start up, baked offline by VulkyBake into the layout the
+ * GPU consumes: SPIR-V, textures with all of their mip levels in their final format and the vertices and indices of the model
+ * in the vertex format they are drawn with. A table of contents at the start names every section, the sections themselves
+ * start at multiples of "ArchiveSectionAlignment" and mip levels at multiples of "ArchiveMipAlignment", so every one of them
+ * can be copied from the mapped file into a staging buffer in one piece and from there into a buffer or image.
+ *
+ * Layout: "ArchiveHeader", "SectionNum" times "ArchiveSection", "MipNum" times "ArchiveMip", the sections. */
+enum ARCHIVE_SECTION_TYPE
+{
+  ARCHIVE_SECTION_SHADER = 1,
+  ARCHIVE_SECTION_TEXTURE = 2,
+  //"ArchivedModel" followed by the data of "WriteSceneData()".
+  ARCHIVE_SECTION_SCENE = 3,
+  ARCHIVE_SECTION_VERTICES = 4,
+  ARCHIVE_SECTION_INDICES = 5,
+  /* The tiles of a texture for virtual texturing (see "VirtualTexture.hpp"), in the format of its texture section, whose size
+   * and levels give the layout. */
+  ARCHIVE_SECTION_TILES = 6
+};
+
+const uint32_t ArchiveMagic = 0x52414B56; //"VKAR"
+const uint32_t ArchiveVersion = 3; //2: colors are stored in sRGB formats. 3: textures have tiles sections.
+const uint64_t ArchiveSectionAlignment = 4096;
+//A multiple of every texel block size and of the 4 bytes "vkCmdCopyBufferToImage()" needs.
+const uint64_t ArchiveMipAlignment = 16;
+const size_t ArchiveMaxNameLength = 127;
+
+struct ArchiveHeader
+{
+  uint32_t Magic;
+  uint32_t Version;
+  uint32_t SectionNum;
+  uint32_t MipNum;
+};
+
+struct ArchiveSection
+{
+  char Name[ArchiveMaxNameLength + 1]; //The path of the source file, as the application refers to it.
+  uint32_t Type;
+  uint32_t Format; //A "VkFormat" for textures, a "VERTEX_FORMAT" for vertices and scenes.
+  uint32_t Width;
+  uint32_t Height;
+  uint32_t FirstMip;
+  uint32_t MipLevels;
+  uint64_t Offset; //From the start of the file.
+  uint64_t Size;
+};
+
+struct ArchiveMip
+{
+  uint64_t Offset; //From the start of the file.
+  uint64_t Size;
+  uint32_t Width;
+  uint32_t Height;
+};
+
+//The start of a scene section.
+struct ArchivedModel
+{
+  uint32_t VertexFormat;
+  uint32_t Reserved;
+  float PositionScale[3];
+  float PositionOffset[3];
+  uint64_t VertexNum;
+  uint64_t IndexNum;
+};
+
+//Collects the sections in memory and writes the archive in one go.
+class AssetArchiveWriter
+{
+  public:
+  void AddSection(const std::string& Name, ARCHIVE_SECTION_TYPE Type, uint32_t Format, const void* pData, size_t Size);
+
+  //The levels are given from the largest to the smallest one, each with its width and height.
+  void AddTexture(const std::string& Name, uint32_t Format, const std::vector<std::vector<uint8_t>>& Levels, const std::vector<uint32_t>& Widths, const std::vector<uint32_t>& Heights);
+
+  //Returns the size of the written file.
+  uint64_t Write(const std::string& Path) const;
+
+  protected:
+  struct PendingSection
+  {
+    ArchiveSection Section;
+    std::vector<std::vector<uint8_t>> Parts; //The mip levels of a texture, a single part for everything else.
+    std::vector<ArchiveMip> Mips;
+  };
+
+  std::vector<PendingSection> m_Sections;
+};
+
+/* A mapped archive, opening one validates its table of contents. Nothing else is read until the data of a section is
+ * touched, so the pages of the sections that are not used are never read from disk. */
+class AssetArchive
+{
+  public:
+  void Open(const std::string& Path);
+
+  void Close();
+
+  bool IsOpen() const {return m_File.GetData() != nullptr;}
+
+  //Returns nullptr if the archive has no section of the type for the name.
+  const ArchiveSection* Find(const std::string& Name, ARCHIVE_SECTION_TYPE Type) const;
+
+  const uint8_t* GetData(const ArchiveSection& Section) const {return reinterpret_cast<const uint8_t*>(m_File.GetData()) + Section.Offset;}
+
+  const ArchiveMip& GetMip(const ArchiveSection& Section, uint32_t Level) const {return m_pMips[Section.FirstMip + Level];}
+
+  const uint8_t* GetData(const ArchiveMip& Mip) const {return reinterpret_cast<const uint8_t*>(m_File.GetData()) + Mip.Offset;}
+
+  protected:
+  MappedFile m_File;
+  const ArchiveSection* m_pSections = nullptr;
+  const ArchiveMip* m_pMips = nullptr;
+  uint32_t m_SectionNum = 0;
+};
+
+//Read every page of the range of a mapped file in, so copying from it later does not wait on the disk.
+void TouchPages(const void* pData, uint64_t Size);
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "AssetLoader.hpp"
+
+#include <algorithm>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //Decoding is mostly bound by memory and disk, more threads than this only compete with the render thread.
+  const uint32_t MaxAssetThreadNum = 4;
+}
+
+AssetLoader::~AssetLoader()
+{
+  Stop();
+}
+
+void AssetLoader::Start(uint32_t ThreadNum)
+{
+  if(!m_Workers.empty())
+    return;
+
+  if(ThreadNum == 0)
+    ThreadNum = std::min(std::max(std::thread::hardware_concurrency(), 1u), MaxAssetThreadNum);
+
+  m_bStopping = false;
+  for(uint32_t i = 0; i < ThreadNum; ++i)
+    m_Workers.emplace_back(&AssetLoader::WorkerMain, this);
+}
+
+void AssetLoader::Stop()
+{
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    m_bStopping = true;
+    m_Queue.clear();
+  }
+  m_Condition.notify_all();
+
+  for(auto& Worker : m_Workers)
+    Worker.join();
+  m_Workers.clear();
+
+  Job* pJob = m_pCompleted.exchange(nullptr, std::memory_order_acquire);
+  while(pJob != nullptr)
+  {
+    std::unique_ptr<Job> Finished(pJob);
+    pJob = pJob->pNext;
+  }
+
+  m_PendingNum.store(0, std::memory_order_relaxed);
+}
+
+void AssetLoader::Submit(std::function<void()> Load, std::function<void()> Publish)
+{
+  auto NewJob = std::make_unique<Job>();
+  NewJob->Load = std::move(Load);
+  NewJob->Publish = std::move(Publish);
+
+  m_PendingNum.fetch_add(1, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    m_Queue.push_back(std::move(NewJob));
+  }
+  m_Condition.notify_one();
+}
+
+void AssetLoader::PublishCompleted()
+{
+  //Acquire pairs with the release of the workers, everything a job has loaded is visible from here on.
+  Job* pJob = m_pCompleted.exchange(nullptr, std::memory_order_acquire);
+
+  //The stack holds the last finished job first.
+  std::vector<std::unique_ptr<Job>> Finished;
+  for(; pJob != nullptr; pJob = pJob->pNext)
+    Finished.emplace_back(pJob);
+  std::reverse(Finished.begin(), Finished.end());
+
+  //A failing job must not drop the rest of the batch, the whole batch is published before the first error is rethrown.
+  std::exception_ptr FirstError;
+  for(auto& FinishedJob : Finished)
+  {
+    m_PendingNum.fetch_sub(1, std::memory_order_relaxed);
+
+    try
+    {
+      if(FinishedJob->Error)
+        std::rethrow_exception(FinishedJob->Error);
+
+      if(FinishedJob->Publish)
+        FinishedJob->Publish();
+    }
+    catch(...)
+    {
+      if(!FirstError)
+        FirstError = std::current_exception();
+    }
+  }
+
+  if(FirstError)
+    std::rethrow_exception(FirstError);
+}
+
+void AssetLoader::WorkerMain()
+{
+  for(;;)
+  {
+    std::unique_ptr<Job> CurrentJob;
+    {
+      std::unique_lock<std::mutex> Lock(m_Mutex);
+      m_Condition.wait(Lock, [this]() {return m_bStopping || !m_Queue.empty();});
+      if(m_bStopping)
+        return;
+
+      CurrentJob = std::move(m_Queue.front());
+      m_Queue.pop_front();
+    }
+
+    try
+    {
+      CurrentJob->Load();
+    }
+    catch(...)
+    {
+      CurrentJob->Error = std::current_exception();
+    }
+
+    //Treiber stack push, the release makes the loaded data visible to the thread that takes the job off the stack.
+    Job* pJob = CurrentJob.release();
+    pJob->pNext = m_pCompleted.load(std::memory_order_relaxed);
+    while(!m_pCompleted.compare_exchange_weak(pJob->pNext, pJob, std::memory_order_release, std::memory_order_relaxed))
+      ;
+  }
+}
+
+NAMESPACE_END
\ No newline at end of file
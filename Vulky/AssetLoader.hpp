@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* Runs the slow part of loading assets (reading and decoding files) on worker threads and hands the results back to the
+ * render thread. Every job is split in two: "Load" runs on a worker and must only touch data owned by the job, "Publish"
+ * runs later on the thread that calls "PublishCompleted()" and turns the result into GPU resources. Finished jobs are
+ * pushed onto a lock-free stack, so neither a worker nor the render thread ever waits for the other: the render thread
+ * only polls "HasCompleted()" once per frame and takes all finished jobs with a single atomic exchange. */
+class AssetLoader
+{
+  public:
+  AssetLoader() = default;
+
+  ~AssetLoader();
+
+  AssetLoader(const AssetLoader&) = delete;
+
+  AssetLoader& operator=(const AssetLoader&) = delete;
+
+  //Zero threads picks a number based on the hardware.
+  void Start(uint32_t ThreadNum = 0);
+
+  //Jobs that are running are finished, jobs that have not started and results that were not published are dropped.
+  void Stop();
+
+  void Submit(std::function<void()> Load, std::function<void()> Publish);
+
+  bool HasCompleted() const {return m_pCompleted.load(std::memory_order_relaxed) != nullptr;}
+
+  /* Publish all finished jobs in the order they were finished in. The first exception thrown by a "Load" or "Publish" is
+   * rethrown here, after all other jobs of the batch were published. */
+  void PublishCompleted();
+
+  //Jobs that have been submitted but not yet published.
+  size_t GetPendingNum() const {return m_PendingNum.load(std::memory_order_relaxed);}
+
+  protected:
+  struct Job
+  {
+    std::function<void()> Load;
+    std::function<void()> Publish;
+    std::exception_ptr Error;
+    Job* pNext = nullptr;
+  };
+
+  void WorkerMain();
+
+  std::vector<std::thread> m_Workers;
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  std::deque<std::unique_ptr<Job>> m_Queue;
+  bool m_bStopping = false;
+
+  //The top of the stack of finished jobs, each one owned by the stack until it is published.
+  std::atomic<Job*> m_pCompleted{nullptr};
+  std::atomic<size_t> m_PendingNum{0};
+};
+
+NAMESPACE_END
\ No newline at end of file
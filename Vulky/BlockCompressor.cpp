@@ -0,0 +1,461 @@
+#include "BlockCompressor.hpp"
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define BLOCK_SIMD_SSE2
+#endif
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //Levels with fewer blocks than this are not worth a thread of their own.
+  const size_t MinParallelBlockNum = 64 * 64;
+  //The interpolation weights of 4 bit BC7 indices, in 64ths.
+  const int Bc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+  const int Bc7RefinementNum = 2;
+
+  //The 16 texels of a block, row by row.
+  struct Block
+  {
+    uint8_t Texels[16][4];
+  };
+
+  void LoadBlock(const uint8_t* pPixels, uint32_t Width, uint32_t Height, uint32_t BlockX, uint32_t BlockY, Block& Out)
+  {
+    for(uint32_t y = 0; y < 4; ++y)
+    {
+      uint32_t SourceY = std::min(BlockY * 4 + y, Height - 1);
+      for(uint32_t x = 0; x < 4; ++x)
+      {
+        uint32_t SourceX = std::min(BlockX * 4 + x, Width - 1);
+        std::memcpy(Out.Texels[y * 4 + x], pPixels + (static_cast<size_t>(SourceY) * Width + SourceX) * 4, 4);
+      }
+    }
+  }
+
+  //Collects the fields of a 128 bit block from the least significant bit on.
+  class BlockBits
+  {
+    public:
+    void Write(uint32_t Value, int BitNum)
+    {
+      for(int i = 0; i < BitNum; ++i, ++m_Position)
+        m_Bytes[m_Position / 8] |= static_cast<uint8_t>(((Value >> i) & 1) << (m_Position % 8));
+    }
+
+    const uint8_t* GetData() const {return m_Bytes;}
+
+    protected:
+    uint8_t m_Bytes[16] = {};
+    int m_Position = 0;
+  };
+
+  //One channel of a block into 8 bytes of BC4: the largest and the smallest value and a 3 bit index per texel between them.
+  void EncodeBc4Block(const Block& Source, int Channel, uint8_t* pOut)
+  {
+    uint8_t Values[16];
+    for(int i = 0; i < 16; ++i)
+      Values[i] = Source.Texels[i][Channel];
+
+    uint8_t Min, Max;
+#if defined(BLOCK_SIMD_SSE2)
+    __m128i Low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Values));
+    __m128i High = Low;
+    Low = _mm_min_epu8(Low, _mm_srli_si128(Low, 8));
+    High = _mm_max_epu8(High, _mm_srli_si128(High, 8));
+    Low = _mm_min_epu8(Low, _mm_srli_si128(Low, 4));
+    High = _mm_max_epu8(High, _mm_srli_si128(High, 4));
+    Low = _mm_min_epu8(Low, _mm_srli_si128(Low, 2));
+    High = _mm_max_epu8(High, _mm_srli_si128(High, 2));
+    Low = _mm_min_epu8(Low, _mm_srli_si128(Low, 1));
+    High = _mm_max_epu8(High, _mm_srli_si128(High, 1));
+    Min = static_cast<uint8_t>(_mm_cvtsi128_si32(Low));
+    Max = static_cast<uint8_t>(_mm_cvtsi128_si32(High));
+#else
+    auto MinMax = std::minmax_element(Values, Values + 16);
+    Min = *MinMax.first;
+    Max = *MinMax.second;
+#endif
+
+    //With the larger end point first the palette runs from it (index 0) over six interpolated values (indices 2 to 7) to the smaller one (index 1).
+    pOut[0] = Max;
+    pOut[1] = Min;
+
+    uint64_t Indices = 0;
+    int Range = Max - Min;
+    if(Range > 0)
+    {
+      for(int i = 0; i < 16; ++i)
+      {
+        int Step = ((Values[i] - Min) * 14 + Range) / (2 * Range);
+        uint64_t Index = Step == 7 ? 0 : Step == 0 ? 1 : 8 - Step;
+        Indices |= Index << (3 * i);
+      }
+    }
+
+    for(int i = 0; i < 6; ++i)
+      pOut[2 + i] = static_cast<uint8_t>(Indices >> (8 * i));
+  }
+
+  struct Bc7Endpoints
+  {
+    int Values[2][4]; //7 bits per channel.
+    int PBits[2];
+    uint8_t Indices[16];
+    int Error = INT_MAX;
+  };
+
+  //The p-bit is the least significant bit of all four channels of an end point, both are tried.
+  void QuantizeEndpoint(const float* pColor, int* pValues, int& PBit)
+  {
+    float BestError = -1.0f;
+    for(int Bit = 0; Bit < 2; ++Bit)
+    {
+      int Values[4];
+      float Error = 0.0f;
+      for(int Channel = 0; Channel < 4; ++Channel)
+      {
+        float Color = std::clamp(pColor[Channel], 0.0f, 255.0f);
+        Values[Channel] = std::clamp(static_cast<int>(std::floor((Color - Bit) * 0.5f + 0.5f)), 0, 127);
+        float Difference = static_cast<float>((Values[Channel] << 1) | Bit) - Color;
+        Error += Difference * Difference;
+      }
+
+      if(BestError < 0.0f || Error < BestError)
+      {
+        BestError = Error;
+        std::copy(Values, Values + 4, pValues);
+        PBit = Bit;
+      }
+    }
+  }
+
+  //The closest of the 16 palette entries for every texel, returns the summed squared error.
+  int FindBc7Indices(const Block& Source, const Bc7Endpoints& Endpoints, uint8_t* pIndices)
+  {
+    alignas(16) int16_t Palette[16][4];
+    for(int i = 0; i < 16; ++i)
+    {
+      for(int Channel = 0; Channel < 4; ++Channel)
+      {
+        int Color0 = (Endpoints.Values[0][Channel] << 1) | Endpoints.PBits[0];
+        int Color1 = (Endpoints.Values[1][Channel] << 1) | Endpoints.PBits[1];
+        Palette[i][Channel] = static_cast<int16_t>(((64 - Bc7Weights[i]) * Color0 + Bc7Weights[i] * Color1 + 32) >> 6);
+      }
+    }
+
+    int TotalError = 0;
+    for(int Texel = 0; Texel < 16; ++Texel)
+    {
+      const uint8_t* pTexel = Source.Texels[Texel];
+
+      alignas(16) int32_t Errors[16];
+#if defined(BLOCK_SIMD_SSE2)
+      //Two entries per register, the squares of the differences are summed in pairs by "_mm_madd_epi16()" and the pairs of four entries are added after a shuffle.
+      __m128i Color = _mm_set_epi16(pTexel[3], pTexel[2], pTexel[1], pTexel[0], pTexel[3], pTexel[2], pTexel[1], pTexel[0]);
+      for(int Group = 0; Group < 4; ++Group)
+      {
+        __m128i DifferenceA = _mm_sub_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(Palette[Group * 4])), Color);
+        __m128i DifferenceB = _mm_sub_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(Palette[Group * 4 + 2])), Color);
+        __m128 SquaresA = _mm_castsi128_ps(_mm_madd_epi16(DifferenceA, DifferenceA));
+        __m128 SquaresB = _mm_castsi128_ps(_mm_madd_epi16(DifferenceB, DifferenceB));
+        __m128i Sum = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(SquaresA, SquaresB, _MM_SHUFFLE(2, 0, 2, 0))), _mm_castps_si128(_mm_shuffle_ps(SquaresA, SquaresB, _MM_SHUFFLE(3, 1, 3, 1))));
+        _mm_store_si128(reinterpret_cast<__m128i*>(Errors + Group * 4), Sum);
+      }
+#else
+      for(int i = 0; i < 16; ++i)
+      {
+        Errors[i] = 0;
+        for(int Channel = 0; Channel < 4; ++Channel)
+          Errors[i] += (Palette[i][Channel] - pTexel[Channel]) * (Palette[i][Channel] - pTexel[Channel]);
+      }
+#endif
+
+      int Best = 0;
+      for(int i = 1; i < 16; ++i)
+      {
+        if(Errors[i] < Errors[Best])
+          Best = i;
+      }
+
+      pIndices[Texel] = static_cast<uint8_t>(Best);
+      TotalError += Errors[Best];
+    }
+
+    return TotalError;
+  }
+
+  Bc7Endpoints EvaluateBc7Endpoints(const Block& Source, const float Colors[2][4])
+  {
+    Bc7Endpoints Endpoints;
+    QuantizeEndpoint(Colors[0], Endpoints.Values[0], Endpoints.PBits[0]);
+    QuantizeEndpoint(Colors[1], Endpoints.Values[1], Endpoints.PBits[1]);
+    Endpoints.Error = FindBc7Indices(Source, Endpoints, Endpoints.Indices);
+    return Endpoints;
+  }
+
+  //The end points that minimize the squared error for the given indices, false if the indices do not determine them.
+  bool FitBc7Endpoints(const Block& Source, const uint8_t* pIndices, float Colors[2][4])
+  {
+    float A = 0.0f, B = 0.0f, C = 0.0f;
+    float X[4] = {}, Y[4] = {};
+    for(int Texel = 0; Texel < 16; ++Texel)
+    {
+      float Weight1 = Bc7Weights[pIndices[Texel]] / 64.0f;
+      float Weight0 = 1.0f - Weight1;
+      A += Weight0 * Weight0;
+      B += Weight0 * Weight1;
+      C += Weight1 * Weight1;
+      for(int Channel = 0; Channel < 4; ++Channel)
+      {
+        X[Channel] += Weight0 * Source.Texels[Texel][Channel];
+        Y[Channel] += Weight1 * Source.Texels[Texel][Channel];
+      }
+    }
+
+    float Determinant = A * C - B * B;
+    if(std::abs(Determinant) < 1e-6f)
+      return false;
+
+    for(int Channel = 0; Channel < 4; ++Channel)
+    {
+      Colors[0][Channel] = (C * X[Channel] - B * Y[Channel]) / Determinant;
+      Colors[1][Channel] = (A * Y[Channel] - B * X[Channel]) / Determinant;
+    }
+
+    return true;
+  }
+
+  //A block into 16 bytes of BC7 mode 6.
+  void EncodeBc7Block(const Block& Source, uint8_t* pOut)
+  {
+    float Mean[4] = {};
+    for(int Texel = 0; Texel < 16; ++Texel)
+    {
+      for(int Channel = 0; Channel < 4; ++Channel)
+        Mean[Channel] += Source.Texels[Texel][Channel] / 16.0f;
+    }
+
+    float Covariance[4][4] = {};
+    for(int Texel = 0; Texel < 16; ++Texel)
+    {
+      float Difference[4];
+      for(int Channel = 0; Channel < 4; ++Channel)
+        Difference[Channel] = Source.Texels[Texel][Channel] - Mean[Channel];
+
+      for(int i = 0; i < 4; ++i)
+      {
+        for(int j = 0; j < 4; ++j)
+          Covariance[i][j] += Difference[i] * Difference[j];
+      }
+    }
+
+    //The principal axis by power iteration, starting from the channel that varies the most.
+    int Largest = 0;
+    for(int Channel = 1; Channel < 4; ++Channel)
+    {
+      if(Covariance[Channel][Channel] > Covariance[Largest][Largest])
+        Largest = Channel;
+    }
+
+    float Axis[4] = {Covariance[Largest][0], Covariance[Largest][1], Covariance[Largest][2], Covariance[Largest][3]};
+    for(int Iteration = 0; Iteration < 8; ++Iteration)
+    {
+      float Next[4] = {};
+      for(int i = 0; i < 4; ++i)
+      {
+        for(int j = 0; j < 4; ++j)
+          Next[i] += Covariance[i][j] * Axis[j];
+      }
+
+      float Length = std::sqrt(Next[0] * Next[0] + Next[1] * Next[1] + Next[2] * Next[2] + Next[3] * Next[3]);
+      for(int i = 0; i < 4; ++i)
+        Axis[i] = Length > 1e-6f ? Next[i] / Length : 0.0f;
+    }
+
+    float Min = 0.0f, Max = 0.0f;
+    for(int Texel = 0; Texel < 16; ++Texel)
+    {
+      float Projection = 0.0f;
+      for(int Channel = 0; Channel < 4; ++Channel)
+        Projection += (Source.Texels[Texel][Channel] - Mean[Channel]) * Axis[Channel];
+
+      Min = std::min(Min, Projection);
+      Max = std::max(Max, Projection);
+    }
+
+    float Colors[2][4];
+    for(int Channel = 0; Channel < 4; ++Channel)
+    {
+      Colors[0][Channel] = Mean[Channel] + Min * Axis[Channel];
+      Colors[1][Channel] = Mean[Channel] + Max * Axis[Channel];
+    }
+
+    Bc7Endpoints Best = EvaluateBc7Endpoints(Source, Colors);
+    for(int Refinement = 0; Refinement < Bc7RefinementNum && Best.Error > 0 && FitBc7Endpoints(Source, Best.Indices, Colors); ++Refinement)
+    {
+      Bc7Endpoints Refined = EvaluateBc7Endpoints(Source, Colors);
+      if(Refined.Error >= Best.Error)
+        break;
+
+      Best = Refined;
+    }
+
+    //The most significant bit of the index of the first texel is implied to be zero, swapping the end points inverts the indices.
+    if(Best.Indices[0] >= 8)
+    {
+      std::swap(Best.Values[0], Best.Values[1]);
+      std::swap(Best.PBits[0], Best.PBits[1]);
+      for(uint8_t& Index : Best.Indices)
+        Index = static_cast<uint8_t>(15 - Index);
+    }
+
+    BlockBits Bits;
+    Bits.Write(1 << 6, 7);
+    for(int Channel = 0; Channel < 4; ++Channel)
+    {
+      Bits.Write(Best.Values[0][Channel], 7);
+      Bits.Write(Best.Values[1][Channel], 7);
+    }
+    Bits.Write(Best.PBits[0], 1);
+    Bits.Write(Best.PBits[1], 1);
+    Bits.Write(Best.Indices[0], 3);
+    for(int Texel = 1; Texel < 16; ++Texel)
+      Bits.Write(Best.Indices[Texel], 4);
+
+    std::memcpy(pOut, Bits.GetData(), 16);
+  }
+}
+
+TEXTURE_ENCODING GetTextureEncoding(MIP_CONTENT Content, uint32_t ChannelNum, bool bBlockCompressed)
+{
+  if(Content == MIP_CONTENT_LINEAR && ChannelNum == 1)
+    return bBlockCompressed ? TEXTURE_ENCODING_BC4 : TEXTURE_ENCODING_R8;
+
+  if(!bBlockCompressed)
+    return Content == MIP_CONTENT_SRGB ? TEXTURE_ENCODING_RGBA8_SRGB : TEXTURE_ENCODING_RGBA8;
+
+  if(Content == MIP_CONTENT_SRGB)
+    return TEXTURE_ENCODING_BC7_SRGB;
+
+  return Content == MIP_CONTENT_NORMAL || ChannelNum == 2 ? TEXTURE_ENCODING_BC5 : TEXTURE_ENCODING_BC7;
+}
+
+bool IsBlockCompressed(TEXTURE_ENCODING Encoding)
+{
+  return Encoding != TEXTURE_ENCODING_R8 && Encoding != TEXTURE_ENCODING_RGBA8 && Encoding != TEXTURE_ENCODING_RGBA8_SRGB;
+}
+
+const char* GetEncodingName(TEXTURE_ENCODING Encoding)
+{
+  switch(Encoding)
+  {
+    case TEXTURE_ENCODING_R8:
+      return "R8";
+    case TEXTURE_ENCODING_BC4:
+      return "BC4";
+    case TEXTURE_ENCODING_BC5:
+      return "BC5";
+    case TEXTURE_ENCODING_BC7:
+      return "BC7";
+    case TEXTURE_ENCODING_BC7_SRGB:
+      return "BC7 sRGB";
+    case TEXTURE_ENCODING_RGBA8_SRGB:
+      return "RGBA8 sRGB";
+    default:
+      return "RGBA8";
+  }
+}
+
+size_t GetEncodedSize(TEXTURE_ENCODING Encoding, uint32_t Width, uint32_t Height)
+{
+  size_t BlockNum = static_cast<size_t>((Width + 3) / 4) * ((Height + 3) / 4);
+
+  switch(Encoding)
+  {
+    case TEXTURE_ENCODING_R8:
+      return static_cast<size_t>(Width) * Height;
+    case TEXTURE_ENCODING_RGBA8:
+    case TEXTURE_ENCODING_RGBA8_SRGB:
+      return static_cast<size_t>(Width) * Height * 4;
+    case TEXTURE_ENCODING_BC4:
+      return BlockNum * 8;
+    case TEXTURE_ENCODING_BC5:
+    case TEXTURE_ENCODING_BC7:
+    case TEXTURE_ENCODING_BC7_SRGB:
+      return BlockNum * 16;
+    default:
+      throw std::runtime_error("Unknown texture encoding!");
+  }
+}
+
+void EncodeTexture(const uint8_t* pPixels, uint32_t Width, uint32_t Height, TEXTURE_ENCODING Encoding, std::vector<uint8_t>& Encoded, uint32_t ThreadNum)
+{
+  Encoded.resize(GetEncodedSize(Encoding, Width, Height));
+
+  if(Encoding == TEXTURE_ENCODING_RGBA8 || Encoding == TEXTURE_ENCODING_RGBA8_SRGB)
+  {
+    std::memcpy(Encoded.data(), pPixels, Encoded.size());
+    return;
+  }
+
+  if(Encoding == TEXTURE_ENCODING_R8)
+  {
+    for(size_t i = 0; i < Encoded.size(); ++i)
+      Encoded[i] = pPixels[i * 4];
+    return;
+  }
+
+  if(ThreadNum == 0)
+    ThreadNum = std::max(std::thread::hardware_concurrency(), 1u);
+
+  uint32_t BlockWidth = (Width + 3) / 4, BlockHeight = (Height + 3) / 4;
+  size_t BlockSize = Encoding == TEXTURE_ENCODING_BC4 ? 8 : 16;
+
+  size_t TaskNum = static_cast<size_t>(BlockWidth) * BlockHeight >= MinParallelBlockNum ? ThreadNum : 1;
+  ParallelFor(BlockHeight, TaskNum, [&](size_t Begin, size_t End)
+  {
+    Block Source;
+    for(size_t BlockY = Begin; BlockY < End; ++BlockY)
+    {
+      for(uint32_t BlockX = 0; BlockX < BlockWidth; ++BlockX)
+      {
+        LoadBlock(pPixels, Width, Height, BlockX, static_cast<uint32_t>(BlockY), Source);
+
+        uint8_t* pOut = Encoded.data() + (BlockY * BlockWidth + BlockX) * BlockSize;
+        if(Encoding == TEXTURE_ENCODING_BC7 || Encoding == TEXTURE_ENCODING_BC7_SRGB)
+          EncodeBc7Block(Source, pOut);
+        else
+        {
+          EncodeBc4Block(Source, 0, pOut);
+          if(Encoding == TEXTURE_ENCODING_BC5)
+            EncodeBc4Block(Source, 1, pOut + 8);
+        }
+      }
+    }
+  });
+}
+
+void EncodeMipChain(MipChain& Chain, TEXTURE_ENCODING Encoding, uint32_t ThreadNum)
+{
+  if(Encoding == TEXTURE_ENCODING_RGBA8 || Encoding == TEXTURE_ENCODING_RGBA8_SRGB)
+    return;
+
+  std::vector<uint8_t> Encoded;
+  for(size_t i = 0; i < Chain.Levels.size(); ++i)
+  {
+    EncodeTexture(Chain.Levels[i].data(), Chain.Widths[i], Chain.Heights[i], Encoding, Encoded, ThreadNum);
+    Chain.Levels[i].swap(Encoded);
+  }
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "MipGenerator.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* The formats textures are stored in, the values are the "VkFormat" of the image (spelled out, so VulkyBake does not depend on
+ * the Vulkan headers). The block compressed ones store 4 x 4 texels per block and are sampled from directly by the GPU. */
+enum TEXTURE_ENCODING
+{
+  TEXTURE_ENCODING_R8 = 9,     //"VK_FORMAT_R8_UNORM", the red channel in 16 bytes per 4 x 4 texels.
+  TEXTURE_ENCODING_RGBA8 = 37,      //"VK_FORMAT_R8G8B8A8_UNORM", 64 bytes per 4 x 4 texels.
+  TEXTURE_ENCODING_RGBA8_SRGB = 43, //"VK_FORMAT_R8G8B8A8_SRGB", RGBA8 decoded to linear by the sampler before filtering.
+  TEXTURE_ENCODING_BC4 = 139,       //"VK_FORMAT_BC4_UNORM_BLOCK", the red channel in 8 bytes.
+  TEXTURE_ENCODING_BC5 = 141,       //"VK_FORMAT_BC5_UNORM_BLOCK", red and green in 16 bytes.
+  TEXTURE_ENCODING_BC7 = 145,       //"VK_FORMAT_BC7_UNORM_BLOCK", RGBA in 16 bytes.
+  TEXTURE_ENCODING_BC7_SRGB = 146   //"VK_FORMAT_BC7_SRGB_BLOCK", BC7 decoded to linear by the sampler.
+};
+
+/* The encoding for textures of the content that use the first "ChannelNum" channels. Block compressed: BC7 for colors and
+ * packed channels, BC5 for the X and Y of normal maps (the shader reconstructs Z) and BC4 for scalar maps. Uncompressed: R8
+ * for scalar maps, RGBA8 for everything else. Colors use the sRGB variants, so the shader reads them linear for free. */
+TEXTURE_ENCODING GetTextureEncoding(MIP_CONTENT Content, uint32_t ChannelNum, bool bBlockCompressed);
+
+//Whether the encoding needs "textureCompressionBC".
+bool IsBlockCompressed(TEXTURE_ENCODING Encoding);
+
+const char* GetEncodingName(TEXTURE_ENCODING Encoding);
+
+//The size of a level, block compressed ones are padded to whole blocks.
+size_t GetEncodedSize(TEXTURE_ENCODING Encoding, uint32_t Width, uint32_t Height);
+
+/* Encode an RGBA8 image, the texels of partial blocks at the right and bottom border are repeated. BC4 and BC5 take the end
+ * points from the range of each block, BC7 uses mode 6 (one subset, 7 bit RGBA end points, 4 bit indices) with end points
+ * on the principal axis of the block, refined by least squares. The rows of blocks are split across "ThreadNum" threads (zero
+ * picks a number based on the hardware), the searches use SSE2 where the compiler targets it. */
+void EncodeTexture(const uint8_t* pPixels, uint32_t Width, uint32_t Height, TEXTURE_ENCODING Encoding, std::vector<uint8_t>& Encoded, uint32_t ThreadNum = 0);
+
+//Encode every level of the chain in place, RGBA8 (sRGB or not) leaves it as it is.
+void EncodeMipChain(MipChain& Chain, TEXTURE_ENCODING Encoding, uint32_t ThreadNum = 0);
+
+NAMESPACE_END
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Camera.hpp"
 
+#include <glm/gtc/matrix_transform.hpp>
+
 #include <algorithm>
 #include <cmath>
 
@@ -93,6 +95,20 @@ void Camera::RetriveData(glm::vec3& Target, glm::vec3& Eye, glm::vec3& Up, glm::
   m_Eye = Eye;
 }
 
+void Camera::RetriveMatrices(float AspectRatio, glm::mat4& View, glm::mat4& Projection)
+{
+  glm::vec3 Eye, Target, Up;
+  float NearZ, FarZ;
+  glm::vec2 Fov;
+
+  RetriveData(Target, Eye, Up, Fov, NearZ, FarZ);
+
+  View = glm::lookAt(Eye, Target, Up);
+  Projection = glm::perspective(Fov.y, AspectRatio, NearZ, FarZ);
+  //GLM was originally designed for OpenGL, where the y-coordinate of the clip coordinates is inverted.
+  Projection[1][1] *= -1.0f;
+}
+
 glm::vec3 Camera::GetCachedTarget() const {return m_Target;}
 
 glm::vec3 Camera::GetCachedUp() const {return m_Up;}
@@ -105,4 +121,37 @@ void Camera::ClampPitch(float& Pitch) const {Pitch = std::clamp(Pitch, glm::radi
 
 void Camera::ClampRadius(float& Radius) const {Radius = std::clamp(Radius, 1e-4f, 50.0f);}
 
+void ExtractFrustumPlanes(const glm::mat4& Matrix, std::array<glm::vec4, 6>& Planes)
+{
+  //GLM matrices are column-major, so the rows have to be gathered.
+  glm::vec4 Rows[4];
+  for(int i = 0; i < 4; ++i)
+    Rows[i] = glm::vec4(Matrix[0][i], Matrix[1][i], Matrix[2][i], Matrix[3][i]);
+
+  Planes[0] = Rows[3] + Rows[0]; //Left
+  Planes[1] = Rows[3] - Rows[0]; //Right
+  Planes[2] = Rows[3] + Rows[1]; //Bottom
+  Planes[3] = Rows[3] - Rows[1]; //Top
+  Planes[4] = Rows[2]; //Near
+  Planes[5] = Rows[3] - Rows[2]; //Far
+
+  for(auto& Plane : Planes)
+  {
+    float Length = glm::length(glm::vec3(Plane));
+    if(Length > 0.0f)
+      Plane /= Length;
+  }
+}
+
+bool IsSphereInFrustum(const std::array<glm::vec4, 6>& Planes, const glm::vec4& Sphere)
+{
+  for(const auto& Plane : Planes)
+  {
+    if(glm::dot(glm::vec3(Plane), glm::vec3(Sphere)) + Plane.w < -Sphere.w)
+      return false;
+  }
+
+  return true;
+}
+
 NAMESPACE_END
\ No newline at end of file
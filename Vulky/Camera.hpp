@@ -1,10 +1,16 @@
 #pragma once
 
+//Vulkan uses a depth range of 0.0 to 1.0, see "App.hpp".
+#ifndef GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#endif
 #ifndef GLM_FORCE_RADIANS
 #define GLM_FORCE_RADIANS
 #endif
 #include <glm/glm.hpp>
 
+#include <array>
+
 #include "Namespace.hpp"
 
 constexpr auto WINDOW_INIT_WIDTH = 1280;
@@ -24,6 +30,8 @@ class Camera
   void SetFov(float FovX);
   void SetResolution(float Width, float Height);
   void RetriveData(glm::vec3& Target, glm::vec3& Eye, glm::vec3& Up, glm::vec2& Fov, float& NearZ, float& FarZ);
+  //View and projection matrices in Vulkan clip space.
+  void RetriveMatrices(float AspectRatio, glm::mat4& View, glm::mat4& Projection);
 
   glm::vec3 GetCachedTarget() const;
   glm::vec3 GetCachedUp() const;
@@ -57,4 +65,12 @@ class Camera
   glm::vec3 m_Up = glm::vec3(0.0f, 0.0f, 0.0f);
 };
 
+/* The six planes of the view frustum of a (model-)view-projection matrix for the depth range of 0 to 1 (Gribb and Hartmann,
+ * "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"), in the space the matrix transforms
+ * from. The normals point inwards and are normalized, so "dot(Plane, vec4(Point, 1))" is the distance to the plane. */
+void ExtractFrustumPlanes(const glm::mat4& Matrix, std::array<glm::vec4, 6>& Planes);
+
+//Whether a sphere (center and radius) is at least partially inside the frustum.
+bool IsSphereInFrustum(const std::array<glm::vec4, 6>& Planes, const glm::vec4& Sphere);
+
 NAMESPACE_END
\ No newline at end of file
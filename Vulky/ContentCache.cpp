@@ -0,0 +1,92 @@
+#include "ContentCache.hpp"
+
+#include <cstring>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  const uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+  const uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+  const uint64_t Prime3 = 0x165667B19E3779F9ull;
+  const uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+  const uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+  uint64_t RotateLeft(uint64_t Value, int Count) {return (Value << Count) | (Value >> (64 - Count));}
+
+  uint64_t Read64(const uint8_t* pData)
+  {
+    uint64_t Value;
+    std::memcpy(&Value, pData, sizeof(Value));
+    return Value;
+  }
+
+  uint32_t Read32(const uint8_t* pData)
+  {
+    uint32_t Value;
+    std::memcpy(&Value, pData, sizeof(Value));
+    return Value;
+  }
+
+  uint64_t Round(uint64_t Accumulator, uint64_t Input)
+  {
+    Accumulator += Input * Prime2;
+    return RotateLeft(Accumulator, 31) * Prime1;
+  }
+
+  uint64_t MergeRound(uint64_t Accumulator, uint64_t Value)
+  {
+    Accumulator ^= Round(0, Value);
+    return Accumulator * Prime1 + Prime4;
+  }
+}
+
+uint64_t HashContent(const void* pData, size_t Size, uint64_t Seed)
+{
+  const uint8_t* pByte = static_cast<const uint8_t*>(pData);
+  const uint8_t* pEnd = pByte + Size;
+  uint64_t Hash;
+
+  //Four independent lanes of 8 bytes each, so the multiplications of a stripe overlap.
+  if(Size >= 32)
+  {
+    uint64_t Lanes[4] = {Seed + Prime1 + Prime2, Seed + Prime2, Seed, Seed - Prime1};
+    for(; pByte + 32 <= pEnd; pByte += 32)
+    {
+      for(int Lane = 0; Lane < 4; ++Lane)
+        Lanes[Lane] = Round(Lanes[Lane], Read64(pByte + 8 * Lane));
+    }
+
+    Hash = RotateLeft(Lanes[0], 1) + RotateLeft(Lanes[1], 7) + RotateLeft(Lanes[2], 12) + RotateLeft(Lanes[3], 18);
+    for(int Lane = 0; Lane < 4; ++Lane)
+      Hash = MergeRound(Hash, Lanes[Lane]);
+  }
+  else
+    Hash = Seed + Prime5;
+
+  Hash += static_cast<uint64_t>(Size);
+
+  for(; pByte + 8 <= pEnd; pByte += 8)
+    Hash = RotateLeft(Hash ^ Round(0, Read64(pByte)), 27) * Prime1 + Prime4;
+  if(pByte + 4 <= pEnd)
+  {
+    Hash = RotateLeft(Hash ^ (Read32(pByte) * Prime1), 23) * Prime2 + Prime3;
+    pByte += 4;
+  }
+  for(; pByte < pEnd; ++pByte)
+    Hash = RotateLeft(Hash ^ (*pByte * Prime5), 11) * Prime1;
+
+  Hash ^= Hash >> 33;
+  Hash *= Prime2;
+  Hash ^= Hash >> 29;
+  Hash *= Prime3;
+  Hash ^= Hash >> 32;
+  return Hash;
+}
+
+uint64_t HashCombine(uint64_t Hash, uint64_t Value)
+{
+  return MergeRound(Hash, Value);
+}
+
+NAMESPACE_END
\ No newline at end of file
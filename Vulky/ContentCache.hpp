@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//A 64 bit hash of the bytes, xxHash64 (several GB/s, fast enough to key whole files by their content).
+uint64_t HashContent(const void* pData, size_t Size, uint64_t Seed = 0);
+
+//Mix a value (e.g. a parameter the content was processed with) into a hash.
+uint64_t HashCombine(uint64_t Hash, uint64_t Value);
+
+/* Values shared by content, e.g. everything decoded from the same bytes with the same parameters. The key is computed by the
+ * caller, usually "HashContent()" of the bytes combined with the parameters. The cache only holds weak references: the handles
+ * count the references to a value, it lives as long as one of them and can be found again until then. Can be used from any
+ * thread, a value is released on the thread that drops its last handle. */
+template <typename T>
+class ContentCache
+{
+  public:
+  //A handle to the value of the key, null if there is none.
+  std::shared_ptr<T> Find(uint64_t Key)
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    auto Iterator = m_Values.find(Key);
+    std::shared_ptr<T> Value = Iterator != m_Values.end() ? Iterator->second.lock() : nullptr;
+    ++(Value != nullptr ? m_HitNum : m_MissNum);
+    return Value;
+  }
+
+  //Share the value under the key. If a value that is still alive was added for the key first, that one is returned instead.
+  std::shared_ptr<T> Add(uint64_t Key, std::shared_ptr<T> Value)
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    if(std::shared_ptr<T> Existing = m_Values[Key].lock())
+      return Existing;
+
+    m_Values[Key] = Value;
+
+    //The entries of released values are only cleaned up here, lookups never pay for it.
+    for(auto Iterator = m_Values.begin(); Iterator != m_Values.end();)
+    {
+      if(Iterator->second.expired())
+        Iterator = m_Values.erase(Iterator);
+      else
+        ++Iterator;
+    }
+
+    return Value;
+  }
+
+  //The values that are alive.
+  size_t GetValueNum() const
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    size_t ValueNum = 0;
+    for(const auto& Entry : m_Values)
+      ValueNum += Entry.second.expired() ? 0 : 1;
+    return ValueNum;
+  }
+
+  //The lookups that found a value and those that did not.
+  uint32_t GetHitNum() const
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    return m_HitNum;
+  }
+
+  uint32_t GetMissNum() const
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    return m_MissNum;
+  }
+
+  protected:
+  mutable std::mutex m_Mutex;
+  std::unordered_map<uint64_t, std::weak_ptr<T>> m_Values;
+  uint32_t m_HitNum = 0;
+  uint32_t m_MissNum = 0;
+};
+
+NAMESPACE_END
\ No newline at end of file
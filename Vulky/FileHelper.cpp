@@ -0,0 +1,23 @@
+#include "FileHelper.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+std::vector<char> ReadFile(const std::string& Filename)
+{
+  std::ifstream File(Filename, std::ios::ate | std::ios::binary);
+  if(!File.is_open())
+    throw std::runtime_error("Failed to open file!");
+
+  size_t FileSize = static_cast<size_t>(File.tellg());
+  std::vector<char> Buffer(FileSize);
+  File.seekg(0);
+  File.read(Buffer.data(), Buffer.size());
+  File.close();
+
+  return Buffer;
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//Read a whole binary file into memory.
+std::vector<char> ReadFile(const std::string& Filename);
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "FileWatcher.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //How long the watcher thread waits for notifications at once, also the latency of stopping it.
+  const int WaitTime = 50;
+
+  //A file has to keep its write time this long before it is reported.
+  const std::chrono::milliseconds SettleTime(100);
+
+  std::filesystem::file_time_type GetWriteTime(const std::string& Path, bool& bExists)
+  {
+    std::error_code Error;
+    auto WriteTime = std::filesystem::last_write_time(Path, Error);
+    bExists = !Error;
+    return WriteTime;
+  }
+}
+
+FileWatcher::~FileWatcher()
+{
+  Stop();
+}
+
+void FileWatcher::Start(const std::vector<std::string>& Paths)
+{
+  Stop();
+
+  m_Files.clear();
+  m_Directories.clear();
+
+  for(const auto& Path : Paths)
+  {
+    std::string Directory = std::filesystem::path(Path).parent_path().string();
+    if(Directory.empty())
+      Directory = ".";
+
+    WatchedFile File;
+    File.Path = Path;
+    File.Directory = std::find(m_Directories.begin(), m_Directories.end(), Directory) - m_Directories.begin();
+    if(File.Directory == m_Directories.size())
+      m_Directories.push_back(Directory);
+
+    bool bExists = false;
+    File.WriteTime = GetWriteTime(Path, bExists);
+    m_Files.push_back(File);
+  }
+
+#ifdef _WIN32
+  for(const auto& Directory : m_Directories)
+  {
+    HANDLE hNotification = FindFirstChangeNotificationA(Directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    m_hNotifications.push_back(hNotification != INVALID_HANDLE_VALUE ? hNotification : nullptr);
+  }
+#else
+  m_InotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if(m_InotifyDescriptor < 0)
+    throw std::runtime_error("Failed to initialize inotify!");
+
+  for(const auto& Directory : m_Directories)
+    m_WatchDescriptors.push_back(inotify_add_watch(m_InotifyDescriptor, Directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO));
+#endif
+
+  m_bStopping = false;
+  m_Thread = std::thread(&FileWatcher::WatcherMain, this);
+}
+
+void FileWatcher::Stop()
+{
+  if(m_Thread.joinable())
+  {
+    m_bStopping = true;
+    m_Thread.join();
+  }
+
+#ifdef _WIN32
+  for(void* hNotification : m_hNotifications)
+  {
+    if(hNotification != nullptr)
+      FindCloseChangeNotification(hNotification);
+  }
+  m_hNotifications.clear();
+#else
+  if(m_InotifyDescriptor >= 0)
+    close(m_InotifyDescriptor);
+  m_InotifyDescriptor = -1;
+  m_WatchDescriptors.clear();
+#endif
+}
+
+void FileWatcher::PollChanges(std::vector<std::string>& ChangedPaths)
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  ChangedPaths.swap(m_ChangedPaths);
+  m_ChangedPaths.clear();
+  m_bHasChanges.store(false, std::memory_order_relaxed);
+}
+
+void FileWatcher::WatcherMain()
+{
+  while(!m_bStopping)
+  {
+#ifdef _WIN32
+    //Directories that could not be watched have no handle, they are never checked.
+    std::vector<HANDLE> Handles;
+    std::vector<size_t> HandleDirectories;
+    for(size_t i = 0; i < m_hNotifications.size() && Handles.size() < MAXIMUM_WAIT_OBJECTS; ++i)
+    {
+      if(m_hNotifications[i] == nullptr)
+        continue;
+
+      Handles.push_back(m_hNotifications[i]);
+      HandleDirectories.push_back(i);
+    }
+
+    DWORD Result = Handles.empty() ? WAIT_TIMEOUT : WaitForMultipleObjects(static_cast<DWORD>(Handles.size()), Handles.data(), FALSE, WaitTime);
+    if(Handles.empty())
+      Sleep(WaitTime);
+
+    if(Result >= WAIT_OBJECT_0 && Result < WAIT_OBJECT_0 + Handles.size())
+    {
+      size_t Signaled = Result - WAIT_OBJECT_0;
+      CheckDirectory(HandleDirectories[Signaled]);
+      FindNextChangeNotification(Handles[Signaled]);
+    }
+#else
+    pollfd Descriptor = {};
+    Descriptor.fd = m_InotifyDescriptor;
+    Descriptor.events = POLLIN;
+
+    if(poll(&Descriptor, 1, WaitTime) > 0 && (Descriptor.revents & POLLIN))
+    {
+      //Every event names the directory by its watch descriptor, the file names are not needed as all watched files are compared anyway.
+      alignas(inotify_event) char Buffer[4096];
+      std::vector<bool> bDirectoryChanged(m_Directories.size(), false);
+
+      ssize_t Length;
+      while((Length = read(m_InotifyDescriptor, Buffer, sizeof(Buffer))) > 0)
+      {
+        for(ssize_t Offset = 0; Offset < Length;)
+        {
+          const auto* pEvent = reinterpret_cast<const inotify_event*>(Buffer + Offset);
+          auto Iterator = std::find(m_WatchDescriptors.begin(), m_WatchDescriptors.end(), pEvent->wd);
+          if(Iterator != m_WatchDescriptors.end())
+            bDirectoryChanged[Iterator - m_WatchDescriptors.begin()] = true;
+
+          Offset += sizeof(inotify_event) + pEvent->len;
+        }
+      }
+
+      for(size_t i = 0; i < bDirectoryChanged.size(); ++i)
+      {
+        if(bDirectoryChanged[i])
+          CheckDirectory(i);
+      }
+    }
+#endif
+
+    ReportSettledFiles();
+  }
+}
+
+void FileWatcher::CheckDirectory(size_t Directory)
+{
+  for(auto& File : m_Files)
+  {
+    if(File.Directory != Directory)
+      continue;
+
+    //A file that is missing for the moment is most likely being replaced, it is checked again with the next notification.
+    bool bExists = false;
+    auto WriteTime = GetWriteTime(File.Path, bExists);
+    if(!bExists || WriteTime == File.WriteTime)
+      continue;
+
+    File.WriteTime = WriteTime;
+    File.bChanged = true;
+    File.ChangeTime = std::chrono::steady_clock::now();
+  }
+}
+
+void FileWatcher::ReportSettledFiles()
+{
+  auto Now = std::chrono::steady_clock::now();
+
+  for(auto& File : m_Files)
+  {
+    if(!File.bChanged)
+      continue;
+
+    //Writers that keep the file open may not send another notification, so the write time is compared once more before reporting.
+    bool bExists = false;
+    auto WriteTime = GetWriteTime(File.Path, bExists);
+    if(bExists && WriteTime != File.WriteTime)
+    {
+      File.WriteTime = WriteTime;
+      File.ChangeTime = Now;
+      continue;
+    }
+
+    if(!bExists || Now - File.ChangeTime < SettleTime)
+      continue;
+
+    File.bChanged = false;
+
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    if(std::find(m_ChangedPaths.begin(), m_ChangedPaths.end(), File.Path) == m_ChangedPaths.end())
+      m_ChangedPaths.push_back(File.Path);
+    m_bHasChanges.store(true, std::memory_order_relaxed);
+  }
+}
+
+NAMESPACE_END
\ No newline at end of file
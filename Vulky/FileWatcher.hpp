@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* Watches a set of files for changes on a thread of its own. The directories of the files are watched (with inotify on Linux
+ * and change notifications on Windows) rather than the files themselves, so files that editors and compilers replace by
+ * renaming a new one over them are still caught. A file is only reported once its write time has stopped changing for a
+ * moment, a file that is still being written is never picked up half-way. */
+class FileWatcher
+{
+  public:
+  FileWatcher() = default;
+
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher&) = delete;
+
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  void Start(const std::vector<std::string>& Paths);
+
+  void Stop();
+
+  bool HasChanges() const {return m_bHasChanges.load(std::memory_order_relaxed);}
+
+  //Take the paths (exactly as they were passed to "Start()") that changed since the last call.
+  void PollChanges(std::vector<std::string>& ChangedPaths);
+
+  protected:
+  struct WatchedFile
+  {
+    std::string Path;
+    size_t Directory = 0;
+    std::filesystem::file_time_type WriteTime;
+    bool bChanged = false;
+    std::chrono::steady_clock::time_point ChangeTime;
+  };
+
+  void WatcherMain();
+
+  //Compare the write times of the files in the directory with the ones seen last.
+  void CheckDirectory(size_t Directory);
+
+  //Report the files that have not changed again for a while.
+  void ReportSettledFiles();
+
+  std::vector<WatchedFile> m_Files;
+  std::vector<std::string> m_Directories;
+
+  std::thread m_Thread;
+  std::atomic<bool> m_bStopping{false};
+  std::atomic<bool> m_bHasChanges{false};
+  std::mutex m_Mutex;
+  std::vector<std::string> m_ChangedPaths;
+
+#ifdef _WIN32
+  std::vector<void*> m_hNotifications;
+#else
+  int m_InotifyDescriptor = -1;
+  std::vector<int> m_WatchDescriptors;
+#endif
+};
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,957 @@
+#include "GltfLoader.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  const uint32_t GlbMagic = 0x46546C67; //"glTF"
+  const uint32_t GlbVersion = 2;
+  const uint32_t GlbJsonChunk = 0x4E4F534A; //"JSON"
+  const uint32_t GlbBinaryChunk = 0x004E4942; //"BIN"
+  const size_t GlbHeaderSize = 12;
+  const size_t GlbChunkHeaderSize = 8;
+
+  const uint32_t ComponentTypeByte = 5120;
+  const uint32_t ComponentTypeUnsignedByte = 5121;
+  const uint32_t ComponentTypeShort = 5122;
+  const uint32_t ComponentTypeUnsignedShort = 5123;
+  const uint32_t ComponentTypeUnsignedInt = 5125;
+  const uint32_t ComponentTypeFloat = 5126;
+
+  const uint32_t PrimitiveModeTriangles = 4;
+
+  //Deeper nesting than any glTF file needs, it only protects the recursive parser against malicious files.
+  const int MaxJsonDepth = 64;
+
+  template<typename T>
+  T Load(const uint8_t* pData)
+  {
+    T Value;
+    std::memcpy(&Value, pData, sizeof(Value));
+    return Value;
+  }
+
+  //A parsed JSON value. Members are kept in a vector, glTF objects are small enough for a linear search.
+  struct JsonValue
+  {
+    enum TYPE
+    {
+      TYPE_NULL = 0,
+      TYPE_BOOL,
+      TYPE_NUMBER,
+      TYPE_STRING,
+      TYPE_ARRAY,
+      TYPE_OBJECT
+    };
+
+    TYPE Type = TYPE_NULL;
+    bool bBool = false;
+    double Number = 0.0;
+    std::string String;
+    std::vector<JsonValue> Elements;
+    std::vector<std::pair<std::string, JsonValue>> Members;
+
+    const JsonValue* Find(const char* pKey) const
+    {
+      for(const auto& Member : Members)
+      {
+        if(Member.first == pKey)
+          return &Member.second;
+      }
+
+      return nullptr;
+    }
+
+    //The elements of an array member, a missing member is an empty array.
+    const std::vector<JsonValue>& GetArray(const char* pKey) const
+    {
+      static const std::vector<JsonValue> Empty;
+      const JsonValue* pValue = Find(pKey);
+      return pValue && pValue->Type == TYPE_ARRAY ? pValue->Elements : Empty;
+    }
+
+    double GetNumber(const char* pKey, double Default) const
+    {
+      const JsonValue* pValue = Find(pKey);
+      return pValue && pValue->Type == TYPE_NUMBER ? pValue->Number : Default;
+    }
+
+    bool GetBool(const char* pKey, bool bDefault) const
+    {
+      const JsonValue* pValue = Find(pKey);
+      return pValue && pValue->Type == TYPE_BOOL ? pValue->bBool : bDefault;
+    }
+
+    std::string GetString(const char* pKey) const
+    {
+      const JsonValue* pValue = Find(pKey);
+      return pValue && pValue->Type == TYPE_STRING ? pValue->String : std::string();
+    }
+
+    //A non-negative integer member, like a byte offset or a count.
+    size_t GetSize(const char* pKey, size_t Default) const
+    {
+      const JsonValue* pValue = Find(pKey);
+      if(!pValue)
+        return Default;
+
+      if(pValue->Type != TYPE_NUMBER || pValue->Number < 0.0 || pValue->Number > 9007199254740992.0 || pValue->Number != static_cast<double>(static_cast<uint64_t>(pValue->Number)))
+        throw std::runtime_error("Invalid glTF number!");
+
+      return static_cast<size_t>(pValue->Number);
+    }
+
+    //The index of another glTF object, or -1 if there is none.
+    int32_t GetIndex(const char* pKey) const
+    {
+      const JsonValue* pValue = Find(pKey);
+      if(!pValue)
+        return -1;
+
+      if(pValue->Type != TYPE_NUMBER || pValue->Number < 0.0 || pValue->Number > 2147483647.0)
+        throw std::runtime_error("Invalid glTF index!");
+
+      return static_cast<int32_t>(pValue->Number);
+    }
+  };
+
+  class JsonParser
+  {
+    public:
+    JsonParser(const char* pBegin, const char* pEnd) : m_pCursor(pBegin), m_pEnd(pEnd) {}
+
+    JsonValue Parse()
+    {
+      JsonValue Value;
+      ParseValue(Value, 0);
+
+      SkipWhitespace();
+      //The JSON chunk is padded with spaces, some exporters pad with zeros instead.
+      while(m_pCursor < m_pEnd && *m_pCursor == '\0')
+        ++m_pCursor;
+
+      if(m_pCursor != m_pEnd)
+        Fail();
+
+      return Value;
+    }
+
+    protected:
+    [[noreturn]] void Fail() const {throw std::runtime_error("Invalid glTF JSON!");}
+
+    void SkipWhitespace()
+    {
+      while(m_pCursor < m_pEnd && (*m_pCursor == ' ' || *m_pCursor == '\t' || *m_pCursor == '\n' || *m_pCursor == '\r'))
+        ++m_pCursor;
+    }
+
+    bool Consume(char Character)
+    {
+      SkipWhitespace();
+      if(m_pCursor < m_pEnd && *m_pCursor == Character)
+      {
+        ++m_pCursor;
+        return true;
+      }
+
+      return false;
+    }
+
+    void Expect(const char* pLiteral)
+    {
+      for(; *pLiteral; ++pLiteral, ++m_pCursor)
+      {
+        if(m_pCursor == m_pEnd || *m_pCursor != *pLiteral)
+          Fail();
+      }
+    }
+
+    void ParseValue(JsonValue& Value, int Depth)
+    {
+      if(Depth > MaxJsonDepth)
+        Fail();
+
+      SkipWhitespace();
+      if(m_pCursor == m_pEnd)
+        Fail();
+
+      switch(*m_pCursor)
+      {
+        case '{':
+          ++m_pCursor;
+          Value.Type = JsonValue::TYPE_OBJECT;
+          if(Consume('}'))
+            break;
+
+          do
+          {
+            SkipWhitespace();
+            Value.Members.emplace_back();
+            ParseString(Value.Members.back().first);
+            if(!Consume(':'))
+              Fail();
+
+            ParseValue(Value.Members.back().second, Depth + 1);
+          } while(Consume(','));
+
+          if(!Consume('}'))
+            Fail();
+          break;
+
+        case '[':
+          ++m_pCursor;
+          Value.Type = JsonValue::TYPE_ARRAY;
+          if(Consume(']'))
+            break;
+
+          do
+          {
+            Value.Elements.emplace_back();
+            ParseValue(Value.Elements.back(), Depth + 1);
+          } while(Consume(','));
+
+          if(!Consume(']'))
+            Fail();
+          break;
+
+        case '"':
+          Value.Type = JsonValue::TYPE_STRING;
+          ParseString(Value.String);
+          break;
+
+        case 't':
+          Expect("true");
+          Value.Type = JsonValue::TYPE_BOOL;
+          Value.bBool = true;
+          break;
+
+        case 'f':
+          Expect("false");
+          Value.Type = JsonValue::TYPE_BOOL;
+          break;
+
+        case 'n':
+          Expect("null");
+          break;
+
+        default:
+          Value.Type = JsonValue::TYPE_NUMBER;
+          Value.Number = ParseNumber();
+          break;
+      }
+    }
+
+    double ParseNumber()
+    {
+      //Copied out first, because "strtod()" needs a terminated string and the chunk is not one.
+      char Buffer[64];
+      size_t Length = 0;
+      while(m_pCursor < m_pEnd && (std::isdigit(static_cast<unsigned char>(*m_pCursor)) || *m_pCursor == '-' || *m_pCursor == '+' || *m_pCursor == '.' || *m_pCursor == 'e' || *m_pCursor == 'E'))
+      {
+        if(Length + 1 == sizeof(Buffer))
+          Fail();
+
+        Buffer[Length++] = *m_pCursor++;
+      }
+
+      Buffer[Length] = '\0';
+      char* pEnd = nullptr;
+      double Number = std::strtod(Buffer, &pEnd);
+      if(Length == 0 || pEnd != Buffer + Length)
+        Fail();
+
+      return Number;
+    }
+
+    uint32_t ParseHexQuad()
+    {
+      uint32_t Value = 0;
+      for(int i = 0; i < 4; ++i, ++m_pCursor)
+      {
+        if(m_pCursor == m_pEnd || !std::isxdigit(static_cast<unsigned char>(*m_pCursor)))
+          Fail();
+
+        char Digit = static_cast<char>(std::tolower(static_cast<unsigned char>(*m_pCursor)));
+        Value = Value * 16 + static_cast<uint32_t>(Digit <= '9' ? Digit - '0' : Digit - 'a' + 10);
+      }
+
+      return Value;
+    }
+
+    void AppendUtf8(std::string& String, uint32_t CodePoint)
+    {
+      if(CodePoint < 0x80)
+        String += static_cast<char>(CodePoint);
+      else if(CodePoint < 0x800)
+      {
+        String += static_cast<char>(0xC0 | (CodePoint >> 6));
+        String += static_cast<char>(0x80 | (CodePoint & 0x3F));
+      }
+      else if(CodePoint < 0x10000)
+      {
+        String += static_cast<char>(0xE0 | (CodePoint >> 12));
+        String += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+        String += static_cast<char>(0x80 | (CodePoint & 0x3F));
+      }
+      else
+      {
+        String += static_cast<char>(0xF0 | (CodePoint >> 18));
+        String += static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F));
+        String += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+        String += static_cast<char>(0x80 | (CodePoint & 0x3F));
+      }
+    }
+
+    void ParseString(std::string& String)
+    {
+      if(m_pCursor == m_pEnd || *m_pCursor != '"')
+        Fail();
+
+      for(++m_pCursor; ; )
+      {
+        if(m_pCursor == m_pEnd)
+          Fail();
+
+        char Character = *m_pCursor++;
+        if(Character == '"')
+          return;
+
+        if(Character != '\\')
+        {
+          String += Character;
+          continue;
+        }
+
+        if(m_pCursor == m_pEnd)
+          Fail();
+
+        switch(*m_pCursor++)
+        {
+          case '"': String += '"'; break;
+          case '\\': String += '\\'; break;
+          case '/': String += '/'; break;
+          case 'b': String += '\b'; break;
+          case 'f': String += '\f'; break;
+          case 'n': String += '\n'; break;
+          case 'r': String += '\r'; break;
+          case 't': String += '\t'; break;
+          case 'u':
+          {
+            uint32_t CodePoint = ParseHexQuad();
+            //A high surrogate followed by a low one encodes a code point above the basic multilingual plane.
+            if(CodePoint >= 0xD800 && CodePoint < 0xDC00 && m_pEnd - m_pCursor >= 6 && m_pCursor[0] == '\\' && m_pCursor[1] == 'u')
+            {
+              m_pCursor += 2;
+              uint32_t LowSurrogate = ParseHexQuad();
+              if(LowSurrogate < 0xDC00 || LowSurrogate >= 0xE000)
+                Fail();
+
+              CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+            }
+
+            AppendUtf8(String, CodePoint);
+            break;
+          }
+          default:
+            Fail();
+        }
+      }
+    }
+
+    const char* m_pCursor;
+    const char* m_pEnd;
+  };
+
+  uint32_t GetComponentSize(uint32_t ComponentType)
+  {
+    switch(ComponentType)
+    {
+      case ComponentTypeByte:
+      case ComponentTypeUnsignedByte: return 1;
+      case ComponentTypeShort:
+      case ComponentTypeUnsignedShort: return 2;
+      case ComponentTypeUnsignedInt:
+      case ComponentTypeFloat: return 4;
+      default: return 0;
+    }
+  }
+
+  uint32_t GetComponentNum(const std::string& Type)
+  {
+    if(Type == "SCALAR")
+      return 1;
+    if(Type == "VEC2")
+      return 2;
+    if(Type == "VEC3")
+      return 3;
+    if(Type == "VEC4" || Type == "MAT2")
+      return 4;
+    if(Type == "MAT3")
+      return 9;
+    if(Type == "MAT4")
+      return 16;
+    return 0;
+  }
+
+  //Normalized integers are mapped to [0, 1] or [-1, 1] like the "_UNORM" and "_SNORM" Vulkan formats.
+  float ReadComponent(const uint8_t* pData, uint32_t ComponentType, bool bNormalized)
+  {
+    switch(ComponentType)
+    {
+      case ComponentTypeFloat:
+        return Load<float>(pData);
+      case ComponentTypeByte:
+      {
+        float Value = static_cast<float>(Load<int8_t>(pData));
+        return bNormalized ? std::max(Value / 127.0f, -1.0f) : Value;
+      }
+      case ComponentTypeUnsignedByte:
+      {
+        float Value = static_cast<float>(Load<uint8_t>(pData));
+        return bNormalized ? Value / 255.0f : Value;
+      }
+      case ComponentTypeShort:
+      {
+        float Value = static_cast<float>(Load<int16_t>(pData));
+        return bNormalized ? std::max(Value / 32767.0f, -1.0f) : Value;
+      }
+      case ComponentTypeUnsignedShort:
+      {
+        float Value = static_cast<float>(Load<uint16_t>(pData));
+        return bNormalized ? Value / 65535.0f : Value;
+      }
+      default:
+        return static_cast<float>(Load<uint32_t>(pData));
+    }
+  }
+
+  float GetElement(const std::vector<JsonValue>& Array, size_t Index, float Default)
+  {
+    return Index < Array.size() && Array[Index].Type == JsonValue::TYPE_NUMBER ? static_cast<float>(Array[Index].Number) : Default;
+  }
+
+  //Either a column-major matrix, like glm's, or translation, rotation and scale.
+  glm::mat4 GetLocalTransform(const JsonValue& Node)
+  {
+    const auto& Matrix = Node.GetArray("matrix");
+    if(Matrix.size() == 16)
+    {
+      glm::mat4 Transform;
+      for(glm::length_t i = 0; i < 16; ++i)
+        Transform[i / 4][i % 4] = GetElement(Matrix, i, 0.0f);
+      return Transform;
+    }
+
+    const auto& Translation = Node.GetArray("translation");
+    const auto& Rotation = Node.GetArray("rotation");
+    const auto& Scale = Node.GetArray("scale");
+
+    glm::vec3 T = glm::vec3(GetElement(Translation, 0, 0.0f), GetElement(Translation, 1, 0.0f), GetElement(Translation, 2, 0.0f));
+    //glTF stores quaternions as x, y, z, w.
+    glm::quat R = glm::quat(GetElement(Rotation, 3, 1.0f), GetElement(Rotation, 0, 0.0f), GetElement(Rotation, 1, 0.0f), GetElement(Rotation, 2, 0.0f));
+    glm::vec3 S = glm::vec3(GetElement(Scale, 0, 1.0f), GetElement(Scale, 1, 1.0f), GetElement(Scale, 2, 1.0f));
+
+    return glm::translate(glm::mat4(1.0f), T) * glm::mat4_cast(R) * glm::scale(glm::mat4(1.0f), S);
+  }
+
+  //A byte range of the binary chunk.
+  struct BufferView
+  {
+    const uint8_t* pData;
+    size_t Length;
+    size_t Stride;
+  };
+}
+
+glm::vec4 GltfFile::Accessor::Read(size_t Index, const glm::vec4& Default) const
+{
+  glm::vec4 Value = Default;
+  uint32_t ComponentSize = GetComponentSize(ComponentType);
+  for(glm::length_t i = 0; i < static_cast<glm::length_t>(std::min(ComponentNum, 4u)); ++i)
+    Value[i] = pData ? ReadComponent(pData + Index * Stride + i * ComponentSize, ComponentType, bNormalized) : 0.0f;
+
+  return Value;
+}
+
+void GltfFile::Open(const std::string& Path, Scene& Result)
+{
+  Close();
+  Result.Clear();
+
+  m_File.Open(Path);
+  const uint8_t* pFile = reinterpret_cast<const uint8_t*>(m_File.GetData());
+  size_t FileSize = m_File.GetSize();
+
+  //The header is followed by the JSON chunk and an optional binary chunk, every chunk starts with its length and type.
+  if(FileSize < GlbHeaderSize + GlbChunkHeaderSize || Load<uint32_t>(pFile) != GlbMagic || Load<uint32_t>(pFile + 4) != GlbVersion)
+    throw std::runtime_error("Invalid GLB file!");
+
+  FileSize = std::min<size_t>(FileSize, Load<uint32_t>(pFile + 8));
+
+  size_t JsonLength = Load<uint32_t>(pFile + GlbHeaderSize);
+  if(Load<uint32_t>(pFile + GlbHeaderSize + 4) != GlbJsonChunk || JsonLength > FileSize - GlbHeaderSize - GlbChunkHeaderSize)
+    throw std::runtime_error("Invalid GLB file!");
+
+  const char* pJson = m_File.GetData() + GlbHeaderSize + GlbChunkHeaderSize;
+
+  const uint8_t* pBinary = nullptr;
+  size_t BinaryLength = 0;
+  size_t BinaryChunk = GlbHeaderSize + GlbChunkHeaderSize + JsonLength;
+  if(BinaryChunk <= FileSize - GlbChunkHeaderSize && Load<uint32_t>(pFile + BinaryChunk + 4) == GlbBinaryChunk)
+  {
+    BinaryLength = Load<uint32_t>(pFile + BinaryChunk);
+    if(BinaryLength > FileSize - BinaryChunk - GlbChunkHeaderSize)
+      throw std::runtime_error("Invalid GLB file!");
+
+    pBinary = pFile + BinaryChunk + GlbChunkHeaderSize;
+  }
+
+  JsonValue Root = JsonParser(pJson, pJson + JsonLength).Parse();
+  if(Root.Type != JsonValue::TYPE_OBJECT)
+    throw std::runtime_error("Invalid glTF JSON!");
+
+  //The only buffer a GLB file can have without a URI is its binary chunk.
+  const auto& Buffers = Root.GetArray("buffers");
+  for(size_t i = 0; i < Buffers.size(); ++i)
+  {
+    if(i > 0 || Buffers[i].Find("uri"))
+      throw std::runtime_error("External glTF buffers are not supported!");
+  }
+
+  std::vector<BufferView> BufferViews;
+  for(const auto& View : Root.GetArray("bufferViews"))
+  {
+    size_t Offset = View.GetSize("byteOffset", 0);
+    size_t Length = View.GetSize("byteLength", 0);
+    if(View.GetIndex("buffer") != 0 || Offset > BinaryLength || Length > BinaryLength - Offset)
+      throw std::runtime_error("Invalid glTF buffer view!");
+
+    BufferViews.push_back({pBinary + Offset, Length, View.GetSize("byteStride", 0)});
+  }
+
+  for(const auto& Json : Root.GetArray("accessors"))
+  {
+    if(Json.Find("sparse"))
+      throw std::runtime_error("Sparse glTF accessors are not supported!");
+
+    Accessor Accessor;
+    Accessor.ComponentType = static_cast<uint32_t>(Json.GetSize("componentType", 0));
+    Accessor.ComponentNum = GetComponentNum(Json.GetString("type"));
+    Accessor.Count = Json.GetSize("count", 0);
+    Accessor.bNormalized = Json.GetBool("normalized", false);
+    Accessor.BufferView = Json.GetIndex("bufferView");
+
+    size_t ElementSize = GetComponentSize(Accessor.ComponentType) * Accessor.ComponentNum;
+    if(ElementSize == 0 || Accessor.BufferView >= static_cast<int32_t>(BufferViews.size()))
+      throw std::runtime_error("Invalid glTF accessor!");
+
+    if(Accessor.BufferView >= 0 && Accessor.Count > 0)
+    {
+      const BufferView& View = BufferViews[Accessor.BufferView];
+      size_t Offset = Json.GetSize("byteOffset", 0);
+      Accessor.Stride = View.Stride ? View.Stride : ElementSize;
+
+      //The last element has to end within the buffer view.
+      if(Offset > View.Length || ElementSize > View.Length - Offset || Accessor.Count - 1 > (View.Length - Offset - ElementSize) / Accessor.Stride)
+        throw std::runtime_error("Invalid glTF accessor!");
+
+      Accessor.pData = View.pData + Offset;
+    }
+
+    const auto& Min = Json.GetArray("min");
+    const auto& Max = Json.GetArray("max");
+    if(Accessor.ComponentNum == 3 && Min.size() == 3 && Max.size() == 3)
+    {
+      Accessor.bHasBounds = true;
+      Accessor.Min = glm::vec3(GetElement(Min, 0, 0.0f), GetElement(Min, 1, 0.0f), GetElement(Min, 2, 0.0f));
+      Accessor.Max = glm::vec3(GetElement(Max, 0, 0.0f), GetElement(Max, 1, 0.0f), GetElement(Max, 2, 0.0f));
+    }
+
+    m_Accessors.push_back(Accessor);
+  }
+
+  for(const auto& Json : Root.GetArray("materials"))
+  {
+    glm::vec4 BaseColorFactor = glm::vec4(1.0f);
+    float MetallicFactor = 1.0f;
+    float RoughnessFactor = 1.0f;
+    if(const JsonValue* pPbr = Json.Find("pbrMetallicRoughness"))
+    {
+      const auto& BaseColor = pPbr->GetArray("baseColorFactor");
+      for(glm::length_t i = 0; i < 4; ++i)
+        BaseColorFactor[i] = GetElement(BaseColor, i, 1.0f);
+
+      MetallicFactor = static_cast<float>(pPbr->GetNumber("metallicFactor", 1.0));
+      RoughnessFactor = static_cast<float>(pPbr->GetNumber("roughnessFactor", 1.0));
+    }
+
+    Result.AddMaterial(Json.GetString("name"), BaseColorFactor, MetallicFactor, RoughnessFactor);
+  }
+
+  const uint32_t MaterialNum = static_cast<uint32_t>(Result.MaterialNum());
+  uint32_t DefaultMaterial = UINT32_MAX;
+
+  auto GetAccessor = [this](const JsonValue* pObject, const char* pKey, uint32_t ComponentNum)
+  {
+    int32_t Index = pObject ? pObject->GetIndex(pKey) : -1;
+    if(Index >= static_cast<int32_t>(m_Accessors.size()) || (Index >= 0 && m_Accessors[Index].ComponentNum != ComponentNum))
+      throw std::runtime_error("Invalid glTF primitive!");
+    return Index;
+  };
+
+  //Every primitive is one mesh, the meshes of glTF mesh i are [MeshFirstPrimitive[i], MeshFirstPrimitive[i + 1]).
+  const auto& Meshes = Root.GetArray("meshes");
+  std::vector<uint32_t> MeshFirstPrimitive(Meshes.size() + 1, 0);
+  std::map<std::array<int32_t, 4>, uint32_t> RangeLookup;
+  for(size_t i = 0; i < Meshes.size(); ++i)
+  {
+    MeshFirstPrimitive[i] = static_cast<uint32_t>(Result.MeshNum());
+    for(const auto& Primitive : Meshes[i].GetArray("primitives"))
+    {
+      const JsonValue* pAttributes = Primitive.Find("attributes");
+
+      VertexRange Range;
+      Range.Position = GetAccessor(pAttributes, "POSITION", 3);
+      Range.Normal = GetAccessor(pAttributes, "NORMAL", 3);
+      Range.Tangent = GetAccessor(pAttributes, "TANGENT", 4);
+      Range.TexCoord = GetAccessor(pAttributes, "TEXCOORD_0", 2);
+
+      IndexRange Indices;
+      Indices.Indices = GetAccessor(&Primitive, "indices", 1);
+      uint32_t IndexType = Indices.Indices >= 0 ? m_Accessors[Indices.Indices].ComponentType : ComponentTypeUnsignedInt;
+      if(IndexType != ComponentTypeUnsignedByte && IndexType != ComponentTypeUnsignedShort && IndexType != ComponentTypeUnsignedInt)
+        throw std::runtime_error("Invalid glTF primitive!");
+
+      //Points, lines, strips and fans are not drawn.
+      size_t IndexNum = 0;
+      if(Primitive.GetSize("mode", PrimitiveModeTriangles) == PrimitiveModeTriangles && Range.Position >= 0)
+        IndexNum = Indices.Indices >= 0 ? m_Accessors[Indices.Indices].Count : m_Accessors[Range.Position].Count;
+      IndexNum -= IndexNum % 3;
+
+      if(IndexNum > 0)
+      {
+        Range.VertexNum = static_cast<uint32_t>(m_Accessors[Range.Position].Count);
+        for(int32_t Attribute : {Range.Normal, Range.Tangent, Range.TexCoord})
+        {
+          if(Attribute >= 0 && m_Accessors[Attribute].Count != Range.VertexNum)
+            throw std::runtime_error("Invalid glTF primitive!");
+        }
+
+        auto [Iterator, bInserted] = RangeLookup.insert({{Range.Position, Range.Normal, Range.Tangent, Range.TexCoord}, static_cast<uint32_t>(m_VertexRanges.size())});
+        if(bInserted)
+        {
+          const Accessor& Positions = m_Accessors[Range.Position];
+          if(Positions.bHasBounds)
+          {
+            Range.Min = Positions.Min;
+            Range.Max = Positions.Max;
+          }
+          else
+          {
+            Range.Min = glm::vec3(std::numeric_limits<float>::max());
+            Range.Max = glm::vec3(std::numeric_limits<float>::lowest());
+            for(size_t j = 0; j < Positions.Count; ++j)
+            {
+              glm::vec3 Position = glm::vec3(Positions.Read(j, glm::vec4(0.0f)));
+              Range.Min = glm::min(Range.Min, Position);
+              Range.Max = glm::max(Range.Max, Position);
+            }
+          }
+
+          Range.FirstVertex = static_cast<uint32_t>(m_VertexNum);
+          m_VertexNum += Range.VertexNum;
+          m_VertexRanges.push_back(Range);
+        }
+
+        Indices.Vertices = Iterator->second;
+        Indices.FirstIndex = static_cast<uint32_t>(m_IndexNum);
+        Indices.IndexNum = static_cast<uint32_t>(IndexNum);
+        m_IndexNum += IndexNum;
+        m_IndexRanges.push_back(Indices);
+
+        if(m_VertexNum > std::numeric_limits<int32_t>::max() || m_IndexNum > std::numeric_limits<uint32_t>::max())
+          throw std::runtime_error("The glTF file has too many vertices or indices!");
+      }
+
+      int32_t Material = Primitive.GetIndex("material");
+      if(Material < 0 || static_cast<uint32_t>(Material) >= MaterialNum)
+      {
+        if(DefaultMaterial == UINT32_MAX)
+          DefaultMaterial = Result.AddMaterial("");
+        Material = static_cast<int32_t>(DefaultMaterial);
+      }
+
+      const VertexRange& Vertices = IndexNum > 0 ? m_VertexRanges[Indices.Vertices] : Range;
+      Result.MeshFirstIndex.push_back(IndexNum > 0 ? Indices.FirstIndex : 0);
+      Result.MeshIndexNum.push_back(static_cast<uint32_t>(IndexNum));
+      Result.MeshBaseVertex.push_back(static_cast<int32_t>(Vertices.FirstVertex));
+      Result.MeshVertexNum.push_back(Vertices.VertexNum);
+      Result.MeshMaterial.push_back(static_cast<uint32_t>(Material));
+
+      //The sphere around the accessor bounds.
+      Meshlet Whole;
+      Whole.IndexNum = static_cast<uint32_t>(IndexNum);
+      Whole.Bounds = glm::vec4(0.5f * (Vertices.Min + Vertices.Max), 0.5f * glm::length(Vertices.Max - Vertices.Min));
+      Result.MeshBoundsCenter.push_back(glm::vec3(Whole.Bounds));
+      Result.MeshBoundsRadius.push_back(Whole.Bounds.w);
+
+      //The indices are written straight from the mapped file, so there are no simplified levels of detail and every mesh is one meshlet.
+      Result.AddLod(Result.MeshFirstIndex.back(), Result.MeshIndexNum.back(), 0.0f, IndexNum > 0 ? std::vector<Meshlet>{Whole} : std::vector<Meshlet>());
+    }
+  }
+  MeshFirstPrimitive[Meshes.size()] = static_cast<uint32_t>(Result.MeshNum());
+
+  m_Min = glm::vec3(std::numeric_limits<float>::max());
+  m_Max = glm::vec3(std::numeric_limits<float>::lowest());
+  for(const auto& Range : m_VertexRanges)
+  {
+    m_Min = glm::min(m_Min, Range.Min);
+    m_Max = glm::max(m_Max, Range.Max);
+  }
+
+  if(m_VertexRanges.empty())
+    m_Min = m_Max = glm::vec3(0.0f);
+
+  //The nodes of the default scene, or all root nodes if there is no scene.
+  const auto& Nodes = Root.GetArray("nodes");
+  std::vector<int32_t> Roots;
+  const auto& Scenes = Root.GetArray("scenes");
+  if(!Scenes.empty())
+  {
+    int32_t SceneIndex = std::max(Root.GetIndex("scene"), 0);
+    if(SceneIndex >= static_cast<int32_t>(Scenes.size()))
+      throw std::runtime_error("Invalid glTF scene!");
+
+    for(const auto& Node : Scenes[SceneIndex].GetArray("nodes"))
+      Roots.push_back(Node.Type == JsonValue::TYPE_NUMBER ? static_cast<int32_t>(Node.Number) : -1);
+  }
+  else
+  {
+    std::vector<bool> IsChild(Nodes.size(), false);
+    for(const auto& Node : Nodes)
+    {
+      for(const auto& Child : Node.GetArray("children"))
+      {
+        if(Child.Type == JsonValue::TYPE_NUMBER && Child.Number >= 0.0 && Child.Number < static_cast<double>(Nodes.size()))
+          IsChild[static_cast<size_t>(Child.Number)] = true;
+      }
+    }
+
+    for(size_t i = 0; i < Nodes.size(); ++i)
+    {
+      if(!IsChild[i])
+        Roots.push_back(static_cast<int32_t>(i));
+    }
+  }
+
+  //Flatten the node trees depth-first, like "ImportNodes()" in "Scene.cpp". A node must not be reachable twice.
+  std::vector<bool> IsVisited(Nodes.size(), false);
+  std::vector<std::pair<int32_t, int32_t>> Stack;
+  for(size_t i = Roots.size(); i > 0; --i)
+    Stack.push_back({Roots[i - 1], -1});
+
+  while(!Stack.empty())
+  {
+    auto [Node, Parent] = Stack.back();
+    Stack.pop_back();
+
+    if(Node < 0 || Node >= static_cast<int32_t>(Nodes.size()) || IsVisited[Node])
+      throw std::runtime_error("Invalid glTF node hierarchy!");
+    IsVisited[Node] = true;
+
+    const JsonValue& Json = Nodes[Node];
+    int32_t NodeIndex = static_cast<int32_t>(Result.NodeParent.size());
+    Result.NodeParent.push_back(Parent);
+    Result.NodeLocalTransform.push_back(GetLocalTransform(Json));
+
+    int32_t Mesh = Json.GetIndex("mesh");
+    if(Mesh >= static_cast<int32_t>(Meshes.size()))
+      throw std::runtime_error("Invalid glTF node!");
+
+    for(uint32_t Primitive = Mesh >= 0 ? MeshFirstPrimitive[Mesh] : 0; Mesh >= 0 && Primitive < MeshFirstPrimitive[Mesh + 1]; ++Primitive)
+    {
+      if(Result.MeshIndexNum[Primitive] == 0)
+        continue;
+
+      Result.DrawMesh.push_back(Primitive);
+      Result.DrawNode.push_back(static_cast<uint32_t>(NodeIndex));
+    }
+
+    const auto& Children = Json.GetArray("children");
+    for(size_t i = Children.size(); i > 0; --i)
+      Stack.push_back({Children[i - 1].Type == JsonValue::TYPE_NUMBER ? static_cast<int32_t>(Children[i - 1].Number) : -1, NodeIndex});
+  }
+
+  Result.UpdateWorldTransforms();
+}
+
+void GltfFile::Close()
+{
+  m_File.Close();
+  m_Accessors.clear();
+  m_VertexRanges.clear();
+  m_IndexRanges.clear();
+  m_VertexNum = 0;
+  m_IndexNum = 0;
+  m_Min = m_Max = glm::vec3(0.0f);
+}
+
+Vertex GltfFile::ReadVertex(const VertexRange& Range, size_t Index) const
+{
+  const glm::vec4 Zero = glm::vec4(0.0f);
+
+  Vertex Vertex;
+  Vertex.Position = glm::vec3(m_Accessors[Range.Position].Read(Index, Zero));
+  Vertex.Normal = Range.Normal >= 0 ? glm::vec3(m_Accessors[Range.Normal].Read(Index, Zero)) : glm::vec3(0.0f);
+  Vertex.Tangent = Range.Tangent >= 0 ? m_Accessors[Range.Tangent].Read(Index, Zero) : glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+  Vertex.TexCoord = Range.TexCoord >= 0 ? glm::vec2(m_Accessors[Range.TexCoord].Read(Index, Zero)) : glm::vec2(0.0f);
+  return Vertex;
+}
+
+void GltfFile::ReadIndices(const IndexRange& Range, uint32_t* pTarget) const
+{
+  //Every index has to address a vertex of its range, a broken file must not make the GPU read past the vertex buffer.
+  uint32_t VertexNum = m_VertexRanges[Range.Vertices].VertexNum;
+
+  if(Range.Indices < 0)
+  {
+    if(Range.IndexNum > VertexNum)
+      throw std::runtime_error("Invalid glTF indices!");
+
+    for(uint32_t i = 0; i < Range.IndexNum; ++i)
+      pTarget[i] = i;
+    return;
+  }
+
+  const Accessor& Indices = m_Accessors[Range.Indices];
+  if(!Indices.pData)
+  {
+    if(Range.IndexNum > 0 && VertexNum == 0)
+      throw std::runtime_error("Invalid glTF indices!");
+
+    std::fill(pTarget, pTarget + Range.IndexNum, 0u);
+    return;
+  }
+
+  for(uint32_t i = 0; i < Range.IndexNum; ++i)
+  {
+    const uint8_t* pIndex = Indices.pData + i * Indices.Stride;
+    uint32_t Index;
+    switch(Indices.ComponentType)
+    {
+      case ComponentTypeUnsignedByte: Index = Load<uint8_t>(pIndex); break;
+      case ComponentTypeUnsignedShort: Index = Load<uint16_t>(pIndex); break;
+      default: Index = Load<uint32_t>(pIndex); break;
+    }
+
+    if(Index >= VertexNum)
+      throw std::runtime_error("Invalid glTF indices!");
+
+    pTarget[i] = Index;
+  }
+}
+
+void GltfFile::WriteRange(uint32_t RangeIndex, void* pTarget, VERTEX_FORMAT Format, const glm::vec3& PositionScale, const glm::vec3& PositionOffset) const
+{
+  const VertexRange& Range = m_VertexRanges[RangeIndex];
+  uint8_t* pVertices = static_cast<uint8_t*>(pTarget);
+
+  auto Store = [&](const Vertex& Source, size_t Index)
+  {
+    if(Format == VERTEX_FORMAT_COMPACT)
+    {
+      CompactVertex Target = QuantizeVertex(Source, PositionScale, PositionOffset);
+      std::memcpy(pVertices + Index * sizeof(CompactVertex), &Target, sizeof(Target));
+    }
+    else
+      std::memcpy(pVertices + Index * sizeof(Vertex), &Source, sizeof(Source));
+  };
+
+  if(Range.Normal >= 0 && Range.Tangent >= 0)
+  {
+    for(size_t i = 0; i < Range.VertexNum; ++i)
+      Store(ReadVertex(Range, i), i);
+    return;
+  }
+
+  /* Missing normals and tangents have to be generated from the triangles of all primitives that use the vertices, which
+   * needs the vertices on the heap. glTF asks for flat normals and MikkTSpace tangents, the area weighted normals and the
+   * tangents of the other importers are used instead. */
+  std::vector<Vertex> Vertices(Range.VertexNum);
+  for(size_t i = 0; i < Vertices.size(); ++i)
+    Vertices[i] = ReadVertex(Range, i);
+
+  std::vector<uint32_t> Indices;
+  for(const auto& Primitive : m_IndexRanges)
+  {
+    if(Primitive.Vertices != RangeIndex)
+      continue;
+
+    size_t Offset = Indices.size();
+    Indices.resize(Offset + Primitive.IndexNum);
+    ReadIndices(Primitive, Indices.data() + Offset);
+  }
+
+  GenerateNormalsAndTangents(Vertices, Indices, std::vector<bool>(Vertices.size(), Range.Normal >= 0));
+
+  for(size_t i = 0; i < Vertices.size(); ++i)
+    Store(Vertices[i], i);
+}
+
+void GltfFile::WriteVertices(void* pTarget, VERTEX_FORMAT Format, const glm::vec3& PositionScale, const glm::vec3& PositionOffset) const
+{
+  size_t VertexSize = Format == VERTEX_FORMAT_COMPACT ? sizeof(CompactVertex) : sizeof(Vertex);
+
+  for(uint32_t i = 0; i < static_cast<uint32_t>(m_VertexRanges.size()); ++i)
+    WriteRange(i, static_cast<uint8_t*>(pTarget) + m_VertexRanges[i].FirstVertex * VertexSize, Format, PositionScale, PositionOffset);
+}
+
+size_t GltfFile::WriteIndices(uint32_t* pTarget) const
+{
+  size_t CopiedSize = 0;
+
+  for(const auto& Range : m_IndexRanges)
+  {
+    const Accessor* pIndices = Range.Indices >= 0 ? &m_Accessors[Range.Indices] : nullptr;
+    if(pIndices && pIndices->pData && pIndices->ComponentType == ComponentTypeUnsignedInt && pIndices->Stride == sizeof(uint32_t))
+    {
+      //Checked in the mapped file rather than in the target, which is usually write-combined and slow to read back.
+      uint32_t VertexNum = m_VertexRanges[Range.Vertices].VertexNum;
+      for(uint32_t i = 0; i < Range.IndexNum; ++i)
+      {
+        if(Load<uint32_t>(pIndices->pData + i * sizeof(uint32_t)) >= VertexNum)
+          throw std::runtime_error("Invalid glTF indices!");
+      }
+
+      std::memcpy(pTarget + Range.FirstIndex, pIndices->pData, Range.IndexNum * sizeof(uint32_t));
+      CopiedSize += Range.IndexNum * sizeof(uint32_t);
+    }
+    else
+      ReadIndices(Range, pTarget + Range.FirstIndex);
+  }
+
+  return CopiedSize;
+}
+
+bool IsGlbFile(const std::string& Path)
+{
+  std::string Extension = std::filesystem::path(Path).extension().string();
+  std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char Character) {return static_cast<char>(std::tolower(static_cast<unsigned char>(Character)));});
+  return Extension == ".glb";
+}
+
+NAMESPACE_END
\ No newline at end of file
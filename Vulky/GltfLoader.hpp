@@ -0,0 +1,113 @@
+#pragma once
+
+#ifndef GLM_FORCE_RADIANS
+#define GLM_FORCE_RADIANS
+#endif
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "Mesh.hpp"
+#include "MappedFile.hpp"
+#include "Scene.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* A binary glTF 2.0 file (.glb). Opening it maps the file and turns its JSON chunk into the meshes, nodes, draws and materials
+ * of a "Scene", but leaves the vertices and indices of the scene empty: they stay in the mapped binary chunk until
+ * "WriteVertices()" and "WriteIndices()" write them straight into a (mapped staging) buffer. Every primitive becomes one mesh,
+ * primitives with the same attribute accessors share their vertices. Unsigned int indices are copied in one piece, vertices
+ * and all other indices are converted element by element. Every index is checked against the vertices of its primitive.
+ * Only triangle lists are drawn, external buffers and sparse accessors are not supported. */
+class GltfFile
+{
+  public:
+  GltfFile() = default;
+
+  GltfFile(const GltfFile&) = delete;
+
+  GltfFile& operator=(const GltfFile&) = delete;
+
+  void Open(const std::string& Path, Scene& Result);
+
+  void Close();
+
+  bool IsOpen() const {return m_File.GetData() != nullptr;}
+
+  size_t GetVertexNum() const {return m_VertexNum;}
+
+  size_t GetIndexNum() const {return m_IndexNum;}
+
+  //The bounds of all positions, from the "min" and "max" that glTF requires for position accessors.
+  void GetBounds(glm::vec3& Min, glm::vec3& Max) const {Min = m_Min; Max = m_Max;}
+
+  /* Write all vertices in the given layout, "pTarget" has to have room for "GetVertexNum()" of them. Compact vertices are
+   * quantized with the given scale and offset. */
+  void WriteVertices(void* pTarget, VERTEX_FORMAT Format, const glm::vec3& PositionScale, const glm::vec3& PositionOffset) const;
+
+  //Write all indices, relative to the base vertex of their mesh. Returns the number of bytes that were copied without any conversion.
+  size_t WriteIndices(uint32_t* pTarget) const;
+
+  protected:
+  //A typed view into the binary chunk. Accessors without a buffer view have no data and read as zeros.
+  struct Accessor
+  {
+    const uint8_t* pData = nullptr;
+    size_t Stride = 0;
+    size_t Count = 0;
+    uint32_t ComponentType = 0;
+    uint32_t ComponentNum = 0;
+    int32_t BufferView = -1;
+    bool bNormalized = false;
+    bool bHasBounds = false;
+    glm::vec3 Min = glm::vec3(0.0f);
+    glm::vec3 Max = glm::vec3(0.0f);
+
+    //Components that the accessor does not have are taken from "Default".
+    glm::vec4 Read(size_t Index, const glm::vec4& Default) const;
+  };
+
+  //The vertices of all primitives with the same attribute accessors (-1 if missing).
+  struct VertexRange
+  {
+    int32_t Position = -1;
+    int32_t Normal = -1;
+    int32_t Tangent = -1;
+    int32_t TexCoord = -1;
+    uint32_t FirstVertex = 0;
+    uint32_t VertexNum = 0;
+    glm::vec3 Min = glm::vec3(0.0f);
+    glm::vec3 Max = glm::vec3(0.0f);
+  };
+
+  //The indices of a primitive, primitives without an index accessor draw their vertices in order.
+  struct IndexRange
+  {
+    int32_t Indices = -1;
+    uint32_t FirstIndex = 0;
+    uint32_t IndexNum = 0;
+    uint32_t Vertices = 0;
+  };
+
+  void WriteRange(uint32_t RangeIndex, void* pTarget, VERTEX_FORMAT Format, const glm::vec3& PositionScale, const glm::vec3& PositionOffset) const;
+
+  Vertex ReadVertex(const VertexRange& Range, size_t Index) const;
+
+  void ReadIndices(const IndexRange& Range, uint32_t* pTarget) const;
+
+  MappedFile m_File;
+  std::vector<Accessor> m_Accessors;
+  std::vector<VertexRange> m_VertexRanges;
+  std::vector<IndexRange> m_IndexRanges;
+  size_t m_VertexNum = 0;
+  size_t m_IndexNum = 0;
+  glm::vec3 m_Min = glm::vec3(0.0f);
+  glm::vec3 m_Max = glm::vec3(0.0f);
+};
+
+bool IsGlbFile(const std::string& Path);
+
+NAMESPACE_END
\ No newline at end of file
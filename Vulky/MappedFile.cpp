@@ -0,0 +1,110 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+MappedFile::MappedFile(const std::string& Filename)
+{
+  Open(Filename);
+}
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+void MappedFile::Open(const std::string& Filename)
+{
+  Close();
+
+#ifdef _WIN32
+  HANDLE hFile = CreateFileA(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if(hFile == INVALID_HANDLE_VALUE)
+    throw std::runtime_error("Failed to open file!");
+  m_hFile = hFile;
+
+  LARGE_INTEGER FileSize = {};
+  if(!GetFileSizeEx(hFile, &FileSize))
+  {
+    Close();
+    throw std::runtime_error("Failed to get the size of the file!");
+  }
+
+  m_Size = static_cast<size_t>(FileSize.QuadPart);
+  if(m_Size == 0) //Empty files cannot be mapped.
+    return;
+
+  m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(m_hMapping)
+    m_pData = static_cast<const char*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+#else
+  m_FileDescriptor = open(Filename.c_str(), O_RDONLY);
+  if(m_FileDescriptor < 0)
+    throw std::runtime_error("Failed to open file!");
+
+  struct stat Status = {};
+  if(fstat(m_FileDescriptor, &Status) != 0)
+  {
+    Close();
+    throw std::runtime_error("Failed to get the size of the file!");
+  }
+
+  m_Size = static_cast<size_t>(Status.st_size);
+  if(m_Size == 0) //Empty files cannot be mapped.
+    return;
+
+  void* pData = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0);
+  if(pData != MAP_FAILED)
+  {
+    m_pData = static_cast<const char*>(pData);
+    madvise(pData, m_Size, MADV_SEQUENTIAL);
+  }
+#endif
+
+  if(!m_pData)
+  {
+    Close();
+    throw std::runtime_error("Failed to map file!");
+  }
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+  if(m_pData)
+    UnmapViewOfFile(m_pData);
+  if(m_hMapping)
+    CloseHandle(m_hMapping);
+  if(m_hFile)
+    CloseHandle(m_hFile);
+  m_hMapping = nullptr;
+  m_hFile = nullptr;
+#else
+  if(m_pData)
+    munmap(const_cast<char*>(m_pData), m_Size);
+  if(m_FileDescriptor >= 0)
+    close(m_FileDescriptor);
+  m_FileDescriptor = -1;
+#endif
+
+  m_pData = nullptr;
+  m_Size = 0;
+}
+
+NAMESPACE_END
\ No newline at end of file
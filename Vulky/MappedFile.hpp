@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* A read-only memory mapping of a whole file. Pages are only read from disk when they are touched, so large files can be
+ * processed without first copying them into a buffer, and by several threads at once. */
+class MappedFile
+{
+  public:
+  MappedFile() = default;
+
+  explicit MappedFile(const std::string& Filename);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  void Open(const std::string& Filename);
+
+  void Close();
+
+  const char* GetData() const {return m_pData;}
+
+  size_t GetSize() const {return m_Size;}
+
+  protected:
+  const char* m_pData = nullptr;
+  size_t m_Size = 0;
+#ifdef _WIN32
+  void* m_hFile = nullptr;
+  void* m_hMapping = nullptr;
+#else
+  int m_FileDescriptor = -1;
+#endif
+};
+
+NAMESPACE_END
\ No newline at end of file
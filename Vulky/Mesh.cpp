@@ -0,0 +1,376 @@
+#include "Mesh.hpp"
+
+#include <assimp/scene.h>
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //Positive and negative zero compare equal, so they must hash equally as well.
+  uint64_t FloatBits(float Value)
+  {
+    if(Value == 0.0f)
+      Value = 0.0f;
+
+    uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(Bits));
+    return Bits;
+  }
+
+  uint64_t PackFloats(float Low, float High) {return FloatBits(Low) | (FloatBits(High) << 32);}
+
+  uint64_t RotateLeft(uint64_t Value, int Shift) {return (Value << Shift) | (Value >> (64 - Shift));}
+
+  //A multiply-rotate round in the style of xxHash64.
+  uint64_t HashCombine(uint64_t Hash, uint64_t Key)
+  {
+    Hash ^= RotateLeft(Key * 0xC2B2AE3D27D4EB4Full, 31) * 0x9E3779B185EBCA87ull;
+    return RotateLeft(Hash, 27) * 0x9E3779B185EBCA87ull + 0x85EBCA77C2B2AE63ull;
+  }
+
+  //The finalizer of MurmurHash3, so that every input bit affects the low bits used for the table slot.
+  uint64_t HashFinalize(uint64_t Hash)
+  {
+    Hash ^= Hash >> 33;
+    Hash *= 0xFF51AFD7ED558CCDull;
+    Hash ^= Hash >> 33;
+    Hash *= 0xC4CEB9FE1A85EC53ull;
+    Hash ^= Hash >> 33;
+    return Hash;
+  }
+
+  uint64_t HashVertex(const Vertex& Vertex)
+  {
+    uint64_t Hash = 0x27D4EB2F165667C5ull;
+    Hash = HashCombine(Hash, PackFloats(Vertex.Position.x, Vertex.Position.y));
+    Hash = HashCombine(Hash, PackFloats(Vertex.Position.z, Vertex.Normal.x));
+    Hash = HashCombine(Hash, PackFloats(Vertex.Normal.y, Vertex.Normal.z));
+    Hash = HashCombine(Hash, PackFloats(Vertex.Tangent.x, Vertex.Tangent.y));
+    Hash = HashCombine(Hash, PackFloats(Vertex.Tangent.z, Vertex.Tangent.w));
+    Hash = HashCombine(Hash, PackFloats(Vertex.TexCoord.x, Vertex.TexCoord.y));
+    return HashFinalize(Hash);
+  }
+
+  int16_t FloatToSnorm16(float Value) {return static_cast<int16_t>(std::round(std::clamp(Value, -1.0f, 1.0f) * 32767.0f));}
+
+  uint16_t FloatToUnorm16(float Value) {return static_cast<uint16_t>(std::round(std::clamp(Value, 0.0f, 1.0f) * 65535.0f));}
+
+  //Octahedral mapping of a unit vector to [-1, 1]^2, see Cigolle et al., "A Survey of Efficient Representations for Independent Unit Vectors".
+  glm::vec2 EncodeOctahedral(glm::vec3 Direction)
+  {
+    float Length = std::abs(Direction.x) + std::abs(Direction.y) + std::abs(Direction.z);
+    if(Length == 0.0f)
+      return glm::vec2(0.0f, 0.0f);
+
+    Direction /= Length;
+    if(Direction.z >= 0.0f)
+      return glm::vec2(Direction.x, Direction.y);
+
+    return glm::vec2((1.0f - std::abs(Direction.y)) * (Direction.x >= 0.0f ? 1.0f : -1.0f),
+                     (1.0f - std::abs(Direction.x)) * (Direction.y >= 0.0f ? 1.0f : -1.0f));
+  }
+}
+
+void ConvertMesh(const aiMesh* pMesh, std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices)
+{
+  size_t VertexNum = pMesh->mNumVertices;
+  size_t FacetNum = pMesh->mNumFaces;
+
+  Vertices.clear();
+  Indices.clear();
+
+  Vertices.reserve(VertexNum);
+  Indices.reserve(FacetNum * 3);
+
+  for(uint32_t i = 0; i < VertexNum; ++i)
+  {
+    Vertex Vertex = {};
+
+    Vertex.Position.x = pMesh->mVertices[i].x;
+    Vertex.Position.y = pMesh->mVertices[i].y;
+    Vertex.Position.z = pMesh->mVertices[i].z;
+
+    if(pMesh->HasNormals())
+    {
+      Vertex.Normal.x = pMesh->mNormals[i].x;
+      Vertex.Normal.y = pMesh->mNormals[i].y;
+      Vertex.Normal.z = pMesh->mNormals[i].z;
+    }
+
+    Vertex.Tangent.w = 1.0f;
+    if(pMesh->HasTangentsAndBitangents())
+    {
+      Vertex.Tangent.x = pMesh->mTangents[i].x;
+      Vertex.Tangent.y = pMesh->mTangents[i].y;
+      Vertex.Tangent.z = pMesh->mTangents[i].z;
+
+      //Mirrored texture coordinates flip the bitangent, the shader rebuilds it as "cross(Normal, Tangent) * Handedness".
+      glm::vec3 Bitangent(pMesh->mBitangents[i].x, pMesh->mBitangents[i].y, pMesh->mBitangents[i].z);
+      if(glm::dot(glm::cross(Vertex.Normal, glm::vec3(Vertex.Tangent)), Bitangent) < 0.0f)
+        Vertex.Tangent.w = -1.0f;
+    }
+
+    if(pMesh->HasTextureCoords(0))
+    {
+      Vertex.TexCoord.x = pMesh->mTextureCoords[0][i].x;
+      Vertex.TexCoord.y = pMesh->mTextureCoords[0][i].y;
+    }
+
+    Vertices.push_back(Vertex);
+  }
+
+  for(uint32_t i = 0; i < FacetNum; ++i)
+  {
+    Indices.push_back(pMesh->mFaces[i].mIndices[0]);
+    Indices.push_back(pMesh->mFaces[i].mIndices[1]);
+    Indices.push_back(pMesh->mFaces[i].mIndices[2]);
+  }
+}
+
+void WeldVertices(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices)
+{
+  //Linear probing in a table of at most 50 % load, every slot keeps the upper hash bits to skip most full comparisons.
+  struct Slot
+  {
+    uint32_t Hash;
+    uint32_t Index;
+  };
+
+  const uint32_t EmptySlot = UINT32_MAX;
+
+  size_t Capacity = 16;
+  while(Capacity < Vertices.size() * 2)
+    Capacity *= 2;
+
+  const size_t Mask = Capacity - 1;
+  std::vector<Slot> Table(Capacity, Slot{0, EmptySlot});
+  std::vector<uint32_t> Remap(Vertices.size());
+
+  uint32_t UniqueNum = 0;
+  for(size_t i = 0; i < Vertices.size(); ++i)
+  {
+    uint64_t Hash = HashVertex(Vertices[i]);
+    uint32_t HashTag = static_cast<uint32_t>(Hash >> 32);
+
+    for(size_t SlotIndex = Hash & Mask; ; SlotIndex = (SlotIndex + 1) & Mask)
+    {
+      Slot& Slot = Table[SlotIndex];
+      if(Slot.Index == EmptySlot)
+      {
+        //The unique vertices are compacted to the front, which never overwrites a vertex that is still to be visited.
+        Slot.Hash = HashTag;
+        Slot.Index = UniqueNum;
+        Vertices[UniqueNum] = Vertices[i];
+        Remap[i] = UniqueNum++;
+        break;
+      }
+
+      if(Slot.Hash == HashTag && VertexEqual()(Vertices[Slot.Index], Vertices[i]))
+      {
+        Remap[i] = Slot.Index;
+        break;
+      }
+    }
+  }
+
+  Vertices.resize(UniqueNum);
+
+  for(auto& Index : Indices)
+    Index = Remap[Index];
+}
+
+void GenerateNormalsAndTangents(std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices, const std::vector<bool>& HasNormal)
+{
+  std::vector<glm::vec3> Tangents(Vertices.size(), glm::vec3(0.0f));
+  std::vector<glm::vec3> Bitangents(Vertices.size(), glm::vec3(0.0f));
+
+  for(size_t i = 0; i + 2 < Indices.size(); i += 3)
+  {
+    const uint32_t Triangle[3] = {Indices[i], Indices[i + 1], Indices[i + 2]};
+    const Vertex& V0 = Vertices[Triangle[0]];
+    const Vertex& V1 = Vertices[Triangle[1]];
+    const Vertex& V2 = Vertices[Triangle[2]];
+
+    glm::vec3 Edge1 = V1.Position - V0.Position;
+    glm::vec3 Edge2 = V2.Position - V0.Position;
+    glm::vec2 DeltaUv1 = V1.TexCoord - V0.TexCoord;
+    glm::vec2 DeltaUv2 = V2.TexCoord - V0.TexCoord;
+
+    glm::vec3 FaceNormal = glm::cross(Edge1, Edge2);
+    for(uint32_t Index : Triangle)
+    {
+      if(!HasNormal[Index])
+        Vertices[Index].Normal += FaceNormal;
+    }
+
+    float Determinant = DeltaUv1.x * DeltaUv2.y - DeltaUv2.x * DeltaUv1.y;
+    if(std::abs(Determinant) < 1e-12f)
+      continue;
+
+    glm::vec3 Tangent = (Edge1 * DeltaUv2.y - Edge2 * DeltaUv1.y) / Determinant;
+    glm::vec3 Bitangent = (Edge2 * DeltaUv1.x - Edge1 * DeltaUv2.x) / Determinant;
+    for(uint32_t Index : Triangle)
+    {
+      Tangents[Index] += Tangent;
+      Bitangents[Index] += Bitangent;
+    }
+  }
+
+  for(size_t i = 0; i < Vertices.size(); ++i)
+  {
+    Vertex& Vertex = Vertices[i];
+
+    float NormalLength = glm::length(Vertex.Normal);
+    Vertex.Normal = NormalLength > 0.0f ? Vertex.Normal / NormalLength : glm::vec3(0.0f, 0.0f, 1.0f);
+
+    //Gram-Schmidt against the normal, vertices without a usable gradient get any perpendicular direction.
+    glm::vec3 Tangent = Tangents[i] - Vertex.Normal * glm::dot(Vertex.Normal, Tangents[i]);
+    if(glm::dot(Tangent, Tangent) < 1e-20f)
+      Tangent = glm::cross(Vertex.Normal, std::abs(Vertex.Normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+
+    Tangent = glm::normalize(Tangent);
+    float Handedness = glm::dot(glm::cross(Vertex.Normal, Tangent), Bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+    Vertex.Tangent = glm::vec4(Tangent, Handedness);
+  }
+}
+
+void ComputeQuantization(const glm::vec3& Min, const glm::vec3& Max, glm::vec3& PositionScale, glm::vec3& PositionOffset)
+{
+  //Flat axes get a tiny instead of a zero scale, so the division in "QuantizeVertex()" stays defined.
+  PositionOffset = Min;
+  PositionScale = glm::max(Max - Min, glm::vec3(std::numeric_limits<float>::min()));
+}
+
+CompactVertex QuantizeVertex(const Vertex& Source, const glm::vec3& PositionScale, const glm::vec3& PositionOffset)
+{
+  CompactVertex Target;
+
+  glm::vec3 Position = (Source.Position - PositionOffset) / PositionScale;
+  Target.Position[0] = FloatToUnorm16(Position.x);
+  Target.Position[1] = FloatToUnorm16(Position.y);
+  Target.Position[2] = FloatToUnorm16(Position.z);
+  Target.Position[3] = Source.Tangent.w < 0.0f ? 0 : 65535;
+
+  glm::vec2 Normal = EncodeOctahedral(Source.Normal);
+  Target.Normal[0] = FloatToSnorm16(Normal.x);
+  Target.Normal[1] = FloatToSnorm16(Normal.y);
+
+  glm::vec2 Tangent = EncodeOctahedral(glm::vec3(Source.Tangent));
+  Target.Tangent[0] = FloatToSnorm16(Tangent.x);
+  Target.Tangent[1] = FloatToSnorm16(Tangent.y);
+
+  Target.TexCoord[0] = glm::packHalf1x16(Source.TexCoord.x);
+  Target.TexCoord[1] = glm::packHalf1x16(Source.TexCoord.y);
+  return Target;
+}
+
+void QuantizeVertices(const std::vector<Vertex>& Vertices, std::vector<CompactVertex>& CompactVertices, glm::vec3& PositionScale, glm::vec3& PositionOffset)
+{
+  glm::vec3 Min = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 Max = glm::vec3(std::numeric_limits<float>::lowest());
+  for(const auto& Vertex : Vertices)
+  {
+    Min = glm::min(Min, Vertex.Position);
+    Max = glm::max(Max, Vertex.Position);
+  }
+
+  if(Vertices.empty())
+    Min = Max = glm::vec3(0.0f);
+
+  ComputeQuantization(Min, Max, PositionScale, PositionOffset);
+
+  CompactVertices.resize(Vertices.size());
+  for(size_t i = 0; i < Vertices.size(); ++i)
+    CompactVertices[i] = QuantizeVertex(Vertices[i], PositionScale, PositionOffset);
+}
+
+size_t VertexHash::operator()(const Vertex& Rhs) const {return static_cast<size_t>(HashVertex(Rhs));}
+
+bool VertexEqual::operator()(const Vertex& Lhs, const Vertex& Rhs) const
+{
+  return Lhs.Position == Rhs.Position &&
+         Lhs.Normal == Rhs.Normal &&
+         Lhs.Tangent == Rhs.Tangent &&
+         Lhs.TexCoord == Rhs.TexCoord;
+}
+
+VkVertexInputBindingDescription Vertex::GetBindingDescription()
+{
+  VkVertexInputBindingDescription BindingDescription = {};
+  BindingDescription.binding = 0;
+  BindingDescription.stride = sizeof(Vertex);
+  BindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  return BindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 4> Vertex::GetAttributeDescription()
+{
+  std::array<VkVertexInputAttributeDescription, 4> AttributeDescriptions = {};
+
+  AttributeDescriptions[0].binding = 0;
+  AttributeDescriptions[0].location = 0;
+  AttributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+  AttributeDescriptions[0].offset = offsetof(Vertex, Position);
+
+  AttributeDescriptions[1].binding = 0;
+  AttributeDescriptions[1].location = 1;
+  AttributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+  AttributeDescriptions[1].offset = offsetof(Vertex, Normal);
+
+  AttributeDescriptions[2].binding = 0;
+  AttributeDescriptions[2].location = 2;
+  AttributeDescriptions[2].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+  AttributeDescriptions[2].offset = offsetof(Vertex, Tangent);
+
+  AttributeDescriptions[3].binding = 0;
+  AttributeDescriptions[3].location = 3;
+  AttributeDescriptions[3].format = VK_FORMAT_R32G32_SFLOAT;
+  AttributeDescriptions[3].offset = offsetof(Vertex, TexCoord);
+
+  return AttributeDescriptions;
+}
+
+VkVertexInputBindingDescription CompactVertex::GetBindingDescription()
+{
+  VkVertexInputBindingDescription BindingDescription = {};
+  BindingDescription.binding = 0;
+  BindingDescription.stride = sizeof(CompactVertex);
+  BindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  return BindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 4> CompactVertex::GetAttributeDescription()
+{
+  std::array<VkVertexInputAttributeDescription, 4> AttributeDescriptions = {};
+
+  AttributeDescriptions[0].binding = 0;
+  AttributeDescriptions[0].location = 0;
+  AttributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+  AttributeDescriptions[0].offset = offsetof(CompactVertex, Position);
+
+  AttributeDescriptions[1].binding = 0;
+  AttributeDescriptions[1].location = 1;
+  AttributeDescriptions[1].format = VK_FORMAT_R16G16_SNORM;
+  AttributeDescriptions[1].offset = offsetof(CompactVertex, Normal);
+
+  AttributeDescriptions[2].binding = 0;
+  AttributeDescriptions[2].location = 2;
+  AttributeDescriptions[2].format = VK_FORMAT_R16G16_SNORM;
+  AttributeDescriptions[2].offset = offsetof(CompactVertex, Tangent);
+
+  AttributeDescriptions[3].binding = 0;
+  AttributeDescriptions[3].location = 3;
+  AttributeDescriptions[3].format = VK_FORMAT_R16G16_SFLOAT;
+  AttributeDescriptions[3].offset = offsetof(CompactVertex, TexCoord);
+
+  return AttributeDescriptions;
+}
+
+NAMESPACE_END
\ No newline at end of file
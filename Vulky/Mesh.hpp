@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#endif
+#include <GLFW/glfw3.h>
+
+#ifndef GLM_FORCE_RADIANS
+#define GLM_FORCE_RADIANS
+#endif
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+
+#include "Namespace.hpp"
+
+struct aiMesh;
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//The vertex layout used for importing and processing meshes, and for rendering when precision matters more than bandwidth.
+struct Vertex
+{
+  glm::vec3 Position;
+  glm::vec3 Normal;
+  glm::vec4 Tangent; //The handedness of the bitangent is stored in w.
+  glm::vec2 TexCoord;
+
+  static VkVertexInputBindingDescription GetBindingDescription();
+  static std::array<VkVertexInputAttributeDescription, 4> GetAttributeDescription();
+};
+
+/* The same attributes in 20 bytes instead of 48: the position is normalized to the bounds of the mesh, with the tangent
+ * handedness as 0 or 1 in w, normal and tangent are octahedral encoded and the texture coordinates are half floats.
+ * The shader input locations match the ones of "Vertex", the vertex shader decodes them with "PositionScale" and
+ * "PositionOffset" when its specialization constant selects the compact layout. */
+struct CompactVertex
+{
+  uint16_t Position[4];
+  int16_t Normal[2];
+  int16_t Tangent[2];
+  uint16_t TexCoord[2];
+
+  static VkVertexInputBindingDescription GetBindingDescription();
+  static std::array<VkVertexInputAttributeDescription, 4> GetAttributeDescription();
+};
+
+enum VERTEX_FORMAT
+{
+  VERTEX_FORMAT_FULL = 0,
+  VERTEX_FORMAT_COMPACT = 1
+};
+
+struct VertexHash {size_t operator()(const Vertex& Rhs) const;};
+
+struct VertexEqual {bool operator()(const Vertex& Lhs, const Vertex& Rhs) const;};
+
+struct MeshImportStatistics
+{
+  bool bLoadedFromCache = false;
+  size_t SourceVertexNum = 0;
+  size_t WeldedVertexNum = 0;
+  double ImportTime = 0.0; //In milliseconds, reading the file and converting the meshes, or reading the mesh cache.
+  double WeldTime = 0.0; //In milliseconds.
+  double OptimizeTime = 0.0; //In milliseconds.
+  double SimplifyTime = 0.0; //In milliseconds, generating the levels of detail.
+  //Vertex cache efficiency of the index buffer before and after the optimization, see "MeshOptimizer.hpp".
+  double AcmrBefore = 0.0;
+  double AcmrAfter = 0.0;
+  double AtvrBefore = 0.0;
+  double AtvrAfter = 0.0;
+};
+
+//Convert an imported mesh into the vertex layout of the graphics pipeline, the mesh has to be triangulated.
+void ConvertMesh(const aiMesh* pMesh, std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices);
+
+//Merge identical vertices and remap the indices, the unique vertices keep the order of their first occurrence.
+void WeldVertices(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices);
+
+//Area weighted face normals for the vertices without one, and tangents from the texture coordinate gradients for all of them.
+void GenerateNormalsAndTangents(std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices, const std::vector<bool>& HasNormal);
+
+//The scale and offset that map positions within the given bounds to [0, 1] for "QuantizeVertex()".
+void ComputeQuantization(const glm::vec3& Min, const glm::vec3& Max, glm::vec3& PositionScale, glm::vec3& PositionOffset);
+
+CompactVertex QuantizeVertex(const Vertex& Source, const glm::vec3& PositionScale, const glm::vec3& PositionOffset);
+
+//Quantize the vertices, the original position is "Position * PositionScale + PositionOffset".
+void QuantizeVertices(const std::vector<Vertex>& Vertices, std::vector<CompactVertex>& CompactVertices, glm::vec3& PositionScale, glm::vec3& PositionOffset);
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,476 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  const uint32_t InvalidIndex = UINT32_MAX;
+
+  //A FIFO cache in which every vertex remembers when it was inserted, a vertex is cached while fewer than "CacheSize" vertices were inserted after it.
+  class FifoCache
+  {
+    public:
+    FifoCache(size_t VertexNum, uint32_t CacheSize) : m_CacheTime(VertexNum, 0), m_CacheSize(CacheSize), m_Timestamp(CacheSize + 1) {}
+
+    //Returns whether the vertex had to be transformed.
+    bool Access(uint32_t Vertex)
+    {
+      if(m_Timestamp - m_CacheTime[Vertex] <= m_CacheSize)
+        return false;
+
+      m_CacheTime[Vertex] = m_Timestamp++;
+      return true;
+    }
+
+    //Move the time forward, so every vertex counts as evicted.
+    void Flush() {m_Timestamp += m_CacheSize + 1;}
+
+    uint32_t GetTimestamp() const {return m_Timestamp;}
+
+    uint32_t GetCacheTime(uint32_t Vertex) const {return m_CacheTime[Vertex];}
+
+    protected:
+    std::vector<uint32_t> m_CacheTime;
+    uint32_t m_CacheSize;
+    uint32_t m_Timestamp;
+  };
+
+  uint32_t CountTriangleMisses(FifoCache& Cache, const uint32_t* pTriangle)
+  {
+    return Cache.Access(pTriangle[0]) + Cache.Access(pTriangle[1]) + Cache.Access(pTriangle[2]);
+  }
+
+  /* A cluster starts wherever all three vertices of a triangle miss the cache, which is where Tipsify had to jump to a
+   * dead-end vertex. Within these, further boundaries are placed where the ACMR of the running cluster is low enough,
+   * so that shuffling the clusters only slightly degrades the cache efficiency. */
+  std::vector<uint32_t> GenerateClusters(const std::vector<uint32_t>& Indices, size_t VertexNum, float Threshold, uint32_t CacheSize)
+  {
+    const uint32_t TriangleNum = static_cast<uint32_t>(Indices.size() / 3);
+
+    std::vector<uint32_t> HardBoundaries;
+    FifoCache Cache(VertexNum, CacheSize);
+    for(uint32_t i = 0; i < TriangleNum; ++i)
+    {
+      if(CountTriangleMisses(Cache, &Indices[i * 3]) == 3 || i == 0)
+        HardBoundaries.push_back(i);
+    }
+    HardBoundaries.push_back(TriangleNum);
+
+    std::vector<uint32_t> Boundaries;
+    for(size_t Cluster = 0; Cluster + 1 < HardBoundaries.size(); ++Cluster)
+    {
+      uint32_t Start = HardBoundaries[Cluster];
+      uint32_t End = HardBoundaries[Cluster + 1];
+
+      Cache.Flush();
+      uint32_t ClusterMisses = 0;
+      for(uint32_t i = Start; i < End; ++i)
+        ClusterMisses += CountTriangleMisses(Cache, &Indices[i * 3]);
+
+      float ClusterThreshold = Threshold * static_cast<float>(ClusterMisses) / static_cast<float>(End - Start);
+
+      Boundaries.push_back(Start);
+
+      Cache.Flush();
+      uint32_t Misses = 0, Size = 0;
+      for(uint32_t i = Start; i < End; ++i)
+      {
+        Misses += CountTriangleMisses(Cache, &Indices[i * 3]);
+        ++Size;
+
+        if(i + 1 < End && static_cast<float>(Misses) <= ClusterThreshold * static_cast<float>(Size))
+        {
+          Boundaries.push_back(i + 1);
+          Cache.Flush();
+          Misses = 0;
+          Size = 0;
+        }
+      }
+    }
+    Boundaries.push_back(TriangleNum);
+
+    return Boundaries;
+  }
+
+  //Below this, the normals of a meshlet spread too far for its cone to be of any use.
+  const float MinConeDot = 0.1f;
+
+  void ComputeMeshletBounds(const std::vector<Vertex>& Vertices, const uint32_t* pIndices, uint32_t IndexNum, Meshlet& Result)
+  {
+    glm::vec3 Min = Vertices[pIndices[0]].Position;
+    glm::vec3 Max = Min;
+    for(uint32_t i = 0; i < IndexNum; ++i)
+    {
+      Min = glm::min(Min, Vertices[pIndices[i]].Position);
+      Max = glm::max(Max, Vertices[pIndices[i]].Position);
+    }
+
+    glm::vec3 Center = 0.5f * (Min + Max);
+    float RadiusSquared = 0.0f;
+    for(uint32_t i = 0; i < IndexNum; ++i)
+    {
+      glm::vec3 Offset = Vertices[pIndices[i]].Position - Center;
+      RadiusSquared = std::max(RadiusSquared, glm::dot(Offset, Offset));
+    }
+    Result.Bounds = glm::vec4(Center, std::sqrt(RadiusSquared));
+
+    //The cone axis is the average of the unit face normals, degenerate triangles are never rasterized and are left out.
+    glm::vec3 Normals[MESHLET_MAX_TRIANGLE_NUM];
+    uint32_t NormalNum = 0;
+    glm::vec3 Axis = glm::vec3(0.0f);
+    for(uint32_t i = 0; i + 2 < IndexNum && NormalNum < MESHLET_MAX_TRIANGLE_NUM; i += 3)
+    {
+      const glm::vec3& P0 = Vertices[pIndices[i + 0]].Position;
+      const glm::vec3& P1 = Vertices[pIndices[i + 1]].Position;
+      const glm::vec3& P2 = Vertices[pIndices[i + 2]].Position;
+
+      glm::vec3 Normal = glm::cross(P1 - P0, P2 - P0);
+      float Length = glm::length(Normal);
+      if(Length > 0.0f)
+      {
+        Normals[NormalNum++] = Normal / Length;
+        Axis += Normal / Length;
+      }
+    }
+
+    Result.Cone = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    float AxisLength = glm::length(Axis);
+    if(NormalNum == 0 || AxisLength <= 0.0f)
+      return;
+
+    Axis /= AxisLength;
+    float MinDot = 1.0f;
+    for(uint32_t i = 0; i < NormalNum; ++i)
+      MinDot = std::min(MinDot, glm::dot(Normals[i], Axis));
+
+    //The cutoff is the sine of the largest angle between the axis and a normal.
+    if(MinDot > MinConeDot)
+      Result.Cone = glm::vec4(Axis, std::sqrt(1.0f - MinDot * MinDot));
+  }
+}
+
+VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& Indices, size_t VertexNum, uint32_t CacheSize)
+{
+  FifoCache Cache(VertexNum, CacheSize);
+  std::vector<bool> Referenced(VertexNum, false);
+
+  size_t MissNum = 0, ReferencedNum = 0;
+  for(uint32_t Index : Indices)
+  {
+    MissNum += Cache.Access(Index);
+
+    if(!Referenced[Index])
+    {
+      Referenced[Index] = true;
+      ++ReferencedNum;
+    }
+  }
+
+  VertexCacheStatistics Statistics = {};
+  Statistics.Acmr = Indices.empty() ? 0.0 : static_cast<double>(MissNum) / static_cast<double>(Indices.size() / 3);
+  Statistics.Atvr = ReferencedNum == 0 ? 0.0 : static_cast<double>(MissNum) / static_cast<double>(ReferencedNum);
+  return Statistics;
+}
+
+void OptimizeVertexCache(std::vector<uint32_t>& Indices, size_t VertexNum, uint32_t CacheSize)
+{
+  const uint32_t TriangleNum = static_cast<uint32_t>(Indices.size() / 3);
+
+  //Triangles adjacent to every vertex, in compressed rows, and the number of adjacent triangles that were not emitted yet.
+  std::vector<uint32_t> LiveTriangleNum(VertexNum, 0);
+  for(uint32_t Index : Indices)
+    ++LiveTriangleNum[Index];
+
+  std::vector<uint32_t> AdjacencyOffsets(VertexNum + 1, 0);
+  std::partial_sum(LiveTriangleNum.begin(), LiveTriangleNum.end(), AdjacencyOffsets.begin() + 1);
+
+  std::vector<uint32_t> Adjacency(Indices.size());
+  {
+    std::vector<uint32_t> Cursors(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+    for(uint32_t i = 0; i < TriangleNum; ++i)
+    {
+      Adjacency[Cursors[Indices[i * 3 + 0]]++] = i;
+      Adjacency[Cursors[Indices[i * 3 + 1]]++] = i;
+      Adjacency[Cursors[Indices[i * 3 + 2]]++] = i;
+    }
+  }
+
+  FifoCache Cache(VertexNum, CacheSize);
+  std::vector<bool> Emitted(TriangleNum, false);
+  std::vector<uint32_t> DeadEndStack;
+  std::vector<uint32_t> Candidates;
+  std::vector<uint32_t> Output;
+  DeadEndStack.reserve(Indices.size());
+  Output.reserve(Indices.size());
+
+  uint32_t ScanCursor = 0;
+  uint32_t FanningVertex = VertexNum > 0 ? 0 : InvalidIndex;
+
+  while(FanningVertex != InvalidIndex)
+  {
+    //Emit all remaining triangles around the fanning vertex.
+    Candidates.clear();
+    for(uint32_t i = AdjacencyOffsets[FanningVertex]; i < AdjacencyOffsets[FanningVertex + 1]; ++i)
+    {
+      uint32_t Triangle = Adjacency[i];
+      if(Emitted[Triangle])
+        continue;
+
+      for(uint32_t Corner = 0; Corner < 3; ++Corner)
+      {
+        uint32_t Vertex = Indices[Triangle * 3 + Corner];
+        Output.push_back(Vertex);
+        DeadEndStack.push_back(Vertex);
+        Candidates.push_back(Vertex);
+        --LiveTriangleNum[Vertex];
+        Cache.Access(Vertex);
+      }
+
+      Emitted[Triangle] = true;
+    }
+
+    //Continue with the candidate that entered the cache first among those that will still be cached after their fan was emitted.
+    uint32_t NextVertex = InvalidIndex;
+    int64_t BestPriority = -1;
+    for(uint32_t Vertex : Candidates)
+    {
+      if(LiveTriangleNum[Vertex] == 0)
+        continue;
+
+      int64_t Priority = 0;
+      int64_t Age = static_cast<int64_t>(Cache.GetTimestamp()) - static_cast<int64_t>(Cache.GetCacheTime(Vertex));
+      if(Age + 2 * static_cast<int64_t>(LiveTriangleNum[Vertex]) <= static_cast<int64_t>(CacheSize))
+        Priority = Age;
+
+      if(Priority > BestPriority)
+      {
+        BestPriority = Priority;
+        NextVertex = Vertex;
+      }
+    }
+
+    //Dead end, fall back to recently used vertices and then to any vertex with remaining triangles.
+    while(NextVertex == InvalidIndex && !DeadEndStack.empty())
+    {
+      uint32_t Vertex = DeadEndStack.back();
+      DeadEndStack.pop_back();
+      if(LiveTriangleNum[Vertex] > 0)
+        NextVertex = Vertex;
+    }
+
+    while(NextVertex == InvalidIndex && ScanCursor < VertexNum)
+    {
+      if(LiveTriangleNum[ScanCursor] > 0)
+        NextVertex = ScanCursor;
+      else
+        ++ScanCursor;
+    }
+
+    FanningVertex = NextVertex;
+  }
+
+  Indices.swap(Output);
+}
+
+void OptimizeOverdraw(std::vector<uint32_t>& Indices, const std::vector<Vertex>& Vertices, float Threshold, uint32_t CacheSize)
+{
+  if(Indices.empty())
+    return;
+
+  std::vector<uint32_t> Boundaries = GenerateClusters(Indices, Vertices.size(), Threshold, CacheSize);
+  const size_t ClusterNum = Boundaries.size() - 1;
+
+  glm::vec3 MeshCenter = glm::vec3(0.0f);
+  for(const auto& Vertex : Vertices)
+    MeshCenter += Vertex.Position;
+  MeshCenter /= static_cast<float>(std::max<size_t>(Vertices.size(), 1));
+
+  //Area weighted center and normal of every cluster, clusters facing away from the mesh center are likely occluders.
+  std::vector<float> SortKeys(ClusterNum);
+  for(size_t Cluster = 0; Cluster < ClusterNum; ++Cluster)
+  {
+    glm::vec3 Center = glm::vec3(0.0f);
+    glm::vec3 Normal = glm::vec3(0.0f);
+    float Area = 0.0f;
+
+    for(uint32_t i = Boundaries[Cluster]; i < Boundaries[Cluster + 1]; ++i)
+    {
+      const glm::vec3& P0 = Vertices[Indices[i * 3 + 0]].Position;
+      const glm::vec3& P1 = Vertices[Indices[i * 3 + 1]].Position;
+      const glm::vec3& P2 = Vertices[Indices[i * 3 + 2]].Position;
+
+      glm::vec3 Cross = glm::cross(P1 - P0, P2 - P0);
+      float TriangleArea = glm::length(Cross);
+
+      Center += (P0 + P1 + P2) * (TriangleArea / 3.0f);
+      Normal += Cross;
+      Area += TriangleArea;
+    }
+
+    float NormalLength = glm::length(Normal);
+    if(Area > 0.0f)
+      Center /= Area;
+    if(NormalLength > 0.0f)
+      Normal /= NormalLength;
+
+    SortKeys[Cluster] = glm::dot(Center - MeshCenter, Normal);
+  }
+
+  std::vector<uint32_t> Order(ClusterNum);
+  std::iota(Order.begin(), Order.end(), 0);
+  std::stable_sort(Order.begin(), Order.end(), [&](uint32_t Lhs, uint32_t Rhs) {return SortKeys[Lhs] > SortKeys[Rhs];});
+
+  std::vector<uint32_t> Output;
+  Output.reserve(Indices.size());
+  for(uint32_t Cluster : Order)
+    Output.insert(Output.end(), Indices.begin() + Boundaries[Cluster] * 3, Indices.begin() + Boundaries[Cluster + 1] * 3);
+
+  Indices.swap(Output);
+}
+
+void BuildMeshlets(const std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices, std::vector<Meshlet>& Meshlets, uint32_t MaxVertexNum, uint32_t MaxTriangleNum)
+{
+  Meshlets.clear();
+
+  const uint32_t TriangleNum = static_cast<uint32_t>(Indices.size() / 3);
+  if(TriangleNum == 0)
+    return;
+
+  //The triangles around every vertex, and how many of them are not in a meshlet yet.
+  std::vector<uint32_t> AdjacencyOffsets(Vertices.size() + 1, 0);
+  for(uint32_t Index : Indices)
+    ++AdjacencyOffsets[Index + 1];
+  std::partial_sum(AdjacencyOffsets.begin(), AdjacencyOffsets.end(), AdjacencyOffsets.begin());
+
+  std::vector<uint32_t> Adjacency(Indices.size());
+  std::vector<uint32_t> LiveTriangleNum(Vertices.size());
+  {
+    std::vector<uint32_t> Cursors(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+    for(size_t i = 0; i < TriangleNum * 3; ++i)
+      Adjacency[Cursors[Indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+    for(size_t i = 0; i < Vertices.size(); ++i)
+      LiveTriangleNum[i] = AdjacencyOffsets[i + 1] - AdjacencyOffsets[i];
+  }
+
+  std::vector<bool> Emitted(TriangleNum, false);
+  //The meshlet that last used a vertex, so the unique vertices of the current one are counted without clearing anything.
+  std::vector<uint32_t> VertexMeshlet(Vertices.size(), InvalidIndex);
+  std::vector<uint32_t> MeshletVertices;
+  std::vector<uint32_t> MeshletTriangles;
+  std::vector<uint32_t> Output;
+  Output.reserve(TriangleNum * 3);
+
+  auto CountNewVertices = [&](uint32_t Triangle)
+  {
+    uint32_t Current = static_cast<uint32_t>(Meshlets.size());
+    return static_cast<uint32_t>(VertexMeshlet[Indices[Triangle * 3 + 0]] != Current) + static_cast<uint32_t>(VertexMeshlet[Indices[Triangle * 3 + 1]] != Current) +
+           static_cast<uint32_t>(VertexMeshlet[Indices[Triangle * 3 + 2]] != Current);
+  };
+
+  auto FinishMeshlet = [&]()
+  {
+    std::sort(MeshletTriangles.begin(), MeshletTriangles.end());
+
+    Meshlet Result;
+    Result.FirstIndex = static_cast<uint32_t>(Output.size());
+    Result.IndexNum = static_cast<uint32_t>(MeshletTriangles.size() * 3);
+    for(uint32_t Triangle : MeshletTriangles)
+      Output.insert(Output.end(), Indices.begin() + Triangle * 3, Indices.begin() + Triangle * 3 + 3);
+
+    ComputeMeshletBounds(Vertices, &Output[Result.FirstIndex], Result.IndexNum, Result);
+    Meshlets.push_back(Result);
+
+    MeshletVertices.clear();
+    MeshletTriangles.clear();
+  };
+
+  uint32_t Seed = 0;
+  while(true)
+  {
+    //The neighbor that adds the fewest vertices, any triangle that only uses vertices of the meshlet is taken right away.
+    uint32_t Best = InvalidIndex;
+    uint32_t BestNewVertexNum = 4;
+    for(size_t i = 0; i < MeshletVertices.size() && BestNewVertexNum > 0; ++i)
+    {
+      uint32_t Vertex = MeshletVertices[i];
+      if(LiveTriangleNum[Vertex] == 0)
+        continue;
+
+      for(uint32_t j = AdjacencyOffsets[Vertex]; j < AdjacencyOffsets[Vertex + 1]; ++j)
+      {
+        uint32_t Triangle = Adjacency[j];
+        if(Emitted[Triangle])
+          continue;
+
+        uint32_t NewVertexNum = CountNewVertices(Triangle);
+        if(NewVertexNum < BestNewVertexNum || (NewVertexNum == BestNewVertexNum && Triangle < Best))
+        {
+          Best = Triangle;
+          BestNewVertexNum = NewVertexNum;
+        }
+      }
+    }
+
+    //Nothing left around the meshlet, continue with the first triangle that has not been emitted yet.
+    if(Best == InvalidIndex)
+    {
+      while(Seed < TriangleNum && Emitted[Seed])
+        ++Seed;
+      if(Seed == TriangleNum)
+        break;
+
+      Best = Seed;
+      BestNewVertexNum = CountNewVertices(Best);
+    }
+
+    //The triangle does not fit anymore, it starts the next meshlet instead, which keeps that one close to this one.
+    if(MeshletVertices.size() + BestNewVertexNum > MaxVertexNum || MeshletTriangles.size() + 1 > MaxTriangleNum)
+      FinishMeshlet();
+
+    Emitted[Best] = true;
+    MeshletTriangles.push_back(Best);
+    for(uint32_t Corner = 0; Corner < 3; ++Corner)
+    {
+      uint32_t Vertex = Indices[Best * 3 + Corner];
+      if(VertexMeshlet[Vertex] != static_cast<uint32_t>(Meshlets.size()))
+      {
+        VertexMeshlet[Vertex] = static_cast<uint32_t>(Meshlets.size());
+        MeshletVertices.push_back(Vertex);
+      }
+
+      --LiveTriangleNum[Vertex];
+    }
+  }
+
+  if(!MeshletTriangles.empty())
+    FinishMeshlet();
+
+  Indices.swap(Output);
+}
+
+void OptimizeVertexFetch(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices)
+{
+  std::vector<uint32_t> Remap(Vertices.size(), InvalidIndex);
+  std::vector<Vertex> Reordered;
+  Reordered.reserve(Vertices.size());
+
+  for(auto& Index : Indices)
+  {
+    if(Remap[Index] == InvalidIndex)
+    {
+      Remap[Index] = static_cast<uint32_t>(Reordered.size());
+      Reordered.push_back(Vertices[Index]);
+    }
+
+    Index = Remap[Index];
+  }
+
+  Vertices.swap(Reordered);
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#ifndef GLM_FORCE_RADIANS
+#define GLM_FORCE_RADIANS
+#endif
+#include <glm/glm.hpp>
+
+#include "Namespace.hpp"
+#include "Mesh.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//The post-transform vertex cache is modelled as a FIFO, the usual size on current hardware is somewhere between 16 and 32 entries.
+constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+//The limits of a meshlet, the ones recommended for mesh shaders, so the same clusters would also fit such a pipeline.
+constexpr uint32_t MESHLET_MAX_VERTEX_NUM = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLE_NUM = 124;
+
+struct VertexCacheStatistics
+{
+  double Acmr = 0.0; //Average cache miss ratio, vertex shader invocations per triangle (0.5 - 3.0).
+  double Atvr = 0.0; //Average transformed vertex ratio, vertex shader invocations per vertex (1.0 is optimal).
+};
+
+VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& Indices, size_t VertexNum, uint32_t CacheSize = VERTEX_CACHE_SIZE);
+
+/* Reorder the triangles for the post-transform vertex cache with Tipsify (Sander et al., "Fast Triangle Reordering for
+ * Vertex Locality and Reduced Overdraw"): triangles are emitted as fans around vertices that are likely still cached. */
+void OptimizeVertexCache(std::vector<uint32_t>& Indices, size_t VertexNum, uint32_t CacheSize = VERTEX_CACHE_SIZE);
+
+/* Reorder clusters of a cache optimized index buffer so that triangles facing away from the mesh center are drawn first,
+ * which reduces overdraw independently of the view. Clusters are split wherever the local ACMR stays below
+ * "Threshold" times the ACMR of the surrounding cluster, so the vertex cache efficiency is mostly preserved. */
+void OptimizeOverdraw(std::vector<uint32_t>& Indices, const std::vector<Vertex>& Vertices, float Threshold = 1.05f, uint32_t CacheSize = VERTEX_CACHE_SIZE);
+
+//A cluster of triangles that is culled as a whole.
+struct Meshlet
+{
+  uint32_t FirstIndex = 0; //Relative to the start of the indices the meshlets were built from.
+  uint32_t IndexNum = 0;
+  glm::vec4 Bounds = glm::vec4(0.0f); //Center and radius of the bounding sphere.
+  /* Axis and cutoff of the cone around all triangle normals, the meshlet faces away from "Eye" if
+   * "dot(Center - Eye, Axis) >= Cutoff * length(Center - Eye) + Radius". Meshlets whose normals spread over about a
+   * hemisphere or more have a zero axis and a cutoff of 1, so the test never passes for them. */
+  glm::vec4 Cone = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+};
+
+/* Partition a triangle list into meshlets of at most "MaxVertexNum" unique vertices and "MaxTriangleNum" triangles. Every
+ * meshlet grows greedily from the first unassigned triangle over the neighbor that adds the fewest new vertices, so it
+ * stays compact and its bounding sphere and normal cone stay tight. The indices are reordered so that every meshlet is one
+ * consecutive range, the triangles of a meshlet keep their relative order, so the vertex cache optimization mostly survives. */
+void BuildMeshlets(const std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices, std::vector<Meshlet>& Meshlets,
+                   uint32_t MaxVertexNum = MESHLET_MAX_VERTEX_NUM, uint32_t MaxTriangleNum = MESHLET_MAX_TRIANGLE_NUM);
+
+//Renumber the vertices in the order of their first use, so vertex fetches are mostly sequential. Unused vertices are removed.
+void OptimizeVertexFetch(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices);
+
+NAMESPACE_END
\ No newline at end of file
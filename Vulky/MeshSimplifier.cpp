@@ -0,0 +1,376 @@
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //Position, normal and texture coordinates.
+  constexpr uint32_t AttributeNum = 8;
+  constexpr uint32_t QuadricSize = AttributeNum * (AttributeNum + 1) / 2;
+
+  //How much a deviation of the unit normal and of the texture coordinates counts compared to one of the normalized position.
+  const double NormalWeight = 0.25;
+  const double TexCoordWeight = 1.0;
+
+  //The new normal of a triangle around a collapsed vertex has to stay within about 80 degrees of the old one.
+  const float MinFlipCosine = 0.2f;
+
+  /* The squared distance of a point to the planes (in attribute space) of all triangles added to the quadric, weighted by
+   * their area: "v^T * A * v + 2 * b^T * v + c". "A" is symmetric, only its upper triangle is stored. "W" is the sum of the
+   * weights, dividing by it turns the error into a mean squared distance that does not grow with the triangle count. */
+  struct Quadric
+  {
+    double A[QuadricSize];
+    double B[AttributeNum];
+    double C;
+    double W;
+
+    Quadric& operator+=(const Quadric& Rhs)
+    {
+      for(uint32_t i = 0; i < QuadricSize; ++i)
+        A[i] += Rhs.A[i];
+      for(uint32_t i = 0; i < AttributeNum; ++i)
+        B[i] += Rhs.B[i];
+      C += Rhs.C;
+      W += Rhs.W;
+      return *this;
+    }
+  };
+
+  struct AttributeVector
+  {
+    double Values[AttributeNum];
+  };
+
+  double Dot(const double* pLhs, const double* pRhs)
+  {
+    double Sum = 0.0;
+    for(uint32_t i = 0; i < AttributeNum; ++i)
+      Sum += pLhs[i] * pRhs[i];
+    return Sum;
+  }
+
+  bool Normalize(double* pVector)
+  {
+    double Length = std::sqrt(Dot(pVector, pVector));
+    if(Length < 1e-12)
+      return false;
+
+    for(uint32_t i = 0; i < AttributeNum; ++i)
+      pVector[i] /= Length;
+    return true;
+  }
+
+  //The triangle spans a plane in attribute space with the orthonormal basis E1 and E2, its quadric measures the distance to it.
+  void AddTriangleQuadric(Quadric& Quadric, const double* pP, const double* pQ, const double* pR, double Weight)
+  {
+    double E1[AttributeNum], E2[AttributeNum];
+    for(uint32_t i = 0; i < AttributeNum; ++i)
+    {
+      E1[i] = pQ[i] - pP[i];
+      E2[i] = pR[i] - pP[i];
+    }
+
+    if(!Normalize(E1))
+      return;
+
+    double Projection = Dot(E1, E2);
+    for(uint32_t i = 0; i < AttributeNum; ++i)
+      E2[i] -= Projection * E1[i];
+
+    if(!Normalize(E2))
+      return;
+
+    double PE1 = Dot(pP, E1);
+    double PE2 = Dot(pP, E2);
+
+    uint32_t Index = 0;
+    for(uint32_t i = 0; i < AttributeNum; ++i)
+    {
+      for(uint32_t j = i; j < AttributeNum; ++j)
+        Quadric.A[Index++] += Weight * ((i == j ? 1.0 : 0.0) - E1[i] * E1[j] - E2[i] * E2[j]);
+
+      Quadric.B[i] += Weight * (PE1 * E1[i] + PE2 * E2[i] - pP[i]);
+    }
+
+    Quadric.C += Weight * (Dot(pP, pP) - PE1 * PE1 - PE2 * PE2);
+    Quadric.W += Weight;
+  }
+
+  //The weighted sum of squared distances, not yet divided by the weight.
+  double EvaluateQuadricSum(const Quadric& Quadric, const double* pV)
+  {
+    double Sum = Quadric.C;
+    uint32_t Index = 0;
+    for(uint32_t i = 0; i < AttributeNum; ++i)
+    {
+      Sum += 2.0 * Quadric.B[i] * pV[i] + Quadric.A[Index++] * pV[i] * pV[i];
+      for(uint32_t j = i + 1; j < AttributeNum; ++j)
+        Sum += 2.0 * Quadric.A[Index++] * pV[i] * pV[j];
+    }
+
+    return Sum;
+  }
+
+  //The error of the merged quadrics of both vertices of an edge at "pV", the quadrics are linear so they need not be added up first.
+  double EvaluateCollapse(const Quadric& Lhs, const Quadric& Rhs, const double* pV)
+  {
+    double Weight = Lhs.W + Rhs.W;
+    //Rounding can make the error of a point on all planes slightly negative.
+    return Weight > 0.0 ? std::max(EvaluateQuadricSum(Lhs, pV) + EvaluateQuadricSum(Rhs, pV), 0.0) / Weight : 0.0;
+  }
+
+  /* Vertices that share their position with another one (seams of normals or texture coordinates) and vertices on edges
+   * with other than two triangles (open borders and non-manifold edges) are locked, they could only be moved together. */
+  std::vector<bool> FindLockedVertices(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices)
+  {
+    std::vector<uint32_t> Order(Vertices.size());
+    std::iota(Order.begin(), Order.end(), 0);
+    std::sort(Order.begin(), Order.end(), [&](uint32_t Lhs, uint32_t Rhs)
+    {
+      const glm::vec3& L = Vertices[Lhs].Position;
+      const glm::vec3& R = Vertices[Rhs].Position;
+      return L.x != R.x ? L.x < R.x : (L.y != R.y ? L.y < R.y : L.z < R.z);
+    });
+
+    std::vector<bool> Locked(Vertices.size(), false);
+    std::vector<uint32_t> Canonical(Vertices.size());
+    for(size_t Begin = 0, End = 0; Begin < Order.size(); Begin = End)
+    {
+      for(End = Begin + 1; End < Order.size() && Vertices[Order[End]].Position == Vertices[Order[Begin]].Position; ++End);
+
+      for(size_t i = Begin; i < End; ++i)
+      {
+        Canonical[Order[i]] = Order[Begin];
+        Locked[Order[i]] = End - Begin > 1;
+      }
+    }
+
+    //Edges between positions, every edge of a closed manifold surface is used by exactly two triangles.
+    std::vector<uint64_t> Edges;
+    Edges.reserve(Indices.size());
+    for(size_t i = 0; i + 2 < Indices.size(); i += 3)
+    {
+      for(uint32_t Corner = 0; Corner < 3; ++Corner)
+      {
+        uint64_t A = Canonical[Indices[i + Corner]];
+        uint64_t B = Canonical[Indices[i + (Corner + 1) % 3]];
+        Edges.push_back(std::min(A, B) << 32 | std::max(A, B));
+      }
+    }
+    std::sort(Edges.begin(), Edges.end());
+
+    for(size_t Begin = 0, End = 0; Begin < Edges.size(); Begin = End)
+    {
+      for(End = Begin + 1; End < Edges.size() && Edges[End] == Edges[Begin]; ++End);
+
+      if(End - Begin != 2)
+      {
+        Locked[static_cast<uint32_t>(Edges[Begin] >> 32)] = true;
+        Locked[static_cast<uint32_t>(Edges[Begin])] = true;
+      }
+    }
+
+    //Locking the canonical vertex of a position locks all vertices at that position.
+    for(size_t i = 0; i < Vertices.size(); ++i)
+      Locked[i] = Locked[i] || Locked[Canonical[i]];
+
+    return Locked;
+  }
+
+  struct Collapse
+  {
+    uint32_t From;
+    uint32_t To;
+    double Error;
+  };
+
+  //Whether moving "From" onto "To" would turn any of the other triangles around "From" over.
+  bool FlipsTriangle(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices, const uint32_t* pAdjacency, uint32_t AdjacencyNum, uint32_t From, uint32_t To)
+  {
+    for(uint32_t i = 0; i < AdjacencyNum; ++i)
+    {
+      const uint32_t* pTriangle = &Indices[pAdjacency[i] * 3];
+      if(pTriangle[0] == To || pTriangle[1] == To || pTriangle[2] == To)
+        continue;
+
+      //Rotate the triangle so that "From" is its first corner.
+      uint32_t Corner = pTriangle[0] == From ? 0 : (pTriangle[1] == From ? 1 : 2);
+      const glm::vec3& B = Vertices[pTriangle[(Corner + 1) % 3]].Position;
+      const glm::vec3& C = Vertices[pTriangle[(Corner + 2) % 3]].Position;
+
+      glm::vec3 OldNormal = glm::cross(B - Vertices[From].Position, C - Vertices[From].Position);
+      glm::vec3 NewNormal = glm::cross(B - Vertices[To].Position, C - Vertices[To].Position);
+
+      float Cosine = glm::dot(OldNormal, NewNormal);
+      if(Cosine <= MinFlipCosine * glm::length(OldNormal) * glm::length(NewNormal))
+        return true;
+    }
+
+    return false;
+  }
+}
+
+float SimplifyMesh(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices, size_t TargetIndexNum, float TargetError, std::vector<uint32_t>& Result)
+{
+  Result = Indices;
+  if(Result.size() <= TargetIndexNum || Vertices.empty())
+    return 0.0f;
+
+  //Positions are normalized to the bounds, so the error is relative to the size of the mesh.
+  glm::vec3 Min = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 Max = glm::vec3(std::numeric_limits<float>::lowest());
+  for(const auto& Vertex : Vertices)
+  {
+    Min = glm::min(Min, Vertex.Position);
+    Max = glm::max(Max, Vertex.Position);
+  }
+
+  const glm::vec3 Size = Max - Min;
+  const double Extent = std::max(std::max(Size.x, Size.y), std::max(Size.z, std::numeric_limits<float>::min()));
+
+  std::vector<AttributeVector> Attributes(Vertices.size());
+  for(size_t i = 0; i < Vertices.size(); ++i)
+  {
+    const Vertex& Vertex = Vertices[i];
+    double* pValues = Attributes[i].Values;
+    for(glm::length_t j = 0; j < 3; ++j)
+    {
+      pValues[j] = (Vertex.Position[j] - Min[j]) / Extent;
+      pValues[3 + j] = Vertex.Normal[j] * NormalWeight;
+    }
+    pValues[6] = Vertex.TexCoord.x * TexCoordWeight;
+    pValues[7] = Vertex.TexCoord.y * TexCoordWeight;
+  }
+
+  std::vector<Quadric> Quadrics(Vertices.size());
+  std::memset(Quadrics.data(), 0, Quadrics.size() * sizeof(Quadric));
+  for(size_t i = 0; i + 2 < Result.size(); i += 3)
+  {
+    const uint32_t Triangle[3] = {Result[i], Result[i + 1], Result[i + 2]};
+    const double* pP = Attributes[Triangle[0]].Values;
+    const double* pQ = Attributes[Triangle[1]].Values;
+    const double* pR = Attributes[Triangle[2]].Values;
+
+    glm::dvec3 Edge1 = glm::dvec3(pQ[0] - pP[0], pQ[1] - pP[1], pQ[2] - pP[2]);
+    glm::dvec3 Edge2 = glm::dvec3(pR[0] - pP[0], pR[1] - pP[1], pR[2] - pP[2]);
+    double Area = 0.5 * glm::length(glm::cross(Edge1, Edge2));
+
+    for(uint32_t Index : Triangle)
+      AddTriangleQuadric(Quadrics[Index], pP, pQ, pR, Area);
+  }
+
+  const std::vector<bool> Locked = FindLockedVertices(Vertices, Result);
+  const double MaxError = static_cast<double>(TargetError) * static_cast<double>(TargetError);
+  double ResultError = 0.0;
+
+  std::vector<uint32_t> AdjacencyOffsets(Vertices.size() + 1);
+  std::vector<uint32_t> Adjacency;
+  std::vector<Collapse> Collapses;
+  std::vector<uint32_t> Remap(Vertices.size());
+  std::vector<bool> Touched(Vertices.size());
+
+  //Every pass collapses a set of independent edges, so the flip tests of one collapse are not invalidated by another one.
+  while(Result.size() > TargetIndexNum)
+  {
+    const uint32_t TriangleNum = static_cast<uint32_t>(Result.size() / 3);
+
+    std::fill(AdjacencyOffsets.begin(), AdjacencyOffsets.end(), 0);
+    for(uint32_t Index : Result)
+      ++AdjacencyOffsets[Index + 1];
+    std::partial_sum(AdjacencyOffsets.begin(), AdjacencyOffsets.end(), AdjacencyOffsets.begin());
+
+    Adjacency.resize(Result.size());
+    {
+      std::vector<uint32_t> Cursors(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+      for(uint32_t i = 0; i < static_cast<uint32_t>(Result.size()); ++i)
+        Adjacency[Cursors[Result[i]]++] = i / 3;
+    }
+
+    Collapses.clear();
+    for(uint32_t i = 0; i < TriangleNum; ++i)
+    {
+      for(uint32_t Corner = 0; Corner < 3; ++Corner)
+      {
+        uint32_t A = Result[i * 3 + Corner];
+        uint32_t B = Result[i * 3 + (Corner + 1) % 3];
+
+        //Interior edges are used by two triangles in opposite directions, only the one with "A < B" is evaluated. Border
+        //edges may be skipped by that as well, but both of their vertices are locked anyway.
+        if(A > B || (Locked[A] && Locked[B]))
+          continue;
+
+        //Only the cheaper direction of the edge is a candidate.
+        double ErrorAB = Locked[A] ? std::numeric_limits<double>::max() : EvaluateCollapse(Quadrics[A], Quadrics[B], Attributes[B].Values);
+        double ErrorBA = Locked[B] ? std::numeric_limits<double>::max() : EvaluateCollapse(Quadrics[A], Quadrics[B], Attributes[A].Values);
+        if(ErrorAB <= ErrorBA)
+          Collapses.push_back({A, B, ErrorAB});
+        else
+          Collapses.push_back({B, A, ErrorBA});
+      }
+    }
+
+    std::sort(Collapses.begin(), Collapses.end(), [](const Collapse& Lhs, const Collapse& Rhs) {return Lhs.Error < Rhs.Error;});
+
+    std::iota(Remap.begin(), Remap.end(), 0);
+    std::fill(Touched.begin(), Touched.end(), false);
+
+    const size_t TrianglesToRemove = (Result.size() - TargetIndexNum + 2) / 3;
+    size_t RemovedTriangleNum = 0;
+    size_t CollapseNum = 0;
+    for(const auto& Collapse : Collapses)
+    {
+      if(Collapse.Error > MaxError || RemovedTriangleNum >= TrianglesToRemove)
+        break;
+
+      if(Touched[Collapse.From] || Touched[Collapse.To])
+        continue;
+
+      const uint32_t* pAdjacency = &Adjacency[AdjacencyOffsets[Collapse.From]];
+      uint32_t AdjacencyNum = AdjacencyOffsets[Collapse.From + 1] - AdjacencyOffsets[Collapse.From];
+      if(FlipsTriangle(Vertices, Result, pAdjacency, AdjacencyNum, Collapse.From, Collapse.To))
+        continue;
+
+      Remap[Collapse.From] = Collapse.To;
+      Quadrics[Collapse.To] += Quadrics[Collapse.From];
+      ResultError = std::max(ResultError, Collapse.Error);
+      ++CollapseNum;
+
+      //The whole one-ring of "From" changes shape, none of its vertices may be collapsed again in this pass.
+      for(uint32_t i = 0; i < AdjacencyNum; ++i)
+      {
+        const uint32_t* pTriangle = &Result[pAdjacency[i] * 3];
+        Touched[pTriangle[0]] = Touched[pTriangle[1]] = Touched[pTriangle[2]] = true;
+        RemovedTriangleNum += pTriangle[0] == Collapse.To || pTriangle[1] == Collapse.To || pTriangle[2] == Collapse.To;
+      }
+    }
+
+    if(CollapseNum == 0)
+      break;
+
+    size_t Write = 0;
+    for(size_t i = 0; i + 2 < Result.size(); i += 3)
+    {
+      uint32_t A = Remap[Result[i]];
+      uint32_t B = Remap[Result[i + 1]];
+      uint32_t C = Remap[Result[i + 2]];
+      if(A == B || B == C || C == A)
+        continue;
+
+      Result[Write++] = A;
+      Result[Write++] = B;
+      Result[Write++] = C;
+    }
+    Result.resize(Write);
+  }
+
+  return static_cast<float>(std::sqrt(ResultError));
+}
+
+NAMESPACE_END
\ No newline at end of file
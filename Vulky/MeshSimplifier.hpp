@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "Mesh.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* Simplify a triangle mesh by edge collapses in the order of their quadric error (Garland and Heckbert, "Simplifying Surfaces
+ * with Color and Texture using Quadric Error Metrics"): every vertex is a point in a space of position, normal and texture
+ * coordinates, so collapses that distort the shading or the texture mapping are as expensive as ones that move the surface.
+ * Vertices are only collapsed onto neighboring vertices, the result indexes the same vertex array and can share its vertex
+ * buffer. Vertices on open borders and on attribute seams (several vertices at one position) are never moved.
+ * Collapses stop once at most "TargetIndexNum" indices are left or the next one would exceed "TargetError". Both
+ * "TargetError" and the returned error of the result are relative to the largest extent of the mesh bounds. */
+float SimplifyMesh(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices, size_t TargetIndexNum, float TargetError, std::vector<uint32_t>& Result);
+
+NAMESPACE_END
\ No newline at end of file
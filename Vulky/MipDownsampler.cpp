@@ -0,0 +1,374 @@
+#include "MipDownsampler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //The levels one dispatch writes after level 0 and the bindings of "Shaders/Downsample.comp".
+  const uint32_t MaxLevelNum = 12;
+  const uint32_t CounterBinding = MaxLevelNum + 1;
+  //Every work group covers 64 x 64 texels of level 0, i.e. 32 x 32 of level 1, with 256 invocations.
+  const uint32_t WorkGroupLevel1Size = 32;
+  const uint32_t WorkGroupInvocationNum = 256;
+
+  //See "DownsampleParameters" in the shader.
+  struct DownsampleParameters
+  {
+    uint32_t Size[2];
+    uint32_t LevelNum;
+    uint32_t WorkGroupNum;
+  };
+
+  void CreateLevelView(VkDevice Device, VkImage Image, VkFormat Format, uint32_t Level, VkImageView& ImageView)
+  {
+    VkImageViewCreateInfo CreateInfo = {};
+    CreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    CreateInfo.image = Image;
+    CreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    CreateInfo.format = Format;
+    CreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    CreateInfo.subresourceRange.baseMipLevel = Level;
+    CreateInfo.subresourceRange.levelCount = 1;
+    CreateInfo.subresourceRange.baseArrayLayer = 0;
+    CreateInfo.subresourceRange.layerCount = 1;
+
+    if(vkCreateImageView(Device, &CreateInfo, nullptr, &ImageView) != VK_SUCCESS)
+      throw std::runtime_error("Failed to create mip level image view!");
+  }
+
+  VkImageMemoryBarrier MakeLevelBarrier(VkImage Image, uint32_t BaseLevel, uint32_t LevelCount, VkImageLayout OldLayout, VkImageLayout NewLayout,
+                                        VkAccessFlags SrcAccessMask, VkAccessFlags DstAccessMask)
+  {
+    VkImageMemoryBarrier Barrier = {};
+    Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    Barrier.oldLayout = OldLayout;
+    Barrier.newLayout = NewLayout;
+    Barrier.srcAccessMask = SrcAccessMask;
+    Barrier.dstAccessMask = DstAccessMask;
+    Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.image = Image;
+    Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Barrier.subresourceRange.baseMipLevel = BaseLevel;
+    Barrier.subresourceRange.levelCount = LevelCount;
+    Barrier.subresourceRange.baseArrayLayer = 0;
+    Barrier.subresourceRange.layerCount = 1;
+    return Barrier;
+  }
+}
+
+void MipDownsampler::Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, const std::vector<char>& ShaderCode, uint32_t MaxTargetNum)
+{
+  m_PhysicalDevice = PhysicalDevice;
+  m_Device = Device;
+
+  //The shader binds a storage image per level and runs 256 invocations per work group, more than Vulkan guarantees.
+  VkPhysicalDeviceProperties Properties;
+  vkGetPhysicalDeviceProperties(PhysicalDevice, &Properties);
+  if(!IsSpirVCode(ShaderCode) || Properties.limits.maxPerStageDescriptorStorageImages < MaxLevelNum ||
+     Properties.limits.maxComputeWorkGroupInvocations < WorkGroupInvocationNum || Properties.limits.maxComputeWorkGroupSize[0] < WorkGroupInvocationNum)
+    return;
+
+  //Level 0 is sampled in the middle of 2 x 2 texels, the linear filter averages them.
+  SamplerState State;
+  State.Filter = VK_FILTER_LINEAR;
+  State.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  State.AddressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  State.MaxAnisotropy = 1.0f;
+  State.MaxLod = 0.0f;
+  m_Sampler = AcquireSampler(Device, State);
+
+  std::array<VkDescriptorSetLayoutBinding, MaxLevelNum + 2> Bindings = {};
+  for(uint32_t Binding = 0; Binding < Bindings.size(); ++Binding)
+  {
+    Bindings[Binding].binding = Binding;
+    Bindings[Binding].descriptorType = Binding == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER :
+                                       (Binding == CounterBinding ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+    Bindings[Binding].descriptorCount = 1;
+    Bindings[Binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  }
+
+  VkDescriptorSetLayoutCreateInfo LayoutCreateInfo = {};
+  LayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  LayoutCreateInfo.bindingCount = static_cast<uint32_t>(Bindings.size());
+  LayoutCreateInfo.pBindings = Bindings.data();
+
+  if(vkCreateDescriptorSetLayout(Device, &LayoutCreateInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create downsampler descriptor set layout!");
+
+  std::array<VkDescriptorPoolSize, 3> PoolSizes = {};
+  PoolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  PoolSizes[0].descriptorCount = MaxTargetNum;
+  PoolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  PoolSizes[1].descriptorCount = MaxTargetNum * MaxLevelNum;
+  PoolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  PoolSizes[2].descriptorCount = MaxTargetNum;
+
+  //Targets come and go with the images they belong to, their sets are freed one by one.
+  VkDescriptorPoolCreateInfo PoolCreateInfo = {};
+  PoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  PoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+  PoolCreateInfo.poolSizeCount = static_cast<uint32_t>(PoolSizes.size());
+  PoolCreateInfo.pPoolSizes = PoolSizes.data();
+  PoolCreateInfo.maxSets = MaxTargetNum;
+
+  if(vkCreateDescriptorPool(Device, &PoolCreateInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create downsampler descriptor pool!");
+
+  VkPushConstantRange PushConstantRange = {};
+  PushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  PushConstantRange.offset = 0;
+  PushConstantRange.size = sizeof(DownsampleParameters);
+
+  VkPipelineLayoutCreateInfo PipelineLayoutInfo = {};
+  PipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  PipelineLayoutInfo.setLayoutCount = 1;
+  PipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+  PipelineLayoutInfo.pushConstantRangeCount = 1;
+  PipelineLayoutInfo.pPushConstantRanges = &PushConstantRange;
+
+  if(vkCreatePipelineLayout(Device, &PipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create downsampler pipeline layout!");
+
+  VkShaderModule ShaderModule = CreateShaderModule(Device, ShaderCode);
+
+  VkComputePipelineCreateInfo PipelineInfo = {};
+  PipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  PipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  PipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  PipelineInfo.stage.module = ShaderModule;
+  PipelineInfo.stage.pName = "main";
+  PipelineInfo.layout = m_PipelineLayout;
+
+  VkResult Result = vkCreateComputePipelines(Device, VK_NULL_HANDLE, 1, &PipelineInfo, nullptr, &m_Pipeline);
+  vkDestroyShaderModule(Device, ShaderModule, nullptr);
+  if(Result != VK_SUCCESS)
+    throw std::runtime_error("Failed to create downsampler pipeline!");
+
+  //The counter starts at zero and every dispatch leaves it there, host visible memory saves a command to clear it.
+  CreateBuffer(PhysicalDevice, Device, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_CounterBuffer);
+  const uint32_t Zero = 0;
+  MapMemory(Device, m_CounterBuffer.Memory, sizeof(Zero), &Zero);
+}
+
+void MipDownsampler::Destroy()
+{
+  if(m_Device == VK_NULL_HANDLE)
+    return;
+
+  DestroyBuffer(m_Device, m_CounterBuffer);
+  m_CounterBuffer = BufferInfo();
+  vkDestroyPipeline(m_Device, m_Pipeline, nullptr);
+  vkDestroyPipelineLayout(m_Device, m_PipelineLayout, nullptr);
+  vkDestroyDescriptorPool(m_Device, m_DescriptorPool, nullptr);
+  vkDestroyDescriptorSetLayout(m_Device, m_DescriptorSetLayout, nullptr);
+  if(m_Sampler != VK_NULL_HANDLE)
+    ReleaseSampler(m_Device, m_Sampler);
+
+  m_Pipeline = VK_NULL_HANDLE;
+  m_PipelineLayout = VK_NULL_HANDLE;
+  m_DescriptorPool = VK_NULL_HANDLE;
+  m_DescriptorSetLayout = VK_NULL_HANDLE;
+  m_Sampler = VK_NULL_HANDLE;
+  m_Device = VK_NULL_HANDLE;
+}
+
+bool MipDownsampler::IsComputeSupported(VkFormat Format, uint32_t Width, uint32_t Height, uint32_t MipLevels) const
+{
+  //The shader stores "rgba8", and the last work group reduces at most 64 x 64 texels of level 6.
+  if(!IsComputeSupported() || Format != VK_FORMAT_R8G8B8A8_UNORM || MipLevels < 2 || MipLevels > MaxLevelNum + 1 || std::max(Width, Height) > (1u << MaxLevelNum))
+    return false;
+
+  VkFormatProperties FormatProperties;
+  vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, Format, &FormatProperties);
+  const VkFormatFeatureFlags Features = VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+  return (FormatProperties.optimalTilingFeatures & Features) == Features;
+}
+
+void MipDownsampler::CreateTarget(VkImage Image, VkFormat Format, uint32_t Width, uint32_t Height, uint32_t MipLevels, MIP_DOWNSAMPLE_PATH Path, MipTarget& Target)
+{
+  Target.Image = Image;
+  Target.Format = Format;
+  Target.Width = Width;
+  Target.Height = Height;
+  Target.MipLevels = MipLevels;
+  Target.Path = Path == MIP_DOWNSAMPLE_PATH_COMPUTE && IsComputeSupported(Format, Width, Height, MipLevels) ? MIP_DOWNSAMPLE_PATH_COMPUTE : MIP_DOWNSAMPLE_PATH_BLIT;
+
+  if(Target.Path == MIP_DOWNSAMPLE_PATH_BLIT)
+  {
+    VkFormatProperties FormatProperties;
+    vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, Format, &FormatProperties);
+
+    if(!(FormatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+      throw std::runtime_error("Texture image format does not support linear blitting!");
+    return;
+  }
+
+  Target.LevelViews.resize(MipLevels);
+  for(uint32_t Level = 0; Level < MipLevels; ++Level)
+    CreateLevelView(m_Device, Image, Format, Level, Target.LevelViews[Level]);
+
+  VkDescriptorSetAllocateInfo AllocInfo = {};
+  AllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  AllocInfo.descriptorPool = m_DescriptorPool;
+  AllocInfo.descriptorSetCount = 1;
+  AllocInfo.pSetLayouts = &m_DescriptorSetLayout;
+
+  if(vkAllocateDescriptorSets(m_Device, &AllocInfo, &Target.DescriptorSet) != VK_SUCCESS)
+    throw std::runtime_error("Failed to allocate downsampler descriptor set!");
+
+  //Every binding the shader declares needs a valid descriptor, the ones past the last level repeat it and are never stored to.
+  std::array<VkDescriptorImageInfo, MaxLevelNum + 1> ImageInfos = {};
+  ImageInfos[0].sampler = m_Sampler;
+  ImageInfos[0].imageView = Target.LevelViews[0];
+  ImageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  for(uint32_t Level = 1; Level <= MaxLevelNum; ++Level)
+  {
+    ImageInfos[Level].imageView = Target.LevelViews[std::min(Level, MipLevels - 1)];
+    ImageInfos[Level].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+  }
+
+  VkDescriptorBufferInfo CounterInfo = {};
+  CounterInfo.buffer = m_CounterBuffer.Buffer;
+  CounterInfo.offset = 0;
+  CounterInfo.range = sizeof(uint32_t);
+
+  std::array<VkWriteDescriptorSet, MaxLevelNum + 2> DescriptorWrites = {};
+  for(uint32_t Binding = 0; Binding < DescriptorWrites.size(); ++Binding)
+  {
+    DescriptorWrites[Binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    DescriptorWrites[Binding].dstSet = Target.DescriptorSet;
+    DescriptorWrites[Binding].dstBinding = Binding;
+    DescriptorWrites[Binding].dstArrayElement = 0;
+    DescriptorWrites[Binding].descriptorCount = 1;
+    if(Binding == CounterBinding)
+    {
+      DescriptorWrites[Binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      DescriptorWrites[Binding].pBufferInfo = &CounterInfo;
+    }
+    else
+    {
+      DescriptorWrites[Binding].descriptorType = Binding == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+      DescriptorWrites[Binding].pImageInfo = &ImageInfos[Binding];
+    }
+  }
+
+  vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(DescriptorWrites.size()), DescriptorWrites.data(), 0, nullptr);
+}
+
+void MipDownsampler::DestroyTarget(MipTarget& Target)
+{
+  if(Target.DescriptorSet != VK_NULL_HANDLE)
+    vkFreeDescriptorSets(m_Device, m_DescriptorPool, 1, &Target.DescriptorSet);
+
+  for(VkImageView View : Target.LevelViews)
+    vkDestroyImageView(m_Device, View, nullptr);
+
+  Target.LevelViews.clear();
+  Target.DescriptorSet = VK_NULL_HANDLE;
+  Target.Image = VK_NULL_HANDLE;
+}
+
+void MipDownsampler::Record(VkCommandBuffer CommandBuffer, const MipTarget& Target) const
+{
+  if(Target.Path == MIP_DOWNSAMPLE_PATH_COMPUTE)
+    RecordCompute(CommandBuffer, Target);
+  else
+    RecordBlit(CommandBuffer, Target);
+}
+
+void MipDownsampler::RecordCompute(VkCommandBuffer CommandBuffer, const MipTarget& Target) const
+{
+  //Level 0 is sampled, the others are stored to; the counter may still be in use by the dispatch of another target.
+  VkMemoryBarrier CounterBarrier = {};
+  CounterBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  CounterBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  CounterBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+  std::array<VkImageMemoryBarrier, 2> Barriers =
+  {
+    MakeLevelBarrier(Target.Image, 0, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT),
+    MakeLevelBarrier(Target.Image, 1, Target.MipLevels - 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL, 0, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT)
+  };
+
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                       1, &CounterBarrier, 0, nullptr, static_cast<uint32_t>(Barriers.size()), Barriers.data());
+
+  const uint32_t Level1Width = std::max(Target.Width >> 1, 1u);
+  const uint32_t Level1Height = std::max(Target.Height >> 1, 1u);
+  const uint32_t GroupCountX = (Level1Width + WorkGroupLevel1Size - 1) / WorkGroupLevel1Size;
+  const uint32_t GroupCountY = (Level1Height + WorkGroupLevel1Size - 1) / WorkGroupLevel1Size;
+
+  DownsampleParameters Parameters = {};
+  Parameters.Size[0] = Target.Width;
+  Parameters.Size[1] = Target.Height;
+  Parameters.LevelNum = Target.MipLevels - 1;
+  Parameters.WorkGroupNum = GroupCountX * GroupCountY;
+
+  vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+  vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &Target.DescriptorSet, 0, nullptr);
+  vkCmdPushConstants(CommandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Parameters), &Parameters);
+  vkCmdDispatch(CommandBuffer, GroupCountX, GroupCountY, 1);
+
+  VkImageMemoryBarrier Barrier = MakeLevelBarrier(Target.Image, 1, Target.MipLevels - 1, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                  VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+}
+
+void MipDownsampler::RecordBlit(VkCommandBuffer CommandBuffer, const MipTarget& Target) const
+{
+  int32_t MipWidth = static_cast<int32_t>(Target.Width);
+  int32_t MipHeight = static_cast<int32_t>(Target.Height);
+
+  for(uint32_t i = 1; i < Target.MipLevels; ++i)
+  {
+    VkImageMemoryBarrier Barrier = MakeLevelBarrier(Target.Image, i - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                    VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+
+    VkImageBlit Blit = {};
+    Blit.srcOffsets[0] = {0, 0, 0};
+    Blit.srcOffsets[1] = {MipWidth, MipHeight, 1};
+    Blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Blit.srcSubresource.mipLevel = i - 1;
+    Blit.srcSubresource.baseArrayLayer = 0;
+    Blit.srcSubresource.layerCount = 1;
+    Blit.dstOffsets[0] = {0, 0, 0};
+    Blit.dstOffsets[1] =
+    {
+      MipWidth > 1 ? MipWidth / 2 : 1,
+      MipHeight > 1 ? MipHeight / 2 : 1,
+      1
+    };
+    Blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Blit.dstSubresource.mipLevel = i;
+    Blit.dstSubresource.baseArrayLayer = 0;
+    Blit.dstSubresource.layerCount = 1;
+
+    vkCmdBlitImage(CommandBuffer, Target.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Target.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &Blit, VK_FILTER_LINEAR);
+
+    Barrier = MakeLevelBarrier(Target.Image, i - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                               VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+
+    if(MipWidth > 1)
+      MipWidth /= 2;
+
+    if(MipHeight > 1)
+      MipHeight /= 2;
+  }
+
+  VkImageMemoryBarrier Barrier = MakeLevelBarrier(Target.Image, Target.MipLevels - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                  VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+
+#include "Namespace.hpp"
+#include "VulkanHelper.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+enum MIP_DOWNSAMPLE_PATH
+{
+  MIP_DOWNSAMPLE_PATH_COMPUTE, //All levels in one dispatch of "Shaders/Downsample.comp".
+  MIP_DOWNSAMPLE_PATH_BLIT     //One blit per level, each waiting for the one before.
+};
+
+//An image whose levels are generated from level 0 on the GPU, e.g. a render target, with what the compute path binds.
+struct MipTarget
+{
+  VkImage Image = VK_NULL_HANDLE;
+  VkFormat Format = VK_FORMAT_UNDEFINED;
+  uint32_t Width = 1;
+  uint32_t Height = 1;
+  uint32_t MipLevels = 1;
+  MIP_DOWNSAMPLE_PATH Path = MIP_DOWNSAMPLE_PATH_BLIT;
+  //One view per level, only for the compute path.
+  std::vector<VkImageView> LevelViews;
+  VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+};
+
+/* Generates the mip levels of images that are created on the GPU (render targets, procedural maps), the textures loaded from
+ * files get theirs from the CPU (see "MipGenerator.hpp"). The compute path writes up to 12 levels in a single dispatch: every
+ * work group averages a 64 x 64 tile of level 0 down to level 6 in shared memory, and the last work group to finish (counted
+ * with an atomic in a buffer) goes on from level 6 to the smallest level, so there is no barrier between the levels. It needs
+ * an RGBA8 image of at most 4096 texels per side that can be sampled and stored to, otherwise the levels are blitted one by
+ * one like before. Both box filter each level from the one before. */
+class MipDownsampler
+{
+  public:
+  //"ShaderCode" is the SPIR-V of "Shaders/Downsample.comp", without it (or on devices it does not run on) every target blits.
+  void Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, const std::vector<char>& ShaderCode, uint32_t MaxTargetNum = 16);
+
+  void Destroy();
+
+  bool IsComputeSupported() const {return m_Pipeline != VK_NULL_HANDLE;}
+
+  //Whether the compute path can generate the levels of an image, it has to be created with sampled and storage usage as well.
+  bool IsComputeSupported(VkFormat Format, uint32_t Width, uint32_t Height, uint32_t MipLevels) const;
+
+  //Prefers "Path", the compute path falls back to blitting if the image is not supported.
+  void CreateTarget(VkImage Image, VkFormat Format, uint32_t Width, uint32_t Height, uint32_t MipLevels, MIP_DOWNSAMPLE_PATH Path, MipTarget& Target);
+
+  void DestroyTarget(MipTarget& Target);
+
+  /* Record the generation of all levels after level 0. All levels are expected in "VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL", with
+   * level 0 written by a transfer, and are left in "VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL" for the fragment shader. */
+  void Record(VkCommandBuffer CommandBuffer, const MipTarget& Target) const;
+
+  protected:
+  void RecordCompute(VkCommandBuffer CommandBuffer, const MipTarget& Target) const;
+
+  void RecordBlit(VkCommandBuffer CommandBuffer, const MipTarget& Target) const;
+
+  VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+  VkDevice m_Device = VK_NULL_HANDLE;
+
+  VkSampler m_Sampler = VK_NULL_HANDLE;
+  VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
+  VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+  VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+  VkPipeline m_Pipeline = VK_NULL_HANDLE;
+  //The work groups of a dispatch that are done, shared by all targets and back at zero after every dispatch.
+  BufferInfo m_CounterBuffer;
+};
+
+NAMESPACE_END
\ No newline at end of file
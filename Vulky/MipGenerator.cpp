@@ -0,0 +1,334 @@
+#include "MipGenerator.hpp"
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define MIP_SIMD_AVX2
+  #define MIP_SIMD_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define MIP_SIMD_SSE2
+#endif
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  const double Pi = 3.14159265358979323846;
+  //The support of the Kaiser filter in texels of the smaller level, and the shape of its window.
+  const double KaiserRadius = 3.0;
+  const double KaiserAlpha = 4.0;
+  //Levels with fewer texels than this are not worth a thread of their own.
+  const size_t MinParallelTexelNum = 256 * 256;
+
+  //The texels of the larger level every texel of the smaller one is filtered from along one axis, with normalized weights.
+  struct FilterTaps
+  {
+    std::vector<uint32_t> Begin; //Into "Indices" and "Weights", one more than there are texels.
+    std::vector<uint32_t> Indices; //Wrapped around the border.
+    std::vector<float> Weights;
+    uint32_t MaxTapNum = 0;
+  };
+
+  double BesselI0(double x)
+  {
+    double Sum = 1.0, Term = 1.0;
+    for(int k = 1; k < 64 && Term > Sum * 1e-12; ++k)
+    {
+      double Factor = x * 0.5 / k;
+      Term *= Factor * Factor;
+      Sum += Term;
+    }
+
+    return Sum;
+  }
+
+  double Kaiser(double x)
+  {
+    if(std::abs(x) >= KaiserRadius)
+      return 0.0;
+
+    double Sinc = x == 0.0 ? 1.0 : std::sin(Pi * x) / (Pi * x);
+    double t = x / KaiserRadius;
+    return Sinc * BesselI0(KaiserAlpha * std::sqrt(1.0 - t * t)) / BesselI0(KaiserAlpha);
+  }
+
+  //Odd sizes make the smaller level cover a little more than two texels per texel, so the taps are computed for every texel.
+  FilterTaps MakeFilterTaps(uint32_t SourceSize, uint32_t Size, MIP_FILTER Filter)
+  {
+    FilterTaps Taps;
+    double Scale = static_cast<double>(SourceSize) / Size;
+
+    for(uint32_t i = 0; i < Size; ++i)
+    {
+      uint32_t First = static_cast<uint32_t>(Taps.Weights.size());
+      Taps.Begin.push_back(First);
+
+      double Center = (i + 0.5) * Scale;
+      double Radius = Filter == MIP_FILTER_BOX ? 0.5 * Scale : KaiserRadius * Scale;
+      int64_t Low = static_cast<int64_t>(std::floor(Center - Radius));
+      int64_t High = static_cast<int64_t>(std::ceil(Center + Radius));
+
+      double Sum = 0.0;
+      std::vector<double> Weights;
+      for(int64_t j = Low; j < High; ++j)
+      {
+        double Weight = Filter == MIP_FILTER_BOX ? std::min(Center + Radius, j + 1.0) - std::max(Center - Radius, static_cast<double>(j)) : Kaiser((j + 0.5 - Center) / Scale);
+        if(Weight == 0.0)
+          continue;
+
+        Taps.Indices.push_back(static_cast<uint32_t>((j % SourceSize + SourceSize) % SourceSize));
+        Weights.push_back(Weight);
+        Sum += Weight;
+      }
+
+      for(double Weight : Weights)
+        Taps.Weights.push_back(static_cast<float>(Weight / Sum));
+
+      Taps.MaxTapNum = std::max(Taps.MaxTapNum, static_cast<uint32_t>(Taps.Weights.size()) - First);
+    }
+
+    Taps.Begin.push_back(static_cast<uint32_t>(Taps.Weights.size()));
+    return Taps;
+  }
+
+  //Turn 8 bit texels into the space they are filtered in and back.
+  struct TexelCodec
+  {
+    std::array<float, 256> DecodeColor;
+    std::array<float, 256> DecodeAlpha;
+    //The linear values halfway between two sRGB codes, a binary search in them rounds to the nearest code.
+    std::array<float, 255> SrgbThresholds;
+    MIP_CONTENT Content;
+
+    explicit TexelCodec(MIP_CONTENT ContentType) : Content(ContentType)
+    {
+      for(int i = 0; i < 256; ++i)
+      {
+        float Value = i / 255.0f;
+        DecodeAlpha[i] = Value;
+
+        if(Content == MIP_CONTENT_SRGB)
+          DecodeColor[i] = Value <= 0.04045f ? Value / 12.92f : std::pow((Value + 0.055f) / 1.055f, 2.4f);
+        else if(Content == MIP_CONTENT_NORMAL)
+          DecodeColor[i] = Value * 2.0f - 1.0f;
+        else
+          DecodeColor[i] = Value;
+      }
+
+      for(int i = 0; i < 255; ++i)
+        SrgbThresholds[i] = 0.5f * (DecodeColor[i] + DecodeColor[i + 1]);
+    }
+
+    void DecodeRow(const uint8_t* pTexels, uint32_t Width, float* pRow) const
+    {
+      for(size_t i = 0; i < static_cast<size_t>(Width) * 4; i += 4)
+      {
+        pRow[i] = DecodeColor[pTexels[i]];
+        pRow[i + 1] = DecodeColor[pTexels[i + 1]];
+        pRow[i + 2] = DecodeColor[pTexels[i + 2]];
+        pRow[i + 3] = DecodeAlpha[pTexels[i + 3]];
+      }
+    }
+
+    static uint8_t ToUnorm8(float Value) {return static_cast<uint8_t>(std::clamp(Value, 0.0f, 1.0f) * 255.0f + 0.5f);}
+
+    void EncodeTexel(const float* pTexel, uint8_t* pOut) const
+    {
+      float Color[3] = {pTexel[0], pTexel[1], pTexel[2]};
+
+      if(Content == MIP_CONTENT_NORMAL)
+      {
+        //Filtering shortens the normals where they diverge, the shader expects unit length.
+        float Length = std::sqrt(Color[0] * Color[0] + Color[1] * Color[1] + Color[2] * Color[2]);
+        if(Length > 1e-6f)
+        {
+          for(float& Channel : Color)
+            Channel /= Length;
+        }
+        else
+        {
+          Color[0] = 0.0f;
+          Color[1] = 0.0f;
+          Color[2] = 1.0f;
+        }
+
+        for(float& Channel : Color)
+          Channel = Channel * 0.5f + 0.5f;
+      }
+
+      for(int i = 0; i < 3; ++i)
+      {
+        if(Content == MIP_CONTENT_SRGB)
+          pOut[i] = static_cast<uint8_t>(std::upper_bound(SrgbThresholds.begin(), SrgbThresholds.end(), Color[i]) - SrgbThresholds.begin());
+        else
+          pOut[i] = ToUnorm8(Color[i]);
+      }
+
+      pOut[3] = ToUnorm8(pTexel[3]);
+    }
+  };
+
+  //"pOut[i] += Weight * pIn[i]", "Num" is a multiple of 4.
+  void MultiplyAdd(float* pOut, const float* pIn, float Weight, size_t Num)
+  {
+    size_t i = 0;
+
+#if defined(MIP_SIMD_AVX2)
+    __m256 Weight8 = _mm256_set1_ps(Weight);
+    for(; i + 8 <= Num; i += 8)
+      _mm256_storeu_ps(pOut + i, _mm256_add_ps(_mm256_loadu_ps(pOut + i), _mm256_mul_ps(_mm256_loadu_ps(pIn + i), Weight8)));
+#endif
+
+#if defined(MIP_SIMD_SSE2)
+    __m128 Weight4 = _mm_set1_ps(Weight);
+    for(; i + 4 <= Num; i += 4)
+      _mm_storeu_ps(pOut + i, _mm_add_ps(_mm_loadu_ps(pOut + i), _mm_mul_ps(_mm_loadu_ps(pIn + i), Weight4)));
+#endif
+
+    for(; i < Num; ++i)
+      pOut[i] += Weight * pIn[i];
+  }
+
+  //One RGBA texel filtered from the texels of a row, a texel is exactly one SSE register.
+  void FilterTexel(const float* pRow, const uint32_t* pIndices, const float* pWeights, uint32_t TapNum, float* pOut)
+  {
+#if defined(MIP_SIMD_SSE2)
+    __m128 Sum = _mm_setzero_ps();
+    for(uint32_t k = 0; k < TapNum; ++k)
+      Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_loadu_ps(pRow + static_cast<size_t>(pIndices[k]) * 4), _mm_set1_ps(pWeights[k])));
+    _mm_storeu_ps(pOut, Sum);
+#else
+    float Sum[4] = {};
+    for(uint32_t k = 0; k < TapNum; ++k)
+    {
+      for(int Channel = 0; Channel < 4; ++Channel)
+        Sum[Channel] += pWeights[k] * pRow[static_cast<size_t>(pIndices[k]) * 4 + Channel];
+    }
+    std::copy(Sum, Sum + 4, pOut);
+#endif
+  }
+
+  /* Hands out the rows of the larger level in linear floating point. The first level is decoded from its 8 bit texels on
+   * demand: the rows a thread needs slide down with the rows it filters, so the least recently used row is replaced and
+   * every row is decoded about once per thread instead of once per tap. */
+  class SourceRows
+  {
+    public:
+    SourceRows(const uint8_t* pTexels, const float* pRows, uint32_t Width, const TexelCodec& Codec, uint32_t CacheRowNum) :
+      m_pTexels(pTexels), m_pRows(pRows), m_Width(Width), m_Codec(Codec)
+    {
+      if(m_pRows == nullptr)
+      {
+        m_Cache.resize(static_cast<size_t>(CacheRowNum) * Width * 4);
+        m_CachedRows.assign(CacheRowNum, UINT32_MAX);
+        m_LastUses.assign(CacheRowNum, 0);
+      }
+    }
+
+    const float* Get(uint32_t y)
+    {
+      size_t RowSize = static_cast<size_t>(m_Width) * 4;
+      if(m_pRows != nullptr)
+        return m_pRows + y * RowSize;
+
+      ++m_Time;
+
+      size_t Slot = 0;
+      for(size_t i = 0; i < m_CachedRows.size(); ++i)
+      {
+        if(m_CachedRows[i] == y)
+        {
+          m_LastUses[i] = m_Time;
+          return m_Cache.data() + i * RowSize;
+        }
+
+        if(m_LastUses[i] < m_LastUses[Slot])
+          Slot = i;
+      }
+
+      m_Codec.DecodeRow(m_pTexels + y * RowSize, m_Width, m_Cache.data() + Slot * RowSize);
+      m_CachedRows[Slot] = y;
+      m_LastUses[Slot] = m_Time;
+      return m_Cache.data() + Slot * RowSize;
+    }
+
+    protected:
+    const uint8_t* m_pTexels;
+    const float* m_pRows;
+    uint32_t m_Width;
+    const TexelCodec& m_Codec;
+
+    std::vector<float> m_Cache;
+    std::vector<uint32_t> m_CachedRows;
+    std::vector<uint64_t> m_LastUses;
+    uint64_t m_Time = 0;
+  };
+}
+
+void GenerateMipChain(const uint8_t* pPixels, uint32_t Width, uint32_t Height, MIP_CONTENT Content, MIP_FILTER Filter, MipChain& Chain, uint32_t ThreadNum)
+{
+  if(pPixels == nullptr || Width == 0 || Height == 0)
+    throw std::runtime_error("Cannot generate the mip chain of an empty image!");
+
+  if(ThreadNum == 0)
+    ThreadNum = std::max(std::thread::hardware_concurrency(), 1u);
+
+  TexelCodec Codec(Content);
+
+  Chain.Levels.assign(1, std::vector<uint8_t>(pPixels, pPixels + static_cast<size_t>(Width) * Height * 4));
+  Chain.Widths.assign(1, Width);
+  Chain.Heights.assign(1, Height);
+
+  //The previous level in linear floating point, empty while it is the first one, which is decoded from "pPixels".
+  std::vector<float> Previous, Current;
+
+  while(Chain.Widths.back() > 1 || Chain.Heights.back() > 1)
+  {
+    uint32_t SourceWidth = Chain.Widths.back(), SourceHeight = Chain.Heights.back();
+    uint32_t MipWidth = std::max(SourceWidth / 2, 1u), MipHeight = std::max(SourceHeight / 2, 1u);
+
+    FilterTaps TapsX = MakeFilterTaps(SourceWidth, MipWidth, Filter);
+    FilterTaps TapsY = MakeFilterTaps(SourceHeight, MipHeight, Filter);
+
+    std::vector<uint8_t> Level(static_cast<size_t>(MipWidth) * MipHeight * 4);
+    Current.resize(static_cast<size_t>(MipWidth) * MipHeight * 4);
+
+    size_t TaskNum = static_cast<size_t>(MipWidth) * MipHeight >= MinParallelTexelNum ? ThreadNum : 1;
+    ParallelFor(MipHeight, TaskNum, [&](size_t Begin, size_t End)
+    {
+      SourceRows Rows(Previous.empty() ? pPixels : nullptr, Previous.empty() ? nullptr : Previous.data(), SourceWidth, Codec, TapsY.MaxTapNum + 2);
+      std::vector<float> Column(static_cast<size_t>(SourceWidth) * 4);
+
+      for(size_t y = Begin; y < End; ++y)
+      {
+        //Vertically into a row of the width of the larger level first, the contiguous rows keep the vector units busy.
+        std::fill(Column.begin(), Column.end(), 0.0f);
+        for(uint32_t k = TapsY.Begin[y]; k < TapsY.Begin[y + 1]; ++k)
+          MultiplyAdd(Column.data(), Rows.Get(TapsY.Indices[k]), TapsY.Weights[k], Column.size());
+
+        float* pRow = Current.data() + y * MipWidth * 4;
+        uint8_t* pLevelRow = Level.data() + y * MipWidth * 4;
+        for(uint32_t x = 0; x < MipWidth; ++x)
+        {
+          FilterTexel(Column.data(), &TapsX.Indices[TapsX.Begin[x]], &TapsX.Weights[TapsX.Begin[x]], TapsX.Begin[x + 1] - TapsX.Begin[x], pRow + x * 4);
+          Codec.EncodeTexel(pRow + x * 4, pLevelRow + x * 4);
+        }
+      }
+    });
+
+    Previous.swap(Current);
+
+    Chain.Levels.push_back(std::move(Level));
+    Chain.Widths.push_back(MipWidth);
+    Chain.Heights.push_back(MipHeight);
+  }
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//How the color channels of a texture are filtered, alpha is always filtered as it is stored.
+enum MIP_CONTENT
+{
+  MIP_CONTENT_LINEAR, //Data like metallic, roughness or ambient occlusion.
+  MIP_CONTENT_SRGB,   //Colors authored in sRGB, filtered in linear space and encoded again.
+  MIP_CONTENT_NORMAL  //Tangent space normals mapped to [0, 1], filtered as vectors and renormalized.
+};
+
+enum MIP_FILTER
+{
+  MIP_FILTER_BOX,   //The area average of the texels a texel of the smaller level covers.
+  MIP_FILTER_KAISER //A Kaiser windowed sinc, sharper than the box and with less aliasing.
+};
+
+//All levels of an RGBA8 texture from the largest to the smallest one, each with tightly packed rows.
+struct MipChain
+{
+  std::vector<std::vector<uint8_t>> Levels;
+  std::vector<uint32_t> Widths;
+  std::vector<uint32_t> Heights;
+};
+
+/* Build the full mip chain of an RGBA8 image on the CPU, so the levels can be copied into the image with a single command
+ * (or baked into an asset archive) instead of being blitted on the GPU. Every level is filtered from the previous one kept in
+ * linear floating point, never from quantized texels. The filters repeat at the borders like the samplers of the textures.
+ * The levels depend on each other, the rows of a level are split across "ThreadNum" threads (zero picks a number based on
+ * the hardware) and filtered with SSE2 or AVX2 where the compiler targets them. */
+void GenerateMipChain(const uint8_t* pPixels, uint32_t Width, uint32_t Height, MIP_CONTENT Content, MIP_FILTER Filter, MipChain& Chain, uint32_t ThreadNum = 0);
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,495 @@
+#include "ObjLoader.hpp"
+#include "MappedFile.hpp"
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  const uint32_t MissingIndex = UINT32_MAX;
+  const uint32_t InheritedMaterial = UINT32_MAX;
+  const int32_t MissingCorner = INT32_MIN;
+  //Negative indices count back from the last element, which may lie in an earlier chunk. They are stored biased by this until the chunk offsets are known.
+  const int32_t RelativeIndexBias = 1 << 30;
+  //Chunks smaller than this are not worth a thread of their own.
+  const size_t MinChunkSize = 1024 * 1024;
+
+  struct ObjCorner
+  {
+    int32_t Position;
+    int32_t TexCoord;
+    int32_t Normal;
+  };
+
+  struct VertexKey
+  {
+    uint32_t Position;
+    uint32_t TexCoord;
+    uint32_t Normal;
+
+    bool operator==(const VertexKey& Rhs) const {return Position == Rhs.Position && TexCoord == Rhs.TexCoord && Normal == Rhs.Normal;}
+  };
+
+  struct ObjChunk
+  {
+    const char* pBegin = nullptr;
+    const char* pEnd = nullptr;
+
+    std::vector<glm::vec3> Positions;
+    std::vector<glm::vec2> TexCoords;
+    std::vector<glm::vec3> Normals;
+    std::vector<ObjCorner> Corners; //Three per triangle.
+    std::vector<uint32_t> TriangleMaterials; //Into "MaterialNames", or "InheritedMaterial" before the first "usemtl" of the chunk.
+    std::vector<std::string> MaterialNames;
+    uint32_t LastMaterial = InheritedMaterial; //The material the next chunk continues with.
+
+    size_t PositionOffset = 0;
+    size_t TexCoordOffset = 0;
+    size_t NormalOffset = 0;
+    size_t CornerOffset = 0;
+
+    //The distinct corners of the chunk, and the index of every corner into them.
+    std::vector<VertexKey> UniqueKeys;
+    std::vector<uint32_t> LocalIndices;
+  };
+
+  //Linear probing in a table of at most 50 % load, the keys are stored densely in the order of insertion.
+  class VertexKeyTable
+  {
+    public:
+    explicit VertexKeyTable(size_t MaxKeyNum)
+    {
+      size_t Capacity = 16;
+      while(Capacity < MaxKeyNum * 2)
+        Capacity *= 2;
+
+      m_Slots.assign(Capacity, MissingIndex);
+      m_Mask = Capacity - 1;
+      m_Keys.reserve(MaxKeyNum);
+    }
+
+    //Returns the index of the key, which is added if it is not in the table yet.
+    uint32_t Insert(const VertexKey& Key)
+    {
+      uint64_t Hash = static_cast<uint64_t>(Key.Position) * 0x9E3779B185EBCA87ull ^
+                      static_cast<uint64_t>(Key.TexCoord) * 0xC2B2AE3D27D4EB4Full ^
+                      static_cast<uint64_t>(Key.Normal) * 0x165667B19E3779F9ull;
+      Hash ^= Hash >> 32;
+
+      for(size_t SlotIndex = Hash & m_Mask; ; SlotIndex = (SlotIndex + 1) & m_Mask)
+      {
+        uint32_t& Slot = m_Slots[SlotIndex];
+        if(Slot == MissingIndex)
+        {
+          Slot = static_cast<uint32_t>(m_Keys.size());
+          m_Keys.push_back(Key);
+          return Slot;
+        }
+
+        if(m_Keys[Slot] == Key)
+          return Slot;
+      }
+    }
+
+    std::vector<VertexKey>& GetKeys() {return m_Keys;}
+
+    protected:
+    std::vector<uint32_t> m_Slots;
+    std::vector<VertexKey> m_Keys;
+    size_t m_Mask = 0;
+  };
+
+  bool IsSpace(char Character) {return Character == ' ' || Character == '\t';}
+
+  bool IsDigit(char Character) {return static_cast<unsigned>(Character - '0') < 10;}
+
+  const char* SkipSpaces(const char* p, const char* pEnd)
+  {
+    while(p < pEnd && IsSpace(*p))
+      ++p;
+    return p;
+  }
+
+  const char* SkipLine(const char* p, const char* pEnd)
+  {
+    while(p < pEnd && *p != '\n')
+      ++p;
+    return p < pEnd ? p + 1 : pEnd;
+  }
+
+  double PowerOfTen(int Exponent)
+  {
+    //Powers up to 10^22 are exact in double precision, so multiplying or dividing by them rounds only once.
+    static const double Table[] =
+    {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    return Exponent <= 22 ? Table[Exponent] : std::pow(10.0, Exponent);
+  }
+
+  /* Parse a decimal number without "strtod", which is locale dependent and slow. Up to 19 significant digits are gathered
+   * in an integer, so the loop is a multiply-add per digit, and the decimal exponent is applied once at the end. */
+  float ParseFloat(const char*& p, const char* pEnd)
+  {
+    p = SkipSpaces(p, pEnd);
+
+    bool bNegative = false;
+    if(p < pEnd && (*p == '-' || *p == '+'))
+      bNegative = *p++ == '-';
+
+    uint64_t Mantissa = 0;
+    int DigitNum = 0;
+    int Exponent = 0;
+
+    for(; p < pEnd && IsDigit(*p); ++p)
+    {
+      if(DigitNum < 19)
+      {
+        Mantissa = Mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        DigitNum += Mantissa != 0;
+      }
+      else
+        ++Exponent;
+    }
+
+    if(p < pEnd && *p == '.')
+    {
+      for(++p; p < pEnd && IsDigit(*p); ++p)
+      {
+        if(DigitNum < 19)
+        {
+          Mantissa = Mantissa * 10 + static_cast<uint64_t>(*p - '0');
+          DigitNum += Mantissa != 0;
+          --Exponent;
+        }
+      }
+    }
+
+    if(p < pEnd && (*p == 'e' || *p == 'E'))
+    {
+      ++p;
+      bool bNegativeExponent = false;
+      if(p < pEnd && (*p == '-' || *p == '+'))
+        bNegativeExponent = *p++ == '-';
+
+      int ExplicitExponent = 0;
+      for(; p < pEnd && IsDigit(*p); ++p)
+        ExplicitExponent = std::min(ExplicitExponent * 10 + (*p - '0'), 1000);
+
+      Exponent += bNegativeExponent ? -ExplicitExponent : ExplicitExponent;
+    }
+
+    double Value = static_cast<double>(Mantissa);
+    if(Exponent < 0)
+      Value /= PowerOfTen(-Exponent);
+    else if(Exponent > 0)
+      Value *= PowerOfTen(Exponent);
+
+    return static_cast<float>(bNegative ? -Value : Value);
+  }
+
+  //Absolute indices are made zero based, relative ones are stored biased, see "RelativeIndexBias".
+  int32_t ParseCornerIndex(const char*& p, const char* pEnd, size_t LocalNum)
+  {
+    bool bNegative = false;
+    if(p < pEnd && (*p == '-' || *p == '+'))
+      bNegative = *p++ == '-';
+
+    int64_t Value = 0;
+    const char* pDigits = p;
+    for(; p < pEnd && IsDigit(*p); ++p)
+      Value = std::min<int64_t>(Value * 10 + (*p - '0'), RelativeIndexBias);
+
+    if(p == pDigits || Value == 0 || Value >= RelativeIndexBias || LocalNum >= static_cast<size_t>(RelativeIndexBias))
+      throw std::runtime_error("Invalid face in OBJ file!");
+
+    return static_cast<int32_t>(bNegative ? static_cast<int64_t>(LocalNum) - Value - RelativeIndexBias : Value - 1);
+  }
+
+  void ParseFace(const char*& p, const char* pEnd, ObjChunk& Chunk, uint32_t Material, std::vector<ObjCorner>& Polygon)
+  {
+    Polygon.clear();
+
+    while(true)
+    {
+      p = SkipSpaces(p, pEnd);
+      if(p >= pEnd || !(IsDigit(*p) || *p == '-' || *p == '+'))
+        break;
+
+      ObjCorner Corner = {MissingCorner, MissingCorner, MissingCorner};
+      Corner.Position = ParseCornerIndex(p, pEnd, Chunk.Positions.size());
+      if(p < pEnd && *p == '/')
+      {
+        ++p;
+        if(p < pEnd && *p != '/')
+          Corner.TexCoord = ParseCornerIndex(p, pEnd, Chunk.TexCoords.size());
+
+        if(p < pEnd && *p == '/')
+        {
+          ++p;
+          Corner.Normal = ParseCornerIndex(p, pEnd, Chunk.Normals.size());
+        }
+      }
+
+      Polygon.push_back(Corner);
+    }
+
+    for(size_t i = 2; i < Polygon.size(); ++i)
+    {
+      Chunk.Corners.push_back(Polygon[0]);
+      Chunk.Corners.push_back(Polygon[i - 1]);
+      Chunk.Corners.push_back(Polygon[i]);
+      Chunk.TriangleMaterials.push_back(Material);
+    }
+  }
+
+  uint32_t ParseMaterial(const char* p, const char* pEnd, ObjChunk& Chunk)
+  {
+    p = SkipSpaces(p, pEnd);
+    const char* pNameEnd = p;
+    while(pNameEnd < pEnd && *pNameEnd != '\n' && *pNameEnd != '\r')
+      ++pNameEnd;
+    while(pNameEnd > p && IsSpace(pNameEnd[-1]))
+      --pNameEnd;
+
+    std::string Name(p, pNameEnd);
+    auto Iter = std::find(Chunk.MaterialNames.begin(), Chunk.MaterialNames.end(), Name);
+    if(Iter != Chunk.MaterialNames.end())
+      return static_cast<uint32_t>(Iter - Chunk.MaterialNames.begin());
+
+    Chunk.MaterialNames.push_back(Name);
+    return static_cast<uint32_t>(Chunk.MaterialNames.size() - 1);
+  }
+
+  void ParseChunk(ObjChunk& Chunk)
+  {
+    const char* p = Chunk.pBegin;
+    const char* pEnd = Chunk.pEnd;
+    uint32_t Material = InheritedMaterial;
+    std::vector<ObjCorner> Polygon;
+
+    while(p < pEnd)
+    {
+      p = SkipSpaces(p, pEnd);
+      size_t Remaining = static_cast<size_t>(pEnd - p);
+
+      if(Remaining > 2 && p[0] == 'v' && IsSpace(p[1]))
+      {
+        p += 2;
+        glm::vec3 Position;
+        Position.x = ParseFloat(p, pEnd);
+        Position.y = ParseFloat(p, pEnd);
+        Position.z = ParseFloat(p, pEnd);
+        Chunk.Positions.push_back(Position);
+      }
+      else if(Remaining > 3 && p[0] == 'v' && p[1] == 't' && IsSpace(p[2]))
+      {
+        p += 3;
+        glm::vec2 TexCoord;
+        TexCoord.x = ParseFloat(p, pEnd);
+        TexCoord.y = ParseFloat(p, pEnd);
+        Chunk.TexCoords.push_back(TexCoord);
+      }
+      else if(Remaining > 3 && p[0] == 'v' && p[1] == 'n' && IsSpace(p[2]))
+      {
+        p += 3;
+        glm::vec3 Normal;
+        Normal.x = ParseFloat(p, pEnd);
+        Normal.y = ParseFloat(p, pEnd);
+        Normal.z = ParseFloat(p, pEnd);
+        Chunk.Normals.push_back(Normal);
+      }
+      else if(Remaining > 2 && p[0] == 'f' && IsSpace(p[1]))
+      {
+        p += 2;
+        ParseFace(p, pEnd, Chunk, Material, Polygon);
+      }
+      else if(Remaining > 7 && std::equal(p, p + 6, "usemtl") && IsSpace(p[6]))
+        Material = ParseMaterial(p + 7, pEnd, Chunk);
+
+      p = SkipLine(p, pEnd);
+    }
+
+    Chunk.LastMaterial = Material;
+  }
+
+  uint32_t ResolveIndex(int32_t Corner, size_t Offset, size_t Num)
+  {
+    if(Corner == MissingCorner)
+      return MissingIndex;
+
+    int64_t Index = Corner;
+    if(Index < 0)
+      Index += RelativeIndexBias + static_cast<int64_t>(Offset);
+
+    if(Index < 0 || Index >= static_cast<int64_t>(Num))
+      throw std::runtime_error("Invalid index in OBJ file!");
+
+    return static_cast<uint32_t>(Index);
+  }
+
+  //Resolve the corners of a chunk to global attribute indices and deduplicate them.
+  void DeduplicateChunk(ObjChunk& Chunk, size_t PositionNum, size_t TexCoordNum, size_t NormalNum)
+  {
+    VertexKeyTable Table(Chunk.Corners.size());
+
+    Chunk.LocalIndices.resize(Chunk.Corners.size());
+    for(size_t i = 0; i < Chunk.Corners.size(); ++i)
+    {
+      const ObjCorner& Corner = Chunk.Corners[i];
+
+      VertexKey Key = {};
+      Key.Position = ResolveIndex(Corner.Position, Chunk.PositionOffset, PositionNum);
+      Key.TexCoord = ResolveIndex(Corner.TexCoord, Chunk.TexCoordOffset, TexCoordNum);
+      Key.Normal = ResolveIndex(Corner.Normal, Chunk.NormalOffset, NormalNum);
+      Chunk.LocalIndices[i] = Table.Insert(Key);
+    }
+
+    Chunk.UniqueKeys.swap(Table.GetKeys());
+    Chunk.Corners = std::vector<ObjCorner>();
+  }
+}
+
+void LoadObj(const std::string& Path, ObjModel& Model, uint32_t ThreadNum)
+{
+  MappedFile File(Path);
+  const char* pData = File.GetData();
+  const char* pDataEnd = pData + File.GetSize();
+
+  if(ThreadNum == 0)
+    ThreadNum = std::max(std::thread::hardware_concurrency(), 1u);
+
+  //Line aligned chunks: every chunk but the first starts after a line feed.
+  size_t ChunkNum = std::clamp<size_t>(File.GetSize() / MinChunkSize, 1, ThreadNum);
+  std::vector<ObjChunk> Chunks(ChunkNum);
+  for(size_t i = 0; i < ChunkNum; ++i)
+  {
+    Chunks[i].pBegin = i == 0 ? pData : Chunks[i - 1].pEnd;
+    Chunks[i].pEnd = i + 1 == ChunkNum ? pDataEnd : std::max(Chunks[i].pBegin, SkipLine(pData + File.GetSize() * (i + 1) / ChunkNum, pDataEnd));
+  }
+
+  ParallelFor(ChunkNum, ChunkNum, [&](size_t Begin, size_t End)
+  {
+    for(size_t i = Begin; i < End; ++i)
+      ParseChunk(Chunks[i]);
+  });
+
+  size_t PositionNum = 0, TexCoordNum = 0, NormalNum = 0, CornerNum = 0;
+  for(auto& Chunk : Chunks)
+  {
+    Chunk.PositionOffset = PositionNum;
+    Chunk.TexCoordOffset = TexCoordNum;
+    Chunk.NormalOffset = NormalNum;
+    Chunk.CornerOffset = CornerNum;
+    PositionNum += Chunk.Positions.size();
+    TexCoordNum += Chunk.TexCoords.size();
+    NormalNum += Chunk.Normals.size();
+    CornerNum += Chunk.Corners.size();
+  }
+
+  if(CornerNum > UINT32_MAX)
+    throw std::runtime_error("OBJ file has too many faces!");
+
+  ParallelFor(ChunkNum, ChunkNum, [&](size_t Begin, size_t End)
+  {
+    for(size_t i = Begin; i < End; ++i)
+      DeduplicateChunk(Chunks[i], PositionNum, TexCoordNum, NormalNum);
+  });
+
+  //Merge the distinct corners of all chunks and the materials, a chunk continues with the material the one before ended with.
+  size_t ChunkKeyNum = 0;
+  for(const auto& Chunk : Chunks)
+    ChunkKeyNum += Chunk.UniqueKeys.size();
+
+  VertexKeyTable Table(ChunkKeyNum);
+  std::vector<std::vector<uint32_t>> ChunkRemaps(ChunkNum);
+  std::vector<std::vector<uint32_t>> ChunkMaterials(ChunkNum);
+
+  Model.MaterialNames.assign(1, "");
+  uint32_t CurrentMaterial = 0;
+  for(size_t i = 0; i < ChunkNum; ++i)
+  {
+    ObjChunk& Chunk = Chunks[i];
+
+    ChunkRemaps[i].resize(Chunk.UniqueKeys.size());
+    for(size_t Key = 0; Key < Chunk.UniqueKeys.size(); ++Key)
+      ChunkRemaps[i][Key] = Table.Insert(Chunk.UniqueKeys[Key]);
+    Chunk.UniqueKeys = std::vector<VertexKey>();
+
+    for(const auto& Name : Chunk.MaterialNames)
+    {
+      auto Iter = std::find(Model.MaterialNames.begin(), Model.MaterialNames.end(), Name);
+      ChunkMaterials[i].push_back(static_cast<uint32_t>(Iter - Model.MaterialNames.begin()));
+      if(Iter == Model.MaterialNames.end())
+        Model.MaterialNames.push_back(Name);
+    }
+
+    for(uint32_t& Material : Chunk.TriangleMaterials)
+      Material = Material == InheritedMaterial ? CurrentMaterial : ChunkMaterials[i][Material];
+
+    if(Chunk.LastMaterial != InheritedMaterial)
+      CurrentMaterial = ChunkMaterials[i][Chunk.LastMaterial];
+  }
+
+  const std::vector<VertexKey>& Keys = Table.GetKeys();
+
+  Model.Indices.resize(CornerNum);
+  Model.TriangleMaterials.resize(CornerNum / 3);
+  Model.Vertices.resize(Keys.size());
+
+  ParallelFor(ChunkNum, ChunkNum, [&](size_t Begin, size_t End)
+  {
+    for(size_t i = Begin; i < End; ++i)
+    {
+      const ObjChunk& Chunk = Chunks[i];
+      for(size_t Corner = 0; Corner < Chunk.LocalIndices.size(); ++Corner)
+        Model.Indices[Chunk.CornerOffset + Corner] = ChunkRemaps[i][Chunk.LocalIndices[Corner]];
+
+      std::copy(Chunk.TriangleMaterials.begin(), Chunk.TriangleMaterials.end(), Model.TriangleMaterials.begin() + Chunk.CornerOffset / 3);
+    }
+  });
+
+  //The attributes of every vertex are looked up in the chunk that defined them.
+  std::vector<glm::vec3> Positions(PositionNum);
+  std::vector<glm::vec2> TexCoords(TexCoordNum);
+  std::vector<glm::vec3> Normals(NormalNum);
+  ParallelFor(ChunkNum, ChunkNum, [&](size_t Begin, size_t End)
+  {
+    for(size_t i = Begin; i < End; ++i)
+    {
+      std::copy(Chunks[i].Positions.begin(), Chunks[i].Positions.end(), Positions.begin() + Chunks[i].PositionOffset);
+      std::copy(Chunks[i].TexCoords.begin(), Chunks[i].TexCoords.end(), TexCoords.begin() + Chunks[i].TexCoordOffset);
+      std::copy(Chunks[i].Normals.begin(), Chunks[i].Normals.end(), Normals.begin() + Chunks[i].NormalOffset);
+    }
+  });
+  Chunks.clear();
+
+  std::vector<bool> HasNormal(Keys.size());
+  for(size_t i = 0; i < Keys.size(); ++i)
+    HasNormal[i] = Keys[i].Normal != MissingIndex;
+
+  ParallelFor(Keys.size(), ThreadNum, [&](size_t Begin, size_t End)
+  {
+    for(size_t i = Begin; i < End; ++i)
+    {
+      Vertex& Vertex = Model.Vertices[i];
+      Vertex = {};
+      Vertex.Position = Positions[Keys[i].Position];
+      if(Keys[i].TexCoord != MissingIndex)
+        Vertex.TexCoord = glm::vec2(TexCoords[Keys[i].TexCoord].x, 1.0f - TexCoords[Keys[i].TexCoord].y);
+      if(Keys[i].Normal != MissingIndex)
+        Vertex.Normal = Normals[Keys[i].Normal];
+    }
+  });
+
+  GenerateNormalsAndTangents(Model.Vertices, Model.Indices, HasNormal);
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "Mesh.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+struct ObjModel
+{
+  //Every distinct combination of position, texture coordinate and normal index is one vertex, in the order of first use.
+  std::vector<Vertex> Vertices;
+  std::vector<uint32_t> Indices;
+  //The material of every triangle. Faces before the first "usemtl" get material 0, which has an empty name.
+  std::vector<uint32_t> TriangleMaterials;
+  std::vector<std::string> MaterialNames;
+};
+
+/* Parse a Wavefront OBJ file with "ThreadNum" threads (0 for one per hardware thread). The file is memory mapped and split
+ * into line aligned chunks, every chunk is parsed and its face corners are deduplicated independently, and the per chunk
+ * results are then merged into one indexed mesh. Polygons are triangulated as fans, texture coordinates are flipped
+ * vertically like with "aiProcess_FlipUVs", and missing normals and the tangents are generated. Only "v", "vt", "vn",
+ * "f" and "usemtl" are interpreted, everything else (groups, smoothing groups, lines, material libraries) is skipped. */
+void LoadObj(const std::string& Path, ObjModel& Model, uint32_t ThreadNum = 0);
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,665 @@
+#include "Overlay.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //5x7 glyphs for the printable ASCII range [32, 95], one byte per row with the leftmost pixel in bit 4.
+  //Lowercase letters are mapped to uppercase before lookup, the remaining cells of the atlas hold a solid block.
+  const uint8_t GlyphBitmaps[64][7] =
+  {
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, //Space
+  {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}, //'!'
+  {0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00}, //'"'
+  {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A}, //'#'
+  {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04}, //'$'
+  {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, //'%'
+  {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D}, //'&'
+  {0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00}, //'''
+  {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, //'('
+  {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, //')'
+  {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00}, //'*'
+  {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}, //'+'
+  {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}, //','
+  {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, //'-'
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, //'.'
+  {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, //'/'
+  {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, //'0'
+  {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, //'1'
+  {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, //'2'
+  {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, //'3'
+  {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, //'4'
+  {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, //'5'
+  {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, //'6'
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, //'7'
+  {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, //'8'
+  {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, //'9'
+  {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, //':'
+  {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08}, //';'
+  {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}, //'<'
+  {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}, //'='
+  {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}, //'>'
+  {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}, //'?'
+  {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E}, //'@'
+  {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, //'A'
+  {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, //'B'
+  {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, //'C'
+  {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, //'D'
+  {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, //'E'
+  {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, //'F'
+  {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, //'G'
+  {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, //'H'
+  {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, //'I'
+  {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, //'J'
+  {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, //'K'
+  {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, //'L'
+  {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, //'M'
+  {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, //'N'
+  {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, //'O'
+  {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, //'P'
+  {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, //'Q'
+  {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, //'R'
+  {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, //'S'
+  {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, //'T'
+  {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, //'U'
+  {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, //'V'
+  {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, //'W'
+  {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, //'X'
+  {0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04}, //'Y'
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, //'Z'
+  {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E}, //'['
+  {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00}, //'\\'
+  {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E}, //']'
+  {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00}, //'^'
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}, //'_'
+  };
+
+  constexpr uint32_t GlyphCellWidth = 6;
+  constexpr uint32_t GlyphCellHeight = 8;
+  constexpr uint32_t AtlasColumnNum = 16;
+  constexpr uint32_t AtlasRowNum = 6;
+  constexpr uint32_t FirstGlyph = 32;
+  constexpr uint32_t SolidGlyph = AtlasColumnNum * AtlasRowNum - 1;
+
+  constexpr uint32_t PackColor(uint8_t R, uint8_t G, uint8_t B, uint8_t A) {return R | (G << 8) | (B << 16) | (static_cast<uint32_t>(A) << 24);}
+
+  constexpr uint32_t TextColor = PackColor(255, 255, 255, 255);
+  constexpr uint32_t LabelColor = PackColor(160, 200, 255, 255);
+  constexpr uint32_t PanelColor = PackColor(0, 0, 0, 160);
+  constexpr uint32_t CpuGraphColor = PackColor(255, 170, 60, 255);
+  constexpr uint32_t GpuGraphColor = PackColor(80, 220, 255, 255);
+  constexpr uint32_t ReferenceLineColor = PackColor(255, 255, 255, 96);
+
+  //The frame time graphs are scaled so that 33.3 ms (30 FPS) fills the whole height.
+  constexpr float GraphMaxFrameTime = 1000.0f / 30.0f;
+  constexpr float GraphHeight = 48.0f;
+  constexpr float GraphBarWidth = 2.0f;
+
+  uint32_t CharacterToGlyph(char Character)
+  {
+    if(Character >= 'a' && Character <= 'z')
+      Character = Character - 'a' + 'A';
+
+    uint32_t Code = static_cast<unsigned char>(Character);
+    if(Code < FirstGlyph || Code >= FirstGlyph + 64)
+      Code = '?';
+
+    return Code - FirstGlyph;
+  }
+}
+
+void Overlay::Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, size_t ImageCount)
+{
+  CreateGlyphAtlas(PhysicalDevice, Device, CommandPool, Queue);
+
+  CreateDescriptorSet(Device);
+
+  CreateInstanceBuffers(PhysicalDevice, Device, ImageCount);
+
+  m_Instances.reserve(m_MaxInstanceNum);
+  m_CpuFrameTimeHistory.assign(m_HistoryNum, 0.0f);
+  m_GpuFrameTimeHistory.assign(m_HistoryNum, 0.0f);
+  m_HistoryCursor = 0;
+}
+
+void Overlay::CreatePipeline(VkDevice Device, VkRenderPass RenderPass, uint32_t Subpass, VkExtent2D Extent, bool bSrgbFramebuffer, const std::vector<char>& VertShaderCode, const std::vector<char>& FragShaderCode)
+{
+  m_Extent = Extent;
+
+  VkShaderModule VertShaderModule = CreateShaderModule(Device, VertShaderCode);
+  VkShaderModule FragShaderModule = CreateShaderModule(Device, FragShaderCode);
+
+  VkBool32 bSrgb = bSrgbFramebuffer ? VK_TRUE : VK_FALSE;
+
+  VkSpecializationMapEntry VertSpecializationMapEntry = {};
+  VertSpecializationMapEntry.constantID = 0;
+  VertSpecializationMapEntry.offset = 0;
+  VertSpecializationMapEntry.size = sizeof(bSrgb);
+
+  VkSpecializationInfo VertSpecializationInfo = {};
+  VertSpecializationInfo.mapEntryCount = 1;
+  VertSpecializationInfo.pMapEntries = &VertSpecializationMapEntry;
+  VertSpecializationInfo.dataSize = sizeof(bSrgb);
+  VertSpecializationInfo.pData = &bSrgb;
+
+  VkPipelineShaderStageCreateInfo ShaderStageCreateInfos[2] = {};
+  ShaderStageCreateInfos[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  ShaderStageCreateInfos[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+  ShaderStageCreateInfos[0].module = VertShaderModule;
+  ShaderStageCreateInfos[0].pName = "main";
+  ShaderStageCreateInfos[0].pSpecializationInfo = &VertSpecializationInfo;
+  ShaderStageCreateInfos[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  ShaderStageCreateInfos[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+  ShaderStageCreateInfos[1].module = FragShaderModule;
+  ShaderStageCreateInfos[1].pName = "main";
+
+  //The quad corners are generated from "gl_VertexIndex", only the instance data is fetched.
+  auto BindingDescription = GlyphInstance::GetBindingDescription();
+  auto AttributeDescription = GlyphInstance::GetAttributeDescription();
+
+  VkPipelineVertexInputStateCreateInfo VertexInputStateCreateInfo = {};
+  VertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+  VertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
+  VertexInputStateCreateInfo.pVertexBindingDescriptions = &BindingDescription;
+  VertexInputStateCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(AttributeDescription.size());
+  VertexInputStateCreateInfo.pVertexAttributeDescriptions = AttributeDescription.data();
+
+  VkPipelineInputAssemblyStateCreateInfo InputAssemblyStateCreateInfo = {};
+  InputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  InputAssemblyStateCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  InputAssemblyStateCreateInfo.primitiveRestartEnable = VK_FALSE;
+
+  VkViewport Viewport = {};
+  Viewport.x = 0.0f;
+  Viewport.y = 0.0f;
+  Viewport.width = static_cast<float>(Extent.width);
+  Viewport.height = static_cast<float>(Extent.height);
+  Viewport.minDepth = 0.0f;
+  Viewport.maxDepth = 1.0f;
+
+  VkRect2D Scissor = {};
+  Scissor.offset = {0, 0};
+  Scissor.extent = Extent;
+
+  VkPipelineViewportStateCreateInfo ViewportStateCreateInfo = {};
+  ViewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+  ViewportStateCreateInfo.viewportCount = 1;
+  ViewportStateCreateInfo.pViewports = &Viewport;
+  ViewportStateCreateInfo.scissorCount = 1;
+  ViewportStateCreateInfo.pScissors = &Scissor;
+
+  VkPipelineRasterizationStateCreateInfo RasterizationStateCreateInfo = {};
+  RasterizationStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  RasterizationStateCreateInfo.depthClampEnable = VK_FALSE;
+  RasterizationStateCreateInfo.rasterizerDiscardEnable = VK_FALSE;
+  RasterizationStateCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+  RasterizationStateCreateInfo.lineWidth = 1.0f;
+  RasterizationStateCreateInfo.cullMode = VK_CULL_MODE_NONE;
+  RasterizationStateCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  RasterizationStateCreateInfo.depthBiasEnable = VK_FALSE;
+
+  //The overlay subpass renders straight into the single-sampled swap chain image.
+  VkPipelineMultisampleStateCreateInfo MultisampleStateCreateInfo = {};
+  MultisampleStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+  MultisampleStateCreateInfo.sampleShadingEnable = VK_FALSE;
+  MultisampleStateCreateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+  VkPipelineColorBlendAttachmentState ColorBlendAttachmentState = {};
+  ColorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
+                                             VK_COLOR_COMPONENT_G_BIT |
+                                             VK_COLOR_COMPONENT_B_BIT |
+                                             VK_COLOR_COMPONENT_A_BIT;
+  ColorBlendAttachmentState.blendEnable = VK_TRUE;
+  ColorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+  ColorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  ColorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
+  ColorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  ColorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+  ColorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+
+  VkPipelineColorBlendStateCreateInfo ColorBlendStateCreateInfo = {};
+  ColorBlendStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+  ColorBlendStateCreateInfo.logicOpEnable = VK_FALSE;
+  ColorBlendStateCreateInfo.attachmentCount = 1;
+  ColorBlendStateCreateInfo.pAttachments = &ColorBlendAttachmentState;
+
+  VkPushConstantRange PushConstantRange = {};
+  PushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  PushConstantRange.offset = 0;
+  PushConstantRange.size = sizeof(glm::vec2);
+
+  VkPipelineLayoutCreateInfo PipelineLayoutCreateInfo = {};
+  PipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  PipelineLayoutCreateInfo.setLayoutCount = 1;
+  PipelineLayoutCreateInfo.pSetLayouts = &m_DescriptorSetLayout;
+  PipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+  PipelineLayoutCreateInfo.pPushConstantRanges = &PushConstantRange;
+
+  if(vkCreatePipelineLayout(Device, &PipelineLayoutCreateInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create overlay pipeline layout!");
+
+  VkGraphicsPipelineCreateInfo GraphicsPipelineCreateInfo = {};
+  GraphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  GraphicsPipelineCreateInfo.stageCount = 2;
+  GraphicsPipelineCreateInfo.pStages = ShaderStageCreateInfos;
+  GraphicsPipelineCreateInfo.pVertexInputState = &VertexInputStateCreateInfo;
+  GraphicsPipelineCreateInfo.pInputAssemblyState = &InputAssemblyStateCreateInfo;
+  GraphicsPipelineCreateInfo.pViewportState = &ViewportStateCreateInfo;
+  GraphicsPipelineCreateInfo.pRasterizationState = &RasterizationStateCreateInfo;
+  GraphicsPipelineCreateInfo.pMultisampleState = &MultisampleStateCreateInfo;
+  GraphicsPipelineCreateInfo.pDepthStencilState = nullptr;
+  GraphicsPipelineCreateInfo.pColorBlendState = &ColorBlendStateCreateInfo;
+  GraphicsPipelineCreateInfo.pDynamicState = nullptr;
+  GraphicsPipelineCreateInfo.layout = m_PipelineLayout;
+  GraphicsPipelineCreateInfo.renderPass = RenderPass;
+  GraphicsPipelineCreateInfo.subpass = Subpass;
+  GraphicsPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+  GraphicsPipelineCreateInfo.basePipelineIndex = -1;
+
+  if(vkCreateGraphicsPipelines(Device, VK_NULL_HANDLE, 1, &GraphicsPipelineCreateInfo, nullptr, &m_Pipeline) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create overlay pipeline!");
+
+  vkDestroyShaderModule(Device, VertShaderModule, nullptr);
+  vkDestroyShaderModule(Device, FragShaderModule, nullptr);
+}
+
+void Overlay::DestroyPipeline(VkDevice Device)
+{
+  vkDestroyPipeline(Device, m_Pipeline, nullptr);
+  vkDestroyPipelineLayout(Device, m_PipelineLayout, nullptr);
+
+  m_Pipeline = VK_NULL_HANDLE;
+  m_PipelineLayout = VK_NULL_HANDLE;
+}
+
+void Overlay::TakePipeline(VkPipeline& Pipeline, VkPipelineLayout& PipelineLayout)
+{
+  Pipeline = m_Pipeline;
+  PipelineLayout = m_PipelineLayout;
+
+  m_Pipeline = VK_NULL_HANDLE;
+  m_PipelineLayout = VK_NULL_HANDLE;
+}
+
+void Overlay::Destroy(VkDevice Device)
+{
+  for(size_t i = 0; i < m_InstanceBuffers.size(); ++i)
+  {
+    vkUnmapMemory(Device, m_InstanceBuffers[i].Memory);
+    DestroyBuffer(Device, m_InstanceBuffers[i]);
+
+    vkUnmapMemory(Device, m_IndirectBuffers[i].Memory);
+    DestroyBuffer(Device, m_IndirectBuffers[i]);
+  }
+
+  m_InstanceBuffers.clear();
+  m_IndirectBuffers.clear();
+  m_pMappedInstances.clear();
+  m_pMappedIndirects.clear();
+
+  vkDestroyDescriptorPool(Device, m_DescriptorPool, nullptr);
+  vkDestroyDescriptorSetLayout(Device, m_DescriptorSetLayout, nullptr);
+
+  DestroyTexture(Device, m_GlyphAtlas);
+}
+
+void Overlay::Update(uint32_t ImageIndex, const FrameStatistics& Statistics)
+{
+  m_CpuFrameTimeHistory[m_HistoryCursor] = static_cast<float>(Statistics.CpuFrameTime);
+  m_GpuFrameTimeHistory[m_HistoryCursor] = static_cast<float>(Statistics.GpuFrameTime);
+  m_HistoryCursor = (m_HistoryCursor + 1) % m_HistoryNum;
+
+  m_Instances.clear();
+
+  const float LineHeight = (GlyphCellHeight + 2) * m_GlyphScale;
+  const float Margin = 8.0f;
+  const float GraphWidth = m_HistoryNum * GraphBarWidth;
+
+  //The background panel goes first so that it is blended below everything else, its size is fixed up at the end.
+  AddRectangle(Margin, Margin, 0.0f, 0.0f, PanelColor);
+
+  float X = 2.0f * Margin;
+  float Y = 2.0f * Margin;
+  char Buffer[256];
+
+  AddText(X, Y, Statistics.GpuName.c_str(), LabelColor);
+  Y += LineHeight;
+
+  if(Statistics.bGpuTimeAvailable)
+    std::snprintf(Buffer, sizeof(Buffer), "FPS %d  CPU %.2f MS  GPU %.2f MS", static_cast<int32_t>(Statistics.FPS), Statistics.CpuFrameTime, Statistics.GpuFrameTime);
+  else
+    std::snprintf(Buffer, sizeof(Buffer), "FPS %d  CPU %.2f MS  GPU N/A", static_cast<int32_t>(Statistics.FPS), Statistics.CpuFrameTime);
+  AddText(X, Y, Buffer, TextColor);
+  Y += LineHeight;
+
+  if(Statistics.bGpuTimeAvailable)
+    std::snprintf(Buffer, sizeof(Buffer), "HUD %.3f MS  MEMORY %.1f MB", Statistics.OverlayGpuTime, static_cast<double>(Statistics.DeviceMemorySize) / (1024.0 * 1024.0));
+  else
+    std::snprintf(Buffer, sizeof(Buffer), "HUD N/A  MEMORY %.1f MB", static_cast<double>(Statistics.DeviceMemorySize) / (1024.0 * 1024.0));
+  AddText(X, Y, Buffer, TextColor);
+  Y += LineHeight;
+
+  std::snprintf(Buffer, sizeof(Buffer), "DRAWS %u  VERTICES %zu  TRIANGLES %zu", Statistics.DrawCallNum, Statistics.VertexNum, Statistics.FacetNum);
+  AddText(X, Y, Buffer, TextColor);
+  Y += LineHeight;
+
+  if(!Statistics.LodFacetNum.empty())
+  {
+    int Length = std::snprintf(Buffer, sizeof(Buffer), "LOD");
+    for(size_t i = 0; i < Statistics.LodFacetNum.size() && Length < static_cast<int>(sizeof(Buffer)); ++i)
+      Length += std::snprintf(Buffer + Length, sizeof(Buffer) - Length, " %zu:%zu", i, Statistics.LodFacetNum[i]);
+    AddText(X, Y, Buffer, TextColor);
+    Y += LineHeight;
+
+    std::snprintf(Buffer, sizeof(Buffer), "MESHLETS %zu OF %zu", Statistics.DrawnMeshletNum, Statistics.MeshletNum);
+    AddText(X, Y, Buffer, TextColor);
+    Y += LineHeight;
+  }
+
+  if(!Statistics.TextureLevels.empty())
+  {
+    int Length = std::snprintf(Buffer, sizeof(Buffer), "TEXTURE LEVELS");
+    for(size_t i = 0; i < Statistics.TextureLevels.size() && Length < static_cast<int>(sizeof(Buffer)); ++i)
+      Length += std::snprintf(Buffer + Length, sizeof(Buffer) - Length, " %u", Statistics.TextureLevels[i]);
+    if(Length < static_cast<int>(sizeof(Buffer)))
+      std::snprintf(Buffer + Length, sizeof(Buffer) - Length, "  STREAMED %.1f MB", static_cast<double>(Statistics.StreamedTextureSize) / (1024.0 * 1024.0));
+    AddText(X, Y, Buffer, TextColor);
+    Y += LineHeight;
+  }
+
+  if(!Statistics.ResidentTileNums.empty())
+  {
+    int Length = std::snprintf(Buffer, sizeof(Buffer), "TILES");
+    for(size_t i = 0; i < Statistics.ResidentTileNums.size() && Length < static_cast<int>(sizeof(Buffer)); ++i)
+      Length += std::snprintf(Buffer + Length, sizeof(Buffer) - Length, " %u", Statistics.ResidentTileNums[i]);
+    if(Length < static_cast<int>(sizeof(Buffer)))
+      std::snprintf(Buffer + Length, sizeof(Buffer) - Length, " OF %u  STREAMED %llu  EVICTED %llu", Statistics.TileSlotNum, static_cast<unsigned long long>(Statistics.StreamedTileNum),
+                    static_cast<unsigned long long>(Statistics.EvictedTileNum));
+    AddText(X, Y, Buffer, TextColor);
+    Y += LineHeight;
+  }
+
+  if(Statistics.TextureMemoryBudget > 0)
+  {
+    std::snprintf(Buffer, sizeof(Buffer), "TEXTURES %.1f OF %.1f MB  EVICTED %u (%.1f MB)", static_cast<double>(Statistics.TextureMemorySize) / (1024.0 * 1024.0),
+                  static_cast<double>(Statistics.TextureMemoryBudget) / (1024.0 * 1024.0), Statistics.EvictedLevelNum, static_cast<double>(Statistics.EvictedTextureSize) / (1024.0 * 1024.0));
+    AddText(X, Y, Buffer, Statistics.TextureMemorySize > Statistics.TextureMemoryBudget ? LabelColor : TextColor);
+    Y += LineHeight;
+  }
+
+  if(Statistics.PendingAssetNum > 0)
+  {
+    std::snprintf(Buffer, sizeof(Buffer), "LOADING %zu ASSETS", Statistics.PendingAssetNum);
+    AddText(X, Y, Buffer, LabelColor);
+    Y += LineHeight;
+  }
+  else if(Statistics.TimeToFullyLoaded >= 0.0)
+  {
+    std::snprintf(Buffer, sizeof(Buffer), "FIRST FRAME %.0f MS  LOADED %.0f MS", Statistics.TimeToFirstFrame, Statistics.TimeToFullyLoaded);
+    AddText(X, Y, Buffer, TextColor);
+    Y += LineHeight;
+  }
+
+  std::snprintf(Buffer, sizeof(Buffer), "MODE %s", Statistics.Mode.c_str());
+  AddText(X, Y, Buffer, TextColor);
+  Y += LineHeight;
+
+  std::snprintf(Buffer, sizeof(Buffer), "EYE (%.2f, %.2f, %.2f)", Statistics.Eye.x, Statistics.Eye.y, Statistics.Eye.z);
+  AddText(X, Y, Buffer, TextColor);
+  Y += LineHeight;
+
+  AddGraph(X, Y, "CPU", m_CpuFrameTimeHistory, CpuGraphColor);
+  AddGraph(X + GraphWidth + Margin, Y, "GPU", m_GpuFrameTimeHistory, GpuGraphColor);
+
+  glm::vec2 Extent = glm::vec2(0.0f);
+  for(size_t i = 1; i < m_Instances.size(); ++i)
+    Extent = glm::max(Extent, glm::vec2(m_Instances[i].Rectangle.x + m_Instances[i].Rectangle.z, m_Instances[i].Rectangle.y + m_Instances[i].Rectangle.w));
+  m_Instances[0].Rectangle.z = Extent.x + Margin - m_Instances[0].Rectangle.x;
+  m_Instances[0].Rectangle.w = Extent.y + Margin - m_Instances[0].Rectangle.y;
+
+  memcpy(m_pMappedInstances[ImageIndex], m_Instances.data(), sizeof(GlyphInstance) * m_Instances.size());
+
+  VkDrawIndirectCommand DrawCommand = {};
+  DrawCommand.vertexCount = 6;
+  DrawCommand.instanceCount = static_cast<uint32_t>(m_Instances.size());
+  DrawCommand.firstVertex = 0;
+  DrawCommand.firstInstance = 0;
+  memcpy(m_pMappedIndirects[ImageIndex], &DrawCommand, sizeof(DrawCommand));
+}
+
+void Overlay::RecordDrawCommands(VkCommandBuffer CommandBuffer, uint32_t ImageIndex) const
+{
+  glm::vec2 InvViewportSize = glm::vec2(1.0f / static_cast<float>(m_Extent.width), 1.0f / static_cast<float>(m_Extent.height));
+
+  vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+  vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &m_DescriptorSet, 0, nullptr);
+  vkCmdPushConstants(CommandBuffer, m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(InvViewportSize), &InvViewportSize);
+
+  VkBuffer InstanceBuffers[] = {m_InstanceBuffers[ImageIndex].Buffer};
+  VkDeviceSize Offsets[] = {0};
+  vkCmdBindVertexBuffers(CommandBuffer, 0, 1, InstanceBuffers, Offsets);
+
+  vkCmdDrawIndirect(CommandBuffer, m_IndirectBuffers[ImageIndex].Buffer, 0, 1, sizeof(VkDrawIndirectCommand));
+}
+
+void Overlay::CreateGlyphAtlas(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue)
+{
+  const uint32_t Width = AtlasColumnNum * GlyphCellWidth;
+  const uint32_t Height = AtlasRowNum * GlyphCellHeight;
+  std::vector<uint8_t> Pixels(Width * Height, 0);
+
+  for(uint32_t Glyph = 0; Glyph < AtlasColumnNum * AtlasRowNum; ++Glyph)
+  {
+    uint32_t CellX = (Glyph % AtlasColumnNum) * GlyphCellWidth;
+    uint32_t CellY = (Glyph / AtlasColumnNum) * GlyphCellHeight;
+
+    for(uint32_t Row = 0; Row < GlyphCellHeight; ++Row)
+    {
+      for(uint32_t Column = 0; Column < GlyphCellWidth; ++Column)
+      {
+        bool bSet = false;
+        if(Glyph == SolidGlyph)
+          bSet = true;
+        else if(Glyph < 64 && Row < 7 && Column < 5)
+          bSet = (GlyphBitmaps[Glyph][Row] >> (4 - Column)) & 1;
+
+        Pixels[(CellY + Row) * Width + CellX + Column] = bSet ? 255 : 0;
+      }
+    }
+  }
+
+  VkDeviceSize ImageSize = Pixels.size();
+  BufferInfo StagingBuffer;
+
+  CreateBuffer(PhysicalDevice, Device, ImageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, StagingBuffer);
+
+  MapMemory(Device, StagingBuffer.Memory, ImageSize, Pixels.data());
+
+  m_GlyphAtlas.MipLevels = 1;
+
+  CreateImage(PhysicalDevice, Device, Width, Height, 1, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_GlyphAtlas.TextureImage, m_GlyphAtlas.TextureImageMemory);
+
+  TransitionImageLayout(Device, Queue, CommandPool, m_GlyphAtlas.TextureImage, VK_FORMAT_R8_UNORM, 1, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+  CopyBufferToImage(Device, Queue, CommandPool, StagingBuffer.Buffer, m_GlyphAtlas.TextureImage, Width, Height);
+
+  TransitionImageLayout(Device, Queue, CommandPool, m_GlyphAtlas.TextureImage, VK_FORMAT_R8_UNORM, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  DestroyBuffer(Device, StagingBuffer);
+
+  CreateImageView(Device, m_GlyphAtlas.TextureImage, VK_FORMAT_R8_UNORM, 1, VK_IMAGE_ASPECT_COLOR_BIT, m_GlyphAtlas.TextureImageView);
+
+  //Glyphs are drawn at integer scales, so nearest filtering keeps them crisp and avoids bleeding between cells.
+  SamplerState State;
+  State.Filter = VK_FILTER_NEAREST;
+  State.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  State.AddressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  State.MaxAnisotropy = 1.0f;
+  State.MaxLod = 0.0f;
+  m_GlyphAtlas.TextureSampler = AcquireSampler(Device, State);
+}
+
+void Overlay::CreateDescriptorSet(VkDevice Device)
+{
+  VkDescriptorSetLayoutBinding AtlasSamplerLayoutBinding = {};
+  AtlasSamplerLayoutBinding.binding = 0;
+  AtlasSamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  AtlasSamplerLayoutBinding.descriptorCount = 1;
+  AtlasSamplerLayoutBinding.pImmutableSamplers = nullptr;
+  AtlasSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  VkDescriptorSetLayoutCreateInfo LayoutCreateInfo = {};
+  LayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  LayoutCreateInfo.bindingCount = 1;
+  LayoutCreateInfo.pBindings = &AtlasSamplerLayoutBinding;
+
+  if(vkCreateDescriptorSetLayout(Device, &LayoutCreateInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create overlay descriptor set layout!");
+
+  VkDescriptorPoolSize PoolSize = {};
+  PoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  PoolSize.descriptorCount = 1;
+
+  VkDescriptorPoolCreateInfo PoolCreateInfo = {};
+  PoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  PoolCreateInfo.poolSizeCount = 1;
+  PoolCreateInfo.pPoolSizes = &PoolSize;
+  PoolCreateInfo.maxSets = 1;
+
+  if(vkCreateDescriptorPool(Device, &PoolCreateInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create overlay descriptor pool!");
+
+  VkDescriptorSetAllocateInfo AllocInfo = {};
+  AllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  AllocInfo.descriptorPool = m_DescriptorPool;
+  AllocInfo.descriptorSetCount = 1;
+  AllocInfo.pSetLayouts = &m_DescriptorSetLayout;
+
+  if(vkAllocateDescriptorSets(Device, &AllocInfo, &m_DescriptorSet) != VK_SUCCESS)
+    throw std::runtime_error("Failed to allocate overlay descriptor set!");
+
+  VkDescriptorImageInfo AtlasImageInfo = m_GlyphAtlas.GetDescriptorImageInfo();
+
+  VkWriteDescriptorSet DescriptorWrite = {};
+  DescriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  DescriptorWrite.dstSet = m_DescriptorSet;
+  DescriptorWrite.dstBinding = 0;
+  DescriptorWrite.dstArrayElement = 0;
+  DescriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  DescriptorWrite.descriptorCount = 1;
+  DescriptorWrite.pImageInfo = &AtlasImageInfo;
+
+  vkUpdateDescriptorSets(Device, 1, &DescriptorWrite, 0, nullptr);
+}
+
+void Overlay::CreateInstanceBuffers(VkPhysicalDevice PhysicalDevice, VkDevice Device, size_t ImageCount)
+{
+  m_InstanceBuffers.resize(ImageCount);
+  m_IndirectBuffers.resize(ImageCount);
+  m_pMappedInstances.resize(ImageCount);
+  m_pMappedIndirects.resize(ImageCount);
+
+  for(size_t i = 0; i < ImageCount; ++i)
+  {
+    CreateBuffer(PhysicalDevice, Device, sizeof(GlyphInstance) * m_MaxInstanceNum, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_InstanceBuffers[i]);
+    CreateBuffer(PhysicalDevice, Device, sizeof(VkDrawIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_IndirectBuffers[i]);
+
+    vkMapMemory(Device, m_InstanceBuffers[i].Memory, 0, VK_WHOLE_SIZE, 0, &m_pMappedInstances[i]);
+    vkMapMemory(Device, m_IndirectBuffers[i].Memory, 0, VK_WHOLE_SIZE, 0, &m_pMappedIndirects[i]);
+
+    //Nothing is drawn until the first update.
+    VkDrawIndirectCommand DrawCommand = {};
+    memcpy(m_pMappedIndirects[i], &DrawCommand, sizeof(DrawCommand));
+  }
+}
+
+void Overlay::AddText(float X, float Y, const char* pText, uint32_t Color)
+{
+  const float GlyphWidth = GlyphCellWidth * m_GlyphScale;
+  const float GlyphHeight = GlyphCellHeight * m_GlyphScale;
+
+  for(const char* pCharacter = pText; *pCharacter != '\0' && m_Instances.size() < m_MaxInstanceNum; ++pCharacter)
+  {
+    if(*pCharacter != ' ')
+    {
+      GlyphInstance Instance = {};
+      Instance.Rectangle = glm::vec4(X, Y, GlyphWidth, GlyphHeight);
+      Instance.Color = Color;
+      Instance.Glyph = CharacterToGlyph(*pCharacter);
+      m_Instances.push_back(Instance);
+    }
+
+    X += GlyphWidth;
+  }
+}
+
+void Overlay::AddRectangle(float X, float Y, float Width, float Height, uint32_t Color)
+{
+  if(m_Instances.size() >= m_MaxInstanceNum)
+    return;
+
+  GlyphInstance Instance = {};
+  Instance.Rectangle = glm::vec4(X, Y, Width, Height);
+  Instance.Color = Color;
+  Instance.Glyph = SolidGlyph;
+  m_Instances.push_back(Instance);
+}
+
+void Overlay::AddGraph(float X, float Y, const char* pLabel, const std::vector<float>& History, uint32_t Color)
+{
+  AddText(X, Y, pLabel, Color);
+  Y += (GlyphCellHeight + 2) * m_GlyphScale;
+
+  //Reference line at 16.7 ms (60 FPS).
+  float ReferenceY = Y + GraphHeight * (1.0f - (1000.0f / 60.0f) / GraphMaxFrameTime);
+  AddRectangle(X, ReferenceY, m_HistoryNum * GraphBarWidth, 1.0f, ReferenceLineColor);
+
+  //Oldest sample on the left, the cursor points at the oldest entry.
+  for(uint32_t i = 0; i < m_HistoryNum; ++i)
+  {
+    float FrameTime = History[(m_HistoryCursor + i) % m_HistoryNum];
+    float BarHeight = std::max(1.0f, GraphHeight * std::min(FrameTime / GraphMaxFrameTime, 1.0f));
+    AddRectangle(X + i * GraphBarWidth, Y + GraphHeight - BarHeight, GraphBarWidth, BarHeight, Color);
+  }
+}
+
+VkVertexInputBindingDescription Overlay::GlyphInstance::GetBindingDescription()
+{
+  VkVertexInputBindingDescription BindingDescription = {};
+  BindingDescription.binding = 0;
+  BindingDescription.stride = sizeof(GlyphInstance);
+  BindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+  return BindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 3> Overlay::GlyphInstance::GetAttributeDescription()
+{
+  std::array<VkVertexInputAttributeDescription, 3> AttributeDescriptions = {};
+
+  AttributeDescriptions[0].binding = 0;
+  AttributeDescriptions[0].location = 0;
+  AttributeDescriptions[0].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+  AttributeDescriptions[0].offset = offsetof(GlyphInstance, Rectangle);
+
+  AttributeDescriptions[1].binding = 0;
+  AttributeDescriptions[1].location = 1;
+  AttributeDescriptions[1].format = VK_FORMAT_R8G8B8A8_UNORM;
+  AttributeDescriptions[1].offset = offsetof(GlyphInstance, Color);
+
+  AttributeDescriptions[2].binding = 0;
+  AttributeDescriptions[2].location = 2;
+  AttributeDescriptions[2].format = VK_FORMAT_R32_UINT;
+  AttributeDescriptions[2].offset = offsetof(GlyphInstance, Glyph);
+
+  return AttributeDescriptions;
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#endif
+#include <GLFW/glfw3.h>
+
+#ifndef GLM_FORCE_RADIANS
+#define GLM_FORCE_RADIANS
+#endif
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+
+#include "Namespace.hpp"
+#include "VulkanHelper.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* A lightweight heads-up display drawn in its own subpass on top of the resolved image.
+ * Every character and graph bar is one instance of a screen-space quad, so the whole
+ * overlay is a single instanced draw. The instance count is written into a host-visible
+ * indirect buffer, which keeps the prerecorded drawing command buffers valid. */
+class Overlay
+{
+  public:
+  struct FrameStatistics
+  {
+    double FPS = 0.0;
+    double CpuFrameTime = 0.0; //In milliseconds.
+    double GpuFrameTime = 0.0; //In milliseconds, main subpass only.
+    double OverlayGpuTime = 0.0; //In milliseconds, the overlay subpass.
+    bool bGpuTimeAvailable = false;
+    VkDeviceSize DeviceMemorySize = 0;
+    uint32_t DrawCallNum = 0;
+    size_t VertexNum = 0;
+    size_t FacetNum = 0;
+    std::vector<size_t> LodFacetNum; //The triangles drawn at every level of detail, empty if none are selected.
+    size_t MeshletNum = 0; //Of the selected levels of detail.
+    size_t DrawnMeshletNum = 0; //The meshlets that were not culled.
+    size_t PendingAssetNum = 0; //Assets that are still loading in the background.
+    std::vector<uint32_t> TextureLevels; //The first resident mip level of every streamed texture, empty without streaming.
+    uint64_t StreamedTextureSize = 0; //In bytes, uploaded by streaming so far.
+    std::vector<uint32_t> ResidentTileNums; //The resident tiles of every virtual texture, empty without virtual texturing.
+    uint32_t TileSlotNum = 0; //The slots of the cache of a virtual texture.
+    uint64_t StreamedTileNum = 0; //Tiles copied into the caches so far.
+    uint64_t EvictedTileNum = 0; //Tiles whose slots were taken by other ones so far.
+    VkDeviceSize TextureMemorySize = 0; //In bytes, of all texture images.
+    VkDeviceSize TextureMemoryBudget = 0; //In bytes, the line of the texture memory is only shown if there is one.
+    uint32_t EvictedLevelNum = 0; //Mip levels evicted to stay within the budget so far.
+    uint64_t EvictedTextureSize = 0; //In bytes, of the evicted levels.
+    double TimeToFirstFrame = -1.0; //In milliseconds since start up, negative until known.
+    double TimeToFullyLoaded = -1.0; //In milliseconds since start up, negative until known.
+    glm::vec3 Eye = glm::vec3(0.0f);
+    std::string GpuName;
+    std::string Mode;
+  };
+
+  void Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, size_t ImageCount);
+
+  /* The pipeline depends on the render pass and the swap chain extent, so it is recreated together with the swap chain. The colors
+   * are given in sRGB, with "bSrgbFramebuffer" the shader decodes them since the framebuffer encodes them again. */
+  void CreatePipeline(VkDevice Device, VkRenderPass RenderPass, uint32_t Subpass, VkExtent2D Extent, bool bSrgbFramebuffer, const std::vector<char>& VertShaderCode, const std::vector<char>& FragShaderCode);
+
+  void DestroyPipeline(VkDevice Device);
+
+  //Hand the pipeline over to the caller instead of destroying it, for frames in flight that may still use it.
+  void TakePipeline(VkPipeline& Pipeline, VkPipelineLayout& PipelineLayout);
+
+  void Destroy(VkDevice Device);
+
+  //Rebuild the instance data of the given swap chain image, must only be called once the image is no longer in flight.
+  void Update(uint32_t ImageIndex, const FrameStatistics& Statistics);
+
+  void RecordDrawCommands(VkCommandBuffer CommandBuffer, uint32_t ImageIndex) const;
+
+  protected:
+  struct GlyphInstance
+  {
+    glm::vec4 Rectangle; //Top left corner and size, in pixels.
+    uint32_t Color; //Packed as R8G8B8A8.
+    uint32_t Glyph;
+
+    static VkVertexInputBindingDescription GetBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 3> GetAttributeDescription();
+  };
+
+  void CreateGlyphAtlas(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue);
+
+  void CreateDescriptorSet(VkDevice Device);
+
+  void CreateInstanceBuffers(VkPhysicalDevice PhysicalDevice, VkDevice Device, size_t ImageCount);
+
+  void AddText(float X, float Y, const char* pText, uint32_t Color);
+
+  void AddRectangle(float X, float Y, float Width, float Height, uint32_t Color);
+
+  void AddGraph(float X, float Y, const char* pLabel, const std::vector<float>& History, uint32_t Color);
+
+  protected:
+  static const uint32_t m_MaxInstanceNum = 2048;
+  static const uint32_t m_HistoryNum = 120;
+  const float m_GlyphScale = 2.0f;
+
+  TextureInfo m_GlyphAtlas;
+
+  VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
+  VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+  VkDescriptorSet m_DescriptorSet = VK_NULL_HANDLE;
+
+  VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+  VkPipeline m_Pipeline = VK_NULL_HANDLE;
+  VkExtent2D m_Extent = {0, 0};
+
+  //One set per swap chain image, persistently mapped.
+  std::vector<BufferInfo> m_InstanceBuffers;
+  std::vector<BufferInfo> m_IndirectBuffers;
+  std::vector<void*> m_pMappedInstances;
+  std::vector<void*> m_pMappedIndirects;
+
+  std::vector<GlyphInstance> m_Instances;
+  std::vector<float> m_CpuFrameTimeHistory;
+  std::vector<float> m_GpuFrameTimeHistory;
+  size_t m_HistoryCursor = 0;
+};
+
+NAMESPACE_END
\ No newline at end of file
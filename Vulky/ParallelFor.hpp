@@ -0,0 +1,28 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <vector>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//Split [0, Num) into "TaskNum" ranges and process them concurrently, exceptions are passed on to the caller.
+template<typename Function>
+void ParallelFor(size_t Num, size_t TaskNum, Function&& Func)
+{
+  TaskNum = std::clamp<size_t>(TaskNum, 1, std::max<size_t>(Num, 1));
+
+  std::vector<std::future<void>> Futures;
+  for(size_t Task = 1; Task < TaskNum; ++Task)
+    Futures.push_back(std::async(std::launch::async, [&, Task]() {Func(Num * Task / TaskNum, Num * (Task + 1) / TaskNum);}));
+
+  Func(0, Num / TaskNum);
+
+  for(auto& Future : Futures)
+    Future.get();
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,741 @@
+#include "PngDecoder.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define PNG_SIMD_SSE2
+#endif
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  const uint8_t PngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+  enum PNG_COLOR_TYPE
+  {
+    PNG_COLOR_TYPE_GRAY = 0,
+    PNG_COLOR_TYPE_RGB = 2,
+    PNG_COLOR_TYPE_PALETTE = 3,
+    PNG_COLOR_TYPE_GRAY_ALPHA = 4,
+    PNG_COLOR_TYPE_RGBA = 6
+  };
+
+  //The largest width and height decoded, like stb_image.
+  const uint32_t MaxDimension = 1 << 24;
+  //The zero bytes after the compressed data, so the bit reader always loads 8 bytes at once.
+  const size_t InputPadding = 16;
+  //The bytes after the inflated rows, so matches are always copied 8 bytes at once.
+  const size_t OutputPadding = 8;
+
+  /* The entries of the decode tables: the value in the upper 16 bits (a literal, the base of a length or distance, or the start
+   * of a subtable), flags in bits 12 to 15, the extra bits (or the index bits of a subtable) in bits 8 to 11 and the bits of the
+   * code in the lowest 8. */
+  const uint32_t EntryLiteral = 0x8000;
+  const uint32_t EntryEnd = 0x4000;
+  const uint32_t EntrySubtable = 0x2000;
+  const uint32_t EntryInvalid = 0x1000;
+
+  //Codes up to these lengths are decoded with one lookup, longer ones go through a subtable.
+  const uint32_t LitLenTableBits = 10;
+  const uint32_t DistanceTableBits = 8;
+  const uint32_t PrecodeTableBits = 7;
+
+  uint32_t MakeEntry(uint32_t Value, uint32_t Flags, uint32_t ExtraBits) {return Value << 16 | Flags | ExtraBits << 8;}
+
+  //The entries of every symbol of the three alphabets of deflate, without the lengths of their codes.
+  struct SymbolEntries
+  {
+    uint32_t LitLen[288];
+    uint32_t Distance[32];
+    uint32_t Precode[19];
+
+    SymbolEntries()
+    {
+      const uint32_t LengthBases[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+      const uint32_t LengthExtraBits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+      const uint32_t DistanceBases[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                          8193, 12289, 16385, 24577};
+      const uint32_t DistanceExtraBits[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+      for(uint32_t Symbol = 0; Symbol < 288; ++Symbol)
+      {
+        if(Symbol < 256)
+          LitLen[Symbol] = MakeEntry(Symbol, EntryLiteral, 0);
+        else if(Symbol == 256)
+          LitLen[Symbol] = MakeEntry(0, EntryEnd, 0);
+        else if(Symbol < 286)
+          LitLen[Symbol] = MakeEntry(LengthBases[Symbol - 257], 0, LengthExtraBits[Symbol - 257]);
+        else
+          LitLen[Symbol] = MakeEntry(0, EntryInvalid, 0);
+      }
+
+      for(uint32_t Symbol = 0; Symbol < 32; ++Symbol)
+        Distance[Symbol] = Symbol < 30 ? MakeEntry(DistanceBases[Symbol], 0, DistanceExtraBits[Symbol]) : MakeEntry(0, EntryInvalid, 0);
+
+      for(uint32_t Symbol = 0; Symbol < 19; ++Symbol)
+        Precode[Symbol] = MakeEntry(Symbol, 0, 0);
+    }
+  };
+
+  const SymbolEntries& GetSymbolEntries()
+  {
+    static const SymbolEntries Entries;
+    return Entries;
+  }
+
+  uint32_t ReverseBits(uint32_t Code, uint32_t Length)
+  {
+    uint32_t Reversed = 0;
+    for(uint32_t i = 0; i < Length; ++i, Code >>= 1)
+      Reversed = Reversed << 1 | (Code & 1);
+    return Reversed;
+  }
+
+  /* Build the table of the canonical Huffman code with the lengths. Codes are stored with their bits reversed, as deflate reads
+   * them from the least significant bit on. Entries no code maps to stay invalid, which allows the incomplete codes deflate
+   * permits; over-subscribed lengths are rejected. */
+  bool BuildDecodeTable(const uint8_t* pLengths, uint32_t SymbolNum, const uint32_t* pEntries, uint32_t TableBits, std::vector<uint32_t>& Table)
+  {
+    uint32_t Counts[16] = {};
+    uint32_t MaxLength = 0;
+    for(uint32_t Symbol = 0; Symbol < SymbolNum; ++Symbol)
+    {
+      ++Counts[pLengths[Symbol]];
+      MaxLength = pLengths[Symbol] > MaxLength ? pLengths[Symbol] : MaxLength;
+    }
+    Counts[0] = 0;
+
+    int32_t Left = 1;
+    uint32_t NextCodes[16] = {};
+    for(uint32_t Length = 1; Length < 16; ++Length)
+    {
+      Left = (Left << 1) - static_cast<int32_t>(Counts[Length]);
+      if(Left < 0)
+        return false;
+      NextCodes[Length] = (NextCodes[Length - 1] + Counts[Length - 1]) << 1;
+    }
+
+    const uint32_t Invalid = MakeEntry(0, EntryInvalid, 0) | 1;
+    const uint32_t SubtableBits = MaxLength > TableBits ? MaxLength - TableBits : 0;
+    Table.assign(size_t(1) << TableBits, Invalid);
+
+    for(uint32_t Symbol = 0; Symbol < SymbolNum; ++Symbol)
+    {
+      uint32_t Length = pLengths[Symbol];
+      if(Length == 0)
+        continue;
+
+      uint32_t Reversed = ReverseBits(NextCodes[Length]++, Length);
+      if(Length <= TableBits)
+      {
+        for(uint32_t i = Reversed; i < (1u << TableBits); i += 1u << Length)
+          Table[i] = pEntries[Symbol] | Length;
+        continue;
+      }
+
+      //Longer codes share a subtable per prefix of "TableBits" bits, indexed by their remaining bits.
+      uint32_t Prefix = Reversed & ((1u << TableBits) - 1);
+      if((Table[Prefix] & EntrySubtable) == 0)
+      {
+        Table[Prefix] = MakeEntry(static_cast<uint32_t>(Table.size()), EntrySubtable, SubtableBits) | TableBits;
+        Table.resize(Table.size() + (size_t(1) << SubtableBits), Invalid);
+      }
+
+      uint32_t Offset = Table[Prefix] >> 16;
+      uint32_t SubLength = Length - TableBits;
+      for(uint32_t i = Reversed >> TableBits; i < (1u << SubtableBits); i += 1u << SubLength)
+        Table[Offset + i] = pEntries[Symbol] | SubLength;
+    }
+
+    return true;
+  }
+
+  uint64_t ReadLittleEndian64(const uint8_t* pData)
+  {
+    uint64_t Value;
+    std::memcpy(&Value, pData, sizeof(Value));
+    return Value;
+  }
+
+  uint32_t ReadBigEndian32(const uint8_t* pData)
+  {
+    return static_cast<uint32_t>(pData[0]) << 24 | static_cast<uint32_t>(pData[1]) << 16 | static_cast<uint32_t>(pData[2]) << 8 | pData[3];
+  }
+
+  //Reads the bits of deflate from the least significant one on, the input has to be followed by "InputPadding" readable bytes.
+  class BitReader
+  {
+    public:
+    BitReader(const uint8_t* pBegin, const uint8_t* pEnd) : m_pNext(pBegin), m_pEnd(pEnd) {}
+
+    //At least 56 bits are buffered afterwards, one refill is enough for a length and a distance with their extra bits.
+    void Refill()
+    {
+      //Past the end only the zeros of the padding are read, a stream that needs them is corrupt.
+      if(m_pNext > m_pEnd + InputPadding - 8)
+      {
+        m_bOverrun = true;
+        m_pNext = m_pEnd + InputPadding - 8;
+      }
+
+      m_Bits |= ReadLittleEndian64(m_pNext) << m_BitNum;
+      m_pNext += (63 - m_BitNum) >> 3;
+      m_BitNum |= 56;
+    }
+
+    uint32_t Take(uint32_t BitNum)
+    {
+      uint32_t Value = static_cast<uint32_t>(m_Bits & ((uint64_t(1) << BitNum) - 1));
+      m_Bits >>= BitNum;
+      m_BitNum -= BitNum;
+      return Value;
+    }
+
+    //Refills on its own, for the headers of the blocks.
+    uint32_t Read(uint32_t BitNum)
+    {
+      if(m_BitNum < BitNum)
+        Refill();
+      return Take(BitNum);
+    }
+
+    uint32_t Decode(const uint32_t* pTable, uint32_t TableBits)
+    {
+      uint32_t Entry = pTable[m_Bits & ((1u << TableBits) - 1)];
+      if(Entry & EntrySubtable)
+      {
+        Take(TableBits);
+        Entry = pTable[(Entry >> 16) + (m_Bits & ((1u << ((Entry >> 8) & 0xF)) - 1))];
+      }
+
+      Take(Entry & 0xFF);
+      return Entry;
+    }
+
+    //Drop the bits up to the next byte and hand the bytes that were buffered back, stored blocks are read byte by byte.
+    const uint8_t* AlignToByte()
+    {
+      Take(m_BitNum & 7);
+      m_pNext -= m_BitNum >> 3;
+      m_Bits = 0;
+      m_BitNum = 0;
+      return m_pNext;
+    }
+
+    void Skip(const uint8_t* pNext) {m_pNext = pNext;}
+
+    bool HasOverrun() const {return m_bOverrun;}
+
+    protected:
+    const uint8_t* m_pNext;
+    const uint8_t* m_pEnd;
+    uint64_t m_Bits = 0;
+    uint32_t m_BitNum = 0;
+    bool m_bOverrun = false;
+  };
+
+  bool ReadDynamicTables(BitReader& Reader, std::vector<uint32_t>& LitLenTable, std::vector<uint32_t>& DistanceTable)
+  {
+    const uint8_t PrecodeOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    const SymbolEntries& Entries = GetSymbolEntries();
+
+    uint32_t LitLenNum = Reader.Read(5) + 257;
+    uint32_t DistanceNum = Reader.Read(5) + 1;
+    uint32_t PrecodeNum = Reader.Read(4) + 4;
+
+    uint8_t PrecodeLengths[19] = {};
+    for(uint32_t i = 0; i < PrecodeNum; ++i)
+      PrecodeLengths[PrecodeOrder[i]] = static_cast<uint8_t>(Reader.Read(3));
+
+    std::vector<uint32_t> PrecodeTable;
+    if(!BuildDecodeTable(PrecodeLengths, 19, Entries.Precode, PrecodeTableBits, PrecodeTable))
+      return false;
+
+    //The lengths of both codes are one sequence, a repeat may run from one into the other.
+    uint8_t Lengths[288 + 32] = {};
+    for(uint32_t i = 0; i < LitLenNum + DistanceNum;)
+    {
+      Reader.Refill();
+      uint32_t Entry = Reader.Decode(PrecodeTable.data(), PrecodeTableBits);
+      if(Entry & EntryInvalid)
+        return false;
+
+      uint32_t Symbol = Entry >> 16;
+      if(Symbol < 16)
+      {
+        Lengths[i++] = static_cast<uint8_t>(Symbol);
+        continue;
+      }
+
+      uint8_t Repeated = 0;
+      uint32_t RepeatNum = 0;
+      if(Symbol == 16)
+      {
+        if(i == 0)
+          return false;
+        Repeated = Lengths[i - 1];
+        RepeatNum = 3 + Reader.Take(2);
+      }
+      else if(Symbol == 17)
+        RepeatNum = 3 + Reader.Take(3);
+      else
+        RepeatNum = 11 + Reader.Take(7);
+
+      if(i + RepeatNum > LitLenNum + DistanceNum)
+        return false;
+      std::memset(Lengths + i, Repeated, RepeatNum);
+      i += RepeatNum;
+    }
+
+    if(Lengths[256] == 0)
+      return false;
+
+    return BuildDecodeTable(Lengths, LitLenNum, Entries.LitLen, LitLenTableBits, LitLenTable) &&
+           BuildDecodeTable(Lengths + LitLenNum, DistanceNum, Entries.Distance, DistanceTableBits, DistanceTable);
+  }
+
+  void BuildFixedTables(std::vector<uint32_t>& LitLenTable, std::vector<uint32_t>& DistanceTable)
+  {
+    const SymbolEntries& Entries = GetSymbolEntries();
+
+    uint8_t Lengths[288];
+    std::memset(Lengths, 8, 144);
+    std::memset(Lengths + 144, 9, 112);
+    std::memset(Lengths + 256, 7, 24);
+    std::memset(Lengths + 280, 8, 8);
+    BuildDecodeTable(Lengths, 288, Entries.LitLen, LitLenTableBits, LitLenTable);
+
+    std::memset(Lengths, 5, 32);
+    BuildDecodeTable(Lengths, 32, Entries.Distance, DistanceTableBits, DistanceTable);
+  }
+
+  /* Inflate a zlib stream into exactly "OutputSize" bytes, "pOutput" has "OutputPadding" more. The input has to be followed by
+   * "InputPadding" zero bytes. */
+  bool Inflate(const uint8_t* pInput, size_t InputSize, uint8_t* pOutput, size_t OutputSize)
+  {
+    //The zlib header: deflate, no preset dictionary.
+    if(InputSize < 2 || (pInput[0] & 0x0F) != 8 || (pInput[0] * 256u + pInput[1]) % 31 != 0 || (pInput[1] & 0x20) != 0)
+      return false;
+
+    const uint8_t* pInputEnd = pInput + InputSize;
+    BitReader Reader(pInput + 2, pInputEnd);
+    uint8_t* pOut = pOutput;
+    uint8_t* const pOutEnd = pOutput + OutputSize;
+    std::vector<uint32_t> LitLenTable, DistanceTable;
+
+    bool bFinal = false;
+    while(!bFinal)
+    {
+      bFinal = Reader.Read(1) != 0;
+      uint32_t BlockType = Reader.Read(2);
+
+      if(BlockType == 0)
+      {
+        const uint8_t* pStored = Reader.AlignToByte();
+        if(pInputEnd - pStored < 4)
+          return false;
+
+        uint32_t Length = pStored[0] | pStored[1] << 8;
+        uint32_t LengthComplement = pStored[2] | pStored[3] << 8;
+        pStored += 4;
+        if((Length ^ 0xFFFF) != LengthComplement || Length > static_cast<size_t>(pInputEnd - pStored) || Length > static_cast<size_t>(pOutEnd - pOut))
+          return false;
+
+        std::memcpy(pOut, pStored, Length);
+        pOut += Length;
+        Reader.Skip(pStored + Length);
+        continue;
+      }
+
+      if(BlockType == 1)
+        BuildFixedTables(LitLenTable, DistanceTable);
+      else if(BlockType != 2 || !ReadDynamicTables(Reader, LitLenTable, DistanceTable))
+        return false;
+
+      const uint32_t* pLitLen = LitLenTable.data();
+      const uint32_t* pDistance = DistanceTable.data();
+      for(;;)
+      {
+        Reader.Refill();
+        uint32_t Entry = Reader.Decode(pLitLen, LitLenTableBits);
+        if(Entry & EntryLiteral)
+        {
+          if(pOut == pOutEnd)
+            return false;
+          *pOut++ = static_cast<uint8_t>(Entry >> 16);
+          continue;
+        }
+
+        if(Entry & EntryEnd)
+          break;
+        if(Entry & EntryInvalid)
+          return false;
+
+        uint32_t Length = (Entry >> 16) + Reader.Take((Entry >> 8) & 0xF);
+        Entry = Reader.Decode(pDistance, DistanceTableBits);
+        if(Entry & EntryInvalid)
+          return false;
+        uint32_t Distance = (Entry >> 16) + Reader.Take((Entry >> 8) & 0xF);
+
+        if(Distance > static_cast<size_t>(pOut - pOutput) || Length > static_cast<size_t>(pOutEnd - pOut))
+          return false;
+
+        //A match at least 8 bytes back never reads what the same copy writes, it may run up to 7 bytes into the padding.
+        const uint8_t* pFrom = pOut - Distance;
+        uint8_t* pStop = pOut + Length;
+        if(Distance >= 8)
+        {
+          do
+          {
+            std::memcpy(pOut, pFrom, 8);
+            pOut += 8;
+            pFrom += 8;
+          } while(pOut < pStop);
+        }
+        else if(Distance == 1)
+          std::memset(pOut, *pFrom, Length);
+        else
+        {
+          for(uint8_t* pByte = pOut; pByte < pStop; ++pByte, ++pFrom)
+            *pByte = *pFrom;
+        }
+        pOut = pStop;
+      }
+
+      if(Reader.HasOverrun())
+        return false;
+    }
+
+    return pOut == pOutEnd && !Reader.HasOverrun();
+  }
+
+  uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c)
+  {
+    int32_t pa = std::abs(static_cast<int32_t>(b) - c);
+    int32_t pb = std::abs(static_cast<int32_t>(a) - c);
+    int32_t pc = std::abs(static_cast<int32_t>(a) + b - 2 * c);
+    return pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+  }
+
+#ifdef PNG_SIMD_SSE2
+  //One pixel of 3 or 4 bytes in the lowest lanes of a register.
+  template <uint32_t Bpp>
+  __m128i LoadPixel(const uint8_t* pPixel)
+  {
+    uint32_t Value = 0;
+    std::memcpy(&Value, pPixel, Bpp);
+    return _mm_cvtsi32_si128(static_cast<int>(Value));
+  }
+
+  template <uint32_t Bpp>
+  void StorePixel(uint8_t* pPixel, __m128i Pixel)
+  {
+    uint32_t Value = static_cast<uint32_t>(_mm_cvtsi128_si32(Pixel));
+    std::memcpy(pPixel, &Value, Bpp);
+  }
+
+  __m128i Select(__m128i Condition, __m128i Then, __m128i Else) {return _mm_or_si128(_mm_and_si128(Condition, Then), _mm_andnot_si128(Condition, Else));}
+
+  __m128i Abs16(__m128i Value) {return _mm_max_epi16(Value, _mm_sub_epi16(_mm_setzero_si128(), Value));}
+
+  //The filters that depend on the pixel before work a pixel at a time, all its channels at once.
+  template <uint32_t Bpp>
+  void UnfilterSub(uint8_t* pRow, size_t RowBytes)
+  {
+    __m128i Left = _mm_setzero_si128();
+    for(size_t i = 0; i < RowBytes; i += Bpp)
+    {
+      Left = _mm_add_epi8(LoadPixel<Bpp>(pRow + i), Left);
+      StorePixel<Bpp>(pRow + i, Left);
+    }
+  }
+
+  template <uint32_t Bpp>
+  void UnfilterAverage(uint8_t* pRow, const uint8_t* pPrior, size_t RowBytes)
+  {
+    //"_mm_avg_epu8()" rounds up, the filter rounds down.
+    const __m128i One = _mm_set1_epi8(1);
+    __m128i Left = _mm_setzero_si128();
+    for(size_t i = 0; i < RowBytes; i += Bpp)
+    {
+      __m128i Up = LoadPixel<Bpp>(pPrior + i);
+      __m128i Average = _mm_sub_epi8(_mm_avg_epu8(Left, Up), _mm_and_si128(_mm_xor_si128(Left, Up), One));
+      Left = _mm_add_epi8(LoadPixel<Bpp>(pRow + i), Average);
+      StorePixel<Bpp>(pRow + i, Left);
+    }
+  }
+
+  template <uint32_t Bpp>
+  void UnfilterPaeth(uint8_t* pRow, const uint8_t* pPrior, size_t RowBytes)
+  {
+    //In 16 bit lanes, the estimates need 10 bits with their sign.
+    const __m128i Zero = _mm_setzero_si128();
+    __m128i a = Zero, c = Zero;
+    for(size_t i = 0; i < RowBytes; i += Bpp)
+    {
+      __m128i b = _mm_unpacklo_epi8(LoadPixel<Bpp>(pPrior + i), Zero);
+      __m128i x = _mm_unpacklo_epi8(LoadPixel<Bpp>(pRow + i), Zero);
+
+      __m128i pa = _mm_sub_epi16(b, c);
+      __m128i pb = _mm_sub_epi16(a, c);
+      __m128i pc = Abs16(_mm_add_epi16(pa, pb));
+      pa = Abs16(pa);
+      pb = Abs16(pb);
+
+      __m128i Smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+      __m128i Predictor = Select(_mm_cmpeq_epi16(Smallest, pc), c, b);
+      Predictor = Select(_mm_cmpeq_epi16(Smallest, pb), b, Predictor);
+      Predictor = Select(_mm_cmpeq_epi16(Smallest, pa), a, Predictor);
+
+      //The high bytes of the lanes stay zero, the addition wraps like the filter.
+      a = _mm_add_epi8(x, Predictor);
+      StorePixel<Bpp>(pRow + i, _mm_packus_epi16(a, a));
+      c = b;
+    }
+  }
+#endif
+
+  bool UnfilterRow(uint8_t Filter, uint8_t* pRow, const uint8_t* pPrior, size_t RowBytes, uint32_t Bpp)
+  {
+    switch(Filter)
+    {
+      case 0:
+        return true;
+      case 1:
+#ifdef PNG_SIMD_SSE2
+        if(Bpp == 4)
+          UnfilterSub<4>(pRow, RowBytes);
+        else if(Bpp == 3)
+          UnfilterSub<3>(pRow, RowBytes);
+        else
+#endif
+        for(size_t i = Bpp; i < RowBytes; ++i)
+          pRow[i] = static_cast<uint8_t>(pRow[i] + pRow[i - Bpp]);
+        return true;
+      case 2:
+      {
+        size_t i = 0;
+#ifdef PNG_SIMD_SSE2
+        //Independent of the pixels before, 16 bytes at once.
+        for(; i + 16 <= RowBytes; i += 16)
+        {
+          __m128i Sum = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPrior + i)));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(pRow + i), Sum);
+        }
+#endif
+        for(; i < RowBytes; ++i)
+          pRow[i] = static_cast<uint8_t>(pRow[i] + pPrior[i]);
+        return true;
+      }
+      case 3:
+#ifdef PNG_SIMD_SSE2
+        if(Bpp == 4)
+          UnfilterAverage<4>(pRow, pPrior, RowBytes);
+        else if(Bpp == 3)
+          UnfilterAverage<3>(pRow, pPrior, RowBytes);
+        else
+#endif
+        for(size_t i = 0; i < RowBytes; ++i)
+          pRow[i] = static_cast<uint8_t>(pRow[i] + (((i >= Bpp ? pRow[i - Bpp] : 0) + pPrior[i]) >> 1));
+        return true;
+      case 4:
+#ifdef PNG_SIMD_SSE2
+        if(Bpp == 4)
+          UnfilterPaeth<4>(pRow, pPrior, RowBytes);
+        else if(Bpp == 3)
+          UnfilterPaeth<3>(pRow, pPrior, RowBytes);
+        else
+#endif
+        for(size_t i = 0; i < RowBytes; ++i)
+          pRow[i] = static_cast<uint8_t>(pRow[i] + (i >= Bpp ? Paeth(pRow[i - Bpp], pPrior[i], pPrior[i - Bpp]) : pPrior[i]));
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  struct PngFile
+  {
+    PngInfo Info;
+    uint32_t ColorType = 0;
+    //RGBA with the red channel in the lowest byte, opaque unless "tRNS" says otherwise.
+    uint32_t Palette[256] = {};
+    uint32_t PaletteSize = 0;
+    std::vector<uint8_t> Compressed;
+  };
+
+  //The header and the chunks up to the first "IDAT" (all of them with "bCollectData"), whose data is concatenated.
+  bool ParsePng(const void* pData, size_t Size, bool bCollectData, PngFile& File)
+  {
+    const uint8_t* pByte = static_cast<const uint8_t*>(pData);
+    const uint8_t* pEnd = pByte + Size;
+    if(Size < 8 + 25 || std::memcmp(pByte, PngSignature, 8) != 0 || std::memcmp(pByte + 12, "IHDR", 4) != 0)
+      return false;
+
+    const uint8_t* pHeader = pByte + 16;
+    File.Info.Width = ReadBigEndian32(pHeader);
+    File.Info.Height = ReadBigEndian32(pHeader + 4);
+    uint32_t BitDepth = pHeader[8];
+    File.ColorType = pHeader[9];
+    bool bStandard = pHeader[10] == 0 && pHeader[11] == 0 && pHeader[12] == 0;
+
+    switch(File.ColorType)
+    {
+      case PNG_COLOR_TYPE_GRAY: File.Info.ChannelNum = 1; break;
+      case PNG_COLOR_TYPE_GRAY_ALPHA: File.Info.ChannelNum = 2; break;
+      case PNG_COLOR_TYPE_RGB:
+      case PNG_COLOR_TYPE_PALETTE: File.Info.ChannelNum = 3; break;
+      case PNG_COLOR_TYPE_RGBA: File.Info.ChannelNum = 4; break;
+      default: return false;
+    }
+
+    bool bColorKey = false;
+    for(pByte += 8; pEnd - pByte >= 12;)
+    {
+      uint32_t Length = ReadBigEndian32(pByte);
+      const uint8_t* pType = pByte + 4;
+      const uint8_t* pChunk = pByte + 8;
+      if(Length > static_cast<size_t>(pEnd - pChunk) - 4)
+        return false;
+
+      if(std::memcmp(pType, "PLTE", 4) == 0)
+      {
+        File.PaletteSize = Length / 3 < 256 ? Length / 3 : 256;
+        for(uint32_t i = 0; i < File.PaletteSize; ++i)
+          File.Palette[i] = pChunk[3 * i] | pChunk[3 * i + 1] << 8 | pChunk[3 * i + 2] << 16 | 0xFF000000u;
+      }
+      else if(std::memcmp(pType, "tRNS", 4) == 0)
+      {
+        if(File.ColorType == PNG_COLOR_TYPE_PALETTE)
+        {
+          for(uint32_t i = 0; i < Length && i < 256; ++i)
+            File.Palette[i] = (File.Palette[i] & 0x00FFFFFFu) | static_cast<uint32_t>(pChunk[i]) << 24;
+        }
+        else
+          bColorKey = true;
+      }
+      else if(std::memcmp(pType, "IDAT", 4) == 0)
+      {
+        if(!bCollectData)
+          break;
+        File.Compressed.insert(File.Compressed.end(), pChunk, pChunk + Length);
+      }
+      else if(std::memcmp(pType, "IEND", 4) == 0)
+        break;
+
+      pByte = pChunk + Length + 4;
+    }
+
+    File.Info.bSupported = BitDepth == 8 && bStandard && !bColorKey && File.Info.Width > 0 && File.Info.Height > 0 &&
+                           File.Info.Width <= MaxDimension && File.Info.Height <= MaxDimension &&
+                           (File.ColorType != PNG_COLOR_TYPE_PALETTE || File.PaletteSize > 0);
+    return true;
+  }
+
+  //Write an unfiltered row in the layout of the output.
+  void ConvertRow(const PngFile& File, const uint8_t* pRow, uint8_t* pOutput, PNG_LAYOUT Layout, size_t PixelStride)
+  {
+    const uint32_t Width = File.Info.Width;
+    const uint32_t ChannelNum = File.Info.ChannelNum;
+
+    if(Layout == PNG_LAYOUT_RED)
+    {
+      if(File.ColorType == PNG_COLOR_TYPE_PALETTE)
+      {
+        for(uint32_t x = 0; x < Width; ++x)
+          pOutput[x * PixelStride] = static_cast<uint8_t>(File.Palette[pRow[x]]);
+      }
+      else
+      {
+        for(uint32_t x = 0; x < Width; ++x)
+          pOutput[x * PixelStride] = pRow[x * ChannelNum];
+      }
+      return;
+    }
+
+    //The rows are followed by more inflated data or the padding, reading 4 bytes for a pixel of 3 stays within the buffer.
+    uint32_t Pixel;
+    switch(File.ColorType)
+    {
+      case PNG_COLOR_TYPE_RGBA:
+        std::memcpy(pOutput, pRow, static_cast<size_t>(Width) * 4);
+        break;
+      case PNG_COLOR_TYPE_RGB:
+        for(uint32_t x = 0; x < Width; ++x)
+        {
+          std::memcpy(&Pixel, pRow + 3 * x, 4);
+          Pixel |= 0xFF000000u;
+          std::memcpy(pOutput + 4 * x, &Pixel, 4);
+        }
+        break;
+      case PNG_COLOR_TYPE_PALETTE:
+        for(uint32_t x = 0; x < Width; ++x)
+          std::memcpy(pOutput + 4 * x, &File.Palette[pRow[x]], 4);
+        break;
+      case PNG_COLOR_TYPE_GRAY:
+        for(uint32_t x = 0; x < Width; ++x)
+        {
+          Pixel = pRow[x] * 0x010101u | 0xFF000000u;
+          std::memcpy(pOutput + 4 * x, &Pixel, 4);
+        }
+        break;
+      default:
+        for(uint32_t x = 0; x < Width; ++x)
+        {
+          Pixel = pRow[2 * x] * 0x010101u | static_cast<uint32_t>(pRow[2 * x + 1]) << 24;
+          std::memcpy(pOutput + 4 * x, &Pixel, 4);
+        }
+        break;
+    }
+  }
+}
+
+bool ReadPngInfo(const void* pData, size_t Size, PngInfo& Info)
+{
+  PngFile File;
+  if(!ParsePng(pData, Size, false, File))
+    return false;
+
+  Info = File.Info;
+  return true;
+}
+
+bool DecodePng(const void* pData, size_t Size, uint8_t* pOutput, size_t RowPitch, PNG_LAYOUT Layout, size_t PixelStride)
+{
+  PngFile File;
+  if(!ParsePng(pData, Size, true, File) || !File.Info.bSupported)
+    return false;
+
+  //A palette index is one byte, every other channel as well.
+  const uint32_t Bpp = File.ColorType == PNG_COLOR_TYPE_PALETTE ? 1 : File.Info.ChannelNum;
+  const size_t RowBytes = static_cast<size_t>(File.Info.Width) * Bpp;
+  const size_t FilteredSize = (RowBytes + 1) * File.Info.Height;
+
+  size_t CompressedSize = File.Compressed.size();
+  File.Compressed.resize(CompressedSize + InputPadding, 0);
+
+  std::vector<uint8_t> Filtered(FilteredSize + OutputPadding);
+  if(!Inflate(File.Compressed.data(), CompressedSize, Filtered.data(), FilteredSize))
+    return false;
+
+  //Every row is unfiltered in place against the one above it and written out right away, while it is still in the cache.
+  std::vector<uint8_t> ZeroRow(RowBytes, 0);
+  const uint8_t* pPrior = ZeroRow.data();
+  for(uint32_t y = 0; y < File.Info.Height; ++y)
+  {
+    uint8_t* pRow = Filtered.data() + y * (RowBytes + 1);
+    if(!UnfilterRow(pRow[0], pRow + 1, pPrior, RowBytes, Bpp))
+      return false;
+
+    ConvertRow(File, pRow + 1, pOutput + y * RowPitch, Layout, PixelStride);
+    pPrior = pRow + 1;
+  }
+
+  return true;
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+struct PngInfo
+{
+  uint32_t Width = 0;
+  uint32_t Height = 0;
+  //Of the file: 1 gray, 2 gray and alpha, 3 RGB (also for a palette), 4 RGBA.
+  uint32_t ChannelNum = 0;
+  //8 bits per channel, not interlaced and no transparent color key: the files "DecodePng()" handles.
+  bool bSupported = false;
+};
+
+//Parse the header of a PNG file, false if it is not one.
+bool ReadPngInfo(const void* pData, size_t Size, PngInfo& Info);
+
+enum PNG_LAYOUT
+{
+  PNG_LAYOUT_RGBA, //4 bytes per pixel, gray is replicated into red, green and blue and a missing alpha is opaque.
+  PNG_LAYOUT_RED   //The gray or red channel only, one byte every "PixelStride" bytes, e.g. into one channel of an RGBA image.
+};
+
+/* Decode a PNG straight into memory of the caller, e.g. a mapped staging buffer or a channel of a packed texture, in the layout
+ * it is used in; rows are "RowPitch" bytes apart. Nothing is allocated for the pixels besides the inflated rows, which are
+ * unfiltered in place. The zlib stream is inflated by a table driven decoder that refills 64 bits at a time and copies matches
+ * 8 bytes at a time, the rows are unfiltered with SSE2 where the compiler targets it. Checksums are not verified. Returns false
+ * for files it does not handle (see "PngInfo::bSupported") and corrupt ones, the output may be partly written then. */
+bool DecodePng(const void* pData, size_t Size, uint8_t* pOutput, size_t RowPitch, PNG_LAYOUT Layout, size_t PixelStride = 1);
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "ResidencyManager.hpp"
+
+#include <algorithm>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //Without "VK_EXT_memory_budget" some of every heap is left to the other processes and the driver.
+  const VkDeviceSize FallbackBudgetPercentage = 80;
+}
+
+void ResidencyManager::Create(VkInstance Instance, VkPhysicalDevice PhysicalDevice, bool bMemoryBudget, VkDeviceSize TextureBudget)
+{
+  m_PhysicalDevice = PhysicalDevice;
+  m_TextureBudget = TextureBudget;
+
+  if(bMemoryBudget)
+    m_pGetMemoryProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(vkGetInstanceProcAddr(Instance, "vkGetPhysicalDeviceMemoryProperties2KHR"));
+
+  vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+  m_Heaps.assign(m_MemoryProperties.memoryHeapCount, HeapBudget());
+  for(uint32_t Heap = 0; Heap < m_MemoryProperties.memoryHeapCount; ++Heap)
+    m_Heaps[Heap].Size = m_MemoryProperties.memoryHeaps[Heap].size;
+
+  m_TextureHeap = m_MemoryProperties.memoryTypes[FindMemoryType(m_PhysicalDevice, ~0u, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)].heapIndex;
+
+  Update({});
+}
+
+void ResidencyManager::Update(const std::vector<const TextureInfo*>& Textures)
+{
+  if(m_pGetMemoryProperties2 != nullptr)
+  {
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT BudgetProperties = {};
+    BudgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2KHR Properties = {};
+    Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR;
+    Properties.pNext = &BudgetProperties;
+    m_pGetMemoryProperties2(m_PhysicalDevice, &Properties);
+
+    for(uint32_t Heap = 0; Heap < m_Heaps.size(); ++Heap)
+    {
+      m_Heaps[Heap].Budget = BudgetProperties.heapBudget[Heap];
+      m_Heaps[Heap].Usage = BudgetProperties.heapUsage[Heap];
+    }
+  }
+  else
+  {
+    for(auto& Heap : m_Heaps)
+    {
+      Heap.Budget = Heap.Size / 100 * FallbackBudgetPercentage;
+      Heap.Usage = 0;
+    }
+
+    for(uint32_t Type = 0; Type < m_MemoryProperties.memoryTypeCount; ++Type)
+      m_Heaps[m_MemoryProperties.memoryTypes[Type].heapIndex].Usage += GetAllocatedMemorySize(Type);
+  }
+
+  for(auto& Heap : m_Heaps)
+    Heap.TextureUsage = 0;
+
+  //Textures that share an image count it once.
+  std::vector<const TextureInfo*> UniqueTextures = Textures;
+  std::sort(UniqueTextures.begin(), UniqueTextures.end());
+  UniqueTextures.erase(std::unique(UniqueTextures.begin(), UniqueTextures.end()), UniqueTextures.end());
+
+  for(const auto* pTexture : UniqueTextures)
+  {
+    VkDeviceSize Size = 0;
+    uint32_t MemoryTypeIndex = 0;
+    if(pTexture != nullptr && pTexture->TextureImageMemory != VK_NULL_HANDLE && GetAllocationInfo(pTexture->TextureImageMemory, Size, MemoryTypeIndex))
+      m_Heaps[m_MemoryProperties.memoryTypes[MemoryTypeIndex].heapIndex].TextureUsage += Size;
+  }
+}
+
+VkDeviceSize ResidencyManager::GetTextureBudget() const
+{
+  //The usage the driver reports lags behind allocations, it is never taken to be below what the textures alone take up.
+  const HeapBudget& Heap = m_Heaps[m_TextureHeap];
+  VkDeviceSize OtherUsage = Heap.Usage - std::min(Heap.Usage, Heap.TextureUsage);
+  VkDeviceSize Available = Heap.Budget - std::min(Heap.Budget, OtherUsage);
+
+  return std::min(m_TextureBudget, Available);
+}
+
+VkDeviceSize ResidencyManager::GetTextureUsage() const
+{
+  VkDeviceSize Usage = 0;
+  for(const auto& Heap : m_Heaps)
+    Usage += Heap.TextureUsage;
+
+  return Usage;
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include "Namespace.hpp"
+#include "VulkanHelper.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//A memory heap of the device.
+struct HeapBudget
+{
+  VkDeviceSize Size = 0;
+  //What the process can allocate from the heap without the driver paging, a share of the size if the driver does not report it.
+  VkDeviceSize Budget = 0;
+  //What the process has allocated from the heap, only the allocations of "AllocateMemory()" if the driver does not report it.
+  VkDeviceSize Usage = 0;
+  //The part of the usage the textures take up.
+  VkDeviceSize TextureUsage = 0;
+};
+
+/* Keeps track of the memory of every heap and of the part of it the textures take up, and decides how much they may take up:
+ * the configured budget, limited by what the heap of the textures has left besides everything else the process allocated from
+ * it. With "VK_EXT_memory_budget" the driver reports the budget and the usage of the heaps, which also accounts for the memory
+ * other processes use. Which levels of the textures are evicted to stay within the budget is up to the texture streamer. */
+class ResidencyManager
+{
+  public:
+  /* "bMemoryBudget": the instance was created with "VK_KHR_get_physical_device_properties2" and the device with
+   * "VK_EXT_memory_budget". */
+  void Create(VkInstance Instance, VkPhysicalDevice PhysicalDevice, bool bMemoryBudget, VkDeviceSize TextureBudget);
+
+  //Query the heaps again and add the memory of the textures up, once per frame.
+  void Update(const std::vector<const TextureInfo*>& Textures);
+
+  bool HasMemoryBudget() const {return m_pGetMemoryProperties2 != nullptr;}
+
+  const std::vector<HeapBudget>& GetHeaps() const {return m_Heaps;}
+
+  uint32_t GetTextureHeap() const {return m_TextureHeap;}
+
+  //What the textures may take up.
+  VkDeviceSize GetTextureBudget() const;
+
+  VkDeviceSize GetTextureUsage() const;
+
+  protected:
+  VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+  PFN_vkGetPhysicalDeviceMemoryProperties2KHR m_pGetMemoryProperties2 = nullptr;
+  VkPhysicalDeviceMemoryProperties m_MemoryProperties = {};
+  std::vector<HeapBudget> m_Heaps;
+  //The heap of the device local memory textures are allocated from.
+  uint32_t m_TextureHeap = 0;
+  VkDeviceSize m_TextureBudget = 0;
+};
+
+NAMESPACE_END
\ No newline at end of file
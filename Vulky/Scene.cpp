@@ -0,0 +1,763 @@
+#include "Scene.hpp"
+#include "MeshOptimizer.hpp"
+#include "ObjLoader.hpp"
+#include "MeshSimplifier.hpp"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  double ElapsedMilliseconds(std::chrono::steady_clock::time_point Start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+  }
+
+  //Assimp matrices are row-major.
+  glm::mat4 ConvertMatrix(const aiMatrix4x4& Matrix) {return glm::transpose(glm::make_mat4(&Matrix.a1));}
+
+  const uint32_t MeshCacheMagic = 0x48534D56; //"VMSH"
+  const uint32_t MeshCacheVersion = 7;
+
+  //The cache is only valid for the exact model file it was built from, with the same importer and for the current vertex layout.
+  struct MeshCacheHeader
+  {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t VertexSize;
+    uint32_t Importer;
+    uint64_t SourceSize;
+    int64_t SourceTime;
+    uint64_t VertexNum;
+    uint64_t IndexNum;
+    uint64_t MeshNum;
+    uint64_t NodeNum;
+    uint64_t DrawNum;
+    uint64_t MaterialNum;
+    uint64_t LodNum;
+    uint64_t MeshletNum;
+    uint64_t SourceVertexNum;
+    double AcmrBefore;
+    double AcmrAfter;
+    double AtvrBefore;
+    double AtvrAfter;
+  };
+
+  bool GetSourceStamp(const std::string& SourcePath, uint64_t& SourceSize, int64_t& SourceTime)
+  {
+    std::error_code Error;
+    SourceSize = static_cast<uint64_t>(std::filesystem::file_size(SourcePath, Error));
+    if(Error)
+      return false;
+
+    SourceTime = static_cast<int64_t>(std::filesystem::last_write_time(SourcePath, Error).time_since_epoch().count());
+    return !Error;
+  }
+
+  //"Remaining" is what is left of the file, a count that does not fit into it is rejected before anything is allocated.
+  template<typename T>
+  bool ReadArray(std::ifstream& File, std::vector<T>& Array, uint64_t Num, uint64_t& Remaining)
+  {
+    if(Num > Remaining / sizeof(T))
+      return false;
+    Remaining -= Num * sizeof(T);
+
+    Array.resize(Num);
+    return static_cast<bool>(File.read(reinterpret_cast<char*>(Array.data()), Array.size() * sizeof(T)));
+  }
+
+  template<typename T>
+  void WriteArray(std::ofstream& File, const std::vector<T>& Array)
+  {
+    File.write(reinterpret_cast<const char*>(Array.data()), Array.size() * sizeof(T));
+  }
+
+  //Every index, mesh, node and draw has to refer to something that exists, so a corrupt cache never reaches the GPU.
+  bool IsCacheConsistent(const Scene& Result)
+  {
+    if(Result.Indices.size() % 3 != 0)
+      return false;
+
+    for(size_t Mesh = 0; Mesh < Result.MeshNum(); ++Mesh)
+    {
+      uint64_t IndexEnd = static_cast<uint64_t>(Result.MeshFirstIndex[Mesh]) + Result.MeshIndexNum[Mesh];
+      int64_t VertexEnd = static_cast<int64_t>(Result.MeshBaseVertex[Mesh]) + Result.MeshVertexNum[Mesh];
+      if(IndexEnd > Result.Indices.size() || Result.MeshBaseVertex[Mesh] < 0 || VertexEnd > static_cast<int64_t>(Result.Vertices.size()) ||
+         Result.MeshMaterial[Mesh] >= Result.MaterialNames.size())
+        return false;
+
+      //The indices of a mesh are relative to its base vertex.
+      for(uint64_t i = Result.MeshFirstIndex[Mesh]; i < IndexEnd; ++i)
+      {
+        if(Result.Indices[i] >= Result.MeshVertexNum[Mesh])
+          return false;
+      }
+
+      //Its levels of detail use the same vertices, the first one is the mesh itself.
+      uint64_t LodEnd = static_cast<uint64_t>(Result.MeshFirstLod[Mesh]) + Result.MeshLodNum[Mesh];
+      if(Result.MeshLodNum[Mesh] == 0 || Result.MeshLodNum[Mesh] > MaxLodNum || LodEnd > Result.LodNum())
+        return false;
+
+      for(uint64_t Lod = Result.MeshFirstLod[Mesh]; Lod < LodEnd; ++Lod)
+      {
+        uint64_t LodIndexEnd = static_cast<uint64_t>(Result.LodFirstIndex[Lod]) + Result.LodIndexNum[Lod];
+        if(LodIndexEnd > Result.Indices.size() || Result.LodIndexNum[Lod] % 3 != 0)
+          return false;
+
+        for(uint64_t i = Result.LodFirstIndex[Lod]; i < LodIndexEnd; ++i)
+        {
+          if(Result.Indices[i] >= Result.MeshVertexNum[Mesh])
+            return false;
+        }
+
+        //Its meshlets are ranges of its indices.
+        uint64_t MeshletEnd = static_cast<uint64_t>(Result.LodFirstMeshlet[Lod]) + Result.LodMeshletNum[Lod];
+        if(MeshletEnd > Result.MeshletNum())
+          return false;
+
+        for(uint64_t Meshlet = Result.LodFirstMeshlet[Lod]; Meshlet < MeshletEnd; ++Meshlet)
+        {
+          if(Result.MeshletFirstIndex[Meshlet] < Result.LodFirstIndex[Lod] ||
+             static_cast<uint64_t>(Result.MeshletFirstIndex[Meshlet]) + Result.MeshletIndexNum[Meshlet] > LodIndexEnd)
+            return false;
+        }
+      }
+    }
+
+    //A parent always comes before its children.
+    for(size_t Node = 0; Node < Result.NodeNum(); ++Node)
+    {
+      if(Result.NodeParent[Node] >= static_cast<int64_t>(Node) || Result.NodeParent[Node] < -1)
+        return false;
+    }
+
+    for(size_t Draw = 0; Draw < Result.DrawNum(); ++Draw)
+    {
+      if(Result.DrawMesh[Draw] >= Result.MeshNum() || Result.DrawNode[Draw] >= Result.NodeNum())
+        return false;
+    }
+
+    return true;
+  }
+
+  bool LoadMeshCache(const std::string& CachePath, const std::string& SourcePath, MESH_IMPORTER Importer, Scene& Result, MeshImportStatistics& Statistics)
+  {
+    std::ifstream File(CachePath, std::ios::binary);
+    if(!File.is_open())
+      return false;
+
+    MeshCacheHeader Header = {};
+    uint64_t SourceSize = 0;
+    int64_t SourceTime = 0;
+    if(!File.read(reinterpret_cast<char*>(&Header), sizeof(Header)) || !GetSourceStamp(SourcePath, SourceSize, SourceTime))
+      return false;
+
+    if(Header.Magic != MeshCacheMagic || Header.Version != MeshCacheVersion || Header.VertexSize != sizeof(Vertex) || Header.Importer != Importer ||
+       Header.SourceSize != SourceSize || Header.SourceTime != SourceTime)
+      return false;
+
+    //A truncated or corrupt cache is rebuilt from the model.
+    std::error_code Error;
+    uint64_t Remaining = static_cast<uint64_t>(std::filesystem::file_size(CachePath, Error));
+    if(Error || Remaining < sizeof(Header))
+      return false;
+    Remaining -= sizeof(Header);
+
+    bool bSuccess = ReadArray(File, Result.Vertices, Header.VertexNum, Remaining) && ReadArray(File, Result.Indices, Header.IndexNum, Remaining) &&
+                    ReadArray(File, Result.MeshFirstIndex, Header.MeshNum, Remaining) && ReadArray(File, Result.MeshIndexNum, Header.MeshNum, Remaining) &&
+                    ReadArray(File, Result.MeshBaseVertex, Header.MeshNum, Remaining) && ReadArray(File, Result.MeshVertexNum, Header.MeshNum, Remaining) &&
+                    ReadArray(File, Result.MeshMaterial, Header.MeshNum, Remaining) && ReadArray(File, Result.MeshBoundsCenter, Header.MeshNum, Remaining) &&
+                    ReadArray(File, Result.MeshBoundsRadius, Header.MeshNum, Remaining) && ReadArray(File, Result.MeshFirstLod, Header.MeshNum, Remaining) &&
+                    ReadArray(File, Result.MeshLodNum, Header.MeshNum, Remaining) && ReadArray(File, Result.LodFirstIndex, Header.LodNum, Remaining) &&
+                    ReadArray(File, Result.LodIndexNum, Header.LodNum, Remaining) && ReadArray(File, Result.LodError, Header.LodNum, Remaining) &&
+                    ReadArray(File, Result.LodFirstMeshlet, Header.LodNum, Remaining) && ReadArray(File, Result.LodMeshletNum, Header.LodNum, Remaining) &&
+                    ReadArray(File, Result.MeshletFirstIndex, Header.MeshletNum, Remaining) && ReadArray(File, Result.MeshletIndexNum, Header.MeshletNum, Remaining) &&
+                    ReadArray(File, Result.MeshletBounds, Header.MeshletNum, Remaining) && ReadArray(File, Result.MeshletCone, Header.MeshletNum, Remaining) &&
+                    ReadArray(File, Result.NodeParent, Header.NodeNum, Remaining) && ReadArray(File, Result.NodeLocalTransform, Header.NodeNum, Remaining) &&
+                    ReadArray(File, Result.DrawMesh, Header.DrawNum, Remaining) && ReadArray(File, Result.DrawNode, Header.DrawNum, Remaining);
+    if(!bSuccess || Header.MaterialNum > Remaining / sizeof(uint32_t))
+      return false;
+
+    bSuccess = ReadArray(File, Result.MaterialBaseColorFactor, Header.MaterialNum, Remaining) && ReadArray(File, Result.MaterialMetallicFactor, Header.MaterialNum, Remaining) &&
+               ReadArray(File, Result.MaterialRoughnessFactor, Header.MaterialNum, Remaining);
+    if(!bSuccess)
+      return false;
+
+    Result.MaterialNames.resize(Header.MaterialNum);
+    for(auto& Name : Result.MaterialNames)
+    {
+      uint32_t Length = 0;
+      if(Remaining < sizeof(Length) || !File.read(reinterpret_cast<char*>(&Length), sizeof(Length)) || Length > Remaining - sizeof(Length))
+        return false;
+      Remaining -= sizeof(Length) + Length;
+
+      Name.resize(Length);
+      if(!File.read(Name.data(), Length))
+        return false;
+    }
+
+    if(!IsCacheConsistent(Result))
+      return false;
+
+    Result.UpdateWorldTransforms();
+
+    Statistics.SourceVertexNum = Header.SourceVertexNum;
+    Statistics.WeldedVertexNum = Header.VertexNum;
+    Statistics.AcmrBefore = Header.AcmrBefore;
+    Statistics.AcmrAfter = Header.AcmrAfter;
+    Statistics.AtvrBefore = Header.AtvrBefore;
+    Statistics.AtvrAfter = Header.AtvrAfter;
+    return true;
+  }
+
+  //The cache is an optimization only, failing to write it (e.g. in a read-only directory) is not an error.
+  void SaveMeshCache(const std::string& CachePath, const std::string& SourcePath, MESH_IMPORTER Importer, const Scene& Result, const MeshImportStatistics& Statistics)
+  {
+    MeshCacheHeader Header = {};
+    Header.Magic = MeshCacheMagic;
+    Header.Version = MeshCacheVersion;
+    Header.VertexSize = sizeof(Vertex);
+    Header.Importer = Importer;
+    Header.VertexNum = Result.Vertices.size();
+    Header.IndexNum = Result.Indices.size();
+    Header.MeshNum = Result.MeshNum();
+    Header.NodeNum = Result.NodeNum();
+    Header.DrawNum = Result.DrawNum();
+    Header.MaterialNum = Result.MaterialNames.size();
+    Header.LodNum = Result.LodNum();
+    Header.MeshletNum = Result.MeshletNum();
+    Header.SourceVertexNum = Statistics.SourceVertexNum;
+    Header.AcmrBefore = Statistics.AcmrBefore;
+    Header.AcmrAfter = Statistics.AcmrAfter;
+    Header.AtvrBefore = Statistics.AtvrBefore;
+    Header.AtvrAfter = Statistics.AtvrAfter;
+    if(!GetSourceStamp(SourcePath, Header.SourceSize, Header.SourceTime))
+      return;
+
+    std::ofstream File(CachePath, std::ios::binary | std::ios::trunc);
+    if(!File.is_open())
+      return;
+
+    File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+    WriteArray(File, Result.Vertices);
+    WriteArray(File, Result.Indices);
+    WriteArray(File, Result.MeshFirstIndex);
+    WriteArray(File, Result.MeshIndexNum);
+    WriteArray(File, Result.MeshBaseVertex);
+    WriteArray(File, Result.MeshVertexNum);
+    WriteArray(File, Result.MeshMaterial);
+    WriteArray(File, Result.MeshBoundsCenter);
+    WriteArray(File, Result.MeshBoundsRadius);
+    WriteArray(File, Result.MeshFirstLod);
+    WriteArray(File, Result.MeshLodNum);
+    WriteArray(File, Result.LodFirstIndex);
+    WriteArray(File, Result.LodIndexNum);
+    WriteArray(File, Result.LodError);
+    WriteArray(File, Result.LodFirstMeshlet);
+    WriteArray(File, Result.LodMeshletNum);
+    WriteArray(File, Result.MeshletFirstIndex);
+    WriteArray(File, Result.MeshletIndexNum);
+    WriteArray(File, Result.MeshletBounds);
+    WriteArray(File, Result.MeshletCone);
+    WriteArray(File, Result.NodeParent);
+    WriteArray(File, Result.NodeLocalTransform);
+    WriteArray(File, Result.DrawMesh);
+    WriteArray(File, Result.DrawNode);
+    WriteArray(File, Result.MaterialBaseColorFactor);
+    WriteArray(File, Result.MaterialMetallicFactor);
+    WriteArray(File, Result.MaterialRoughnessFactor);
+
+    for(const auto& Name : Result.MaterialNames)
+    {
+      uint32_t Length = static_cast<uint32_t>(Name.size());
+      File.write(reinterpret_cast<const char*>(&Length), sizeof(Length));
+      File.write(Name.data(), Length);
+    }
+  }
+
+  //Every array of a scene that is serialized by "WriteSceneData()" as it is, in the order it is written in.
+  template<typename TScene, typename TFunction>
+  void ForEachSceneArray(TScene& Target, TFunction&& Function)
+  {
+    Function(Target.MeshFirstIndex);
+    Function(Target.MeshIndexNum);
+    Function(Target.MeshBaseVertex);
+    Function(Target.MeshVertexNum);
+    Function(Target.MeshMaterial);
+    Function(Target.MeshBoundsCenter);
+    Function(Target.MeshBoundsRadius);
+    Function(Target.MeshFirstLod);
+    Function(Target.MeshLodNum);
+    Function(Target.LodFirstIndex);
+    Function(Target.LodIndexNum);
+    Function(Target.LodError);
+    Function(Target.LodFirstMeshlet);
+    Function(Target.LodMeshletNum);
+    Function(Target.MeshletFirstIndex);
+    Function(Target.MeshletIndexNum);
+    Function(Target.MeshletBounds);
+    Function(Target.MeshletCone);
+    Function(Target.NodeParent);
+    Function(Target.NodeLocalTransform);
+    Function(Target.DrawMesh);
+    Function(Target.DrawNode);
+    Function(Target.MaterialBaseColorFactor);
+    Function(Target.MaterialMetallicFactor);
+    Function(Target.MaterialRoughnessFactor);
+  }
+
+  void AppendBytes(std::vector<uint8_t>& Data, const void* pSource, size_t Size)
+  {
+    const auto* pBytes = static_cast<const uint8_t*>(pSource);
+    Data.insert(Data.end(), pBytes, pBytes + Size);
+  }
+
+  bool ReadBytes(const uint8_t*& pData, const uint8_t* pEnd, void* pTarget, size_t Size)
+  {
+    if(static_cast<size_t>(pEnd - pData) < Size)
+      return false;
+
+    std::memcpy(pTarget, pData, Size);
+    pData += Size;
+    return true;
+  }
+
+  //Running sums of the vertex cache statistics of all meshes, weighted by their number of triangles and vertices.
+  struct CacheStatisticsSum
+  {
+    double AcmrBefore = 0.0;
+    double AcmrAfter = 0.0;
+    double AtvrBefore = 0.0;
+    double AtvrAfter = 0.0;
+  };
+
+  //A sphere around the center of the bounds, not the smallest one, but good enough for selecting levels of detail.
+  void ComputeBoundingSphere(const std::vector<Vertex>& Vertices, glm::vec3& Center, float& Radius)
+  {
+    if(Vertices.empty())
+      return;
+
+    glm::vec3 Min = Vertices[0].Position;
+    glm::vec3 Max = Vertices[0].Position;
+    for(const auto& Vertex : Vertices)
+    {
+      Min = glm::min(Min, Vertex.Position);
+      Max = glm::max(Max, Vertex.Position);
+    }
+
+    Center = 0.5f * (Min + Max);
+    float RadiusSquared = 0.0f;
+    for(const auto& Vertex : Vertices)
+    {
+      glm::vec3 Offset = Vertex.Position - Center;
+      RadiusSquared = std::max(RadiusSquared, glm::dot(Offset, Offset));
+    }
+
+    Radius = std::sqrt(RadiusSquared);
+  }
+
+  //Levels of detail stop at this number of triangles, or once the simplification no longer removes enough of them.
+  const size_t MinLodFacetNum = 64;
+  const float MinLodReduction = 0.8f;
+  //The largest error of a single simplification, relative to the largest extent of the mesh.
+  const float MaxLodError = 0.05f;
+
+  /* Append ever coarser levels of detail of the mesh, each with about half the triangles of the previous one. Every level is
+   * simplified from the previous one, so their errors add up. */
+  void AppendLods(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices, Scene& Result)
+  {
+    glm::vec3 Min = Vertices[0].Position;
+    glm::vec3 Max = Vertices[0].Position;
+    for(const auto& Vertex : Vertices)
+    {
+      Min = glm::min(Min, Vertex.Position);
+      Max = glm::max(Max, Vertex.Position);
+    }
+
+    const float Extent = std::max(std::max(Max.x - Min.x, Max.y - Min.y), Max.z - Min.z);
+
+    std::vector<uint32_t> Lod = Indices;
+    std::vector<uint32_t> Simplified;
+    std::vector<Meshlet> Meshlets;
+    float Error = 0.0f;
+    for(uint32_t i = 1; i < MaxLodNum && Lod.size() / 3 > MinLodFacetNum; ++i)
+    {
+      size_t TargetIndexNum = Lod.size() / 6 * 3;
+      float LodError = SimplifyMesh(Vertices, Lod, TargetIndexNum, MaxLodError, Simplified);
+      if(static_cast<float>(Simplified.size()) > MinLodReduction * static_cast<float>(Lod.size()))
+        break;
+
+      OptimizeVertexCache(Simplified, Vertices.size());
+      BuildMeshlets(Vertices, Simplified, Meshlets);
+
+      Error += LodError * Extent;
+      Result.AddLod(static_cast<uint32_t>(Result.Indices.size()), static_cast<uint32_t>(Simplified.size()), Error, Meshlets);
+      Result.Indices.insert(Result.Indices.end(), Simplified.begin(), Simplified.end());
+
+      Lod.swap(Simplified);
+    }
+  }
+
+  //Weld, optimize and simplify a mesh and append it to the shared buffers.
+  void AppendMesh(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices, uint32_t Material, Scene& Result, MeshImportStatistics& Statistics, CacheStatisticsSum& Sum)
+  {
+    Statistics.SourceVertexNum += Vertices.size();
+
+    auto WeldStart = std::chrono::steady_clock::now();
+    WeldVertices(Vertices, Indices);
+    Statistics.WeldTime += ElapsedMilliseconds(WeldStart);
+
+    VertexCacheStatistics Before = AnalyzeVertexCache(Indices, Vertices.size());
+
+    auto OptimizeStart = std::chrono::steady_clock::now();
+    std::vector<Meshlet> Meshlets;
+    OptimizeVertexCache(Indices, Vertices.size());
+    OptimizeOverdraw(Indices, Vertices);
+    BuildMeshlets(Vertices, Indices, Meshlets);
+    OptimizeVertexFetch(Vertices, Indices);
+    Statistics.OptimizeTime += ElapsedMilliseconds(OptimizeStart);
+
+    VertexCacheStatistics After = AnalyzeVertexCache(Indices, Vertices.size());
+    double TriangleNum = static_cast<double>(Indices.size() / 3);
+    double VertexNum = static_cast<double>(Vertices.size());
+    Sum.AcmrBefore += Before.Acmr * TriangleNum;
+    Sum.AcmrAfter += After.Acmr * TriangleNum;
+    Sum.AtvrBefore += Before.Atvr * VertexNum;
+    Sum.AtvrAfter += After.Atvr * VertexNum;
+
+    Result.MeshFirstIndex.push_back(static_cast<uint32_t>(Result.Indices.size()));
+    Result.MeshIndexNum.push_back(static_cast<uint32_t>(Indices.size()));
+    Result.MeshBaseVertex.push_back(static_cast<int32_t>(Result.Vertices.size()));
+    Result.MeshVertexNum.push_back(static_cast<uint32_t>(Vertices.size()));
+    Result.MeshMaterial.push_back(Material);
+
+    glm::vec3 Center = glm::vec3(0.0f);
+    float Radius = 0.0f;
+    ComputeBoundingSphere(Vertices, Center, Radius);
+    Result.MeshBoundsCenter.push_back(Center);
+    Result.MeshBoundsRadius.push_back(Radius);
+
+    Result.AddLod(Result.MeshFirstIndex.back(), Result.MeshIndexNum.back(), 0.0f, Meshlets);
+
+    Result.Vertices.insert(Result.Vertices.end(), Vertices.begin(), Vertices.end());
+    Result.Indices.insert(Result.Indices.end(), Indices.begin(), Indices.end());
+
+    if(Indices.empty())
+      return;
+
+    auto SimplifyStart = std::chrono::steady_clock::now();
+    AppendLods(Vertices, Indices, Result);
+    Statistics.SimplifyTime += ElapsedMilliseconds(SimplifyStart);
+  }
+
+  //Flatten the node tree depth-first, and emit a draw for every non-empty mesh of every node.
+  void ImportNodes(const aiScene* pScene, Scene& Result)
+  {
+    std::vector<std::pair<const aiNode*, int32_t>> Stack = {{pScene->mRootNode, -1}};
+    while(!Stack.empty())
+    {
+      auto [pNode, Parent] = Stack.back();
+      Stack.pop_back();
+
+      int32_t NodeIndex = static_cast<int32_t>(Result.NodeParent.size());
+      Result.NodeParent.push_back(Parent);
+      Result.NodeLocalTransform.push_back(ConvertMatrix(pNode->mTransformation));
+
+      for(uint32_t i = 0; i < pNode->mNumMeshes; ++i)
+      {
+        uint32_t Mesh = pNode->mMeshes[i];
+        if(Result.MeshIndexNum[Mesh] == 0)
+          continue;
+
+        Result.DrawMesh.push_back(Mesh);
+        Result.DrawNode.push_back(static_cast<uint32_t>(NodeIndex));
+      }
+
+      //Pushed in reverse, so the children keep their order.
+      for(uint32_t i = pNode->mNumChildren; i > 0; --i)
+        Stack.push_back({pNode->mChildren[i - 1], NodeIndex});
+    }
+  }
+
+  void ImportWithAssimp(const std::string& Path, Scene& Result, MeshImportStatistics& Statistics, CacheStatisticsSum& Sum)
+  {
+    auto ImportStart = std::chrono::steady_clock::now();
+
+    //Points and lines are sorted into meshes of their own, which are then skipped.
+    Assimp::Importer Import;
+    const aiScene* pScene = Import.ReadFile(Path, aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_OptimizeMeshes);
+
+    if(!pScene || pScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !pScene->mRootNode)
+      throw std::runtime_error(Import.GetErrorString());
+
+    Statistics.ImportTime = ElapsedMilliseconds(ImportStart);
+
+    for(uint32_t i = 0; i < pScene->mNumMaterials; ++i)
+    {
+      aiString Name;
+      pScene->mMaterials[i]->Get(AI_MATKEY_NAME, Name);
+      Result.AddMaterial(Name.C_Str());
+    }
+
+    std::vector<Vertex> Vertices;
+    std::vector<uint32_t> Indices;
+    for(uint32_t i = 0; i < pScene->mNumMeshes; ++i)
+    {
+      const aiMesh* pMesh = pScene->mMeshes[i];
+
+      Vertices.clear();
+      Indices.clear();
+
+      auto ConvertStart = std::chrono::steady_clock::now();
+      if(pMesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE)
+        ConvertMesh(pMesh, Vertices, Indices);
+      Statistics.ImportTime += ElapsedMilliseconds(ConvertStart);
+
+      AppendMesh(Vertices, Indices, pMesh->mMaterialIndex, Result, Statistics, Sum);
+    }
+
+    ImportNodes(pScene, Result);
+  }
+
+  //OBJ files have no hierarchy, the triangles of every material become one mesh of a single root node.
+  void ImportWithObjLoader(const std::string& Path, Scene& Result, MeshImportStatistics& Statistics, CacheStatisticsSum& Sum)
+  {
+    auto ImportStart = std::chrono::steady_clock::now();
+
+    ObjModel Model;
+    LoadObj(Path, Model);
+    for(const auto& Name : Model.MaterialNames)
+      Result.AddMaterial(Name);
+
+    std::vector<uint32_t> MaterialOffsets(Model.MaterialNames.size() + 1, 0);
+    for(uint32_t Material : Model.TriangleMaterials)
+      ++MaterialOffsets[Material + 1];
+    std::partial_sum(MaterialOffsets.begin(), MaterialOffsets.end(), MaterialOffsets.begin());
+
+    std::vector<uint32_t> SortedTriangles(Model.TriangleMaterials.size());
+    {
+      std::vector<uint32_t> Cursors(MaterialOffsets.begin(), MaterialOffsets.end() - 1);
+      for(uint32_t i = 0; i < static_cast<uint32_t>(Model.TriangleMaterials.size()); ++i)
+        SortedTriangles[Cursors[Model.TriangleMaterials[i]]++] = i;
+    }
+
+    Statistics.ImportTime = ElapsedMilliseconds(ImportStart);
+
+    const uint32_t Unmapped = UINT32_MAX;
+    std::vector<uint32_t> Remap(Model.Vertices.size(), Unmapped);
+    std::vector<uint32_t> Sources;
+    std::vector<Vertex> Vertices;
+    std::vector<uint32_t> Indices;
+    for(uint32_t Material = 0; Material < static_cast<uint32_t>(Model.MaterialNames.size()); ++Material)
+    {
+      auto ExtractStart = std::chrono::steady_clock::now();
+
+      Vertices.clear();
+      Indices.clear();
+      Sources.clear();
+      for(uint32_t i = MaterialOffsets[Material]; i < MaterialOffsets[Material + 1]; ++i)
+      {
+        for(uint32_t Corner = 0; Corner < 3; ++Corner)
+        {
+          uint32_t Source = Model.Indices[SortedTriangles[i] * 3 + Corner];
+          if(Remap[Source] == Unmapped)
+          {
+            Remap[Source] = static_cast<uint32_t>(Vertices.size());
+            Vertices.push_back(Model.Vertices[Source]);
+            Sources.push_back(Source);
+          }
+
+          Indices.push_back(Remap[Source]);
+        }
+      }
+
+      for(uint32_t Source : Sources)
+        Remap[Source] = Unmapped;
+
+      Statistics.ImportTime += ElapsedMilliseconds(ExtractStart);
+
+      AppendMesh(Vertices, Indices, Material, Result, Statistics, Sum);
+    }
+
+    Result.NodeParent.push_back(-1);
+    Result.NodeLocalTransform.push_back(glm::mat4(1.0f));
+    for(uint32_t Mesh = 0; Mesh < static_cast<uint32_t>(Result.MeshNum()); ++Mesh)
+    {
+      if(Result.MeshIndexNum[Mesh] == 0)
+        continue;
+
+      Result.DrawMesh.push_back(Mesh);
+      Result.DrawNode.push_back(0);
+    }
+  }
+
+  bool IsObjFile(const std::string& Path)
+  {
+    std::string Extension = std::filesystem::path(Path).extension().string();
+    std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char Character) {return static_cast<char>(std::tolower(static_cast<unsigned char>(Character)));});
+    return Extension == ".obj";
+  }
+}
+
+void Scene::Clear()
+{
+  *this = Scene();
+}
+
+uint32_t Scene::AddMaterial(const std::string& Name, const glm::vec4& BaseColorFactor, float MetallicFactor, float RoughnessFactor)
+{
+  MaterialNames.push_back(Name);
+  MaterialBaseColorFactor.push_back(BaseColorFactor);
+  MaterialMetallicFactor.push_back(MetallicFactor);
+  MaterialRoughnessFactor.push_back(RoughnessFactor);
+  return static_cast<uint32_t>(MaterialNames.size() - 1);
+}
+
+size_t Scene::FacetNum() const
+{
+  size_t Num = 0;
+  for(uint32_t IndexNum : MeshIndexNum)
+    Num += IndexNum / 3;
+
+  return Num;
+}
+
+void Scene::AddLod(uint32_t FirstIndex, uint32_t IndexNum, float Error, const std::vector<Meshlet>& Meshlets)
+{
+  if(MeshFirstLod.size() < MeshNum())
+  {
+    MeshFirstLod.push_back(static_cast<uint32_t>(LodNum()));
+    MeshLodNum.push_back(0);
+  }
+
+  ++MeshLodNum.back();
+  LodFirstIndex.push_back(FirstIndex);
+  LodIndexNum.push_back(IndexNum);
+  LodError.push_back(Error);
+  LodFirstMeshlet.push_back(static_cast<uint32_t>(MeshletNum()));
+  LodMeshletNum.push_back(static_cast<uint32_t>(Meshlets.size()));
+
+  for(const auto& Meshlet : Meshlets)
+  {
+    MeshletFirstIndex.push_back(FirstIndex + Meshlet.FirstIndex);
+    MeshletIndexNum.push_back(Meshlet.IndexNum);
+    MeshletBounds.push_back(Meshlet.Bounds);
+    MeshletCone.push_back(Meshlet.Cone);
+  }
+}
+
+void Scene::UpdateWorldTransforms()
+{
+  NodeWorldTransform.resize(NodeNum());
+  for(size_t i = 0; i < NodeNum(); ++i)
+    NodeWorldTransform[i] = NodeParent[i] < 0 ? NodeLocalTransform[i] : NodeWorldTransform[NodeParent[i]] * NodeLocalTransform[i];
+}
+
+void LoadScene(const std::string& Path, Scene& Result, MeshImportStatistics& Statistics, MESH_IMPORTER Importer)
+{
+  const std::string CachePath = Path + ".meshcache";
+
+  if(Importer == MESH_IMPORTER_OBJ && !IsObjFile(Path))
+    Importer = MESH_IMPORTER_ASSIMP;
+
+  auto ImportStart = std::chrono::steady_clock::now();
+
+  if(LoadMeshCache(CachePath, Path, Importer, Result, Statistics))
+  {
+    Statistics.bLoadedFromCache = true;
+    Statistics.ImportTime = ElapsedMilliseconds(ImportStart);
+    return;
+  }
+
+  Result.Clear();
+
+  CacheStatisticsSum Sum;
+  if(Importer == MESH_IMPORTER_OBJ)
+    ImportWithObjLoader(Path, Result, Statistics, Sum);
+  else
+    ImportWithAssimp(Path, Result, Statistics, Sum);
+
+  Result.UpdateWorldTransforms();
+
+  Statistics.WeldedVertexNum = Result.Vertices.size();
+  Statistics.AcmrBefore = Result.Indices.empty() ? 0.0 : Sum.AcmrBefore / static_cast<double>(Result.FacetNum());
+  Statistics.AcmrAfter = Result.Indices.empty() ? 0.0 : Sum.AcmrAfter / static_cast<double>(Result.FacetNum());
+  Statistics.AtvrBefore = Result.Vertices.empty() ? 0.0 : Sum.AtvrBefore / static_cast<double>(Result.Vertices.size());
+  Statistics.AtvrAfter = Result.Vertices.empty() ? 0.0 : Sum.AtvrAfter / static_cast<double>(Result.Vertices.size());
+
+  SaveMeshCache(CachePath, Path, Importer, Result, Statistics);
+}
+
+void WriteSceneData(const Scene& Source, std::vector<uint8_t>& Data)
+{
+  ForEachSceneArray(Source, [&Data](const auto& Array)
+  {
+    uint64_t Num = Array.size();
+    AppendBytes(Data, &Num, sizeof(Num));
+    AppendBytes(Data, Array.data(), Array.size() * sizeof(Array[0]));
+  });
+
+  uint64_t NameNum = Source.MaterialNames.size();
+  AppendBytes(Data, &NameNum, sizeof(NameNum));
+  for(const auto& Name : Source.MaterialNames)
+  {
+    uint32_t Length = static_cast<uint32_t>(Name.size());
+    AppendBytes(Data, &Length, sizeof(Length));
+    AppendBytes(Data, Name.data(), Length);
+  }
+}
+
+bool ReadSceneData(const uint8_t* pData, size_t Size, Scene& Result)
+{
+  const uint8_t* pEnd = pData + Size;
+  bool bSuccess = true;
+
+  Result.Clear();
+  ForEachSceneArray(Result, [&](auto& Array)
+  {
+    uint64_t Num = 0;
+    if(!bSuccess || !ReadBytes(pData, pEnd, &Num, sizeof(Num)) || Num > static_cast<uint64_t>(pEnd - pData) / sizeof(Array[0]))
+    {
+      bSuccess = false;
+      return;
+    }
+
+    Array.resize(static_cast<size_t>(Num));
+    ReadBytes(pData, pEnd, Array.data(), Array.size() * sizeof(Array[0]));
+  });
+
+  uint64_t NameNum = 0;
+  if(!bSuccess || !ReadBytes(pData, pEnd, &NameNum, sizeof(NameNum)) || NameNum != Result.MaterialBaseColorFactor.size())
+    return false;
+
+  Result.MaterialNames.resize(static_cast<size_t>(NameNum));
+  for(auto& Name : Result.MaterialNames)
+  {
+    uint32_t Length = 0;
+    if(!ReadBytes(pData, pEnd, &Length, sizeof(Length)) || Length > static_cast<size_t>(pEnd - pData))
+      return false;
+
+    Name.assign(reinterpret_cast<const char*>(pData), Length);
+    pData += Length;
+  }
+
+  Result.UpdateWorldTransforms();
+  return true;
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#ifndef GLM_FORCE_RADIANS
+#define GLM_FORCE_RADIANS
+#endif
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "Mesh.hpp"
+#include "MeshOptimizer.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* A whole imported model, stored as flat arrays rather than as a tree of objects. The geometry of all meshes is packed into
+ * one vertex and one index buffer, the indices of a mesh are relative to its base vertex, so every mesh can be drawn from the
+ * shared buffers with "vkCmdDrawIndexed(MeshIndexNum, 1, MeshFirstIndex, MeshBaseVertex, ...)". Simplified levels of detail
+ * of a mesh follow its indices in the same index buffer and index the same vertices, only their first index and number of
+ * indices differ. */
+struct Scene
+{
+  std::vector<Vertex> Vertices;
+  std::vector<uint32_t> Indices;
+
+  //Meshes, indexed like "aiScene::mMeshes".
+  std::vector<uint32_t> MeshFirstIndex;
+  std::vector<uint32_t> MeshIndexNum;
+  std::vector<int32_t> MeshBaseVertex;
+  std::vector<uint32_t> MeshVertexNum;
+  std::vector<uint32_t> MeshMaterial;
+  //Bounding sphere in model space.
+  std::vector<glm::vec3> MeshBoundsCenter;
+  std::vector<float> MeshBoundsRadius;
+  //The range of the LOD arrays that belongs to the mesh, LOD 0 is the mesh itself.
+  std::vector<uint32_t> MeshFirstLod;
+  std::vector<uint32_t> MeshLodNum;
+
+  //Levels of detail, from the finest to the coarsest one of every mesh.
+  std::vector<uint32_t> LodFirstIndex;
+  std::vector<uint32_t> LodIndexNum;
+  std::vector<float> LodError; //An estimate of the largest distance to the surface of LOD 0, in model units.
+  std::vector<uint32_t> LodFirstMeshlet;
+  std::vector<uint32_t> LodMeshletNum;
+
+  //Meshlets, every one a consecutive range of the index range of its LOD, see "BuildMeshlets()".
+  std::vector<uint32_t> MeshletFirstIndex;
+  std::vector<uint32_t> MeshletIndexNum;
+  std::vector<glm::vec4> MeshletBounds; //In model space.
+  std::vector<glm::vec4> MeshletCone;
+
+  //Nodes in depth-first order, so a parent always comes before its children. The root has no parent (-1).
+  std::vector<int32_t> NodeParent;
+  std::vector<glm::mat4> NodeLocalTransform;
+  std::vector<glm::mat4> NodeWorldTransform;
+
+  //Draws, one for every mesh referenced by a node. Empty meshes (e.g. ones made of points or lines) are not drawn.
+  std::vector<uint32_t> DrawMesh;
+  std::vector<uint32_t> DrawNode;
+
+  //Materials, with the metallic-roughness factors of glTF. Importers without them use the glTF defaults of 1.
+  std::vector<std::string> MaterialNames;
+  std::vector<glm::vec4> MaterialBaseColorFactor;
+  std::vector<float> MaterialMetallicFactor;
+  std::vector<float> MaterialRoughnessFactor;
+
+  size_t MeshNum() const {return MeshFirstIndex.size();}
+  size_t NodeNum() const {return NodeParent.size();}
+  size_t DrawNum() const {return DrawMesh.size();}
+  size_t MaterialNum() const {return MaterialNames.size();}
+  size_t LodNum() const {return LodFirstIndex.size();}
+  size_t MeshletNum() const {return MeshletFirstIndex.size();}
+  //The triangles of all meshes at LOD 0.
+  size_t FacetNum() const;
+
+  void Clear();
+
+  //Returns the index of the new material.
+  uint32_t AddMaterial(const std::string& Name, const glm::vec4& BaseColorFactor = glm::vec4(1.0f), float MetallicFactor = 1.0f, float RoughnessFactor = 1.0f);
+
+  /* Append a level of detail to the last mesh, the first call after a mesh was added starts its range of LODs. The first
+   * indices of the meshlets are relative to the one of the LOD. */
+  void AddLod(uint32_t FirstIndex, uint32_t IndexNum, float Error, const std::vector<Meshlet>& Meshlets);
+
+  //Recompute the world transforms from the local ones.
+  void UpdateWorldTransforms();
+};
+
+enum MESH_IMPORTER
+{
+  MESH_IMPORTER_ASSIMP = 0,
+  //The multithreaded parser of "ObjLoader.hpp", only used for Wavefront OBJ files, everything else is still imported with Assimp.
+  MESH_IMPORTER_OBJ = 1
+};
+
+//The number of levels of detail of a mesh, LOD 0 included.
+const uint32_t MaxLodNum = 8;
+
+/* Import all meshes, the node hierarchy and the materials of the given model file. Every mesh is welded and optimized for the
+ * vertex cache, overdraw and vertex fetch on its own before it is appended to the shared buffers, together with a chain of
+ * levels of detail that halve its triangles each (see "MeshSimplifier.hpp"). Every level is split into meshlets. The result is saved to
+ * "<Path>.meshcache" and loaded from there as long as the model file is unchanged. The statistics are summed up over all
+ * meshes, the ACMR is weighted by the number of triangles and the ATVR by the number of vertices. */
+void LoadScene(const std::string& Path, Scene& Result, MeshImportStatistics& Statistics, MESH_IMPORTER Importer = MESH_IMPORTER_ASSIMP);
+
+/* Serialize everything but the vertices and indices of a scene, which are stored in their GPU layout next to it (e.g. in an
+ * asset archive). Reading returns false if the data is truncated or corrupted. */
+void WriteSceneData(const Scene& Source, std::vector<uint8_t>& Data);
+
+bool ReadSceneData(const uint8_t* pData, size_t Size, Scene& Result);
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1 @@
+%VULKAN_SDK%/Bin/glslangValidator -V Downsample.comp -o Downsample.comp.spv
\ No newline at end of file
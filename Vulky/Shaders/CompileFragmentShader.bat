@@ -1 +1,2 @@
-%VULKAN_SDK%/Bin/glslangValidator -V Shader.frag -o Shader.frag.spv
\ No newline at end of file
+%VULKAN_SDK%/Bin/glslangValidator -V Shader.frag -o Shader.frag.spv
+%VULKAN_SDK%/Bin/glslangValidator -V -DFRAGMENT_STORES Shader.frag -o ShaderFeedback.frag.spv
\ No newline at end of file
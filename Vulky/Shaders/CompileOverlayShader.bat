@@ -0,0 +1,2 @@
+%VULKAN_SDK%/Bin/glslangValidator -V Overlay.vert -o Overlay.vert.spv
+%VULKAN_SDK%/Bin/glslangValidator -V Overlay.frag -o Overlay.frag.spv
\ No newline at end of file
@@ -1,3 +1,5 @@
 call CompileVertexShader.bat
 call CompileFragmentShader.bat
+call CompileOverlayShader.bat
+call CompileComputeShader.bat
 pause
\ No newline at end of file
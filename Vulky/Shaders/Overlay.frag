@@ -0,0 +1,16 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(binding = 0) uniform sampler2D GlyphAtlasSampler;
+
+layout(location = 0) in vec2 FragTexCoord;
+layout(location = 1) in vec4 FragColor;
+
+layout(location = 0) out vec4 OutColor;
+
+void main()
+{
+  float Coverage = texture(GlyphAtlasSampler, FragTexCoord).r;
+
+  OutColor = vec4(FragColor.rgb, FragColor.a * Coverage);
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+const vec2 ATLAS_SIZE = vec2(16.0f, 6.0f); //In glyph cells.
+
+//The colors are sRGB, an sRGB framebuffer expects them linear.
+layout(constant_id = 0) const bool SRGB_FRAMEBUFFER = false;
+
+layout(push_constant) uniform OverlayPushConstant
+{
+  vec2 InvViewportSize;
+} Overlay;
+
+layout(location = 0) in vec4 Rectangle;
+layout(location = 1) in vec4 Color;
+layout(location = 2) in uint Glyph;
+
+layout(location = 0) out vec2 FragTexCoord;
+layout(location = 1) out vec4 FragColor;
+
+void main()
+{
+  //Every instance is a quad made of two triangles, the corners are derived from the vertex index.
+  const vec2 Corners[6] = vec2[](vec2(0.0f, 0.0f), vec2(1.0f, 0.0f), vec2(0.0f, 1.0f),
+                                 vec2(1.0f, 0.0f), vec2(1.0f, 1.0f), vec2(0.0f, 1.0f));
+  vec2 Corner = Corners[gl_VertexIndex];
+
+  vec2 PositionPixel = Rectangle.xy + Corner * Rectangle.zw;
+  vec2 Cell = vec2(float(Glyph % 16u), float(Glyph / 16u));
+
+  FragTexCoord = (Cell + Corner) / ATLAS_SIZE;
+  FragColor = Color;
+  if(SRGB_FRAMEBUFFER)
+    FragColor.rgb = mix(Color.rgb / 12.92f, pow((Color.rgb + 0.055f) / 1.055f, vec3(2.4f)), step(0.04045f, Color.rgb));
+
+  gl_Position = vec4(PositionPixel * Overlay.InvViewportSize * 2.0f - 1.0f, 0.0f, 1.0f);
+}
\ No newline at end of file
@@ -3,6 +3,33 @@
 
 const float PI = 3.14159265359;
 const int LIGHT_NUM = 8;
+const int MATERIAL_NUM = 256;
+const int STREAMED_TEXTURE_NUM = 3;
+//The anisotropy of the samplers, see "CreateTextureViewAndSampler()".
+const float MAX_ANISOTROPY = 16.0f;
+
+//Set if the device can store from the fragment stage, the streaming of the textures depends on the feedback then.
+layout(constant_id = 0) const bool TEXTURE_FEEDBACK = false;
+//Set if the swap chain has an sRGB format, which encodes the linear colors written to it.
+layout(constant_id = 1) const bool SRGB_FRAMEBUFFER = false;
+//Set if the textures are sampled from the tiles in their tile caches, see "VirtualTexture.hpp".
+layout(constant_id = 2) const bool VIRTUAL_TEXTURING = false;
+
+//See "VirtualTexture.hpp".
+const uint TILE_SIZE = 128;
+const uint TILE_BORDER = 4;
+const uint TILE_STRIDE = TILE_SIZE + 2 * TILE_BORDER;
+//The anisotropy of the samplers of the tile caches, see "TileUploader.cpp".
+const float CACHE_MAX_ANISOTROPY = 4.0f;
+
+/* Without "fragmentStoresAndAtomics" every storage buffer of the fragment stage has to be read-only, even if it is never
+ * written. The feedback of the streamed levels and of the tiles is only compiled into "ShaderFeedback.frag.spv", which is
+ * built with FRAGMENT_STORES. */
+#ifdef FRAGMENT_STORES
+  #define FEEDBACK_BUFFER buffer
+#else
+  #define FEEDBACK_BUFFER readonly buffer
+#endif
 
 layout(binding = 1) uniform LightUniformBufferObject
 {
@@ -11,26 +38,64 @@ layout(binding = 1) uniform LightUniformBufferObject
   vec3 ViewPosition;
 } Lighting;
 
-layout(binding = 2) uniform MaterialUniformBufferObject
+struct MaterialData
 {
   vec4 Albedo;
   float Metallic;
   float Roughness;
   float Ao;
-} Material;
+};
+
+//All materials of the scene, indexed with the material of the draw, see "MaterialUniformBufferObject" in "App.hpp".
+layout(binding = 2) uniform MaterialUniformBufferObject
+{
+  MaterialData Materials[MATERIAL_NUM];
+};
 
 layout(binding = 3) uniform sampler2D AlbedoSampler;
 layout(binding = 4) uniform sampler2D NormalSampler;
-layout(binding = 5) uniform sampler2D MetallicSampler;
-layout(binding = 6) uniform sampler2D RoughnessSampler;
-layout(binding = 7) uniform sampler2D AoSampler;
+//Ambient occlusion, roughness and metallic in red, green and blue, like glTF.
+layout(binding = 5) uniform sampler2D OrmSampler;
+
+/* Per texture (albedo, normal, ORM) the largest number of levels above its smallest one that was sampled plus one, zero if it
+ * was not sampled, see "TextureStreamer.hpp". */
+layout(std430, binding = 7) FEEDBACK_BUFFER TextureFeedbackStorageBufferObject
+{
+  uint TextureDetail[STREAMED_TEXTURE_NUM];
+} Feedback;
+
+//One bit per page of every virtual texture, in page order, see "TileCache::ReportPages()".
+layout(std430, binding = 8) FEEDBACK_BUFFER TileFeedbackStorageBufferObject
+{
+  uint PageBits[];
+} TileFeedback;
+
+struct VirtualTextureData
+{
+  uvec2 Size;
+  uint LevelNum;
+  uint FeedbackOffset;
+  float MinLod;
+};
+
+//See "VirtualTextureUniformBufferObject" in "App.hpp".
+layout(binding = 9) uniform VirtualTextureUniformBufferObject
+{
+  VirtualTextureData Textures[STREAMED_TEXTURE_NUM];
+  vec2 CacheTexelSize;
+  uint FeedbackPixel;
+} Virtual;
+
+//Per level and page the slot of the closest resident tile that covers it, its level and one for a valid entry, see "TileCache".
+layout(binding = 10) uniform usampler2D PageTables[STREAMED_TEXTURE_NUM];
+layout(binding = 11) uniform sampler2D TileCaches[STREAMED_TEXTURE_NUM];
 
 layout(location = 0) in vec4 FragPositionH;
-layout(location = 1) in vec3 FragColor;
-layout(location = 2) in vec2 FragTexCoord;
-layout(location = 3) in vec3 FragPositionW;
-layout(location = 4) in vec3 FragNormalW;
-layout(location = 5) in vec3 FragTangentW;
+layout(location = 1) in vec2 FragTexCoord;
+layout(location = 2) in vec3 FragPositionW;
+layout(location = 3) in vec3 FragNormalW;
+layout(location = 4) in vec4 FragTangentW;
+layout(location = 5) flat in uint FragMaterial;
 
 layout(location = 0) out vec4 OutColor;
 
@@ -72,27 +137,154 @@ float GeometrySmith(vec3 N, vec3 V, vec3 L, float Roughness)
 
 vec3 FresnelSchlick(float NDotV, vec3 F0) {return F0 + (1.0f - F0) * pow(1.0f - NDotV, 5.0f);}
 
-vec3 TangentSpaceToWorldSpace(vec3 NormalMapSample, vec3 NormalW, vec3 TangentW)
+vec3 TangentSpaceToWorldSpace(vec2 NormalMapSample, vec3 NormalW, vec4 TangentW)
 {
-  vec3 NormalRemapped = NormalMapSample * 2.0f - 1.0f;
+  //Normal maps may be stored with only X and Y (BC5), Z is reconstructed from the unit length.
+  vec2 NormalXY = NormalMapSample * 2.0f - 1.0f;
+  vec3 NormalRemapped = vec3(NormalXY, sqrt(max(1.0f - dot(NormalXY, NormalXY), 0.0f)));
 
   vec3 N = NormalW;
-  vec3 T = normalize(TangentW - dot(TangentW, N) * N);
-  vec3 B = cross(N, T);
+  vec3 T = normalize(TangentW.xyz - dot(TangentW.xyz, N) * N);
+  //The handedness in "w" flips the bitangent for mirrored texture coordinates.
+  vec3 B = cross(N, T) * TangentW.w;
 
   mat3 TBN = mat3(T, B, N);
 
   return TBN * NormalRemapped;
 }
 
+//The level the anisotropic sampler picks, before it is clamped to the levels of the image.
+float GetTextureLod(sampler2D Sampler, vec2 TexCoordDx, vec2 TexCoordDy)
+{
+  vec2 Size = vec2(textureSize(Sampler, 0));
+  float Major = max(length(TexCoordDx * Size), length(TexCoordDy * Size));
+  float Minor = min(length(TexCoordDx * Size), length(TexCoordDy * Size));
+
+  return log2(max(max(Major / MAX_ANISOTROPY, Minor), 1e-6f));
+}
+
+//The level the sampler picks, counted from the smallest level so that it does not depend on how many levels are resident.
+uint GetTextureDetail(sampler2D Sampler, vec2 TexCoordDx, vec2 TexCoordDy)
+{
+  return uint(clamp(float(textureQueryLevels(Sampler) - 1) - floor(GetTextureLod(Sampler, TexCoordDx, TexCoordDy)), 0.0f, 31.0f));
+}
+
+/* Sample a streamed texture from its resident levels only, the levels above "MinLod" have not been uploaded yet. The gradients
+ * are widened rather than the level given explicitly, which keeps the anisotropic filter. Half a level of margin keeps the
+ * filter of the hardware off the missing levels where its footprint comes out a bit smaller than this one. */
+vec4 SampleResidentLevels(uint Texture, sampler2D Sampler, vec2 TexCoordDx, vec2 TexCoordDy)
+{
+  float MinLod = Virtual.Textures[Texture].MinLod;
+  float Scale = MinLod > 0.0f ? exp2(max(MinLod + 0.5f - GetTextureLod(Sampler, TexCoordDx, TexCoordDy), 0.0f)) : 1.0f;
+
+  return textureGrad(Sampler, FragTexCoord, TexCoordDx * Scale, TexCoordDy * Scale);
+}
+
+void WriteTextureFeedback(int Texture, uint Detail)
+{
+#ifdef FRAGMENT_STORES
+  //Reading first keeps most pixels from contending for the atomic, zero is left for textures that were not sampled.
+  if(Detail + 1 > Feedback.TextureDetail[Texture])
+    atomicMax(Feedback.TextureDetail[Texture], Detail + 1);
+#endif
+}
+
+//The pages of a level of a virtual texture in each direction.
+uvec2 GetPageCount(uvec2 Size, uint Level)
+{
+  uint LevelTileSize = TILE_SIZE << Level;
+  return (Size + LevelTileSize - 1) / LevelTileSize;
+}
+
+//The page of a level the texture coordinates fall into, repeated like the samplers.
+uvec2 GetVirtualPage(uvec2 Size, uint Level, vec2 TexCoord)
+{
+  vec2 LevelTexel = fract(TexCoord) * vec2(Size) / float(1u << Level);
+  return min(uvec2(LevelTexel / float(TILE_SIZE)), GetPageCount(Size, Level) - 1);
+}
+
+//The level of a virtual texture the tile caches are sampled from, rounded like the nearest mipmap mode of their samplers.
+uint GetVirtualLevel(uint Texture, vec2 TexCoordDx, vec2 TexCoordDy)
+{
+  vec2 Size = vec2(Virtual.Textures[Texture].Size);
+  float Major = max(length(TexCoordDx * Size), length(TexCoordDy * Size));
+  float Minor = min(length(TexCoordDx * Size), length(TexCoordDy * Size));
+  float Lod = log2(max(max(Major / CACHE_MAX_ANISOTROPY, Minor), 1e-6f));
+
+  return uint(clamp(floor(Lod + 0.5f), 0.0f, float(Virtual.Textures[Texture].LevelNum - 1)));
+}
+
+void WriteTileFeedback(uint Texture, uint Level, vec2 TexCoord)
+{
+#ifdef FRAGMENT_STORES
+  uvec2 Size = Virtual.Textures[Texture].Size;
+  uint Page = 0;
+  for(uint i = 0; i < Level; ++i)
+  {
+    uvec2 Pages = GetPageCount(Size, i);
+    Page += Pages.x * Pages.y;
+  }
+  uvec2 Position = GetVirtualPage(Size, Level, TexCoord);
+  Page += Position.y * GetPageCount(Size, Level).x + Position.x;
+
+  //Reading first keeps most pixels from contending for the atomic, the pages of the smaller levels are added on the CPU.
+  uint Word = Virtual.Textures[Texture].FeedbackOffset + Page / 32;
+  uint Bit = 1u << (Page % 32);
+  if((TileFeedback.PageBits[Word] & Bit) == 0)
+    atomicOr(TileFeedback.PageBits[Word], Bit);
+#endif
+}
+
+/* Sample a texture through its page table, from the closest resident tile that covers the page. The tiles are filtered within
+ * their level, with the border keeping the footprint inside the tile. Until the tile of the last level is resident, the
+ * small levels of the texture itself are sampled. The page table and the tile cache are passed in rather than indexed with
+ * "Texture", Vulkan 1.0 does not index arrays of samplers dynamically everywhere. */
+vec4 SampleTexture(uint Texture, sampler2D Sampler, usampler2D PageTable, sampler2D TileCache, vec2 TexCoordDx, vec2 TexCoordDy, bool bFeedback)
+{
+  if(!VIRTUAL_TEXTURING || Virtual.Textures[Texture].LevelNum == 0)
+    return SampleResidentLevels(Texture, Sampler, TexCoordDx, TexCoordDy);
+
+  uvec2 Size = Virtual.Textures[Texture].Size;
+  uint Level = GetVirtualLevel(Texture, TexCoordDx, TexCoordDy);
+  if(bFeedback)
+    WriteTileFeedback(Texture, Level, FragTexCoord);
+
+  uvec4 Entry = texelFetch(PageTable, ivec2(GetVirtualPage(Size, Level, FragTexCoord)), int(Level));
+  if(Entry.w == 0)
+    return textureGrad(Sampler, FragTexCoord, TexCoordDx, TexCoordDy);
+
+  //The entry may be the one of a smaller level, the texel is looked up in the tile of that level.
+  float Scale = 1.0f / float(1u << Entry.z);
+  vec2 TileTexel = fract(FragTexCoord) * vec2(Size) * Scale - vec2(GetVirtualPage(Size, Entry.z, FragTexCoord) * TILE_SIZE);
+  vec2 CacheTexCoord = (vec2(Entry.xy * TILE_STRIDE + TILE_BORDER) + TileTexel) * Virtual.CacheTexelSize;
+  vec2 CacheScale = vec2(Size) * Scale * Virtual.CacheTexelSize;
+
+  return textureGrad(TileCache, CacheTexCoord, TexCoordDx * CacheScale, TexCoordDy * CacheScale);
+}
+
 void main()
 {
-  //Albedo textures that come from artists are generally authored in sRGB space, thus we first convert them to linear space before using albedo in lighting calculations.
-  vec3 Albedo = (Material.Albedo * pow(texture(AlbedoSampler, FragTexCoord), vec4(2.2f))).xyz;
-  vec3 Normal = TangentSpaceToWorldSpace(texture(NormalSampler, FragTexCoord).xyz, FragNormalW, FragTangentW);
-  float Metallic = Material.Metallic * texture(MetallicSampler, FragTexCoord).x;
-  float Roughness = Material.Roughness * texture(RoughnessSampler, FragTexCoord).x;
-  float Ao = Material.Ao * texture(AoSampler, FragTexCoord).x;
+  MaterialData Material = Materials[FragMaterial];
+
+  //One pixel of every 8 x 8 reports, the derivatives are taken before branching on it.
+  vec2 TexCoordDx = dFdx(FragTexCoord);
+  vec2 TexCoordDy = dFdy(FragTexCoord);
+  if(TEXTURE_FEEDBACK && all(equal(ivec2(gl_FragCoord.xy) & 7, ivec2(0))))
+  {
+    WriteTextureFeedback(0, GetTextureDetail(AlbedoSampler, TexCoordDx, TexCoordDy));
+    WriteTextureFeedback(1, GetTextureDetail(NormalSampler, TexCoordDx, TexCoordDy));
+    WriteTextureFeedback(2, GetTextureDetail(OrmSampler, TexCoordDx, TexCoordDy));
+  }
+  //With virtual texturing one pixel of every 4 x 4 reports the pages it samples, a different one every frame.
+  bool bTileFeedback = VIRTUAL_TEXTURING && all(equal(ivec2(gl_FragCoord.xy) & 3, ivec2(Virtual.FeedbackPixel & 3, Virtual.FeedbackPixel >> 2)));
+
+  //Albedo textures that come from artists are generally authored in sRGB space, their sRGB images convert them to linear space before filtering.
+  vec3 Albedo = (Material.Albedo * SampleTexture(0, AlbedoSampler, PageTables[0], TileCaches[0], TexCoordDx, TexCoordDy, bTileFeedback)).xyz;
+  vec3 Normal = TangentSpaceToWorldSpace(SampleTexture(1, NormalSampler, PageTables[1], TileCaches[1], TexCoordDx, TexCoordDy, bTileFeedback).xy, FragNormalW, FragTangentW);
+  vec3 Orm = SampleTexture(2, OrmSampler, PageTables[2], TileCaches[2], TexCoordDx, TexCoordDy, bTileFeedback).xyz;
+  float Metallic = Material.Metallic * Orm.z;
+  float Roughness = Material.Roughness * Orm.y;
+  float Ao = Material.Ao * Orm.x;
 
   vec3 N = normalize(Normal);
   vec3 V = normalize(Lighting.ViewPosition.xyz - FragPositionW);
@@ -132,7 +324,8 @@ void main()
   vec3 Color = Ambient + Lo;
 
   Color = Color / (Color + vec3(1.0f));
-  Color = pow(Color, vec3(1.0f / 2.2f));
+  if(!SRGB_FRAMEBUFFER)
+    Color = pow(Color, vec3(1.0f / 2.2f));
 
   OutColor = vec4(Color, 1.0f);
 }
\ No newline at end of file
@@ -1,35 +1,79 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+//Selects the compact vertex layout, see "CompactVertex" in "Mesh.hpp".
+layout(constant_id = 0) const bool COMPACT_VERTEX = false;
+
 layout(binding = 0) uniform MvpUniformBufferObject
 {
   mat4 Model;
   mat4 ModelInvTranspose;
   mat4 View;
   mat4 Projection;
+  vec4 PositionScale;
+  vec4 PositionOffset;
 } Transformation;
 
-layout(location = 0) in vec3 Position;
-layout(location = 1) in vec3 Color;
-layout(location = 2) in vec3 Normal;
-layout(location = 3) in vec3 Tangent;
-layout(location = 4) in vec2 TexCoord;
+//The node transform and material of every draw, indexed with the instance index, see "DrawStorageBufferObject" in "App.hpp".
+struct DrawData
+{
+  mat4 Model;
+  mat4 ModelInvTranspose;
+  uint Material;
+};
+
+layout(std430, binding = 6) readonly buffer DrawStorageBufferObject
+{
+  DrawData Draws[];
+};
+
+//Full layout: float3 position, float3 normal, float4 tangent with handedness and float2 texture coordinates.
+//Compact layout: unorm16x4 position with handedness in w, octahedral snorm16x2 normal and tangent, half2 texture coordinates.
+layout(location = 0) in vec4 Position;
+layout(location = 1) in vec3 Normal;
+layout(location = 2) in vec4 Tangent;
+layout(location = 3) in vec2 TexCoord;
 
 layout(location = 0) out vec4 FragPositionH;
-layout(location = 1) out vec3 FragColor;
-layout(location = 2) out vec2 FragTexCoord;
-layout(location = 3) out vec3 FragPositionW;
-layout(location = 4) out vec3 FragNormalW;
-layout(location = 5) out vec3 FragTangentW;
+layout(location = 1) out vec2 FragTexCoord;
+layout(location = 2) out vec3 FragPositionW;
+layout(location = 3) out vec3 FragNormalW;
+layout(location = 4) out vec4 FragTangentW;
+layout(location = 5) flat out uint FragMaterial;
+
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+  vec3 Direction = vec3(Encoded, 1.0f - abs(Encoded.x) - abs(Encoded.y));
+  float Fold = max(-Direction.z, 0.0f);
+  Direction.x += Direction.x >= 0.0f ? -Fold : Fold;
+  Direction.y += Direction.y >= 0.0f ? -Fold : Fold;
+  return normalize(Direction);
+}
 
 void main()
 {
-  FragPositionH = Transformation.Projection * Transformation.View * Transformation.Model * vec4(Position, 1.0f);
-  FragColor = Color;
+  vec3 PositionL = Position.xyz;
+  vec3 NormalL = Normal;
+  vec3 TangentL = Tangent.xyz;
+  float Handedness = Tangent.w;
+
+  if(COMPACT_VERTEX)
+  {
+    PositionL = Position.xyz * Transformation.PositionScale.xyz + Transformation.PositionOffset.xyz;
+    NormalL = DecodeOctahedral(Normal.xy);
+    TangentL = DecodeOctahedral(Tangent.xy);
+    Handedness = Position.w * 2.0f - 1.0f;
+  }
+
+  mat4 Model = Transformation.Model * Draws[gl_InstanceIndex].Model;
+  mat4 ModelInvTranspose = Transformation.ModelInvTranspose * Draws[gl_InstanceIndex].ModelInvTranspose;
+
+  FragPositionH = Transformation.Projection * Transformation.View * Model * vec4(PositionL, 1.0f);
   FragTexCoord = TexCoord;
-  FragPositionW = (Transformation.Model * vec4(Position, 1.0f)).xyz;
-  FragNormalW = (Transformation.ModelInvTranspose * vec4(Normal, 1.0f)).xyz;
-  FragTangentW = (Transformation.Model * vec4(Tangent, 1.0f)).xyz;
+  FragPositionW = (Model * vec4(PositionL, 1.0f)).xyz;
+  FragNormalW = (ModelInvTranspose * vec4(NormalL, 0.0f)).xyz;
+  FragTangentW = vec4((Model * vec4(TangentL, 0.0f)).xyz, Handedness);
+  FragMaterial = Draws[gl_InstanceIndex].Material;
 
   gl_Position = FragPositionH;
 }
\ No newline at end of file
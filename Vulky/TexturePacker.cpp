@@ -0,0 +1,70 @@
+#include "TexturePacker.hpp"
+#include "PngDecoder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+void PackChannels(const std::vector<PackSource>& Sources, std::vector<uint8_t>& Packed, uint32_t& Width, uint32_t& Height)
+{
+  if(Sources.empty() || Sources.size() > 4)
+    throw std::runtime_error("Only 1 to 4 images can be packed into one texture!");
+
+  Width = 1;
+  Height = 1;
+  for(const auto& Source : Sources)
+  {
+    Width = std::max(Width, Source.Width);
+    Height = std::max(Height, Source.Height);
+  }
+
+  Packed.assign(static_cast<size_t>(Width) * Height * 4, 255);
+  for(size_t Channel = 0; Channel < Sources.size(); ++Channel)
+  {
+    const PackSource& Source = Sources[Channel];
+    for(uint32_t y = 0; y < Height; ++y)
+    {
+      const uint8_t* pRow = Source.pPixels + static_cast<size_t>(y * Source.Height / Height) * Source.Width * 4;
+      uint8_t* pOut = Packed.data() + static_cast<size_t>(y) * Width * 4 + Channel;
+      for(uint32_t x = 0; x < Width; ++x, pOut += 4)
+        *pOut = pRow[static_cast<size_t>(x * Source.Width / Width) * 4];
+    }
+  }
+}
+
+bool PackPngChannels(const std::vector<std::vector<char>>& Files, std::vector<uint8_t>& Packed, uint32_t& Width, uint32_t& Height)
+{
+  if(Files.empty() || Files.size() > 4)
+    throw std::runtime_error("Only 1 to 4 images can be packed into one texture!");
+
+  std::vector<PngInfo> Infos(Files.size());
+  for(size_t i = 0; i < Files.size(); ++i)
+  {
+    if(!ReadPngInfo(Files[i].data(), Files[i].size(), Infos[i]) || !Infos[i].bSupported ||
+       Infos[i].Width != Infos[0].Width || Infos[i].Height != Infos[0].Height)
+      return false;
+  }
+
+  Width = Infos[0].Width;
+  Height = Infos[0].Height;
+  Packed.assign(static_cast<size_t>(Width) * Height * 4, 255);
+  for(size_t Channel = 0; Channel < Files.size(); ++Channel)
+  {
+    if(!DecodePng(Files[Channel].data(), Files[Channel].size(), Packed.data() + Channel, static_cast<size_t>(Width) * 4, PNG_LAYOUT_RED, 4))
+      return false;
+  }
+
+  return true;
+}
+
+std::string GetPackedTextureName(const std::vector<std::string>& Paths)
+{
+  std::string Name;
+  for(size_t i = 0; i < Paths.size(); ++i)
+    Name += (i == 0 ? "" : "|") + Paths[i];
+
+  return Name;
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//An RGBA8 image a packed texture is built from, only its red channel is used.
+struct PackSource
+{
+  const uint8_t* pPixels = nullptr;
+  uint32_t Width = 1;
+  uint32_t Height = 1;
+};
+
+/* Store the scalar maps of a material in the channels of one RGBA8 image, so the shader fetches them with a single sample:
+ * the red channel of source "i" becomes channel "i" of the result, channels without a source are white. The result has the
+ * size of the largest source, smaller ones are scaled up with the nearest texel. Metallic, roughness and ambient occlusion
+ * are packed in the order of glTF: ambient occlusion, roughness, metallic ("ORM"). */
+void PackChannels(const std::vector<PackSource>& Sources, std::vector<uint8_t>& Packed, uint32_t& Width, uint32_t& Height);
+
+/* Like "PackChannels()" for PNG files that have been read into memory, but every file is decoded straight into its channel
+ * without an RGBA8 image of its own. Only when all of them are PNGs of the same size "DecodePng()" handles, false otherwise
+ * (or if one is corrupt), then they have to be decoded and packed with "PackChannels()". */
+bool PackPngChannels(const std::vector<std::vector<char>>& Files, std::vector<uint8_t>& Packed, uint32_t& Width, uint32_t& Height);
+
+//The name of a texture packed from the files, the paths joined by '|' (a single file keeps its path).
+std::string GetPackedTextureName(const std::vector<std::string>& Paths);
+
+NAMESPACE_END
\ No newline at end of file
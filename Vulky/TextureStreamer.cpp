@@ -0,0 +1,280 @@
+#include "TextureStreamer.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+void TextureStreamer::Init(uint32_t TextureNum, uint64_t StartSize, uint64_t FrameBudget)
+{
+  m_Textures.assign(TextureNum, StreamedTexture());
+  m_StartSize = StartSize;
+  m_FrameBudget = FrameBudget;
+  m_RetiringSize = 0;
+  m_Frame = 0;
+  m_StreamedSize = 0;
+  m_EvictedLevelNum = 0;
+  m_EvictedSize = 0;
+}
+
+uint32_t TextureStreamer::GetStartLevel(const std::vector<uint64_t>& LevelSizes) const
+{
+  uint32_t Level = 0;
+  while(Level + 1 < LevelSizes.size() && LevelSizes[Level] > m_StartSize)
+    ++Level;
+
+  return Level;
+}
+
+void TextureStreamer::SetTexture(uint32_t Texture, const std::vector<uint64_t>& LevelSizes, uint32_t FirstLevel, uint32_t AllocatedLevel)
+{
+  StreamedTexture& Streamed = m_Textures[Texture];
+  Streamed.LevelSizes = LevelSizes;
+  Streamed.StartLevel = FirstLevel;
+  Streamed.ResidentLevel = FirstLevel;
+  Streamed.AllocatedLevel = AllocatedLevel;
+  //Until the shader reports otherwise, the texture is assumed to need no more than it has.
+  Streamed.WantedLevel = FirstLevel;
+  Streamed.bPending = false;
+  Streamed.LastSampledFrame = m_Frame;
+}
+
+void TextureStreamer::ReportDetail(uint32_t Texture, uint32_t Detail)
+{
+  StreamedTexture& Streamed = m_Textures[Texture];
+  if(Streamed.LevelSizes.empty())
+    return;
+
+  //A texture that was not sampled needs no more than it has, it keeps levels it had been sampled with until they are evicted.
+  if(Detail == 0)
+  {
+    Streamed.WantedLevel = std::max(Streamed.WantedLevel, Streamed.ResidentLevel);
+    return;
+  }
+
+  uint32_t LastLevel = static_cast<uint32_t>(Streamed.LevelSizes.size()) - 1;
+  Streamed.WantedLevel = LastLevel - std::min(Detail - 1, LastLevel);
+  Streamed.LastSampledFrame = m_Frame;
+}
+
+void TextureStreamer::Schedule(std::vector<StreamRequest>& Requests)
+{
+  Requests.clear();
+
+  uint64_t Budget = m_FrameBudget;
+  uint64_t Size = 0;
+  //The images replaced by pending requests are still alive as well.
+  uint64_t RetiringSize = m_RetiringSize;
+  for(const auto& Streamed : m_Textures)
+  {
+    Size += GetCommittedSize(Streamed);
+    if(Streamed.bPending && Streamed.PendingAllocatedLevel != Streamed.AllocatedLevel)
+      RetiringSize += GetTailSize(Streamed, Streamed.AllocatedLevel);
+  }
+
+  //The memory budget may have shrunk (or a texture been reloaded larger) since the last frame.
+  while(Size > m_MemoryBudget)
+  {
+    if(!Evict(UINT32_MAX, Size - m_MemoryBudget, Size, RetiringSize, Requests))
+      break;
+  }
+
+  std::vector<uint32_t> Order;
+  for(uint32_t Texture = 0; Texture < m_Textures.size(); ++Texture)
+  {
+    if(!m_Textures[Texture].bPending && m_Textures[Texture].WantedLevel < m_Textures[Texture].ResidentLevel)
+      Order.push_back(Texture);
+  }
+
+  auto GetShortfall = [this](uint32_t Texture) {return m_Textures[Texture].ResidentLevel - m_Textures[Texture].WantedLevel;};
+  std::stable_sort(Order.begin(), Order.end(), [&GetShortfall](uint32_t A, uint32_t B) {return GetShortfall(A) > GetShortfall(B);});
+
+  bool bStreamed = false;
+  for(uint32_t Texture : Order)
+  {
+    StreamedTexture& Streamed = m_Textures[Texture];
+    //Levels of it may have been evicted to make room for a texture before it.
+    if(Streamed.bPending)
+      continue;
+
+    StreamRequest Request;
+    Request.Texture = Texture;
+    Request.FirstLevel = Streamed.ResidentLevel;
+    Request.AllocatedLevel = Streamed.AllocatedLevel;
+
+    //Levels the image has are filled in place, only an image that has all of its levels resident is grown.
+    if(Streamed.ResidentLevel > Streamed.AllocatedLevel)
+    {
+      /* As close to the wanted level as the budget allows, at least one level more. A level larger than the whole budget is
+       * still streamed when it comes first in a frame, it would never be otherwise. */
+      uint32_t FirstLevel = Streamed.ResidentLevel - 1;
+      if(GetUploadSize(Streamed, FirstLevel) > Budget && bStreamed)
+        continue;
+      while(FirstLevel > std::max(Streamed.WantedLevel, Streamed.AllocatedLevel) && GetUploadSize(Streamed, FirstLevel - 1) <= Budget)
+        --FirstLevel;
+
+      Request.FirstLevel = FirstLevel;
+      Request.Size = GetUploadSize(Streamed, FirstLevel);
+      bStreamed = true;
+    }
+    else
+    {
+      /* The new image gets the levels up to the wanted one so that the next requests fill it in place, as many as fit into the
+       * memory budget next to the image it replaces with the textures sampled less recently evicted down to their start level.
+       * Nothing is evicted for levels that would not fit anyway. */
+      uint64_t EvictableSize = 0;
+      for(uint32_t Other = 0; Other < m_Textures.size(); ++Other)
+      {
+        if(IsEvictable(Other, Texture))
+          EvictableSize += GetTailSize(m_Textures[Other], m_Textures[Other].AllocatedLevel) - GetTailSize(m_Textures[Other], m_Textures[Other].StartLevel);
+      }
+      uint32_t AllocatedLevel = Streamed.WantedLevel;
+      while(AllocatedLevel < Streamed.AllocatedLevel && Size - EvictableSize + GetTailSize(Streamed, AllocatedLevel) > m_MemoryBudget)
+        ++AllocatedLevel;
+      if(AllocatedLevel == Streamed.AllocatedLevel)
+        continue;
+
+      uint64_t AllocatedSize = GetTailSize(Streamed, Streamed.AllocatedLevel);
+      uint64_t GrownSize = GetTailSize(Streamed, AllocatedLevel);
+      while(Size + GrownSize > m_MemoryBudget)
+      {
+        if(!Evict(Texture, Size + GrownSize - m_MemoryBudget, Size, RetiringSize, Requests))
+          break;
+      }
+
+      //The images evicted for it are destroyed a few frames later, the image is grown in the first frame it fits next to them.
+      if(Size + RetiringSize + GrownSize > m_MemoryBudget)
+        continue;
+
+      Request.AllocatedLevel = AllocatedLevel;
+      Size += GrownSize - AllocatedSize;
+      RetiringSize += AllocatedSize;
+    }
+
+    Requests.push_back(Request);
+
+    Streamed.bPending = true;
+    Streamed.PendingAllocatedLevel = Request.AllocatedLevel;
+    Budget -= std::min(Budget, Request.Size);
+  }
+
+  ++m_Frame;
+}
+
+uint64_t TextureStreamer::Complete(const StreamRequest& Request)
+{
+  StreamedTexture& Streamed = m_Textures[Request.Texture];
+  if(Request.FirstLevel > Streamed.ResidentLevel)
+  {
+    m_EvictedLevelNum += Request.FirstLevel - Streamed.ResidentLevel;
+    m_EvictedSize += GetTailSize(Streamed, Streamed.ResidentLevel) - GetTailSize(Streamed, Request.FirstLevel);
+  }
+
+  uint64_t ReplacedSize = 0;
+  if(Request.AllocatedLevel != Streamed.AllocatedLevel)
+    ReplacedSize = GetTailSize(Streamed, Streamed.AllocatedLevel);
+  m_RetiringSize += ReplacedSize;
+
+  Streamed.ResidentLevel = Request.FirstLevel;
+  Streamed.AllocatedLevel = Request.AllocatedLevel;
+  Streamed.bPending = false;
+
+  m_StreamedSize += Request.Size;
+
+  return ReplacedSize;
+}
+
+uint64_t TextureStreamer::GetResidentSize() const
+{
+  uint64_t Size = 0;
+  for(const auto& Streamed : m_Textures)
+    Size += GetTailSize(Streamed, Streamed.ResidentLevel);
+
+  return Size;
+}
+
+uint64_t TextureStreamer::GetAllocatedSize() const
+{
+  uint64_t Size = 0;
+  for(const auto& Streamed : m_Textures)
+    Size += GetTailSize(Streamed, Streamed.AllocatedLevel);
+
+  return Size + m_RetiringSize;
+}
+
+uint64_t TextureStreamer::GetTailSize(const StreamedTexture& Texture, uint32_t FirstLevel)
+{
+  return std::accumulate(Texture.LevelSizes.begin() + FirstLevel, Texture.LevelSizes.end(), uint64_t(0));
+}
+
+uint64_t TextureStreamer::GetCommittedSize(const StreamedTexture& Texture)
+{
+  return GetTailSize(Texture, Texture.bPending ? Texture.PendingAllocatedLevel : Texture.AllocatedLevel);
+}
+
+uint64_t TextureStreamer::GetUploadSize(const StreamedTexture& Texture, uint32_t FirstLevel)
+{
+  return GetTailSize(Texture, FirstLevel) - GetTailSize(Texture, std::max(FirstLevel, Texture.ResidentLevel));
+}
+
+bool TextureStreamer::IsEvictable(uint32_t Texture, uint32_t Protected) const
+{
+  const StreamedTexture& Streamed = m_Textures[Texture];
+  if(Texture == Protected || Streamed.bPending || Streamed.AllocatedLevel >= Streamed.StartLevel)
+    return false;
+
+  //Levels a texture was not sampled with can always go.
+  if(Protected < m_Textures.size() && Streamed.AllocatedLevel >= Streamed.WantedLevel)
+    return Streamed.LastSampledFrame < m_Textures[Protected].LastSampledFrame;
+
+  return true;
+}
+
+bool TextureStreamer::Evict(uint32_t Protected, uint64_t NeededSize, uint64_t& Size, uint64_t& RetiringSize, std::vector<StreamRequest>& Requests)
+{
+  auto HasSurplus = [](const StreamedTexture& Streamed) {return Streamed.AllocatedLevel < Streamed.WantedLevel;};
+
+  //Textures with levels they were not sampled with go first, then the least recently sampled ones.
+  uint32_t Victim = UINT32_MAX;
+  for(uint32_t Texture = 0; Texture < m_Textures.size(); ++Texture)
+  {
+    if(!IsEvictable(Texture, Protected))
+      continue;
+
+    const StreamedTexture& Streamed = m_Textures[Texture];
+
+    if(Victim == UINT32_MAX)
+      Victim = Texture;
+    else
+    {
+      const StreamedTexture& Other = m_Textures[Victim];
+      if(HasSurplus(Streamed) != HasSurplus(Other) ? HasSurplus(Streamed) : Streamed.LastSampledFrame < Other.LastSampledFrame)
+        Victim = Texture;
+    }
+  }
+
+  if(Victim == UINT32_MAX)
+    return false;
+
+  //Down to the level it was last sampled with if it has more, then as many levels as are needed. Levels it has but never got are dropped first.
+  StreamedTexture& Streamed = m_Textures[Victim];
+  uint64_t AllocatedSize = GetTailSize(Streamed, Streamed.AllocatedLevel);
+  uint32_t AllocatedLevel = HasSurplus(Streamed) ? std::min(Streamed.WantedLevel, Streamed.StartLevel) : Streamed.AllocatedLevel + 1;
+  while(AllocatedLevel < Streamed.StartLevel && AllocatedSize - GetTailSize(Streamed, AllocatedLevel) < NeededSize)
+    ++AllocatedLevel;
+
+  StreamRequest Request;
+  Request.Texture = Victim;
+  Request.FirstLevel = std::max(Streamed.ResidentLevel, AllocatedLevel);
+  Request.AllocatedLevel = AllocatedLevel;
+  Requests.push_back(Request);
+
+  //The image it replaces is kept until the copy and the frames that sampled it have completed.
+  Size -= AllocatedSize - GetTailSize(Streamed, AllocatedLevel);
+  RetiringSize += AllocatedSize;
+  Streamed.bPending = true;
+  Streamed.PendingAllocatedLevel = AllocatedLevel;
+  return true;
+}
+
+NAMESPACE_END
\ No newline at end of file
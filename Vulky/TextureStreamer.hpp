@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* Make the levels from "FirstLevel" to the end of the chain of the texture resident, in an image with the levels from
+ * "AllocatedLevel" on, "Size" bytes are uploaded for it. Levels missing from the image it has are filled in place. A different
+ * "AllocatedLevel" replaces the image with one the resident levels are copied into on the GPU, nothing is uploaded for it; a
+ * first level behind the resident one evicts the levels in between. */
+struct StreamRequest
+{
+  uint32_t Texture = 0;
+  uint32_t FirstLevel = 0;
+  uint32_t AllocatedLevel = 0;
+  uint64_t Size = 0;
+};
+
+/* Progressive mip streaming. A texture becomes resident with the small levels at the end of its chain first, the levels above
+ * them are added when the fragment shader reports that they are sampled. The report of a texture is its "detail": the number
+ * of levels above the smallest one it needed, which (unlike a level index) stays the same however many levels are resident.
+ * Textures are made resident from one level on to the end of the chain. Their images are allocated with more levels than are
+ * resident, the whole chain when they are loaded, so a request only uploads the new levels into the image it has; the shader
+ * clamps the level it samples to the resident ones. The scheduler serves the textures that are the most levels short first
+ * and keeps the bytes it requests per frame within a budget.
+ * The images of all textures are also kept within a memory budget. When they do not fit, they are replaced by images with
+ * fewer levels above the start level: first those of textures that have more than they were last sampled with, then those of
+ * the least recently sampled ones. A texture only grows its image at the expense of textures sampled less recently than it,
+ * otherwise it gets as many levels as still fit; evicted levels are streamed in again like any other once they are sampled.
+ * A replaced image counts against the budget until it is released, so an image is only grown once the images evicted for it
+ * have been destroyed and while the image it replaces still fits next to it. */
+class TextureStreamer
+{
+  public:
+  //Textures start with the largest level of at most "StartSize" bytes, "FrameBudget" bytes may be requested per frame.
+  void Init(uint32_t TextureNum, uint64_t StartSize, uint64_t FrameBudget);
+
+  //The bytes the resident levels of all textures may take up, unlimited by default.
+  void SetMemoryBudget(uint64_t MemoryBudget) {m_MemoryBudget = MemoryBudget;}
+
+  //The first level a texture with levels of the sizes (from the largest one) is created with.
+  uint32_t GetStartLevel(const std::vector<uint64_t>& LevelSizes) const;
+
+  /* A texture was (re)created with the levels from "FirstLevel" on resident in an image with the levels from "AllocatedLevel" on,
+   * requests that were still pending for it are forgotten. Levels below "FirstLevel" are never evicted. */
+  void SetTexture(uint32_t Texture, const std::vector<uint64_t>& LevelSizes, uint32_t FirstLevel, uint32_t AllocatedLevel);
+
+  //The largest detail the texture was sampled with in a frame plus one, zero if it was not sampled.
+  void ReportDetail(uint32_t Texture, uint32_t Detail);
+
+  //The requests of this frame, evictions first. They stay pending until "Complete()" is called for them.
+  void Schedule(std::vector<StreamRequest>& Requests);
+
+  /* Returns the bytes of the image the request replaced, zero if it filled levels in place. They count against the memory
+   * budget until they are released, once the image has been destroyed. */
+  uint64_t Complete(const StreamRequest& Request);
+
+  void Release(uint64_t Size) {m_RetiringSize -= std::min(m_RetiringSize, Size);}
+
+  uint32_t GetResidentLevel(uint32_t Texture) const {return m_Textures[Texture].ResidentLevel;}
+
+  uint32_t GetAllocatedLevel(uint32_t Texture) const {return m_Textures[Texture].AllocatedLevel;}
+
+  uint32_t GetWantedLevel(uint32_t Texture) const {return m_Textures[Texture].WantedLevel;}
+
+  uint64_t GetStreamedSize() const {return m_StreamedSize;}
+
+  uint64_t GetMemoryBudget() const {return m_MemoryBudget;}
+
+  //The bytes of the resident levels of all textures.
+  uint64_t GetResidentSize() const;
+
+  //The bytes of the levels the images of all textures have, resident or not, and of the replaced images that are not released yet.
+  uint64_t GetAllocatedSize() const;
+
+  uint32_t GetEvictedLevelNum() const {return m_EvictedLevelNum;}
+
+  uint64_t GetEvictedSize() const {return m_EvictedSize;}
+
+  protected:
+  struct StreamedTexture
+  {
+    std::vector<uint64_t> LevelSizes;
+    uint32_t StartLevel = 0;
+    uint32_t ResidentLevel = 0;
+    uint32_t AllocatedLevel = 0;
+    uint32_t WantedLevel = 0;
+    uint32_t PendingAllocatedLevel = 0;
+    bool bPending = false;
+    uint64_t LastSampledFrame = 0;
+  };
+
+  //The bytes of the levels from "FirstLevel" to the end of the chain.
+  static uint64_t GetTailSize(const StreamedTexture& Texture, uint32_t FirstLevel);
+
+  //The bytes of the levels of the image the texture has once its pending request has completed.
+  static uint64_t GetCommittedSize(const StreamedTexture& Texture);
+
+  //The bytes a request for the levels from "FirstLevel" on uploads into the image the texture has.
+  static uint64_t GetUploadSize(const StreamedTexture& Texture, uint32_t FirstLevel);
+
+  //Whether levels of the texture may be evicted, to make room for "Protected" if it is a texture.
+  bool IsEvictable(uint32_t Texture, uint32_t Protected) const;
+
+  /* Request to shrink the image of the texture that should go first, by as many levels as free "NeededSize" bytes (if it has
+   * them) and only of textures sampled less recently than "Protected" if it is a texture. "Size" is the committed size of all
+   * textures, "RetiringSize" that of the images they replace. Returns false if there is no texture to evict from. */
+  bool Evict(uint32_t Protected, uint64_t NeededSize, uint64_t& Size, uint64_t& RetiringSize, std::vector<StreamRequest>& Requests);
+
+  std::vector<StreamedTexture> m_Textures;
+  uint64_t m_StartSize = 0;
+  uint64_t m_FrameBudget = 0;
+  uint64_t m_MemoryBudget = UINT64_MAX;
+  uint64_t m_RetiringSize = 0;
+  uint64_t m_Frame = 0;
+  uint64_t m_StreamedSize = 0;
+  uint32_t m_EvictedLevelNum = 0;
+  uint64_t m_EvictedSize = 0;
+};
+
+NAMESPACE_END
\ No newline at end of file
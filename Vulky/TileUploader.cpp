@@ -0,0 +1,399 @@
+#include "TileUploader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  VkImageMemoryBarrier MakeImageBarrier(VkImage Image, uint32_t MipLevels, VkImageLayout OldLayout, VkImageLayout NewLayout, VkAccessFlags SrcAccess, VkAccessFlags DstAccess)
+  {
+    VkImageMemoryBarrier Barrier = {};
+    Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    Barrier.oldLayout = OldLayout;
+    Barrier.newLayout = NewLayout;
+    Barrier.srcAccessMask = SrcAccess;
+    Barrier.dstAccessMask = DstAccess;
+    Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.image = Image;
+    Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Barrier.subresourceRange.baseMipLevel = 0;
+    Barrier.subresourceRange.levelCount = MipLevels;
+    Barrier.subresourceRange.baseArrayLayer = 0;
+    Barrier.subresourceRange.layerCount = 1;
+    return Barrier;
+  }
+}
+
+TileUploader::~TileUploader()
+{
+  Destroy();
+}
+
+void TileUploader::Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkQueue Queue, uint32_t QueueFamily, uint32_t TextureNum, uint32_t SlotsPerSide, uint32_t FrameNum, uint32_t StagingTileNum)
+{
+  m_PhysicalDevice = PhysicalDevice;
+  m_Device = Device;
+  m_Queue = Queue;
+  m_SlotsPerSide = SlotsPerSide;
+
+  //The command buffers are reset every time their frame records again.
+  VkCommandPoolCreateInfo PoolCreateInfo = {};
+  PoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  PoolCreateInfo.queueFamilyIndex = QueueFamily;
+  PoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+  if(vkCreateCommandPool(m_Device, &PoolCreateInfo, nullptr, &m_CommandPool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create tile upload command pool!");
+
+  m_CommandBuffers.resize(FrameNum);
+  VkCommandBufferAllocateInfo AllocInfo = {};
+  AllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  AllocInfo.commandPool = m_CommandPool;
+  AllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  AllocInfo.commandBufferCount = FrameNum;
+
+  if(vkAllocateCommandBuffers(m_Device, &AllocInfo, m_CommandBuffers.data()) != VK_SUCCESS)
+    throw std::runtime_error("Failed to allocate tile upload command buffers!");
+
+  m_StagingTileSize = GetEncodedSize(TEXTURE_ENCODING_RGBA8, VirtualTileStride, VirtualTileStride);
+  CreateBuffer(m_PhysicalDevice, m_Device, m_StagingTileSize * StagingTileNum, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_Staging);
+
+  void* pMappedStaging = nullptr;
+  vkMapMemory(m_Device, m_Staging.Memory, 0, VK_WHOLE_SIZE, 0, &pMappedStaging);
+  m_pMappedStaging = static_cast<uint8_t*>(pMappedStaging);
+
+  m_FreeStaging.clear();
+  for(uint32_t Staging = StagingTileNum; Staging-- > 0;)
+    m_FreeStaging.push_back(Staging);
+  m_FrameStaging.assign(FrameNum, {});
+
+  //The placeholders keep the descriptors valid until a texture has been loaded, their page tables have no valid entry.
+  m_Textures.resize(TextureNum);
+  for(auto& Texture : m_Textures)
+  {
+    Texture.Format = VK_FORMAT_R8G8B8A8_UNORM;
+    CreateImages(Texture, 1);
+  }
+
+  m_bStopping = false;
+  m_Worker = std::thread(&TileUploader::WorkerMain, this);
+}
+
+void TileUploader::Destroy()
+{
+  if(m_Device == VK_NULL_HANDLE)
+    return;
+
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    m_bStopping = true;
+    m_Pending.clear();
+  }
+  m_Condition.notify_all();
+
+  if(m_Worker.joinable())
+    m_Worker.join();
+  m_Loaded.clear();
+
+  for(auto& Texture : m_Textures)
+    DestroyImages(Texture);
+  m_Textures.clear();
+  for(auto& Texture : m_RetiredTextures)
+    DestroyImages(Texture);
+  m_RetiredTextures.clear();
+
+  vkUnmapMemory(m_Device, m_Staging.Memory);
+  DestroyBuffer(m_Device, m_Staging);
+  m_Staging = BufferInfo();
+  m_pMappedStaging = nullptr;
+
+  vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
+  m_CommandPool = VK_NULL_HANDLE;
+  m_CommandBuffers.clear();
+
+  m_Device = VK_NULL_HANDLE;
+}
+
+void TileUploader::SetTexture(uint32_t Texture, VkFormat Format, const VirtualTextureLayout& Layout)
+{
+  TextureImages& Images = m_Textures[Texture];
+  if(Images.Format == Format && Images.Layout == Layout)
+    return;
+
+  Images.PendingFrames = (1u << m_CommandBuffers.size()) - 1;
+  m_RetiredTextures.push_back(std::move(Images));
+
+  Images = TextureImages();
+  Images.Format = Format;
+  Images.Layout = Layout;
+  Images.bInitialize = true;
+  CreateImages(Images, m_SlotsPerSide * VirtualTileStride);
+}
+
+void TileUploader::CreateImages(TextureImages& Texture, uint32_t CacheSize)
+{
+  //The tiles are copied into the cache, it has a single level, the page table has one per level of the layout.
+  Texture.Cache.MipLevels = 1;
+  CreateImage(m_PhysicalDevice, m_Device, CacheSize, CacheSize, 1, VK_SAMPLE_COUNT_1_BIT, Texture.Format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Texture.Cache.TextureImage, Texture.Cache.TextureImageMemory);
+  CreateImageView(m_Device, Texture.Cache.TextureImage, Texture.Format, 1, VK_IMAGE_ASPECT_COLOR_BIT, Texture.Cache.TextureImageView);
+
+  //The borders of the tiles cover the footprint of the anisotropic filter, see the fragment shader.
+  SamplerState CacheSampler;
+  CacheSampler.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  CacheSampler.AddressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  CacheSampler.MaxAnisotropy = 4.0f;
+  CacheSampler.MaxLod = 0.0f;
+  Texture.Cache.TextureSampler = AcquireSampler(m_Device, CacheSampler);
+
+  uint32_t LevelNum = std::max(Texture.Layout.LevelNum, 1u);
+  Texture.PageTable.MipLevels = LevelNum;
+  CreateImage(m_PhysicalDevice, m_Device, Texture.Layout.TableWidth, Texture.Layout.TableHeight, LevelNum, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_UINT, VK_IMAGE_TILING_OPTIMAL,
+              VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Texture.PageTable.TextureImage, Texture.PageTable.TextureImageMemory);
+  CreateImageView(m_Device, Texture.PageTable.TextureImage, VK_FORMAT_R8G8B8A8_UINT, LevelNum, VK_IMAGE_ASPECT_COLOR_BIT, Texture.PageTable.TextureImageView);
+
+  //Integer images cannot be filtered, the shader fetches the entries anyway.
+  SamplerState PageTableSampler;
+  PageTableSampler.Filter = VK_FILTER_NEAREST;
+  PageTableSampler.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  PageTableSampler.AddressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  PageTableSampler.MaxAnisotropy = 1.0f;
+  Texture.PageTable.TextureSampler = AcquireSampler(m_Device, PageTableSampler);
+
+  //The frames in flight may still be using the queue, the images of a loaded texture are initialized with the frame.
+  if(!Texture.bInitialize)
+  {
+    VkCommandBuffer CommandBuffer = BeginSingleTimeCommands(m_Device, m_CommandPool);
+
+    //Slots without a tile are never sampled, the cache does not need to be cleared.
+    VkImageMemoryBarrier Barriers[2] =
+    {
+      MakeImageBarrier(Texture.Cache.TextureImage, 1, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, VK_ACCESS_SHADER_READ_BIT),
+      MakeImageBarrier(Texture.PageTable.TextureImage, LevelNum, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT)
+    };
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 2, Barriers);
+
+    VkClearColorValue Invalid = {};
+    vkCmdClearColorImage(CommandBuffer, Texture.PageTable.TextureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &Invalid, 1, &Barriers[1].subresourceRange);
+
+    VkImageMemoryBarrier ReadBarrier = MakeImageBarrier(Texture.PageTable.TextureImage, LevelNum, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                        VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &ReadBarrier);
+
+    EndSingleTimeCommands(m_Device, m_Queue, m_CommandPool, CommandBuffer);
+  }
+
+  if(Texture.Layout.LevelNum == 0)
+    return;
+
+  VkDeviceSize TableSize = static_cast<VkDeviceSize>(Texture.Layout.GetTableEntryNum()) * sizeof(uint32_t);
+  Texture.PageTableStaging.resize(m_CommandBuffers.size());
+  Texture.pMappedPageTables.resize(m_CommandBuffers.size());
+  Texture.PageTableWritten.assign(m_CommandBuffers.size(), false);
+  for(size_t Frame = 0; Frame < m_CommandBuffers.size(); ++Frame)
+  {
+    CreateBuffer(m_PhysicalDevice, m_Device, TableSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, Texture.PageTableStaging[Frame]);
+    vkMapMemory(m_Device, Texture.PageTableStaging[Frame].Memory, 0, VK_WHOLE_SIZE, 0, &Texture.pMappedPageTables[Frame]);
+  }
+}
+
+void TileUploader::DestroyImages(TextureImages& Texture)
+{
+  DestroyTexture(m_Device, Texture.Cache);
+  Texture.Cache = TextureInfo();
+  DestroyTexture(m_Device, Texture.PageTable);
+  Texture.PageTable = TextureInfo();
+
+  for(auto& Staging : Texture.PageTableStaging)
+  {
+    vkUnmapMemory(m_Device, Staging.Memory);
+    DestroyBuffer(m_Device, Staging);
+  }
+  Texture.PageTableStaging.clear();
+  Texture.pMappedPageTables.clear();
+  Texture.PageTableWritten.clear();
+}
+
+void TileUploader::Load(const TileRequest& Request, std::shared_ptr<const void> pOwner, const void* pData, size_t Size)
+{
+  if(m_FreeStaging.empty() || Size > m_StagingTileSize)
+    throw std::runtime_error("Tile does not fit into the staging buffer!");
+
+  PendingTile Pending;
+  Pending.pOwner = std::move(pOwner);
+  Pending.pData = pData;
+  Pending.Size = Size;
+  Pending.Tile.Request = Request;
+  Pending.Tile.Staging = m_FreeStaging.back();
+  m_FreeStaging.pop_back();
+
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    m_Pending.push_back(std::move(Pending));
+  }
+  m_Condition.notify_one();
+}
+
+void TileUploader::TakeLoaded(std::vector<LoadedTile>& Tiles)
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  Tiles.insert(Tiles.end(), m_Loaded.begin(), m_Loaded.end());
+  m_Loaded.clear();
+}
+
+void TileUploader::WritePageTable(uint32_t Frame, uint32_t Texture, const std::vector<uint32_t>& Entries)
+{
+  TextureImages& Images = m_Textures[Texture];
+  if(Images.PageTableStaging.empty())
+    return;
+
+  std::memcpy(Images.pMappedPageTables[Frame], Entries.data(), Entries.size() * sizeof(uint32_t));
+  Images.PageTableWritten[Frame] = true;
+}
+
+VkCommandBuffer TileUploader::Record(uint32_t Frame, const std::vector<LoadedTile>& Tiles)
+{
+  for(const auto& Tile : Tiles)
+    m_FrameStaging[Frame].push_back(Tile.Staging);
+
+  //Per texture the copies of its tiles, and whether its page table is copied.
+  std::vector<std::vector<VkBufferImageCopy>> TileCopies(m_Textures.size());
+  for(const auto& Tile : Tiles)
+  {
+    if(!Tile.bCopy)
+      continue;
+
+    VkBufferImageCopy Region = {};
+    Region.bufferOffset = Tile.Staging * m_StagingTileSize;
+    Region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Region.imageSubresource.layerCount = 1;
+    Region.imageOffset = {static_cast<int32_t>(Tile.Request.Slot % m_SlotsPerSide * VirtualTileStride), static_cast<int32_t>(Tile.Request.Slot / m_SlotsPerSide * VirtualTileStride), 0};
+    Region.imageExtent = {VirtualTileStride, VirtualTileStride, 1};
+    TileCopies[Tile.Request.Texture].push_back(Region);
+  }
+
+  std::vector<VkImageMemoryBarrier> Barriers;
+  for(size_t Texture = 0; Texture < m_Textures.size(); ++Texture)
+  {
+    TextureImages& Images = m_Textures[Texture];
+    bool bPageTable = !Images.PageTableWritten.empty() && Images.PageTableWritten[Frame];
+    //The frames before may still sample the slots and the entries that are overwritten, the transfer waits for their fragment shaders.
+    VkImageLayout OldLayout = Images.bInitialize ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    if(Images.bInitialize || !TileCopies[Texture].empty())
+      Barriers.push_back(MakeImageBarrier(Images.Cache.TextureImage, 1, OldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT));
+    if(Images.bInitialize || bPageTable)
+      Barriers.push_back(MakeImageBarrier(Images.PageTable.TextureImage, Images.PageTable.MipLevels, OldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT));
+  }
+
+  if(Barriers.empty())
+    return VK_NULL_HANDLE;
+
+  VkCommandBuffer CommandBuffer = m_CommandBuffers[Frame];
+  vkResetCommandBuffer(CommandBuffer, 0);
+
+  VkCommandBufferBeginInfo BeginInfo = {};
+  BeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  BeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(CommandBuffer, &BeginInfo);
+
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(Barriers.size()), Barriers.data());
+
+  for(size_t Texture = 0; Texture < m_Textures.size(); ++Texture)
+  {
+    TextureImages& Images = m_Textures[Texture];
+    if(!TileCopies[Texture].empty())
+      vkCmdCopyBufferToImage(CommandBuffer, m_Staging.Buffer, Images.Cache.TextureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(TileCopies[Texture].size()), TileCopies[Texture].data());
+
+    //Slots without a tile are never sampled, the cache does not need to be cleared, a page table without entries has to be.
+    bool bPageTable = !Images.PageTableWritten.empty() && Images.PageTableWritten[Frame];
+    if(Images.bInitialize && !bPageTable)
+    {
+      VkClearColorValue Invalid = {};
+      VkImageSubresourceRange Range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, Images.PageTable.MipLevels, 0, 1};
+      vkCmdClearColorImage(CommandBuffer, Images.PageTable.TextureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &Invalid, 1, &Range);
+    }
+    Images.bInitialize = false;
+
+    if(!bPageTable)
+      continue;
+
+    //The levels follow each other in the staging buffer, see "VirtualTextureLayout::GetTableEntryNum()".
+    std::vector<VkBufferImageCopy> Regions(Images.Layout.LevelNum);
+    VkDeviceSize Offset = 0;
+    for(uint32_t Level = 0; Level < Images.Layout.LevelNum; ++Level)
+    {
+      uint32_t Width = std::max(Images.Layout.TableWidth >> Level, 1u), Height = std::max(Images.Layout.TableHeight >> Level, 1u);
+      Regions[Level] = {};
+      Regions[Level].bufferOffset = Offset;
+      Regions[Level].imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, Level, 0, 1};
+      Regions[Level].imageExtent = {Width, Height, 1};
+      Offset += static_cast<VkDeviceSize>(Width) * Height * sizeof(uint32_t);
+    }
+    vkCmdCopyBufferToImage(CommandBuffer, Images.PageTableStaging[Frame].Buffer, Images.PageTable.TextureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(Regions.size()), Regions.data());
+    Images.PageTableWritten[Frame] = false;
+  }
+
+  for(auto& Barrier : Barriers)
+  {
+    Barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    Barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    Barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  }
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(Barriers.size()), Barriers.data());
+
+  if(vkEndCommandBuffer(CommandBuffer) != VK_SUCCESS)
+    throw std::runtime_error("Failed to record tile upload command buffer!");
+
+  return CommandBuffer;
+}
+
+void TileUploader::Release(uint32_t Frame)
+{
+  m_FreeStaging.insert(m_FreeStaging.end(), m_FrameStaging[Frame].begin(), m_FrameStaging[Frame].end());
+  m_FrameStaging[Frame].clear();
+
+  //Once every frame in flight has been released, the frames that were submitted before the images were replaced have finished.
+  for(auto& Texture : m_RetiredTextures)
+    Texture.PendingFrames &= ~(1u << Frame);
+
+  auto Finished = [this](TextureImages& Texture)
+  {
+    if(Texture.PendingFrames != 0)
+      return false;
+
+    DestroyImages(Texture);
+    return true;
+  };
+  m_RetiredTextures.erase(std::remove_if(m_RetiredTextures.begin(), m_RetiredTextures.end(), Finished), m_RetiredTextures.end());
+}
+
+void TileUploader::WorkerMain()
+{
+  while(true)
+  {
+    PendingTile Pending;
+    {
+      std::unique_lock<std::mutex> Lock(m_Mutex);
+      m_Condition.wait(Lock, [this]() {return m_bStopping || !m_Pending.empty();});
+      if(m_bStopping)
+        return;
+
+      Pending = std::move(m_Pending.front());
+      m_Pending.pop_front();
+    }
+
+    //Tiles in the mapped archive are read from disk here if they have not been touched before.
+    std::memcpy(m_pMappedStaging + Pending.Tile.Staging * m_StagingTileSize, Pending.pData, Pending.Size);
+    Pending.pOwner.reset();
+
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    m_Loaded.push_back(Pending.Tile);
+  }
+}
+
+NAMESPACE_END
\ No newline at end of file
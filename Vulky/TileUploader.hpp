@@ -0,0 +1,137 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "VulkanHelper.hpp"
+#include "VirtualTexture.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+//A tile in a slot of the staging buffer, "bCopy" is cleared for tiles that are dropped (their staging slot is freed all the same).
+struct LoadedTile
+{
+  TileRequest Request;
+  uint32_t Staging = 0;
+  bool bCopy = true;
+};
+
+/* The GPU side of the virtual textures (see "VirtualTexture.hpp"): per texture a cache texture of "SlotsPerSide" x "SlotsPerSide"
+ * tiles and a page table with a level per level of its layout, both kept in "VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL". A worker
+ * thread copies the requested tiles from their sources (decoded chains or the mapped archive) into the slots of a persistently
+ * mapped staging buffer. The render thread records the copies of the tiles that are done and of the changed page tables into a
+ * command buffer per frame in flight, which is submitted on the graphics queue right before the one that draws the frame. There
+ * is no sparse binding involved, it runs on every Vulkan 1.0 device. */
+class TileUploader
+{
+  public:
+  TileUploader() = default;
+
+  ~TileUploader();
+
+  TileUploader(const TileUploader&) = delete;
+
+  TileUploader& operator=(const TileUploader&) = delete;
+
+  //"StagingTileNum" tiles can be on their way at once, across "FrameNum" frames in flight.
+  void Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkQueue Queue, uint32_t QueueFamily, uint32_t TextureNum, uint32_t SlotsPerSide, uint32_t FrameNum, uint32_t StagingTileNum);
+
+  void Destroy();
+
+  /* (Re)create the images of the texture for tiles of the format and the layout. The new ones are initialized by the next "Record()",
+   * the old ones are destroyed once every frame in flight has been released, the frames before may still sample them. */
+  void SetTexture(uint32_t Texture, VkFormat Format, const VirtualTextureLayout& Layout);
+
+  //The cache texture and the page table of a texture, 1 x 1 placeholders until "SetTexture()" has been called for it.
+  const TextureInfo& GetCache(uint32_t Texture) const {return m_Textures[Texture].Cache;}
+
+  const TextureInfo& GetPageTable(uint32_t Texture) const {return m_Textures[Texture].PageTable;}
+
+  //The size of a texel of the cache textures, in texture coordinates.
+  float GetCacheTexelSize() const {return 1.0f / static_cast<float>(m_SlotsPerSide * VirtualTileStride);}
+
+  //The staging slots that are free, every call of "Load()" takes one until the frame it is copied in has finished.
+  uint32_t GetFreeStagingNum() const {return static_cast<uint32_t>(m_FreeStaging.size());}
+
+  //Copy "Size" bytes of the tile into a staging slot on the worker, "pOwner" keeps "pData" alive until then.
+  void Load(const TileRequest& Request, std::shared_ptr<const void> pOwner, const void* pData, size_t Size);
+
+  //Take the tiles the worker has copied into staging since the last call.
+  void TakeLoaded(std::vector<LoadedTile>& Tiles);
+
+  //The page table of the texture is uploaded with the next "Record()" of the frame, "Entries" are those of "TileCache::BuildPageTable()".
+  void WritePageTable(uint32_t Frame, uint32_t Texture, const std::vector<uint32_t>& Entries);
+
+  /* Record the copies of the tiles and of the page tables written for the frame, "VK_NULL_HANDLE" if there is nothing to copy.
+   * The staging slots of all tiles passed in are freed by "Release()" of the frame, copied or not. */
+  VkCommandBuffer Record(uint32_t Frame, const std::vector<LoadedTile>& Tiles);
+
+  //The fence of the frame has been waited on, its staging slots can be reused.
+  void Release(uint32_t Frame);
+
+  protected:
+  struct TextureImages
+  {
+    VkFormat Format = VK_FORMAT_UNDEFINED;
+    VirtualTextureLayout Layout;
+    TextureInfo Cache;
+    TextureInfo PageTable;
+    //Per frame in flight, persistently mapped.
+    std::vector<BufferInfo> PageTableStaging;
+    std::vector<void*> pMappedPageTables;
+    std::vector<bool> PageTableWritten;
+    //Set until "Record()" has brought the new images into their layouts.
+    bool bInitialize = false;
+    //The frames in flight that have not been released since the images were replaced, one bit each.
+    uint32_t PendingFrames = 0;
+  };
+
+  struct PendingTile
+  {
+    std::shared_ptr<const void> pOwner;
+    const void* pData = nullptr;
+    size_t Size = 0;
+    LoadedTile Tile;
+  };
+
+  //Create the images of the texture, the cache in the read only layout and the page table cleared to invalid entries.
+  void CreateImages(TextureImages& Texture, uint32_t CacheSize);
+
+  void DestroyImages(TextureImages& Texture);
+
+  void WorkerMain();
+
+  VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+  VkDevice m_Device = VK_NULL_HANDLE;
+  VkQueue m_Queue = VK_NULL_HANDLE;
+  uint32_t m_SlotsPerSide = 1;
+  std::vector<TextureImages> m_Textures;
+  std::vector<TextureImages> m_RetiredTextures;
+
+  VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+  std::vector<VkCommandBuffer> m_CommandBuffers;
+
+  //Every slot holds the largest tile there is, RGBA8.
+  VkDeviceSize m_StagingTileSize = 0;
+  BufferInfo m_Staging;
+  uint8_t* m_pMappedStaging = nullptr;
+  //Only touched by the render thread.
+  std::vector<uint32_t> m_FreeStaging;
+  std::vector<std::vector<uint32_t>> m_FrameStaging;
+
+  std::thread m_Worker;
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  std::deque<PendingTile> m_Pending;
+  std::vector<LoadedTile> m_Loaded;
+  bool m_bStopping = false;
+};
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "TransferQueue.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+void TransferQueue::Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, const QueueFamilyIndices& Indices)
+{
+  if(!Indices.TransferFamily.has_value())
+    return;
+
+  m_PhysicalDevice = PhysicalDevice;
+  m_Device = Device;
+  m_TransferFamily = Indices.TransferFamily.value();
+  m_GraphicsFamily = Indices.GraphicsFamily.value();
+
+  vkGetDeviceQueue(m_Device, m_TransferFamily, 0, &m_Queue);
+
+  VkCommandPoolCreateInfo CmdPoolCreateInfo = {};
+  CmdPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  CmdPoolCreateInfo.queueFamilyIndex = m_TransferFamily;
+  CmdPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+  if(vkCreateCommandPool(m_Device, &CmdPoolCreateInfo, nullptr, &m_CommandPool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create transfer command pool!");
+}
+
+void TransferQueue::Destroy()
+{
+  ReleaseAcquires(true);
+
+  if(m_CommandPool != VK_NULL_HANDLE)
+    vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
+
+  m_CommandPool = VK_NULL_HANDLE;
+  m_Queue = VK_NULL_HANDLE;
+}
+
+void TransferQueue::UploadBuffer(VkDeviceSize Size, VkBufferUsageFlags Usage, const std::function<void(void*)>& Write, BufferInfo& Buffer, TransferTicket& Ticket)
+{
+  auto Start = std::chrono::steady_clock::now();
+
+  BufferInfo StagingBuffer;
+
+  CreateBuffer(m_PhysicalDevice, m_Device, Size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, StagingBuffer);
+
+  void* pMappedData = nullptr;
+  vkMapMemory(m_Device, StagingBuffer.Memory, 0, Size, 0, &pMappedData);
+  Write(pMappedData);
+  vkUnmapMemory(m_Device, StagingBuffer.Memory);
+
+  CreateBuffer(m_PhysicalDevice, m_Device, Size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | Usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Buffer);
+
+  VkBufferMemoryBarrier Barrier = {};
+  Barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  Barrier.srcQueueFamilyIndex = m_TransferFamily;
+  Barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+  Barrier.buffer = Buffer.Buffer;
+  Barrier.offset = 0;
+  Barrier.size = VK_WHOLE_SIZE;
+  Ticket.BufferBarriers.push_back(Barrier);
+
+  Submit([&](VkCommandBuffer CommandBuffer)
+         {
+           VkBufferCopy CopyRegion = {};
+           CopyRegion.size = Size;
+           vkCmdCopyBuffer(CommandBuffer, StagingBuffer.Buffer, Buffer.Buffer, 1, &CopyRegion);
+         },
+         Ticket);
+
+  DestroyBuffer(m_Device, StagingBuffer);
+
+  RecordUpload(UPLOAD_PATH_TRANSFER_QUEUE, Size, Start);
+}
+
+void TransferQueue::UploadTexture(VkFormat Format, const std::vector<MipData>& Mips, TextureInfo& Texture, TransferTicket& Ticket)
+{
+  Texture.MipLevels = static_cast<uint32_t>(Mips.size());
+
+  //Streamed textures are copied into the images that replace them on the graphics queue.
+  CreateImage(m_PhysicalDevice, m_Device, Mips[0].Width, Mips[0].Height, Texture.MipLevels, VK_SAMPLE_COUNT_1_BIT, Format, VK_IMAGE_TILING_OPTIMAL,
+              VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Texture.TextureImage, Texture.TextureImageMemory);
+
+  //The levels that are not filled are in the same layout as the others, the view covers all of them.
+  UploadLevels(Mips, 0, Texture.MipLevels, Texture.TextureImage, Ticket);
+}
+
+void TransferQueue::UploadTextureLevels(const std::vector<MipData>& Mips, const TextureInfo& Texture, TransferTicket& Ticket)
+{
+  uint32_t FirstLevel = 0, EndLevel = static_cast<uint32_t>(Mips.size());
+  while(FirstLevel < EndLevel && Mips[FirstLevel].pData == nullptr)
+    ++FirstLevel;
+  while(EndLevel > FirstLevel && Mips[EndLevel - 1].pData == nullptr)
+    --EndLevel;
+
+  if(FirstLevel < EndLevel)
+    UploadLevels(Mips, FirstLevel, EndLevel, Texture.TextureImage, Ticket);
+}
+
+void TransferQueue::UploadLevels(const std::vector<MipData>& Mips, uint32_t FirstLevel, uint32_t EndLevel, VkImage Image, TransferTicket& Ticket)
+{
+  auto Start = std::chrono::steady_clock::now();
+
+  //Every level starts at a multiple of 16 bytes, enough for "vkCmdCopyBufferToImage()" and every texel block size.
+  std::vector<VkDeviceSize> Offsets(Mips.size());
+  VkDeviceSize StagingSize = 0;
+  for(size_t i = 0; i < Mips.size(); ++i)
+  {
+    if(Mips[i].pData == nullptr)
+      continue;
+
+    Offsets[i] = (StagingSize + 15) / 16 * 16;
+    StagingSize = Offsets[i] + Mips[i].Size;
+  }
+
+  BufferInfo StagingBuffer;
+
+  CreateBuffer(m_PhysicalDevice, m_Device, StagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, StagingBuffer);
+
+  void* pMappedData = nullptr;
+  vkMapMemory(m_Device, StagingBuffer.Memory, 0, StagingSize, 0, &pMappedData);
+  for(size_t i = 0; i < Mips.size(); ++i)
+  {
+    if(Mips[i].pData != nullptr)
+      std::memcpy(static_cast<uint8_t*>(pMappedData) + Offsets[i], Mips[i].pData, static_cast<size_t>(Mips[i].Size));
+  }
+  vkUnmapMemory(m_Device, StagingBuffer.Memory);
+
+  //The layout transition of an ownership transfer is given identically in the release and in the acquire barrier.
+  VkImageMemoryBarrier Barrier = {};
+  Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  Barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  Barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  Barrier.srcQueueFamilyIndex = m_TransferFamily;
+  Barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+  Barrier.image = Image;
+  Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  Barrier.subresourceRange.baseMipLevel = FirstLevel;
+  Barrier.subresourceRange.levelCount = EndLevel - FirstLevel;
+  Barrier.subresourceRange.baseArrayLayer = 0;
+  Barrier.subresourceRange.layerCount = 1;
+  Ticket.ImageBarriers.push_back(Barrier);
+
+  Submit([&](VkCommandBuffer CommandBuffer)
+         {
+           VkImageMemoryBarrier ToTransfer = Barrier;
+           ToTransfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+           ToTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+           ToTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+           ToTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+           ToTransfer.srcAccessMask = 0;
+           ToTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+           vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &ToTransfer);
+
+           std::vector<VkBufferImageCopy> Regions;
+           for(size_t i = 0; i < Mips.size(); ++i)
+           {
+             if(Mips[i].pData == nullptr)
+               continue;
+
+             VkBufferImageCopy Region = {};
+             Region.bufferOffset = Offsets[i];
+             Region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+             Region.imageSubresource.mipLevel = static_cast<uint32_t>(i);
+             Region.imageSubresource.baseArrayLayer = 0;
+             Region.imageSubresource.layerCount = 1;
+             Region.imageExtent = {Mips[i].Width, Mips[i].Height, 1};
+             Regions.push_back(Region);
+           }
+
+           //Whole levels are always copied, so the image transfer granularity of the queue family never matters.
+           vkCmdCopyBufferToImage(CommandBuffer, StagingBuffer.Buffer, Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(Regions.size()), Regions.data());
+         },
+         Ticket);
+
+  DestroyBuffer(m_Device, StagingBuffer);
+
+  RecordUpload(UPLOAD_PATH_TRANSFER_QUEUE, StagingSize, Start);
+}
+
+void TransferQueue::Submit(const std::function<void(VkCommandBuffer)>& Record, TransferTicket& Ticket)
+{
+  VkSemaphoreCreateInfo SemaphoreCreateInfo = {};
+  SemaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+  VkFenceCreateInfo FenceCreateInfo = {};
+  FenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+  VkFence Fence = VK_NULL_HANDLE;
+  if(vkCreateSemaphore(m_Device, &SemaphoreCreateInfo, nullptr, &Ticket.Semaphore) != VK_SUCCESS || vkCreateFence(m_Device, &FenceCreateInfo, nullptr, &Fence) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create synchronization objects for a transfer!");
+
+  //The release halves of the ownership transfers, the access masks of the destination are ignored here.
+  std::vector<VkBufferMemoryBarrier> BufferBarriers = Ticket.BufferBarriers;
+  for(auto& Barrier : BufferBarriers)
+  {
+    Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    Barrier.dstAccessMask = 0;
+  }
+
+  std::vector<VkImageMemoryBarrier> ImageBarriers = Ticket.ImageBarriers;
+  for(auto& Barrier : ImageBarriers)
+  {
+    Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    Barrier.dstAccessMask = 0;
+  }
+
+  VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+
+    CommandBuffer = BeginSingleTimeCommands(m_Device, m_CommandPool);
+
+    Record(CommandBuffer);
+
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                         static_cast<uint32_t>(BufferBarriers.size()), BufferBarriers.data(), static_cast<uint32_t>(ImageBarriers.size()), ImageBarriers.data());
+
+    vkEndCommandBuffer(CommandBuffer);
+
+    VkSubmitInfo SubmitInfo = {};
+    SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    SubmitInfo.commandBufferCount = 1;
+    SubmitInfo.pCommandBuffers = &CommandBuffer;
+    SubmitInfo.signalSemaphoreCount = 1;
+    SubmitInfo.pSignalSemaphores = &Ticket.Semaphore;
+
+    if(vkQueueSubmit(m_Queue, 1, &SubmitInfo, Fence) != VK_SUCCESS)
+      throw std::runtime_error("Failed to submit a transfer!");
+  }
+
+  //Only this thread waits, the staging buffer can be destroyed once the copy is done.
+  vkWaitForFences(m_Device, 1, &Fence, VK_TRUE, UINT64_MAX);
+  vkDestroyFence(m_Device, Fence, nullptr);
+
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &CommandBuffer);
+}
+
+void TransferQueue::Acquire(VkQueue GraphicsQueue, VkCommandPool GraphicsCommandPool, TransferTicket& Ticket)
+{
+  ReleaseAcquires(false);
+
+  if(!IsCreated() || Ticket.Semaphore == VK_NULL_HANDLE)
+    return;
+
+  //The acquire halves, the source access masks are ignored here.
+  for(auto& Barrier : Ticket.BufferBarriers)
+  {
+    Barrier.srcAccessMask = 0;
+    Barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+  }
+
+  for(auto& Barrier : Ticket.ImageBarriers)
+  {
+    Barrier.srcAccessMask = 0;
+    Barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  }
+
+  VkCommandBuffer CommandBuffer = BeginSingleTimeCommands(m_Device, GraphicsCommandPool);
+
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr,
+                       static_cast<uint32_t>(Ticket.BufferBarriers.size()), Ticket.BufferBarriers.data(), static_cast<uint32_t>(Ticket.ImageBarriers.size()), Ticket.ImageBarriers.data());
+
+  vkEndCommandBuffer(CommandBuffer);
+
+  VkPipelineStageFlags WaitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+  VkSubmitInfo SubmitInfo = {};
+  SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  SubmitInfo.waitSemaphoreCount = 1;
+  SubmitInfo.pWaitSemaphores = &Ticket.Semaphore;
+  SubmitInfo.pWaitDstStageMask = &WaitStage;
+  SubmitInfo.commandBufferCount = 1;
+  SubmitInfo.pCommandBuffers = &CommandBuffer;
+
+  /* The graphics queue executes its submissions in order, so nothing has to wait for the acquire here: it only has to be
+   * finished before its command buffer and semaphore are freed. */
+  PendingAcquire Pending;
+  Pending.CommandPool = GraphicsCommandPool;
+  Pending.CommandBuffer = CommandBuffer;
+  Pending.Semaphore = Ticket.Semaphore;
+
+  VkFenceCreateInfo FenceCreateInfo = {};
+  FenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+  if(vkCreateFence(m_Device, &FenceCreateInfo, nullptr, &Pending.Fence) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create a fence for a transfer!");
+
+  if(vkQueueSubmit(GraphicsQueue, 1, &SubmitInfo, Pending.Fence) != VK_SUCCESS)
+    throw std::runtime_error("Failed to submit the acquire of a transfer!");
+
+  m_PendingAcquires.push_back(Pending);
+  Ticket = TransferTicket();
+}
+
+void TransferQueue::ReleaseAcquires(bool bWait)
+{
+  auto Finished = [this, bWait](const PendingAcquire& Pending)
+  {
+    if(bWait)
+      vkWaitForFences(m_Device, 1, &Pending.Fence, VK_TRUE, UINT64_MAX);
+    else if(vkGetFenceStatus(m_Device, Pending.Fence) != VK_SUCCESS)
+      return false;
+
+    vkDestroyFence(m_Device, Pending.Fence, nullptr);
+    vkFreeCommandBuffers(m_Device, Pending.CommandPool, 1, &Pending.CommandBuffer);
+    vkDestroySemaphore(m_Device, Pending.Semaphore, nullptr);
+    return true;
+  };
+
+  m_PendingAcquires.erase(std::remove_if(m_PendingAcquires.begin(), m_PendingAcquires.end(), Finished), m_PendingAcquires.end());
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "VulkanHelper.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* What the graphics queue has to do to take over the resources of an upload on the transfer queue: the acquire halves of the
+ * queue family ownership transfers, executed once the semaphore the transfer signaled has been waited on. */
+struct TransferTicket
+{
+  VkSemaphore Semaphore = VK_NULL_HANDLE;
+  std::vector<VkBufferMemoryBarrier> BufferBarriers;
+  std::vector<VkImageMemoryBarrier> ImageBarriers;
+};
+
+/* Uploads on a queue of a family without graphics, so copying new content does not delay the frames on the graphics queue.
+ * Resources are created with exclusive sharing, the transfer queue releases them to the graphics queue family after the copy
+ * and "Acquire()" takes them over on the graphics queue. The uploads can be started from any thread (e.g. the workers of the
+ * asset loader), they wait for their copy to finish on that thread. */
+class TransferQueue
+{
+  public:
+  //Does nothing if "TransferFamily" is not set, every upload then has to go through the graphics queue.
+  void Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, const QueueFamilyIndices& Indices);
+
+  void Destroy();
+
+  bool IsCreated() const {return m_Queue != VK_NULL_HANDLE;}
+
+  //Create a device local buffer and fill it with "Write", which gets the mapped staging memory of the whole buffer.
+  void UploadBuffer(VkDeviceSize Size, VkBufferUsageFlags Usage, const std::function<void(void*)>& Write, BufferInfo& Buffer, TransferTicket& Ticket);
+
+  /* Create a texture image with the complete mip chain and copy all levels into it with a single command, the image is handed
+   * over in "VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL". Levels without data are left for "UploadTextureLevels()". The view and
+   * the sampler are left to the caller. */
+  void UploadTexture(VkFormat Format, const std::vector<MipData>& Mips, TextureInfo& Texture, TransferTicket& Ticket);
+
+  /* Copy the levels that have data into an image "UploadTexture()" created, the levels of "Mips" are those of the image. The
+   * graphics queue may be sampling its other levels meanwhile, the ones copied must not have been sampled: they are taken
+   * without an ownership transfer, which discards what they had. */
+  void UploadTextureLevels(const std::vector<MipData>& Mips, const TextureInfo& Texture, TransferTicket& Ticket);
+
+  /* Take the resources of the ticket over on the graphics queue, everything submitted to it afterwards sees them. Does nothing
+   * for a ticket without an upload. The graphics command pool has to stay alive until "Destroy()". */
+  void Acquire(VkQueue GraphicsQueue, VkCommandPool GraphicsCommandPool, TransferTicket& Ticket);
+
+  protected:
+  //The command buffer and the semaphore of an acquire can only be freed once the graphics queue has executed it.
+  struct PendingAcquire
+  {
+    VkFence Fence = VK_NULL_HANDLE;
+    VkCommandPool CommandPool = VK_NULL_HANDLE;
+    VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+    VkSemaphore Semaphore = VK_NULL_HANDLE;
+  };
+
+  //Free the acquires the graphics queue has finished, or wait for all of them first.
+  void ReleaseAcquires(bool bWait);
+
+  //Copy the levels that have data into the image and release the levels from "FirstLevel" to "EndLevel" to the graphics queue.
+  void UploadLevels(const std::vector<MipData>& Mips, uint32_t FirstLevel, uint32_t EndLevel, VkImage Image, TransferTicket& Ticket);
+
+  //Record the copy with "Record()", release the resources of the ticket and wait until the transfer queue has executed it.
+  void Submit(const std::function<void(VkCommandBuffer)>& Record, TransferTicket& Ticket);
+
+  VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+  VkDevice m_Device = VK_NULL_HANDLE;
+  uint32_t m_TransferFamily = 0;
+  uint32_t m_GraphicsFamily = 0;
+  VkQueue m_Queue = VK_NULL_HANDLE;
+
+  //Recording into command buffers of the pool and submitting to the queue have to be externally synchronized.
+  std::mutex m_Mutex;
+  VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+
+  //Only touched by the thread that acquires, like the graphics command pool.
+  std::vector<PendingAcquire> m_PendingAcquires;
+};
+
+NAMESPACE_END
\ No newline at end of file
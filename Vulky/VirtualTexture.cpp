@@ -0,0 +1,289 @@
+#include "VirtualTexture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "ParallelFor.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  uint32_t RoundUpToPowerOfTwo(uint32_t Value)
+  {
+    uint32_t Result = 1;
+    while(Result < Value)
+      Result <<= 1;
+
+    return Result;
+  }
+}
+
+void VirtualTextureLayout::GetPagePosition(uint32_t Page, uint32_t& Level, uint32_t& X, uint32_t& Y) const
+{
+  Level = static_cast<uint32_t>(std::upper_bound(FirstPages.begin(), FirstPages.end(), Page) - FirstPages.begin()) - 1;
+  X = (Page - FirstPages[Level]) % PageWidths[Level];
+  Y = (Page - FirstPages[Level]) / PageWidths[Level];
+}
+
+uint32_t VirtualTextureLayout::GetTableEntryNum() const
+{
+  uint32_t EntryNum = 0;
+  for(uint32_t Level = 0; Level < LevelNum; ++Level)
+    EntryNum += std::max(TableWidth >> Level, 1u) * std::max(TableHeight >> Level, 1u);
+
+  return EntryNum;
+}
+
+bool VirtualTextureLayout::operator==(const VirtualTextureLayout& Other) const
+{
+  return BaseLevel == Other.BaseLevel && Width == Other.Width && Height == Other.Height && LevelNum == Other.LevelNum;
+}
+
+void GetVirtualTextureLayout(uint32_t Width, uint32_t Height, uint32_t MipLevels, VirtualTextureLayout& Layout)
+{
+  Layout = VirtualTextureLayout();
+  while(Layout.BaseLevel + 1 < MipLevels && std::max(Width >> Layout.BaseLevel, Height >> Layout.BaseLevel) > MaxVirtualTextureSize)
+    ++Layout.BaseLevel;
+  Layout.Width = std::max(Width >> Layout.BaseLevel, 1u);
+  Layout.Height = std::max(Height >> Layout.BaseLevel, 1u);
+
+  for(uint32_t Level = 0; Layout.BaseLevel + Level < MipLevels; ++Level)
+  {
+    uint64_t LevelTileSize = static_cast<uint64_t>(VirtualTileSize) << Level;
+    uint32_t PageWidth = static_cast<uint32_t>((Layout.Width + LevelTileSize - 1) / LevelTileSize);
+    uint32_t PageHeight = static_cast<uint32_t>((Layout.Height + LevelTileSize - 1) / LevelTileSize);
+
+    Layout.PageWidths.push_back(PageWidth);
+    Layout.PageHeights.push_back(PageHeight);
+    Layout.FirstPages.push_back(Layout.PageNum);
+    Layout.PageNum += PageWidth * PageHeight;
+    ++Layout.LevelNum;
+
+    if(PageWidth == 1 && PageHeight == 1)
+      break;
+  }
+
+  //Every page has to fall back to the tile of the last level at the latest.
+  if(Layout.PageNum == 0 || Layout.PageWidths.back() != 1 || Layout.PageHeights.back() != 1)
+    throw std::runtime_error("The mip chain of a virtual texture has to go down to a level that fits into one tile!");
+
+  Layout.TableWidth = RoundUpToPowerOfTwo(Layout.PageWidths[0]);
+  Layout.TableHeight = RoundUpToPowerOfTwo(Layout.PageHeights[0]);
+}
+
+void SplitIntoTiles(const MipChain& Chain, const VirtualTextureLayout& Layout, TEXTURE_ENCODING Encoding, std::vector<uint8_t>& Tiles, uint32_t ThreadNum)
+{
+  size_t TileSize = GetEncodedSize(Encoding, VirtualTileStride, VirtualTileStride);
+  Tiles.resize(TileSize * Layout.PageNum);
+
+  if(ThreadNum == 0)
+    ThreadNum = std::max(std::thread::hardware_concurrency(), 1u);
+
+  //Every tile is encoded on a single thread, there are enough of them to keep all threads busy.
+  ParallelFor(Layout.PageNum, ThreadNum, [&](size_t Begin, size_t End)
+  {
+    std::vector<uint8_t> Texels(static_cast<size_t>(VirtualTileStride) * VirtualTileStride * 4);
+    std::vector<uint8_t> Encoded;
+    for(size_t Page = Begin; Page < End; ++Page)
+    {
+      uint32_t Level, PageX, PageY;
+      Layout.GetPagePosition(static_cast<uint32_t>(Page), Level, PageX, PageY);
+
+      const uint8_t* pPixels = Chain.Levels[Layout.BaseLevel + Level].data();
+      int64_t Width = Chain.Widths[Layout.BaseLevel + Level], Height = Chain.Heights[Layout.BaseLevel + Level];
+
+      //The texels outside of the level wrap around, like the repeating samplers of the other textures.
+      for(uint32_t Row = 0; Row < VirtualTileStride; ++Row)
+      {
+        int64_t Y = static_cast<int64_t>(PageY) * VirtualTileSize + Row - VirtualTileBorder;
+        Y = (Y % Height + Height) % Height;
+        for(uint32_t Column = 0; Column < VirtualTileStride; ++Column)
+        {
+          int64_t X = static_cast<int64_t>(PageX) * VirtualTileSize + Column - VirtualTileBorder;
+          X = (X % Width + Width) % Width;
+          std::memcpy(&Texels[(static_cast<size_t>(Row) * VirtualTileStride + Column) * 4], pPixels + (Y * Width + X) * 4, 4);
+        }
+      }
+
+      EncodeTexture(Texels.data(), VirtualTileStride, VirtualTileStride, Encoding, Encoded, 1);
+      std::memcpy(Tiles.data() + Page * TileSize, Encoded.data(), TileSize);
+    }
+  });
+}
+
+void TileCache::Init(uint32_t Texture, uint32_t SlotNum, uint32_t RecentFrameNum)
+{
+  m_Texture = Texture;
+  m_SlotsPerSide = SlotNum;
+  m_RecentFrameNum = std::max(RecentFrameNum, 1u);
+  m_SlotPages.assign(static_cast<size_t>(SlotNum) * SlotNum, UINT32_MAX);
+  m_Frame = 0;
+  m_StreamedNum = 0;
+  m_EvictedNum = 0;
+}
+
+void TileCache::SetLayout(const VirtualTextureLayout& Layout)
+{
+  m_Layout = Layout;
+  ++m_Generation;
+
+  m_PageStates.assign(Layout.PageNum, PAGE_STATE_ABSENT);
+  m_PageSlots.assign(Layout.PageNum, UINT32_MAX);
+  m_PageFrames.assign(Layout.PageNum, 0);
+  std::fill(m_SlotPages.begin(), m_SlotPages.end(), UINT32_MAX);
+  m_ResidentNum = 0;
+  m_bPageTableChanged = true;
+
+  //The page of the last level counts as always sampled, so it is requested first and never evicted.
+  if(Layout.PageNum > 0)
+    m_PageFrames[Layout.PageNum - 1] = UINT64_MAX;
+}
+
+void TileCache::ReportPages(const uint32_t* pBits)
+{
+  ++m_Frame;
+
+  for(uint32_t Word = 0; Word < (m_Layout.PageNum + 31) / 32; ++Word)
+  {
+    if(pBits[Word] == 0)
+      continue;
+
+    for(uint32_t Bit = 0; Bit < 32; ++Bit)
+    {
+      uint32_t Page = Word * 32 + Bit;
+      if((pBits[Word] & (1u << Bit)) == 0 || Page >= m_Layout.PageNum)
+        continue;
+
+      uint32_t Level, X, Y;
+      m_Layout.GetPagePosition(Page, Level, X, Y);
+      MarkSampled(Level, X, Y);
+    }
+  }
+}
+
+void TileCache::MarkSampled(uint32_t Level, uint32_t X, uint32_t Y)
+{
+  //A page that has already been marked in this report has had the pages that cover it marked too.
+  for(; Level < m_Layout.LevelNum; ++Level, X >>= 1, Y >>= 1)
+  {
+    uint64_t& Frame = m_PageFrames[m_Layout.GetPage(Level, X, Y)];
+    if(Frame == m_Frame)
+      break;
+    if(Frame != UINT64_MAX)
+      Frame = m_Frame;
+  }
+}
+
+void TileCache::Schedule(uint32_t& Budget, std::vector<TileRequest>& Requests)
+{
+  auto IsRecent = [this](uint32_t Page) {return m_PageFrames[Page] == UINT64_MAX || (m_PageFrames[Page] != 0 && m_Frame - m_PageFrames[Page] < m_RecentFrameNum);};
+
+  //The pages are stored level by level, going backwards requests the small levels first.
+  for(uint32_t Page = m_Layout.PageNum; Page-- > 0 && Budget > 0;)
+  {
+    if(m_PageStates[Page] != PAGE_STATE_ABSENT || !IsRecent(Page))
+      continue;
+
+    uint32_t Slot = FindSlot();
+    if(Slot == UINT32_MAX)
+      break;
+
+    uint32_t Evicted = m_SlotPages[Slot];
+    if(Evicted != UINT32_MAX)
+    {
+      m_PageStates[Evicted] = PAGE_STATE_ABSENT;
+      m_PageSlots[Evicted] = UINT32_MAX;
+      --m_ResidentNum;
+      ++m_EvictedNum;
+      m_bPageTableChanged = true;
+    }
+
+    m_SlotPages[Slot] = Page;
+    m_PageSlots[Page] = Slot;
+    m_PageStates[Page] = PAGE_STATE_PENDING;
+
+    TileRequest Request;
+    Request.Texture = m_Texture;
+    Request.Page = Page;
+    Request.Slot = Slot;
+    Request.Generation = m_Generation;
+    Requests.push_back(Request);
+    --Budget;
+  }
+}
+
+uint32_t TileCache::FindSlot()
+{
+  uint32_t Victim = UINT32_MAX;
+  for(uint32_t Slot = 0; Slot < m_SlotPages.size(); ++Slot)
+  {
+    uint32_t Page = m_SlotPages[Slot];
+    if(Page == UINT32_MAX)
+      return Slot;
+
+    //Pages sampled recently would be requested again right away, the last level is never evicted.
+    if(m_PageStates[Page] != PAGE_STATE_RESIDENT || m_PageFrames[Page] == UINT64_MAX || m_Frame - m_PageFrames[Page] < m_RecentFrameNum)
+      continue;
+
+    if(Victim == UINT32_MAX || m_PageFrames[Page] < m_PageFrames[m_SlotPages[Victim]])
+      Victim = Slot;
+  }
+
+  return Victim;
+}
+
+bool TileCache::Complete(const TileRequest& Request)
+{
+  if(Request.Generation != m_Generation || m_PageStates[Request.Page] != PAGE_STATE_PENDING || m_PageSlots[Request.Page] != Request.Slot)
+    return false;
+
+  m_PageStates[Request.Page] = PAGE_STATE_RESIDENT;
+  ++m_ResidentNum;
+  ++m_StreamedNum;
+  m_bPageTableChanged = true;
+  return true;
+}
+
+void TileCache::BuildPageTable(std::vector<uint32_t>& Entries)
+{
+  Entries.assign(m_Layout.GetTableEntryNum(), 0);
+
+  std::vector<uint32_t> LevelOffsets(m_Layout.LevelNum, 0);
+  for(uint32_t Level = 1; Level < m_Layout.LevelNum; ++Level)
+    LevelOffsets[Level] = LevelOffsets[Level - 1] + std::max(m_Layout.TableWidth >> (Level - 1), 1u) * std::max(m_Layout.TableHeight >> (Level - 1), 1u);
+
+  //From the smallest level up, an entry without a resident tile takes the one of the next smaller level that covers it.
+  for(uint32_t Level = m_Layout.LevelNum; Level-- > 0;)
+  {
+    uint32_t TableWidth = std::max(m_Layout.TableWidth >> Level, 1u), TableHeight = std::max(m_Layout.TableHeight >> Level, 1u);
+    uint32_t CoarserWidth = std::max(m_Layout.TableWidth >> (Level + 1), 1u);
+    for(uint32_t Y = 0; Y < TableHeight; ++Y)
+    {
+      for(uint32_t X = 0; X < TableWidth; ++X)
+      {
+        uint32_t Entry = 0;
+        if(Level + 1 < m_Layout.LevelNum)
+          Entry = Entries[LevelOffsets[Level + 1] + (Y >> 1) * CoarserWidth + (X >> 1)];
+
+        if(X < m_Layout.PageWidths[Level] && Y < m_Layout.PageHeights[Level])
+        {
+          uint32_t Page = m_Layout.GetPage(Level, X, Y);
+          if(m_PageStates[Page] == PAGE_STATE_RESIDENT)
+          {
+            uint32_t Slot = m_PageSlots[Page];
+            Entry = (Slot % m_SlotsPerSide) | (Slot / m_SlotsPerSide) << 8 | Level << 16 | 1u << 24;
+          }
+        }
+
+        Entries[LevelOffsets[Level] + Y * TableWidth + X] = Entry;
+      }
+    }
+  }
+
+  m_bPageTableChanged = false;
+}
+
+NAMESPACE_END
\ No newline at end of file
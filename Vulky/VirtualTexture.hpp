@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Namespace.hpp"
+#include "MipGenerator.hpp"
+#include "BlockCompressor.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+/* A virtual texture is split into tiles of "VirtualTileSize" x "VirtualTileSize" texels per mip level, each stored with a border
+ * of "VirtualTileBorder" texels of its neighbours (wrapped around at the edges, like the repeating samplers), so filtering inside
+ * a tile never reads another one. The border is a whole number of 4 x 4 blocks, the tiles are block compressed on their own. */
+const uint32_t VirtualTileSize = 128;
+const uint32_t VirtualTileBorder = 4;
+const uint32_t VirtualTileStride = VirtualTileSize + 2 * VirtualTileBorder;
+//Larger textures start at the first level that fits, which bounds the pages the feedback has to report.
+const uint32_t MaxVirtualTextureSize = 16384;
+
+/* Level "Level" is treated as "Width" / 2^"Level" texels wide (and "Height" / 2^"Level" high), so the page of a level always lies
+ * within the page of the next one at half its coordinates. For sizes that are not powers of two, the last texels of the smaller
+ * levels are stretched by less than one texel. Only the levels down to the first one that fits into a single tile are split. */
+struct VirtualTextureLayout
+{
+  //The level of the mip chain the virtual texture starts with, and its size.
+  uint32_t BaseLevel = 0;
+  uint32_t Width = 0;
+  uint32_t Height = 0;
+  uint32_t LevelNum = 0;
+  //Per level the pages in each direction and the index of its first page, the pages are counted row by row, level by level.
+  std::vector<uint32_t> PageWidths;
+  std::vector<uint32_t> PageHeights;
+  std::vector<uint32_t> FirstPages;
+  uint32_t PageNum = 0;
+  //The largest level of the page table, the page counts of the first level rounded up to powers of two, so every level fits into the table.
+  uint32_t TableWidth = 1;
+  uint32_t TableHeight = 1;
+
+  uint32_t GetPage(uint32_t Level, uint32_t X, uint32_t Y) const {return FirstPages[Level] + Y * PageWidths[Level] + X;}
+
+  //The level of a page and its position in it.
+  void GetPagePosition(uint32_t Page, uint32_t& Level, uint32_t& X, uint32_t& Y) const;
+
+  //The entries of all levels of the page table, from the largest to the smallest one.
+  uint32_t GetTableEntryNum() const;
+
+  bool operator==(const VirtualTextureLayout& Other) const;
+};
+
+//The layout of a texture with a mip chain of "MipLevels" levels, the first "Width" x "Height" texels.
+void GetVirtualTextureLayout(uint32_t Width, uint32_t Height, uint32_t MipLevels, VirtualTextureLayout& Layout);
+
+/* Cut the levels of an RGBA8 chain into the tiles of the layout and encode every one of them on its own. The tiles are appended
+ * in page order, each "GetEncodedSize(Encoding, VirtualTileStride, VirtualTileStride)" bytes. The tiles are split across
+ * "ThreadNum" threads (zero picks a number based on the hardware). */
+void SplitIntoTiles(const MipChain& Chain, const VirtualTextureLayout& Layout, TEXTURE_ENCODING Encoding, std::vector<uint8_t>& Tiles, uint32_t ThreadNum = 0);
+
+//Copy the tile of a page of the texture into a slot of its cache texture, the slots are counted row by row.
+struct TileRequest
+{
+  uint32_t Texture = 0;
+  uint32_t Page = 0;
+  uint32_t Slot = 0;
+  //The layout the tile belongs to, a request of a texture that has been replaced since is dropped.
+  uint32_t Generation = 0;
+};
+
+/* Which tiles of a virtual texture are in its cache texture, a fixed grid of slots. The fragment shader reports the pages it
+ * samples; they and the pages of the smaller levels that cover them are requested, the small levels first, so a page that is not
+ * resident yet always falls back to the closest resident one. The single page of the last level is requested first and never
+ * evicted, every page falls back to it at the latest. A new tile takes a free slot or the one of the page that has not been
+ * sampled for the longest time, pages sampled during the last "RecentFrameNum" reports keep theirs.
+ * The page table maps every page to the slot of the closest resident tile that covers it (itself if it is resident) and the
+ * level of that tile, in "VK_FORMAT_R8G8B8A8_UINT": slot X, slot Y, level and one for a valid entry. */
+class TileCache
+{
+  public:
+  //The tiles of "Texture" go into a cache of "SlotNum" x "SlotNum" slots, "RecentFrameNum" is at least one.
+  void Init(uint32_t Texture, uint32_t SlotNum, uint32_t RecentFrameNum);
+
+  //The texture was (re)created with the layout, all of its tiles are dropped and requests that are still pending are forgotten.
+  void SetLayout(const VirtualTextureLayout& Layout);
+
+  const VirtualTextureLayout& GetLayout() const {return m_Layout;}
+
+  //The pages the fragment shader sampled in a frame, one bit per page in page order.
+  void ReportPages(const uint32_t* pBits);
+
+  //Request up to "Budget" tiles, which is reduced by the number requested. They stay pending until "Complete()" is called for them.
+  void Schedule(uint32_t& Budget, std::vector<TileRequest>& Requests);
+
+  //The tile of the request has been copied into its slot, false if the request is of a previous layout.
+  bool Complete(const TileRequest& Request);
+
+  //Whether the page table has to be uploaded again.
+  bool HasPageTableChanged() const {return m_bPageTableChanged;}
+
+  //All levels of the page table, see "GetTableEntryNum()".
+  void BuildPageTable(std::vector<uint32_t>& Entries);
+
+  uint32_t GetGeneration() const {return m_Generation;}
+
+  uint32_t GetSlotNum() const {return static_cast<uint32_t>(m_SlotPages.size());}
+
+  uint32_t GetResidentNum() const {return m_ResidentNum;}
+
+  uint32_t GetStreamedNum() const {return m_StreamedNum;}
+
+  uint32_t GetEvictedNum() const {return m_EvictedNum;}
+
+  protected:
+  enum PAGE_STATE : uint8_t
+  {
+    PAGE_STATE_ABSENT,
+    PAGE_STATE_PENDING,
+    PAGE_STATE_RESIDENT
+  };
+
+  //Mark the page and the pages of the smaller levels that cover it as sampled.
+  void MarkSampled(uint32_t Level, uint32_t X, uint32_t Y);
+
+  //A free slot, or the one of the least recently sampled page that may be evicted, "UINT32_MAX" if there is none.
+  uint32_t FindSlot();
+
+  uint32_t m_Texture = 0;
+  uint32_t m_SlotsPerSide = 0;
+  uint32_t m_RecentFrameNum = 1;
+  VirtualTextureLayout m_Layout;
+  uint32_t m_Generation = 0;
+  uint64_t m_Frame = 0;
+
+  std::vector<PAGE_STATE> m_PageStates;
+  std::vector<uint32_t> m_PageSlots;
+  //The report a page was sampled in last, zero if it has not been sampled since the layout was set.
+  std::vector<uint64_t> m_PageFrames;
+  //The page of every slot, "UINT32_MAX" for free slots.
+  std::vector<uint32_t> m_SlotPages;
+  bool m_bPageTableChanged = false;
+
+  uint32_t m_ResidentNum = 0;
+  uint32_t m_StreamedNum = 0;
+  uint32_t m_EvictedNum = 0;
+};
+
+NAMESPACE_END
\ No newline at end of file
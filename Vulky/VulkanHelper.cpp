@@ -1,13 +1,18 @@
 #include "VulkanHelper.hpp"
+#include "PngDecoder.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <cstring>
 #include <memory>
 #include <set>
 #include <string>
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
 
 NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
 
@@ -106,9 +111,34 @@ QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice Device, VkSurfaceKHR Surfa
       break;
   }
 
+  //Every queue supports transfers, only a family without graphics (ideally without compute as well) runs them next to rendering.
+  for(uint32_t i = 0; i < QueueFamilyCount; ++i)
+  {
+    VkQueueFlags Flags = QueueFamilies[i].queueFlags;
+    if(QueueFamilies[i].queueCount == 0 || (Flags & VK_QUEUE_GRAPHICS_BIT) || !(Flags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT)))
+      continue;
+
+    if(!Indices.TransferFamily.has_value() || !(Flags & VK_QUEUE_COMPUTE_BIT))
+      Indices.TransferFamily = i;
+  }
+
   return Indices;
 }
 
+bool CheckInstanceExtensionsSupport(const std::vector<const char*>& Extensions)
+{
+  uint32_t ExtensionCount = 0;
+  vkEnumerateInstanceExtensionProperties(nullptr, &ExtensionCount, nullptr);
+  std::unique_ptr<VkExtensionProperties[]> AvailableExtensions(new VkExtensionProperties[ExtensionCount]);
+  vkEnumerateInstanceExtensionProperties(nullptr, &ExtensionCount, AvailableExtensions.get());
+
+  std::set<std::string> RequiredExtensions(Extensions.begin(), Extensions.end());
+  for(uint32_t i = 0; i < ExtensionCount; ++i)
+    RequiredExtensions.erase(AvailableExtensions[i].extensionName);
+
+  return RequiredExtensions.empty();
+}
+
 bool CheckPhysicalDeviceExtensionsSupport(VkPhysicalDevice Device, const std::vector<const char*> Extensions
 )
 {
@@ -148,10 +178,22 @@ SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice Device, VkSurface
   return Details;
 }
 
-VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& AvailableFormats)
+VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& AvailableFormats, bool bPreferSrgb)
 {
   if(AvailableFormats.size() == 1 && AvailableFormats[0].format == VK_FORMAT_UNDEFINED)
-    return {VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+    return {bPreferSrgb ? VK_FORMAT_B8G8R8A8_SRGB : VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+
+  if(bPreferSrgb)
+  {
+    for(VkFormat Format : {VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_SRGB})
+    {
+      for(const auto& AvailableFormat : AvailableFormats)
+      {
+        if(AvailableFormat.format == Format && AvailableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+          return AvailableFormat;
+      }
+    }
+  }
 
   for(const auto& AvailableFormat : AvailableFormats)
   {
@@ -162,6 +204,19 @@ VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>
   return AvailableFormats[0];
 }
 
+bool IsSrgbFormat(VkFormat Format)
+{
+  switch(Format)
+  {
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+      return true;
+    default:
+      return false;
+  }
+}
+
 VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& AvailablePresentModes)
 {
   VkPresentModeKHR BestMode = VK_PRESENT_MODE_FIFO_KHR;
@@ -230,6 +285,18 @@ VkShaderModule CreateShaderModule(VkDevice Device, const std::vector<char>& Shad
   return ShaderModule;
 }
 
+bool IsSpirVCode(const std::vector<char>& ShaderCode)
+{
+  const uint32_t SpirVMagic = 0x07230203;
+
+  uint32_t Magic = 0;
+  if(ShaderCode.size() < 5 * sizeof(uint32_t) || ShaderCode.size() % sizeof(uint32_t) != 0)
+    return false;
+
+  std::memcpy(&Magic, ShaderCode.data(), sizeof(Magic));
+  return Magic == SpirVMagic;
+}
+
 VkFormat FindSupportedFormat(VkPhysicalDevice Device, const std::vector<VkFormat>& Candidates, VkImageTiling Tiling, VkFormatFeatureFlags Features)
 {
   for(VkFormat Format : Candidates)
@@ -271,6 +338,125 @@ uint32_t FindMemoryType(VkPhysicalDevice Device, uint32_t TypeFilter, VkMemoryPr
   throw std::runtime_error("Failed to find a suitable memory type!");
 }
 
+MEMORY_TOPOLOGY GetMemoryTopology(VkPhysicalDevice Device)
+{
+  VkPhysicalDeviceMemoryProperties MemoryProperties;
+  vkGetPhysicalDeviceMemoryProperties(Device, &MemoryProperties);
+
+  //Without resizable BAR the host can only map a window of 256 MB (or less) of a discrete GPU.
+  const VkDeviceSize BarWindowSize = 256 * 1024 * 1024;
+  const VkMemoryPropertyFlags Mappable = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+  bool bAllMappable = true;
+  VkDeviceSize MappableHeapSize = 0;
+  for(uint32_t i = 0; i < MemoryProperties.memoryTypeCount; i++)
+  {
+    VkMemoryPropertyFlags Flags = MemoryProperties.memoryTypes[i].propertyFlags;
+    if(!(Flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+      continue;
+
+    if((Flags & Mappable) == Mappable)
+      MappableHeapSize = std::max(MappableHeapSize, MemoryProperties.memoryHeaps[MemoryProperties.memoryTypes[i].heapIndex].size);
+    else
+      bAllMappable = false;
+  }
+
+  bool bDeviceLocalHeapOnly = true;
+  for(uint32_t i = 0; i < MemoryProperties.memoryHeapCount; i++)
+  {
+    if(!(MemoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+      bDeviceLocalHeapOnly = false;
+  }
+
+  if(MappableHeapSize == 0)
+    return MEMORY_TOPOLOGY_DISCRETE;
+  if(bDeviceLocalHeapOnly || (bAllMappable && MemoryProperties.memoryHeapCount == 1))
+    return MEMORY_TOPOLOGY_UNIFIED;
+  return MappableHeapSize > BarWindowSize ? MEMORY_TOPOLOGY_RESIZABLE_BAR : MEMORY_TOPOLOGY_DISCRETE;
+}
+
+const char* GetMemoryTopologyName(MEMORY_TOPOLOGY Topology)
+{
+  switch(Topology)
+  {
+    case MEMORY_TOPOLOGY_RESIZABLE_BAR: return "resizable BAR";
+    case MEMORY_TOPOLOGY_UNIFIED: return "unified";
+    default: return "discrete";
+  }
+}
+
+namespace
+{
+  struct Allocation
+  {
+    VkDeviceSize Size;
+    uint32_t MemoryTypeIndex;
+  };
+
+  std::mutex AllocationMutex;
+  std::unordered_map<VkDeviceMemory, Allocation> Allocations;
+  VkDeviceSize AllocatedMemorySize = 0;
+  VkDeviceSize AllocatedTypeSizes[VK_MAX_MEMORY_TYPES] = {};
+}
+
+VkResult AllocateMemory(VkDevice Device, const VkMemoryAllocateInfo& AllocInfo, VkDeviceMemory& Memory)
+{
+  VkResult Result = vkAllocateMemory(Device, &AllocInfo, nullptr, &Memory);
+
+  if(Result == VK_SUCCESS)
+  {
+    std::lock_guard<std::mutex> Lock(AllocationMutex);
+    Allocations[Memory] = {AllocInfo.allocationSize, AllocInfo.memoryTypeIndex};
+    AllocatedMemorySize += AllocInfo.allocationSize;
+    AllocatedTypeSizes[AllocInfo.memoryTypeIndex] += AllocInfo.allocationSize;
+  }
+
+  return Result;
+}
+
+void FreeMemory(VkDevice Device, VkDeviceMemory Memory)
+{
+  if(Memory == VK_NULL_HANDLE)
+    return;
+
+  {
+    std::lock_guard<std::mutex> Lock(AllocationMutex);
+    auto Iterator = Allocations.find(Memory);
+    if(Iterator != Allocations.end())
+    {
+      AllocatedMemorySize -= Iterator->second.Size;
+      AllocatedTypeSizes[Iterator->second.MemoryTypeIndex] -= Iterator->second.Size;
+      Allocations.erase(Iterator);
+    }
+  }
+
+  vkFreeMemory(Device, Memory, nullptr);
+}
+
+VkDeviceSize GetAllocatedMemorySize()
+{
+  std::lock_guard<std::mutex> Lock(AllocationMutex);
+  return AllocatedMemorySize;
+}
+
+VkDeviceSize GetAllocatedMemorySize(uint32_t MemoryTypeIndex)
+{
+  std::lock_guard<std::mutex> Lock(AllocationMutex);
+  return AllocatedTypeSizes[MemoryTypeIndex];
+}
+
+bool GetAllocationInfo(VkDeviceMemory Memory, VkDeviceSize& Size, uint32_t& MemoryTypeIndex)
+{
+  std::lock_guard<std::mutex> Lock(AllocationMutex);
+  auto Iterator = Allocations.find(Memory);
+  if(Iterator == Allocations.end())
+    return false;
+
+  Size = Iterator->second.Size;
+  MemoryTypeIndex = Iterator->second.MemoryTypeIndex;
+  return true;
+}
+
 void CreateBuffer(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkDeviceSize Size, VkBufferUsageFlags Usage, VkMemoryPropertyFlags Properties, BufferInfo& Buffer)
 {
   VkBufferCreateInfo BufferCreateInfo = {};
@@ -290,12 +476,34 @@ void CreateBuffer(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkDeviceSize
   AllocInfo.allocationSize = MemoryRequirements.size;
   AllocInfo.memoryTypeIndex = FindMemoryType(PhysicalDevice, MemoryRequirements.memoryTypeBits, Properties);
 
-  if(vkAllocateMemory(Device, &AllocInfo, nullptr, &Buffer.Memory) != VK_SUCCESS)
+  if(AllocateMemory(Device, AllocInfo, Buffer.Memory) != VK_SUCCESS)
     throw std::runtime_error("Failed to allocate vertex buffer memory!");
 
   vkBindBufferMemory(Device, Buffer.Buffer, Buffer.Memory, 0);
 }
 
+namespace
+{
+  std::mutex UploadMutex;
+  UploadStatistics Uploads;
+}
+
+void RecordUpload(UPLOAD_PATH Path, VkDeviceSize Size, std::chrono::steady_clock::time_point Start)
+{
+  double Time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+  std::lock_guard<std::mutex> Lock(UploadMutex);
+  Uploads.Num[Path] += 1;
+  Uploads.Size[Path] += Size;
+  Uploads.Time[Path] += Time;
+}
+
+UploadStatistics GetUploadStatistics()
+{
+  std::lock_guard<std::mutex> Lock(UploadMutex);
+  return Uploads;
+}
+
 void CopyBuffer(VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, BufferInfo SrcBuffer, BufferInfo DstBuffer, VkDeviceSize Size)
 {
   VkCommandBuffer CommandBuffer = BeginSingleTimeCommands(Device, CommandPool);
@@ -309,6 +517,80 @@ void CopyBuffer(VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, Buffe
   EndSingleTimeCommands(Device, Queue, CommandPool, CommandBuffer);
 }
 
+void CreateDeviceLocalBuffer(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, VkDeviceSize Size, VkBufferUsageFlags Usage,
+                             bool bDirect, const std::function<void(void*)>& Write, BufferInfo& Buffer)
+{
+  auto Start = std::chrono::steady_clock::now();
+
+  if(bDirect)
+  {
+    VkBufferCreateInfo BufferCreateInfo = {};
+    BufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    BufferCreateInfo.size = Size;
+    BufferCreateInfo.usage = Usage;
+    BufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if(vkCreateBuffer(Device, &BufferCreateInfo, nullptr, &Buffer.Buffer) != VK_SUCCESS)
+      throw std::runtime_error("Failed to create vertex buffer!");
+
+    VkMemoryRequirements MemoryRequirements;
+    vkGetBufferMemoryRequirements(Device, Buffer.Buffer, &MemoryRequirements);
+
+    VkPhysicalDeviceMemoryProperties MemoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(PhysicalDevice, &MemoryProperties);
+
+    const VkMemoryPropertyFlags Mappable = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    for(uint32_t i = 0; i < MemoryProperties.memoryTypeCount && Buffer.Memory == VK_NULL_HANDLE; i++)
+    {
+      if(!(MemoryRequirements.memoryTypeBits & (1 << i)) || (MemoryProperties.memoryTypes[i].propertyFlags & Mappable) != Mappable)
+        continue;
+
+      VkMemoryAllocateInfo AllocInfo = {};
+      AllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+      AllocInfo.allocationSize = MemoryRequirements.size;
+      AllocInfo.memoryTypeIndex = i;
+
+      //A full heap is not an error, the next type or the staging buffer is tried.
+      if(AllocateMemory(Device, AllocInfo, Buffer.Memory) != VK_SUCCESS)
+        Buffer.Memory = VK_NULL_HANDLE;
+    }
+
+    if(Buffer.Memory != VK_NULL_HANDLE)
+    {
+      vkBindBufferMemory(Device, Buffer.Buffer, Buffer.Memory, 0);
+
+      //Host coherent, the writes are visible to the first submit after this without a barrier.
+      void* pMappedData = nullptr;
+      vkMapMemory(Device, Buffer.Memory, 0, Size, 0, &pMappedData);
+      Write(pMappedData);
+      vkUnmapMemory(Device, Buffer.Memory);
+
+      RecordUpload(UPLOAD_PATH_DIRECT, Size, Start);
+      return;
+    }
+
+    vkDestroyBuffer(Device, Buffer.Buffer, nullptr);
+    Buffer.Buffer = VK_NULL_HANDLE;
+  }
+
+  BufferInfo StagingBuffer;
+
+  CreateBuffer(PhysicalDevice, Device, Size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, StagingBuffer);
+
+  void* pMappedData = nullptr;
+  vkMapMemory(Device, StagingBuffer.Memory, 0, Size, 0, &pMappedData);
+  Write(pMappedData);
+  vkUnmapMemory(Device, StagingBuffer.Memory);
+
+  CreateBuffer(PhysicalDevice, Device, Size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | Usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Buffer);
+
+  CopyBuffer(Device, CommandPool, Queue, StagingBuffer, Buffer, Size);
+
+  DestroyBuffer(Device, StagingBuffer);
+
+  RecordUpload(UPLOAD_PATH_STAGED, Size, Start);
+}
+
 void CreateImage(VkPhysicalDevice PhysicalDevice, VkDevice Device, uint32_t Width, uint32_t Height, uint32_t MipLevels, VkSampleCountFlagBits Samples, VkFormat Format,
                  VkImageTiling Tiling, VkImageUsageFlags Usage, VkMemoryPropertyFlags Properties, VkImage& Image, VkDeviceMemory& ImageMemory)
 {
@@ -338,7 +620,7 @@ void CreateImage(VkPhysicalDevice PhysicalDevice, VkDevice Device, uint32_t Widt
   AllocInfo.allocationSize = MemRequirements.size;
   AllocInfo.memoryTypeIndex = FindMemoryType(PhysicalDevice, MemRequirements.memoryTypeBits, Properties);
 
-  if(vkAllocateMemory(Device, &AllocInfo, nullptr, &ImageMemory) != VK_SUCCESS)
+  if(AllocateMemory(Device, AllocInfo, ImageMemory) != VK_SUCCESS)
     throw std::runtime_error("Failed to allocate texture image memory!");
 
   vkBindImageMemory(Device, Image, ImageMemory, 0);
@@ -464,86 +746,6 @@ void CopyBufferToImage(VkDevice Device, VkQueue Queue, VkCommandPool CommandPool
   EndSingleTimeCommands(Device, Queue, CommandPool, CommandBuffer);
 }
 
-void GenerateMipmaps(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, VkImage Image, VkFormat Format, uint32_t Width, uint32_t Height, uint32_t MipLevels)
-{
-  //Check if image format supports linear blitting.
-  VkFormatProperties FormatProperties;
-  vkGetPhysicalDeviceFormatProperties(PhysicalDevice, Format, &FormatProperties);
-
-  if(!(FormatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
-    throw std::runtime_error("Texture image format does not support linear blitting!");
-
-  VkCommandBuffer CommandBuffer = BeginSingleTimeCommands(Device, CommandPool);
-
-  VkImageMemoryBarrier Barrier = {};
-  Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-  Barrier.image = Image;
-  Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  Barrier.subresourceRange.baseArrayLayer = 0;
-  Barrier.subresourceRange.layerCount = 1;
-  Barrier.subresourceRange.levelCount = 1;
-
-  int32_t MipWidth = Width;
-  int32_t MipHeight = Height;
-
-  for(uint32_t i = 1; i < MipLevels; ++i)
-  {
-    Barrier.subresourceRange.baseMipLevel = i - 1;
-    Barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    Barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    Barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
-
-    VkImageBlit Blit = {};
-    Blit.srcOffsets[0] = {0, 0, 0};
-    Blit.srcOffsets[1] = {MipWidth, MipHeight, 1};
-    Blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    Blit.srcSubresource.mipLevel = i - 1;
-    Blit.srcSubresource.baseArrayLayer = 0;
-    Blit.srcSubresource.layerCount = 1;
-    Blit.dstOffsets[0] = {0, 0, 0};
-    Blit.dstOffsets[1] =
-    {
-      MipWidth > 1 ? MipWidth / 2 : 1,
-      MipHeight > 1 ? MipHeight / 2 : 1,
-      1
-    };
-    Blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    Blit.dstSubresource.mipLevel = i;
-    Blit.dstSubresource.baseArrayLayer = 0;
-    Blit.dstSubresource.layerCount = 1;
-
-    vkCmdBlitImage(CommandBuffer, Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &Blit, VK_FILTER_LINEAR);
-
-    Barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    Barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    Barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    Barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
-
-    if(MipWidth > 1)
-      MipWidth /= 2;
-
-    if(MipHeight > 1)
-      MipHeight /= 2;
-  }
-
-  Barrier.subresourceRange.baseMipLevel = MipLevels - 1;
-  Barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  Barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  Barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
-
-  EndSingleTimeCommands(Device, Queue, CommandPool, CommandBuffer);
-}
-
 VkSampleCountFlagBits GetMaxUsableSampleCount(VkPhysicalDevice Device)
 {
   VkPhysicalDeviceProperties PhysicalDeviceProperties;
@@ -567,94 +769,388 @@ VkSampleCountFlagBits GetMaxUsableSampleCount(VkPhysicalDevice Device)
     return VK_SAMPLE_COUNT_1_BIT;
 }
 
-void CreateTextureImageFromFile(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const char* pFilename, uint32_t& MipLevels, VkImage& TextureImage, VkDeviceMemory& TextureImageMemory)
+bool LoadImageFile(const char* pFilename, ImageData& Image)
 {
   int TexWidth = -1, TexHeight = -1, TexChannels = -1;
   stbi_uc* pPixels = stbi_load(pFilename, &TexWidth, &TexHeight, &TexChannels, STBI_rgb_alpha);
-  VkDeviceSize ImageSize = static_cast<uint64_t>(TexWidth) * TexHeight * 4;
-  MipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(TexWidth, TexHeight)))) + 1;
 
   if(pPixels == nullptr)
   {
-    pPixels = (stbi_uc*)(malloc(sizeof(stbi_uc) * 4));
-    if(pPixels)
-    {
-      pPixels[0] = 255;
-      pPixels[1] = 255;
-      pPixels[2] = 255;
-      pPixels[3] = 255;
-    }
+    Image = MakeSolidImage(255, 255, 255, 255);
+    return false;
+  }
+
+  Image.Width = static_cast<uint32_t>(TexWidth);
+  Image.Height = static_cast<uint32_t>(TexHeight);
+  Image.Pixels.assign(pPixels, pPixels + static_cast<size_t>(TexWidth) * TexHeight * 4);
 
-    TexWidth = 1;
-    TexHeight = 1;
-    TexChannels = 4;
-    ImageSize = 4;
-    MipLevels = 1;
+  stbi_image_free(pPixels);
+  return true;
+}
+
+bool DecodeImage(const void* pData, size_t Size, ImageData& Image)
+{
+  //PNGs the faster decoder handles are decoded straight into the pixels, without a copy from the buffer of stb_image.
+  PngInfo Info;
+  if(ReadPngInfo(pData, Size, Info) && Info.bSupported)
+  {
+    Image.Width = Info.Width;
+    Image.Height = Info.Height;
+    Image.Pixels.resize(static_cast<size_t>(Info.Width) * Info.Height * 4);
+    if(DecodePng(pData, Size, Image.Pixels.data(), static_cast<size_t>(Info.Width) * 4, PNG_LAYOUT_RGBA))
+      return true;
   }
 
-  BufferInfo StagingBuffer;
+  int TexWidth = -1, TexHeight = -1, TexChannels = -1;
+  stbi_uc* pPixels = Size > 0 ? stbi_load_from_memory(static_cast<const stbi_uc*>(pData), static_cast<int>(Size), &TexWidth, &TexHeight, &TexChannels, STBI_rgb_alpha) : nullptr;
 
-  CreateBuffer(PhysicalDevice, Device, ImageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, StagingBuffer);
+  if(pPixels == nullptr)
+  {
+    Image = MakeSolidImage(255, 255, 255, 255);
+    return false;
+  }
 
-  MapMemory(Device, StagingBuffer.Memory, ImageSize, pPixels);
+  Image.Width = static_cast<uint32_t>(TexWidth);
+  Image.Height = static_cast<uint32_t>(TexHeight);
+  Image.Pixels.assign(pPixels, pPixels + static_cast<size_t>(TexWidth) * TexHeight * 4);
 
   stbi_image_free(pPixels);
+  return true;
+}
 
-  CreateImage(PhysicalDevice, Device, static_cast<uint32_t>(TexWidth), static_cast<uint32_t>(TexHeight), MipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL,
-              VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, TextureImage, TextureImageMemory);
-
-  TransitionImageLayout(Device, Queue, CommandPool, TextureImage, VK_FORMAT_R8G8B8A8_UNORM, MipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+ImageData MakeSolidImage(uint8_t R, uint8_t G, uint8_t B, uint8_t A)
+{
+  ImageData Image;
+  Image.Pixels = {R, G, B, A};
+  return Image;
+}
 
-  CopyBufferToImage(Device, Queue, CommandPool, StagingBuffer.Buffer, TextureImage, static_cast<uint32_t>(TexWidth), static_cast<uint32_t>(TexHeight));
+void CreateTexture(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const ImageData& Image, MIP_CONTENT Content, TextureInfo& Texture)
+{
+  MipChain Chain;
+  GenerateMipChain(Image.Pixels.data(), Image.Width, Image.Height, Content, MIP_FILTER_KAISER, Chain);
 
-  GenerateMipmaps(PhysicalDevice, Device, CommandPool, Queue, TextureImage, VK_FORMAT_R8G8B8A8_UNORM, TexWidth, TexHeight, MipLevels);
+  VkFormat Format = Content == MIP_CONTENT_SRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+  CreateTextureFromMips(PhysicalDevice, Device, CommandPool, Queue, Format, GetMips(Chain), Texture);
+}
 
-  DestroyBuffer(Device, StagingBuffer);
+bool SamplerState::operator==(const SamplerState& Other) const
+{
+  return Filter == Other.Filter && MipmapMode == Other.MipmapMode && AddressMode == Other.AddressMode &&
+         MaxAnisotropy == Other.MaxAnisotropy && MaxLod == Other.MaxLod;
 }
 
-void CreateTextureFromFile(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const char* pFilename, TextureInfo& Texture)
+namespace
 {
-  CreateTextureImageFromFile(PhysicalDevice, Device, CommandPool, Queue, pFilename, Texture.MipLevels, Texture.TextureImage, Texture.TextureImageMemory);
+  struct CachedSampler
+  {
+    VkDevice Device;
+    SamplerState State;
+    VkSampler Sampler;
+    uint32_t RefCount;
+  };
+
+  //There are only a few distinct states, a linear search beats hashing them.
+  std::mutex SamplerMutex;
+  std::vector<CachedSampler> Samplers;
+}
 
-  CreateImageView(Device, Texture.TextureImage, VK_FORMAT_R8G8B8A8_UNORM, Texture.MipLevels, VK_IMAGE_ASPECT_COLOR_BIT, Texture.TextureImageView);
+VkSampler AcquireSampler(VkDevice Device, const SamplerState& State)
+{
+  std::lock_guard<std::mutex> Lock(SamplerMutex);
+  for(auto& Cached : Samplers)
+  {
+    if(Cached.Device == Device && Cached.State == State)
+    {
+      ++Cached.RefCount;
+      return Cached.Sampler;
+    }
+  }
 
   VkSamplerCreateInfo CreateInfo = {};
   CreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-  CreateInfo.magFilter = VK_FILTER_LINEAR;
-  CreateInfo.minFilter = VK_FILTER_LINEAR;
-  CreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-  CreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-  CreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-  CreateInfo.anisotropyEnable = VK_TRUE;
-  CreateInfo.maxAnisotropy = 16;
+  CreateInfo.magFilter = State.Filter;
+  CreateInfo.minFilter = State.Filter;
+  CreateInfo.addressModeU = State.AddressMode;
+  CreateInfo.addressModeV = State.AddressMode;
+  CreateInfo.addressModeW = State.AddressMode;
+  CreateInfo.anisotropyEnable = State.MaxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+  CreateInfo.maxAnisotropy = State.MaxAnisotropy;
   CreateInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
   CreateInfo.unnormalizedCoordinates = VK_FALSE;
   CreateInfo.compareEnable = VK_FALSE;
   CreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-  CreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+  CreateInfo.mipmapMode = State.MipmapMode;
   CreateInfo.mipLodBias = 0.0f;
   CreateInfo.minLod = 0.0f;
-  CreateInfo.maxLod = static_cast<float>(Texture.MipLevels);
+  CreateInfo.maxLod = State.MaxLod;
 
-  if(vkCreateSampler(Device, &CreateInfo, nullptr, &Texture.TextureSampler) != VK_SUCCESS)
+  VkSampler Sampler = VK_NULL_HANDLE;
+  if(vkCreateSampler(Device, &CreateInfo, nullptr, &Sampler) != VK_SUCCESS)
     throw std::runtime_error("Failed to create texture sampler!");
+
+  Samplers.push_back({Device, State, Sampler, 1});
+  return Sampler;
+}
+
+void ReleaseSampler(VkDevice Device, VkSampler Sampler)
+{
+  if(Sampler == VK_NULL_HANDLE)
+    return;
+
+  {
+    std::lock_guard<std::mutex> Lock(SamplerMutex);
+    auto Iterator = std::find_if(Samplers.begin(), Samplers.end(), [Sampler](const CachedSampler& Cached) {return Cached.Sampler == Sampler;});
+    if(Iterator != Samplers.end())
+    {
+      if(--Iterator->RefCount > 0)
+        return;
+      Samplers.erase(Iterator);
+    }
+  }
+
+  vkDestroySampler(Device, Sampler, nullptr);
+}
+
+size_t GetSamplerNum()
+{
+  std::lock_guard<std::mutex> Lock(SamplerMutex);
+  return Samplers.size();
+}
+
+void CreateTextureViewAndSampler(VkDevice Device, VkFormat Format, TextureInfo& Texture)
+{
+  CreateImageView(Device, Texture.TextureImage, Format, Texture.MipLevels, VK_IMAGE_ASPECT_COLOR_BIT, Texture.TextureImageView);
+
+  Texture.TextureSampler = AcquireSampler(Device, SamplerState());
+}
+
+namespace
+{
+  //Copy the levels that have data with a single command, the image has to be in "VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL".
+  VkDeviceSize CopyMipsToImage(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const std::vector<MipData>& Mips, VkImage Image)
+  {
+    //Every level starts at a multiple of 16 bytes, enough for "vkCmdCopyBufferToImage()" and every texel block size.
+    std::vector<VkDeviceSize> Offsets(Mips.size());
+    VkDeviceSize StagingSize = 0;
+    for(size_t i = 0; i < Mips.size(); ++i)
+    {
+      if(Mips[i].pData == nullptr)
+        continue;
+
+      Offsets[i] = (StagingSize + 15) / 16 * 16;
+      StagingSize = Offsets[i] + Mips[i].Size;
+    }
+
+    BufferInfo StagingBuffer;
+
+    CreateBuffer(PhysicalDevice, Device, StagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, StagingBuffer);
+
+    void* pMappedData = nullptr;
+    vkMapMemory(Device, StagingBuffer.Memory, 0, StagingSize, 0, &pMappedData);
+    for(size_t i = 0; i < Mips.size(); ++i)
+    {
+      if(Mips[i].pData != nullptr)
+        std::memcpy(static_cast<uint8_t*>(pMappedData) + Offsets[i], Mips[i].pData, static_cast<size_t>(Mips[i].Size));
+    }
+    vkUnmapMemory(Device, StagingBuffer.Memory);
+
+    //All levels are copied with a single command, nothing has to be generated on the GPU.
+    std::vector<VkBufferImageCopy> Regions;
+    for(size_t i = 0; i < Mips.size(); ++i)
+    {
+      if(Mips[i].pData == nullptr)
+        continue;
+
+      VkBufferImageCopy Region = {};
+      Region.bufferOffset = Offsets[i];
+      Region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      Region.imageSubresource.mipLevel = static_cast<uint32_t>(i);
+      Region.imageSubresource.baseArrayLayer = 0;
+      Region.imageSubresource.layerCount = 1;
+      Region.imageExtent = {Mips[i].Width, Mips[i].Height, 1};
+      Regions.push_back(Region);
+    }
+
+    VkCommandBuffer CommandBuffer = BeginSingleTimeCommands(Device, CommandPool);
+    vkCmdCopyBufferToImage(CommandBuffer, StagingBuffer.Buffer, Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(Regions.size()), Regions.data());
+    EndSingleTimeCommands(Device, Queue, CommandPool, CommandBuffer);
+
+    DestroyBuffer(Device, StagingBuffer);
+
+    return StagingSize;
+  }
+}
+
+void CreateTextureFromMips(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, VkFormat Format, const std::vector<MipData>& Mips, TextureInfo& Texture)
+{
+  auto Start = std::chrono::steady_clock::now();
+
+  Texture.MipLevels = static_cast<uint32_t>(Mips.size());
+
+  //Streamed textures are copied into the images that replace them, see "RecordTextureLevelCopy()".
+  CreateImage(PhysicalDevice, Device, Mips[0].Width, Mips[0].Height, Texture.MipLevels, VK_SAMPLE_COUNT_1_BIT, Format, VK_IMAGE_TILING_OPTIMAL,
+              VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Texture.TextureImage, Texture.TextureImageMemory);
+
+  //The levels that are not filled are in the same layout as the others, the view covers all of them.
+  TransitionImageLayout(Device, Queue, CommandPool, Texture.TextureImage, Format, Texture.MipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+  VkDeviceSize StagingSize = CopyMipsToImage(PhysicalDevice, Device, CommandPool, Queue, Mips, Texture.TextureImage);
+
+  TransitionImageLayout(Device, Queue, CommandPool, Texture.TextureImage, Format, Texture.MipLevels, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  RecordUpload(UPLOAD_PATH_STAGED, StagingSize, Start);
+
+  CreateTextureViewAndSampler(Device, Format, Texture);
+}
+
+void FillTextureLevels(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const std::vector<MipData>& Mips, const TextureInfo& Texture)
+{
+  auto Start = std::chrono::steady_clock::now();
+
+  uint32_t FirstLevel = 0, EndLevel = static_cast<uint32_t>(Mips.size());
+  while(FirstLevel < EndLevel && Mips[FirstLevel].pData == nullptr)
+    ++FirstLevel;
+  while(EndLevel > FirstLevel && Mips[EndLevel - 1].pData == nullptr)
+    --EndLevel;
+  if(FirstLevel == EndLevel)
+    return;
+
+  //Only the filled levels change their layout, what they had before is discarded.
+  VkImageMemoryBarrier Barrier = {};
+  Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  Barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  Barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  Barrier.image = Texture.TextureImage;
+  Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  Barrier.subresourceRange.baseMipLevel = FirstLevel;
+  Barrier.subresourceRange.levelCount = EndLevel - FirstLevel;
+  Barrier.subresourceRange.baseArrayLayer = 0;
+  Barrier.subresourceRange.layerCount = 1;
+  Barrier.srcAccessMask = 0;
+  Barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+  VkCommandBuffer CommandBuffer = BeginSingleTimeCommands(Device, CommandPool);
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+  EndSingleTimeCommands(Device, Queue, CommandPool, CommandBuffer);
+
+  VkDeviceSize StagingSize = CopyMipsToImage(PhysicalDevice, Device, CommandPool, Queue, Mips, Texture.TextureImage);
+
+  Barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  Barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  Barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+  CommandBuffer = BeginSingleTimeCommands(Device, CommandPool);
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+  EndSingleTimeCommands(Device, Queue, CommandPool, CommandBuffer);
+
+  RecordUpload(UPLOAD_PATH_STAGED, StagingSize, Start);
+}
+
+void RecordTextureLevelCopy(VkCommandBuffer CommandBuffer, const std::vector<MipData>& Mips, uint32_t FirstLevel, VkImage SrcImage, uint32_t SrcAllocatedLevel, VkImage DstImage, uint32_t DstAllocatedLevel)
+{
+  uint32_t LevelNum = static_cast<uint32_t>(Mips.size());
+
+  VkImageMemoryBarrier Barriers[2] = {};
+  for(auto& Barrier : Barriers)
+  {
+    Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Barrier.subresourceRange.baseArrayLayer = 0;
+    Barrier.subresourceRange.layerCount = 1;
+  }
+
+  //The copied levels are only read, the frames that sample them merely have to finish first.
+  Barriers[0].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  Barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  Barriers[0].image = SrcImage;
+  Barriers[0].subresourceRange.baseMipLevel = FirstLevel - SrcAllocatedLevel;
+  Barriers[0].subresourceRange.levelCount = LevelNum - FirstLevel;
+  Barriers[0].srcAccessMask = 0;
+  Barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+  Barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  Barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  Barriers[1].image = DstImage;
+  Barriers[1].subresourceRange.baseMipLevel = 0;
+  Barriers[1].subresourceRange.levelCount = LevelNum - DstAllocatedLevel;
+  Barriers[1].srcAccessMask = 0;
+  Barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 2, Barriers);
+
+  std::vector<VkImageCopy> Regions;
+  for(uint32_t Level = FirstLevel; Level < LevelNum; ++Level)
+  {
+    VkImageCopy Region = {};
+    Region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Region.srcSubresource.mipLevel = Level - SrcAllocatedLevel;
+    Region.srcSubresource.layerCount = 1;
+    Region.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Region.dstSubresource.mipLevel = Level - DstAllocatedLevel;
+    Region.dstSubresource.layerCount = 1;
+    Region.extent = {Mips[Level].Width, Mips[Level].Height, 1};
+    Regions.push_back(Region);
+  }
+
+  vkCmdCopyImage(CommandBuffer, SrcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, DstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(Regions.size()), Regions.data());
+
+  //The source is left as it was, the levels of the destination that were not copied are in the same layout as the others.
+  Barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  Barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  Barriers[0].srcAccessMask = 0;
+  Barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+  Barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  Barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  Barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  Barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+  vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 2, Barriers);
+}
+
+std::vector<MipData> GetMips(const MipChain& Chain)
+{
+  std::vector<MipData> Mips(Chain.Levels.size());
+  for(size_t i = 0; i < Mips.size(); ++i)
+  {
+    Mips[i].pData = Chain.Levels[i].data();
+    Mips[i].Size = Chain.Levels[i].size();
+    Mips[i].Width = Chain.Widths[i];
+    Mips[i].Height = Chain.Heights[i];
+  }
+
+  return Mips;
+}
+
+void CreateTextureFromFile(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const char* pFilename, MIP_CONTENT Content, TextureInfo& Texture)
+{
+  ImageData Image;
+  LoadImageFile(pFilename, Image);
+
+  CreateTexture(PhysicalDevice, Device, CommandPool, Queue, Image, Content, Texture);
 }
 
 void DestroyTexture(VkDevice Device, TextureInfo& Texture)
 {
-  vkDestroySampler(Device, Texture.TextureSampler, nullptr);
+  ReleaseSampler(Device, Texture.TextureSampler);
   vkDestroyImageView(Device, Texture.TextureImageView, nullptr);
   vkDestroyImage(Device, Texture.TextureImage, nullptr);
-  vkFreeMemory(Device, Texture.TextureImageMemory, nullptr);
+  FreeMemory(Device, Texture.TextureImageMemory);
 }
 
 void DestroyBuffer(VkDevice Device, BufferInfo& Buffer)
 {
   vkDestroyBuffer(Device, Buffer.Buffer, nullptr);
-  vkFreeMemory(Device, Buffer.Memory, nullptr);
+  FreeMemory(Device, Buffer.Memory);
 }
 
-void MapMemory(VkDevice Device, VkDeviceMemory Memory, VkDeviceSize Size, void* pData)
+void MapMemory(VkDevice Device, VkDeviceMemory Memory, VkDeviceSize Size, const void* pData)
 {
   void* pMappedData = nullptr;
   vkMapMemory(Device, Memory, 0, Size, 0, &pMappedData);
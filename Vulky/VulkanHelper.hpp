@@ -5,11 +5,14 @@
 #endif
 #include <GLFW/glfw3.h>
 
+#include <chrono>
+#include <functional>
 #include <optional>
 #include <vector>
 #include <cstdint>
 
 #include "Namespace.hpp"
+#include "MipGenerator.hpp"
 
 NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
 
@@ -17,6 +20,8 @@ struct QueueFamilyIndices
 {
   std::optional<uint32_t> GraphicsFamily;
   std::optional<uint32_t> PresentFamily;
+  //Only set if there is a family without graphics, uploads on it do not compete with rendering.
+  std::optional<uint32_t> TransferFamily;
 
   bool IsComplete() const;
 };
@@ -80,6 +85,14 @@ struct TextureInfo
   VkDescriptorImageInfo GetDescriptorImageInfo() const;
 };
 
+//Decoded RGBA8 pixels, 4 bytes per pixel and tightly packed rows.
+struct ImageData
+{
+  uint32_t Width = 1;
+  uint32_t Height = 1;
+  std::vector<uint8_t> Pixels;
+};
+
 bool CheckValidationLayerSupport(const std::vector<const char*>& Layers);
 
 std::vector<const char*> GetRequiredExtensions(bool bEnableValidationLayers);
@@ -88,11 +101,17 @@ bool IsPhysicalDeviceSuitable(VkPhysicalDevice Device, VkSurfaceKHR Surface, con
 
 QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice Device, VkSurfaceKHR Surface);
 
+bool CheckInstanceExtensionsSupport(const std::vector<const char*>& Extensions);
+
 bool CheckPhysicalDeviceExtensionsSupport(VkPhysicalDevice Device, const std::vector<const char*> Extensions);
 
 SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice Device, VkSurfaceKHR Surface);
 
-VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& AvailableFormats);
+/* With "bPreferSrgb" an sRGB format is picked where there is one, so the blending hardware encodes the linear colors written to
+ * it. Otherwise (or without one) "VK_FORMAT_B8G8R8A8_UNORM", into which the shaders write encoded colors themselves. */
+VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& AvailableFormats, bool bPreferSrgb);
+
+bool IsSrgbFormat(VkFormat Format);
 
 VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& AvailablePresentModes);
 
@@ -102,6 +121,9 @@ void CreateImageView(VkDevice Device, VkImage Image, VkFormat Format, uint32_t M
 
 VkShaderModule CreateShaderModule(VkDevice Device, const std::vector<char>& ShaderCode);
 
+//Whether the code starts with the SPIR-V magic number and is a whole number of words, a file that is still being written usually is not.
+bool IsSpirVCode(const std::vector<char>& ShaderCode);
+
 VkFormat FindSupportedFormat(VkPhysicalDevice Device, const std::vector<VkFormat>& Candidates, VkImageTiling Tiling, VkFormatFeatureFlags Features);
 
 VkFormat FindDepthFormat(VkPhysicalDevice Device);
@@ -110,10 +132,67 @@ bool HasStencilComponent(VkFormat Format);
 
 uint32_t FindMemoryType(VkPhysicalDevice Device, uint32_t TypeFilter, VkMemoryPropertyFlags Properties);
 
+//How much of the device local memory the host can map, which decides whether uploads need a staging buffer.
+enum MEMORY_TOPOLOGY
+{
+  //None, or only the small window of a discrete GPU without resizable BAR, which is better left to the driver.
+  MEMORY_TOPOLOGY_DISCRETE = 0,
+  //A discrete GPU with resizable BAR, its device local memory is mapped through the PCIe bus.
+  MEMORY_TOPOLOGY_RESIZABLE_BAR = 1,
+  //Integrated GPUs and software rasterizers, there is only one kind of memory.
+  MEMORY_TOPOLOGY_UNIFIED = 2
+};
+
+MEMORY_TOPOLOGY GetMemoryTopology(VkPhysicalDevice Device);
+
+const char* GetMemoryTopologyName(MEMORY_TOPOLOGY Topology);
+
+//Thin wrappers around "vkAllocateMemory()" and "vkFreeMemory()" which keep track of the device memory in use.
+VkResult AllocateMemory(VkDevice Device, const VkMemoryAllocateInfo& AllocInfo, VkDeviceMemory& Memory);
+
+void FreeMemory(VkDevice Device, VkDeviceMemory Memory);
+
+VkDeviceSize GetAllocatedMemorySize();
+
+//The device memory in use of one memory type.
+VkDeviceSize GetAllocatedMemorySize(uint32_t MemoryTypeIndex);
+
+//The size and the memory type of an allocation, false if it was not made by "AllocateMemory()".
+bool GetAllocationInfo(VkDeviceMemory Memory, VkDeviceSize& Size, uint32_t& MemoryTypeIndex);
+
 void CreateBuffer(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkDeviceSize Size, VkBufferUsageFlags Usage, VkMemoryPropertyFlags Properties, BufferInfo& Buffer);
 
 void CopyBuffer(VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, BufferInfo SrcBuffer, BufferInfo DstBuffer, VkDeviceSize Size);
 
+/* Create a device local buffer and fill it with "Write", which gets the mapped memory of the whole buffer. With "bDirect" (see
+ * "GetMemoryTopology()") the buffer is allocated in host visible device local memory and written in place, which saves the
+ * staging buffer, the copy and the submit; if there is no such memory, or it is full, the data goes through a staging buffer. */
+void CreateDeviceLocalBuffer(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, VkDeviceSize Size, VkBufferUsageFlags Usage,
+                             bool bDirect, const std::function<void(void*)>& Write, BufferInfo& Buffer);
+
+enum UPLOAD_PATH
+{
+  //Written in place into host visible device local memory.
+  UPLOAD_PATH_DIRECT = 0,
+  //Copied from a staging buffer on the graphics queue.
+  UPLOAD_PATH_STAGED = 1,
+  //Copied from a staging buffer on a dedicated transfer queue, next to rendering.
+  UPLOAD_PATH_TRANSFER_QUEUE = 2,
+  UPLOAD_PATH_NUM = 3
+};
+
+//Everything uploaded to device local memory so far, by the path it took.
+struct UploadStatistics
+{
+  uint32_t Num[UPLOAD_PATH_NUM] = {};
+  VkDeviceSize Size[UPLOAD_PATH_NUM] = {};
+  double Time[UPLOAD_PATH_NUM] = {}; //In ms.
+};
+
+void RecordUpload(UPLOAD_PATH Path, VkDeviceSize Size, std::chrono::steady_clock::time_point Start);
+
+UploadStatistics GetUploadStatistics();
+
 void CreateImage(VkPhysicalDevice PhysicalDevice, VkDevice Device, uint32_t Width, uint32_t Height, uint32_t MipLevels, VkSampleCountFlagBits Samples, VkFormat Format, 
                  VkImageTiling Tiling, VkImageUsageFlags Usage, VkMemoryPropertyFlags Properties, VkImage& Image, VkDeviceMemory& ImageMemory);
 
@@ -125,19 +204,79 @@ void TransitionImageLayout(VkDevice Device, VkQueue Queue, VkCommandPool Command
 
 void CopyBufferToImage(VkDevice Device, VkQueue Queue, VkCommandPool CommandPool, VkBuffer SrcBuffer, VkImage DstImage, uint32_t Width, uint32_t Height);
 
-void GenerateMipmaps(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, VkImage Image, VkFormat Format, uint32_t Width, uint32_t Height, uint32_t MipLevels);
-
 VkSampleCountFlagBits GetMaxUsableSampleCount(VkPhysicalDevice Device);
 
-void CreateTextureImageFromFile(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const char* pFilename, uint32_t& MipLevels, VkImage& TextureImage, VkDeviceMemory& TextureImageMemory);
+/* Decode an image file into RGBA8 pixels. A file that cannot be read becomes a single white pixel and false is returned, so a
+ * missing texture never stops the application. Only touches its arguments and can be called from any thread. */
+bool LoadImageFile(const char* pFilename, ImageData& Image);
+
+//Decode an image file that has been read into memory, like "LoadImageFile()". PNGs go through "DecodePng()" if it handles them.
+bool DecodeImage(const void* pData, size_t Size, ImageData& Image);
+
+//A 1x1 image of a single color, e.g. a placeholder until the real texture has been loaded.
+ImageData MakeSolidImage(uint8_t R, uint8_t G, uint8_t B, uint8_t A);
+
+//The mip chain is generated on the CPU (see "MipGenerator.hpp") and copied together with the image, sRGB colors into an sRGB image.
+void CreateTexture(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const ImageData& Image, MIP_CONTENT Content, TextureInfo& Texture);
+
+//The state of a sampler, the samplers of textures with the same state are shared.
+struct SamplerState
+{
+  VkFilter Filter = VK_FILTER_LINEAR;
+  VkSamplerMipmapMode MipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+  VkSamplerAddressMode AddressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  //One turns anisotropic filtering off.
+  float MaxAnisotropy = 16.0f;
+  //Unclamped by default, the view decides how many levels there are.
+  float MaxLod = VK_LOD_CLAMP_NONE;
+
+  bool operator==(const SamplerState& Other) const;
+};
+
+/* A sampler of the state, created on first use and shared by everyone who acquires the same state afterwards. Every sampler
+ * acquired has to be released again, the last release destroys it. Can be called from any thread. */
+VkSampler AcquireSampler(VkDevice Device, const SamplerState& State);
+
+//A sampler that was not acquired is destroyed right away.
+void ReleaseSampler(VkDevice Device, VkSampler Sampler);
+
+//The distinct samplers in use.
+size_t GetSamplerNum();
+
+//Create the image view of a texture whose image has been created and acquire the trilinear, anisotropic sampler all textures share.
+void CreateTextureViewAndSampler(VkDevice Device, VkFormat Format, TextureInfo& Texture);
+
+//One level of a mip chain that is already in the format of the texture, e.g. mapped from an asset archive.
+struct MipData
+{
+  const void* pData = nullptr;
+  VkDeviceSize Size = 0;
+  uint32_t Width = 1;
+  uint32_t Height = 1;
+};
+
+//Upload a complete mip chain, from the largest level to the smallest one, without generating anything on the GPU. Levels without data are left for "FillTextureLevels()".
+void CreateTextureFromMips(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, VkFormat Format, const std::vector<MipData>& Mips, TextureInfo& Texture);
+
+//Copy the levels that have data into a texture of "CreateTextureFromMips()", its other levels may be sampled meanwhile.
+void FillTextureLevels(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const std::vector<MipData>& Mips, const TextureInfo& Texture);
+
+/* Record the copy of the levels from "FirstLevel" to the end of a chain with the levels "Mips" between images that have the
+ * levels from "SrcAllocatedLevel" and "DstAllocatedLevel" on. The destination is created with all of its levels in
+ * "VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL", the others are left for "FillTextureLevels()". */
+void RecordTextureLevelCopy(VkCommandBuffer CommandBuffer, const std::vector<MipData>& Mips, uint32_t FirstLevel, VkImage SrcImage, uint32_t SrcAllocatedLevel, VkImage DstImage, uint32_t DstAllocatedLevel);
+
+//The levels of a chain generated on the CPU, they point into it.
+std::vector<MipData> GetMips(const MipChain& Chain);
 
-void CreateTextureFromFile(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const char* pFilename, TextureInfo& Texture);
+void CreateTextureFromFile(VkPhysicalDevice PhysicalDevice, VkDevice Device, VkCommandPool CommandPool, VkQueue Queue, const char* pFilename, MIP_CONTENT Content, TextureInfo& Texture);
 
+//Destroy the image and the view, the sampler is released.
 void DestroyTexture(VkDevice Device, TextureInfo& Texture);
 
 void DestroyBuffer(VkDevice Device, BufferInfo& Buffer);
 
-void MapMemory(VkDevice Device, VkDeviceMemory Memory, VkDeviceSize Size, void* pData);
+void MapMemory(VkDevice Device, VkDeviceMemory Memory, VkDeviceSize Size, const void* pData);
 
 namespace ProxyVulkanFunction
 {
@@ -0,0 +1,273 @@
+#include "AssetArchive.hpp"
+#include "BlockCompressor.hpp"
+#include "FileHelper.hpp"
+#include "Mesh.hpp"
+#include "MipGenerator.hpp"
+#include "Scene.hpp"
+#include "TexturePacker.hpp"
+#include "VirtualTexture.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+
+using namespace Vulky;
+
+namespace
+{
+  //The working directory is expected to be the one of the application, so the names of the sections match its paths.
+  const std::string DefaultModelPath = "Models/Cerberus.obj";
+
+  //The files of a texture, several are scalar maps packed into its channels, and the content its mip levels are filtered as.
+  struct TextureSource
+  {
+    std::vector<std::string> Paths;
+    MIP_CONTENT Content;
+  };
+
+  //RGBA8 pixels with tightly packed rows, like the "ImageData" of the application (which needs the Vulkan headers).
+  struct DecodedImage
+  {
+    uint32_t Width = 1;
+    uint32_t Height = 1;
+    std::vector<uint8_t> Pixels;
+  };
+
+  //The same the application loads: albedo, normal and the packed ambient occlusion, roughness and metallic.
+  const std::vector<TextureSource> DefaultTextures = {{{"Textures/Cerberus/Cerberus_A.png"}, MIP_CONTENT_SRGB}, {{"Textures/Cerberus/Cerberus_N.png"}, MIP_CONTENT_NORMAL},
+                                                      {{"Textures/Cerberus/Cerberus_AO.png", "Textures/Cerberus/Cerberus_R.png", "Textures/Cerberus/Cerberus_M.png"}, MIP_CONTENT_LINEAR}};
+  const std::vector<std::string> DefaultShaderPaths = {"Shaders/Shader.vert.spv", "Shaders/Shader.frag.spv", "Shaders/ShaderFeedback.frag.spv", "Shaders/Overlay.vert.spv", "Shaders/Overlay.frag.spv"};
+
+  double GetMilliseconds(std::chrono::steady_clock::time_point Start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+  }
+
+  template<typename T>
+  void AppendBytes(std::vector<uint8_t>& Data, const T* pSource, size_t Count)
+  {
+    const auto* pBytes = reinterpret_cast<const uint8_t*>(pSource);
+    Data.insert(Data.end(), pBytes, pBytes + sizeof(T) * Count);
+  }
+
+  void BakeModel(AssetArchiveWriter& Writer, const std::string& Path, MESH_IMPORTER Importer, VERTEX_FORMAT VertexFormat)
+  {
+    auto Start = std::chrono::steady_clock::now();
+
+    Scene ModelScene;
+    MeshImportStatistics Statistics;
+    LoadScene(Path, ModelScene, Statistics, Importer);
+
+    ArchivedModel Model = {};
+    Model.VertexFormat = VertexFormat;
+    Model.VertexNum = ModelScene.Vertices.size();
+    Model.IndexNum = ModelScene.Indices.size();
+
+    if(VertexFormat == VERTEX_FORMAT_COMPACT)
+    {
+      std::vector<CompactVertex> CompactVertices;
+      glm::vec3 PositionScale, PositionOffset;
+      QuantizeVertices(ModelScene.Vertices, CompactVertices, PositionScale, PositionOffset);
+
+      for(int i = 0; i < 3; ++i)
+      {
+        Model.PositionScale[i] = PositionScale[i];
+        Model.PositionOffset[i] = PositionOffset[i];
+      }
+
+      Writer.AddSection(Path, ARCHIVE_SECTION_VERTICES, VertexFormat, CompactVertices.data(), sizeof(CompactVertex) * CompactVertices.size());
+    }
+    else
+    {
+      for(int i = 0; i < 3; ++i)
+        Model.PositionScale[i] = 1.0f;
+
+      Writer.AddSection(Path, ARCHIVE_SECTION_VERTICES, VertexFormat, ModelScene.Vertices.data(), sizeof(Vertex) * ModelScene.Vertices.size());
+    }
+
+    Writer.AddSection(Path, ARCHIVE_SECTION_INDICES, VertexFormat, ModelScene.Indices.data(), sizeof(uint32_t) * ModelScene.Indices.size());
+
+    std::vector<uint8_t> SceneData;
+    WriteSceneData(ModelScene, SceneData);
+
+    std::vector<uint8_t> Data;
+    AppendBytes(Data, &Model, 1);
+    Data.insert(Data.end(), SceneData.begin(), SceneData.end());
+    Writer.AddSection(Path, ARCHIVE_SECTION_SCENE, VertexFormat, Data.data(), Data.size());
+
+    std::cout << "Model \"" << Path << "\": " << Model.VertexNum << " vertices, " << Model.IndexNum << " indices, " << ModelScene.MeshNum() << " meshes, "
+              << ModelScene.LodNum() << " levels of detail in " << GetMilliseconds(Start) << " ms." << std::endl;
+  }
+
+  void BakeTexture(AssetArchiveWriter& Writer, const TextureSource& Source, MIP_FILTER Filter, bool bCompress)
+  {
+    auto Start = std::chrono::steady_clock::now();
+
+    std::vector<DecodedImage> Images(Source.Paths.size());
+    for(size_t i = 0; i < Source.Paths.size(); ++i)
+    {
+      int Width, Height, Channels;
+      stbi_uc* pPixels = stbi_load(Source.Paths[i].c_str(), &Width, &Height, &Channels, STBI_rgb_alpha);
+      if(pPixels == nullptr)
+        throw std::runtime_error("Failed to load texture image \"" + Source.Paths[i] + "\"!");
+
+      Images[i].Width = static_cast<uint32_t>(Width);
+      Images[i].Height = static_cast<uint32_t>(Height);
+      Images[i].Pixels.assign(pPixels, pPixels + static_cast<size_t>(Width) * Height * 4);
+      stbi_image_free(pPixels);
+    }
+
+    //A single scalar map only keeps its red channel, packed ones fill as many channels as there are files.
+    DecodedImage Image;
+    uint32_t ChannelNum = Source.Content == MIP_CONTENT_LINEAR ? 1 : 4;
+    if(Images.size() > 1)
+    {
+      std::vector<PackSource> Sources;
+      for(const auto& Packed : Images)
+        Sources.push_back({Packed.Pixels.data(), Packed.Width, Packed.Height});
+      PackChannels(Sources, Image.Pixels, Image.Width, Image.Height);
+      ChannelNum = static_cast<uint32_t>(Images.size());
+    }
+    else
+      Image = std::move(Images[0]);
+
+    MipChain Chain;
+    GenerateMipChain(Image.Pixels.data(), Image.Width, Image.Height, Source.Content, Filter, Chain);
+
+    size_t UncompressedSize = 0;
+    for(const auto& Level : Chain.Levels)
+      UncompressedSize += Level.size();
+
+    TEXTURE_ENCODING Encoding = GetTextureEncoding(Source.Content, ChannelNum, bCompress);
+
+    //The tiles for virtual texturing are cut from the levels before they are encoded, every tile is encoded on its own.
+    VirtualTextureLayout Layout;
+    GetVirtualTextureLayout(Chain.Widths[0], Chain.Heights[0], static_cast<uint32_t>(Chain.Levels.size()), Layout);
+    std::vector<uint8_t> Tiles;
+    SplitIntoTiles(Chain, Layout, Encoding, Tiles);
+
+    EncodeMipChain(Chain, Encoding);
+
+    size_t Size = 0;
+    for(const auto& Level : Chain.Levels)
+      Size += Level.size();
+
+    std::string Name = GetPackedTextureName(Source.Paths);
+    Writer.AddTexture(Name, Encoding, Chain.Levels, Chain.Widths, Chain.Heights);
+    Writer.AddSection(Name, ARCHIVE_SECTION_TILES, Encoding, Tiles.data(), Tiles.size());
+
+    std::cout << "Texture \"" << Name << "\": " << Image.Width << " x " << Image.Height << ", " << Chain.Levels.size() << " mip levels, " << GetEncodingName(Encoding) << " ("
+              << Size / 1024 << " KiB instead of " << UncompressedSize / 1024 << " KiB), " << Layout.PageNum << " tiles (" << Tiles.size() / 1024 << " KiB) in "
+              << GetMilliseconds(Start) << " ms." << std::endl;
+  }
+
+  void BakeShader(AssetArchiveWriter& Writer, const std::string& Path)
+  {
+    std::vector<char> Code = ReadFile(Path);
+
+    //The same check the application does before it creates a shader module.
+    uint32_t Magic = 0;
+    if(Code.size() >= sizeof(Magic))
+      std::copy(Code.begin(), Code.begin() + sizeof(Magic), reinterpret_cast<char*>(&Magic));
+    if(Code.size() % 4 != 0 || Magic != 0x07230203)
+      throw std::runtime_error("\"" + Path + "\" is not SPIR-V!");
+
+    Writer.AddSection(Path, ARCHIVE_SECTION_SHADER, 0, Code.data(), Code.size());
+
+    std::cout << "Shader \"" << Path << "\": " << Code.size() << " bytes." << std::endl;
+  }
+
+  void PrintUsage()
+  {
+    std::cout << "Usage: VulkyBake [--output FILE] [--model FILE] [--texture FILE]... [--srgb-texture FILE]... [--normal-texture FILE]... "
+                 "[--orm-texture AO ROUGHNESS METALLIC]... [--shader FILE]... "
+                 "[--importer obj|assimp] [--vertex-format compact|full] [--mip-filter box|kaiser] [--texture-encoding bc|rgba8]" << std::endl;
+  }
+}
+
+int main(int Argc, char** ppArgv)
+{
+  std::string OutputPath = "Assets.vka";
+  std::string ModelPath = DefaultModelPath;
+  std::vector<TextureSource> Textures;
+  std::vector<std::string> ShaderPaths;
+  MESH_IMPORTER Importer = MESH_IMPORTER_OBJ;
+  VERTEX_FORMAT VertexFormat = VERTEX_FORMAT_COMPACT;
+  MIP_FILTER MipFilter = MIP_FILTER_KAISER;
+  bool bCompressTextures = true;
+
+  try
+  {
+    for(int i = 1; i < Argc; ++i)
+    {
+      std::string Argument = ppArgv[i];
+      bool bHasValue = i + 1 < Argc;
+
+      if(Argument == "--output" && bHasValue)
+        OutputPath = ppArgv[++i];
+      else if(Argument == "--model" && bHasValue)
+        ModelPath = ppArgv[++i];
+      else if(Argument == "--texture" && bHasValue)
+        Textures.push_back({{ppArgv[++i]}, MIP_CONTENT_LINEAR});
+      else if(Argument == "--srgb-texture" && bHasValue)
+        Textures.push_back({{ppArgv[++i]}, MIP_CONTENT_SRGB});
+      else if(Argument == "--normal-texture" && bHasValue)
+        Textures.push_back({{ppArgv[++i]}, MIP_CONTENT_NORMAL});
+      else if(Argument == "--orm-texture" && i + 3 < Argc)
+      {
+        Textures.push_back({{ppArgv[i + 1], ppArgv[i + 2], ppArgv[i + 3]}, MIP_CONTENT_LINEAR});
+        i += 3;
+      }
+      else if(Argument == "--shader" && bHasValue)
+        ShaderPaths.push_back(ppArgv[++i]);
+      else if(Argument == "--importer" && bHasValue && (std::string(ppArgv[i + 1]) == "obj" || std::string(ppArgv[i + 1]) == "assimp"))
+        Importer = std::string(ppArgv[++i]) == "obj" ? MESH_IMPORTER_OBJ : MESH_IMPORTER_ASSIMP;
+      else if(Argument == "--vertex-format" && bHasValue && (std::string(ppArgv[i + 1]) == "compact" || std::string(ppArgv[i + 1]) == "full"))
+        VertexFormat = std::string(ppArgv[++i]) == "compact" ? VERTEX_FORMAT_COMPACT : VERTEX_FORMAT_FULL;
+      else if(Argument == "--mip-filter" && bHasValue && (std::string(ppArgv[i + 1]) == "box" || std::string(ppArgv[i + 1]) == "kaiser"))
+        MipFilter = std::string(ppArgv[++i]) == "box" ? MIP_FILTER_BOX : MIP_FILTER_KAISER;
+      else if(Argument == "--texture-encoding" && bHasValue && (std::string(ppArgv[i + 1]) == "bc" || std::string(ppArgv[i + 1]) == "rgba8"))
+        bCompressTextures = std::string(ppArgv[++i]) == "bc";
+      else
+      {
+        PrintUsage();
+        return EXIT_FAILURE;
+      }
+    }
+
+    if(Textures.empty())
+      Textures = DefaultTextures;
+    if(ShaderPaths.empty())
+      ShaderPaths = DefaultShaderPaths;
+
+    auto Start = std::chrono::steady_clock::now();
+
+    AssetArchiveWriter Writer;
+    for(const auto& Path : ShaderPaths)
+      BakeShader(Writer, Path);
+    for(const auto& Texture : Textures)
+      BakeTexture(Writer, Texture, MipFilter, bCompressTextures);
+    BakeModel(Writer, ModelPath, Importer, VertexFormat);
+
+    uint64_t Size = Writer.Write(OutputPath);
+
+    std::cout << "Wrote \"" << OutputPath << "\" (" << Size / (1024.0 * 1024.0) << " MiB) in " << GetMilliseconds(Start) << " ms." << std::endl;
+  }
+  catch(const std::exception& Ex)
+  {
+    std::cerr << Ex.what() << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+namespace
+{
+  //Choose a unit so that the printed value has a sensible number of digits.
+  void FormatTime(double Nanoseconds, char* pBuffer, size_t BufferSize)
+  {
+    if(Nanoseconds < 1e3)
+      std::snprintf(pBuffer, BufferSize, "%.2f ns", Nanoseconds);
+    else if(Nanoseconds < 1e6)
+      std::snprintf(pBuffer, BufferSize, "%.2f us", Nanoseconds * 1e-3);
+    else if(Nanoseconds < 1e9)
+      std::snprintf(pBuffer, BufferSize, "%.2f ms", Nanoseconds * 1e-6);
+    else
+      std::snprintf(pBuffer, BufferSize, "%.2f s", Nanoseconds * 1e-9);
+  }
+
+  //Nearest-rank percentile of sorted samples.
+  double Percentile(const std::vector<double>& SortedSamples, double Fraction)
+  {
+    size_t Rank = static_cast<size_t>(std::ceil(Fraction * static_cast<double>(SortedSamples.size())));
+    Rank = std::clamp<size_t>(Rank, 1, SortedSamples.size());
+    return SortedSamples[Rank - 1];
+  }
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkSettings& Settings) : m_Settings(Settings)
+{
+  if(m_Settings.SampleNum == 0)
+    throw std::runtime_error("At least one sample per benchmark is required!");
+}
+
+void BenchmarkRunner::Skip(const std::string& Name, const std::string& Reason)
+{
+  if(IsFiltered(Name))
+    return;
+
+  std::printf("%-64s skipped: %s\n", Name.c_str(), Reason.c_str());
+}
+
+void BenchmarkRunner::PrintHeader() const
+{
+  std::printf("%-64s %10s %12s %12s %12s %12s %12s %14s\n", "Benchmark", "Iterations", "Min", "Median", "Mean", "StdDev", "P95", "Throughput");
+  std::printf("%s\n", std::string(64 + 11 + 13 * 5 + 15, '-').c_str());
+}
+
+void BenchmarkRunner::WriteCsv() const
+{
+  if(m_Settings.CsvPath.empty())
+    return;
+
+  std::ofstream File(m_Settings.CsvPath);
+  if(!File.is_open())
+    throw std::runtime_error("Failed to open the CSV file!");
+
+  File << "Name,Samples,Iterations,MinNs,MedianNs,MeanNs,StdDevNs,P95Ns,BytesPerIteration,ItemsPerIteration\n";
+  for(const auto& Result : m_Results)
+  {
+    File << '"' << Result.Name << "\"," << Result.SampleNum << ',' << Result.IterationNum << ','
+         << Result.Min << ',' << Result.Median << ',' << Result.Mean << ',' << Result.StdDev << ',' << Result.P95 << ','
+         << Result.BytesPerIteration << ',' << Result.ItemsPerIteration << '\n';
+  }
+}
+
+bool BenchmarkRunner::IsFiltered(const std::string& Name) const
+{
+  return !m_Settings.Filter.empty() && Name.find(m_Settings.Filter) == std::string::npos;
+}
+
+void BenchmarkRunner::AddResult(const std::string& Name, size_t IterationNum, std::vector<double>& Samples, double BytesPerIteration, double ItemsPerIteration)
+{
+  std::sort(Samples.begin(), Samples.end());
+
+  BenchmarkResult Result = {};
+  Result.Name = Name;
+  Result.SampleNum = Samples.size();
+  Result.IterationNum = IterationNum;
+  Result.Min = Samples.front();
+  Result.Median = Samples.size() % 2 ? Samples[Samples.size() / 2] : 0.5 * (Samples[Samples.size() / 2 - 1] + Samples[Samples.size() / 2]);
+  Result.P95 = Percentile(Samples, 0.95);
+  Result.BytesPerIteration = BytesPerIteration;
+  Result.ItemsPerIteration = ItemsPerIteration;
+
+  double Sum = 0.0;
+  for(double Sample : Samples)
+    Sum += Sample;
+  Result.Mean = Sum / static_cast<double>(Samples.size());
+
+  double SquaredSum = 0.0;
+  for(double Sample : Samples)
+    SquaredSum += (Sample - Result.Mean) * (Sample - Result.Mean);
+  Result.StdDev = Samples.size() > 1 ? std::sqrt(SquaredSum / static_cast<double>(Samples.size() - 1)) : 0.0;
+
+  PrintResult(Result);
+
+  m_Results.push_back(Result);
+}
+
+void BenchmarkRunner::PrintResult(const BenchmarkResult& Result)
+{
+  char Min[32], Median[32], Mean[32], StdDev[32], P95[32], Throughput[32] = "";
+  FormatTime(Result.Min, Min, sizeof(Min));
+  FormatTime(Result.Median, Median, sizeof(Median));
+  FormatTime(Result.Mean, Mean, sizeof(Mean));
+  FormatTime(Result.StdDev, StdDev, sizeof(StdDev));
+  FormatTime(Result.P95, P95, sizeof(P95));
+
+  //Throughput is derived from the median, which is the least noisy of the statistics.
+  if(Result.BytesPerIteration > 0.0)
+    std::snprintf(Throughput, sizeof(Throughput), "%.1f MB/s", Result.BytesPerIteration / Result.Median * 1e9 / (1024.0 * 1024.0));
+  else if(Result.ItemsPerIteration > 0.0)
+    std::snprintf(Throughput, sizeof(Throughput), "%.1f M/s", Result.ItemsPerIteration / Result.Median * 1e3);
+
+  std::printf("%-64s %10zu %12s %12s %12s %12s %12s %14s\n", Result.Name.c_str(), Result.IterationNum, Min, Median, Mean, StdDev, P95, Throughput);
+}
+
+NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Namespace.hpp"
+
+NAMESPACE_BEGIN(GLOBAL_NAMESPACE)
+
+struct BenchmarkSettings
+{
+  size_t SampleNum = 30;
+  size_t WarmupSampleNum = 3;
+  double MinSampleTime = 0.01; //In seconds, every sample runs enough iterations to last at least this long.
+  std::string Filter = "";
+  std::string CsvPath = "";
+};
+
+struct BenchmarkResult
+{
+  std::string Name;
+  size_t SampleNum = 0;
+  size_t IterationNum = 0; //Per sample.
+  //Per iteration, in nanoseconds.
+  double Min = 0.0;
+  double Median = 0.0;
+  double Mean = 0.0;
+  double StdDev = 0.0;
+  double P95 = 0.0;
+  double BytesPerIteration = 0.0;
+  double ItemsPerIteration = 0.0;
+};
+
+/* Runs every benchmark as: calibration of the iteration count, a few discarded warm-up samples and
+ * then a fixed number of timed samples. Each sample is reduced to the time of one iteration, so the
+ * statistics are comparable between machines with different timer resolutions and between runs. */
+class BenchmarkRunner
+{
+  public:
+  explicit BenchmarkRunner(const BenchmarkSettings& Settings);
+
+  //The function returns a value derived from its work, which is accumulated so that it cannot be optimized away.
+  template<typename Function>
+  void Run(const std::string& Name, Function&& Func, double BytesPerIteration = 0.0, double ItemsPerIteration = 0.0);
+
+  void Skip(const std::string& Name, const std::string& Reason);
+
+  void PrintHeader() const;
+
+  //Write all results as CSV, so that runs can be diffed to spot regressions.
+  void WriteCsv() const;
+
+  protected:
+  bool IsFiltered(const std::string& Name) const;
+
+  void AddResult(const std::string& Name, size_t IterationNum, std::vector<double>& Samples, double BytesPerIteration, double ItemsPerIteration);
+
+  static void PrintResult(const BenchmarkResult& Result);
+
+  protected:
+  BenchmarkSettings m_Settings;
+  std::vector<BenchmarkResult> m_Results;
+  volatile size_t m_Sink = 0;
+};
+
+template<typename Function>
+void BenchmarkRunner::Run(const std::string& Name, Function&& Func, double BytesPerIteration, double ItemsPerIteration)
+{
+  if(IsFiltered(Name))
+    return;
+
+  using Clock = std::chrono::steady_clock;
+
+  auto TimeIterations = [&](size_t IterationNum)
+  {
+    size_t Accumulated = 0;
+    auto Start = Clock::now();
+    for(size_t i = 0; i < IterationNum; ++i)
+      Accumulated += static_cast<size_t>(Func());
+    auto End = Clock::now();
+    m_Sink = m_Sink + Accumulated;
+    return std::chrono::duration<double>(End - Start).count();
+  };
+
+  //Double the iteration count until one sample is long enough to be measured reliably.
+  size_t IterationNum = 1;
+  while(IterationNum < (size_t(1) << 30))
+  {
+    double Elapsed = TimeIterations(IterationNum);
+    if(Elapsed >= m_Settings.MinSampleTime)
+      break;
+
+    IterationNum *= 2;
+  }
+
+  for(size_t i = 0; i < m_Settings.WarmupSampleNum; ++i)
+    TimeIterations(IterationNum);
+
+  std::vector<double> Samples(m_Settings.SampleNum);
+  for(auto& Sample : Samples)
+    Sample = TimeIterations(IterationNum) * 1e9 / static_cast<double>(IterationNum);
+
+  AddResult(Name, IterationNum, Samples, BytesPerIteration, ItemsPerIteration);
+}
+
+NAMESPACE_END
\ No newline at end of file
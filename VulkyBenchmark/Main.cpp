@@ -0,0 +1,771 @@
+#include "Benchmark.hpp"
+#include "Camera.hpp"
+#include "FileHelper.hpp"
+#include "Mesh.hpp"
+#include "MipDownsampler.hpp"
+#include "MeshOptimizer.hpp"
+#include "ObjLoader.hpp"
+#include "PngDecoder.hpp"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+//The implementation is compiled with "VulkanHelper.cpp".
+#include <stb_image.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+
+using namespace Vulky;
+
+namespace
+{
+  //The working directory is expected to be the one of the application, so the same relative paths resolve.
+  const std::string ModelPath = "Models/Cerberus.obj";
+  const std::vector<std::string> ImagePaths = {"Textures/Cerberus/Cerberus_A.png", "Textures/Cerberus/Cerberus_UV.png"};
+  const std::vector<std::string> ShaderPaths = {"Shaders/Shader.vert.spv", "Shaders/Shader.frag.spv"};
+  const std::string SyntheticFilePath = "VulkyBenchmark.tmp";
+  const size_t SyntheticFileSize = 16 * 1024 * 1024;
+  const std::string SyntheticObjPath = "VulkyBenchmark.obj";
+  const std::string DownsampleShaderPath = "Shaders/Downsample.comp.spv";
+  const uint32_t DownsampleSize = 4096;
+
+  bool FileExists(const std::string& Path) {return std::ifstream(Path, std::ios::binary).is_open();}
+
+  size_t FloatBits(float Value)
+  {
+    uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(Bits));
+    return Bits;
+  }
+
+  //A UV sphere with normals, tangents and texture coordinates, the same attributes a real model provides.
+  std::unique_ptr<aiMesh> CreateSphereMesh(uint32_t Rings, uint32_t Segments)
+  {
+    const float Pi = glm::pi<float>();
+
+    auto pMesh = std::make_unique<aiMesh>();
+    pMesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    pMesh->mNumVertices = (Rings + 1) * (Segments + 1);
+    pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
+    pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
+    pMesh->mTangents = new aiVector3D[pMesh->mNumVertices];
+    pMesh->mBitangents = new aiVector3D[pMesh->mNumVertices];
+    pMesh->mTextureCoords[0] = new aiVector3D[pMesh->mNumVertices];
+    pMesh->mNumUVComponents[0] = 2;
+
+    for(uint32_t Ring = 0; Ring <= Rings; ++Ring)
+    {
+      for(uint32_t Segment = 0; Segment <= Segments; ++Segment)
+      {
+        float U = static_cast<float>(Segment) / static_cast<float>(Segments);
+        float V = static_cast<float>(Ring) / static_cast<float>(Rings);
+        float Phi = U * 2.0f * Pi;
+        float Theta = V * Pi;
+
+        aiVector3D Normal(std::sin(Theta) * std::cos(Phi), std::sin(Theta) * std::sin(Phi), std::cos(Theta));
+        aiVector3D Tangent(-std::sin(Phi), std::cos(Phi), 0.0f);
+
+        uint32_t Index = Ring * (Segments + 1) + Segment;
+        pMesh->mVertices[Index] = Normal;
+        pMesh->mNormals[Index] = Normal;
+        pMesh->mTangents[Index] = Tangent;
+        pMesh->mBitangents[Index] = Normal ^ Tangent;
+        pMesh->mTextureCoords[0][Index] = aiVector3D(U, V, 0.0f);
+      }
+    }
+
+    pMesh->mNumFaces = Rings * Segments * 2;
+    pMesh->mFaces = new aiFace[pMesh->mNumFaces];
+
+    uint32_t FaceIndex = 0;
+    for(uint32_t Ring = 0; Ring < Rings; ++Ring)
+    {
+      for(uint32_t Segment = 0; Segment < Segments; ++Segment)
+      {
+        uint32_t I0 = Ring * (Segments + 1) + Segment;
+        uint32_t I1 = I0 + 1;
+        uint32_t I2 = I0 + Segments + 1;
+        uint32_t I3 = I2 + 1;
+
+        const uint32_t Quad[2][3] = {{I0, I2, I1}, {I1, I2, I3}};
+        for(const auto& Triangle : Quad)
+        {
+          aiFace& Face = pMesh->mFaces[FaceIndex++];
+          Face.mNumIndices = 3;
+          Face.mIndices = new unsigned int[3];
+          Face.mIndices[0] = Triangle[0];
+          Face.mIndices[1] = Triangle[1];
+          Face.mIndices[2] = Triangle[2];
+        }
+      }
+    }
+
+    return pMesh;
+  }
+
+  //Expand an indexed mesh into one vertex per corner, which is what a vertex welding pass sees when loading an OBJ file.
+  std::vector<Vertex> ExpandToTriangleSoup(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices)
+  {
+    std::vector<Vertex> Soup;
+    Soup.reserve(Indices.size());
+    for(uint32_t Index : Indices)
+      Soup.push_back(Vertices[Index]);
+
+    return Soup;
+  }
+
+  void RunConvertMeshBenchmark(BenchmarkRunner& Runner, const std::string& Name, const aiMesh* pMesh)
+  {
+    std::vector<Vertex> Vertices;
+    std::vector<uint32_t> Indices;
+
+    Runner.Run(Name, [&]()
+    {
+      ConvertMesh(pMesh, Vertices, Indices);
+      return Vertices.size() + Indices.size();
+    }, static_cast<double>(pMesh->mNumVertices * sizeof(Vertex)), static_cast<double>(pMesh->mNumVertices));
+  }
+
+  void RunVertexHashBenchmarks(BenchmarkRunner& Runner, const std::string& Prefix, const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices)
+  {
+    const auto Soup = ExpandToTriangleSoup(Vertices, Indices);
+    const auto SoupCopy = Soup;
+    const double ItemNum = static_cast<double>(Soup.size());
+
+    Runner.Run(Prefix + "VertexHash", [&]()
+    {
+      size_t Hash = 0;
+      for(const auto& Vertex : Soup)
+        Hash += VertexHash()(Vertex);
+      return Hash;
+    }, 0.0, ItemNum);
+
+    Runner.Run(Prefix + "VertexEqual", [&]()
+    {
+      size_t EqualNum = 0;
+      for(size_t i = 0; i < Soup.size(); ++i)
+        EqualNum += VertexEqual()(Soup[i], SoupCopy[i]);
+      return EqualNum;
+    }, 0.0, ItemNum);
+
+    //Both welds produce the unique vertices and the remapped indices from the triangle soup, so they are comparable.
+    Runner.Run(Prefix + "Weld unordered_map", [&]()
+    {
+      std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> UniqueVertices;
+      std::vector<Vertex> WeldedVertices;
+      std::vector<uint32_t> WeldedIndices;
+      UniqueVertices.reserve(Soup.size());
+      WeldedIndices.reserve(Soup.size());
+      for(const auto& Vertex : Soup)
+      {
+        auto Result = UniqueVertices.emplace(Vertex, static_cast<uint32_t>(WeldedVertices.size()));
+        if(Result.second)
+          WeldedVertices.push_back(Vertex);
+        WeldedIndices.push_back(Result.first->second);
+      }
+      return WeldedVertices.size() + WeldedIndices.size();
+    }, 0.0, ItemNum);
+
+    Runner.Run(Prefix + "Weld WeldVertices", [&]()
+    {
+      std::vector<Vertex> WeldedVertices = Soup;
+      std::vector<uint32_t> WeldedIndices(Soup.size());
+      for(size_t i = 0; i < WeldedIndices.size(); ++i)
+        WeldedIndices[i] = static_cast<uint32_t>(i);
+
+      WeldVertices(WeldedVertices, WeldedIndices);
+      return WeldedVertices.size() + WeldedIndices.size();
+    }, 0.0, ItemNum);
+  }
+
+  void RunMeshOptimizerBenchmarks(BenchmarkRunner& Runner, const std::string& Prefix, std::vector<Vertex> Vertices, std::vector<uint32_t> Indices)
+  {
+    WeldVertices(Vertices, Indices);
+
+    const double TriangleNum = static_cast<double>(Indices.size() / 3);
+    std::vector<uint32_t> Optimized;
+
+    Runner.Run(Prefix + "OptimizeVertexCache", [&]()
+    {
+      Optimized = Indices;
+      OptimizeVertexCache(Optimized, Vertices.size());
+      return Optimized[0];
+    }, 0.0, TriangleNum);
+
+    //The overdraw and fetch passes expect a cache optimized index buffer.
+    const auto CacheOptimized = Optimized;
+    Runner.Run(Prefix + "OptimizeOverdraw", [&]()
+    {
+      Optimized = CacheOptimized;
+      OptimizeOverdraw(Optimized, Vertices);
+      return Optimized[0];
+    }, 0.0, TriangleNum);
+
+    std::vector<Vertex> Reordered;
+    Runner.Run(Prefix + "OptimizeVertexFetch", [&]()
+    {
+      Optimized = CacheOptimized;
+      Reordered = Vertices;
+      OptimizeVertexFetch(Reordered, Optimized);
+      return Reordered.size();
+    }, 0.0, TriangleNum);
+
+    Optimized = Indices;
+    OptimizeVertexCache(Optimized, Vertices.size());
+    OptimizeOverdraw(Optimized, Vertices);
+
+    VertexCacheStatistics Before = AnalyzeVertexCache(Indices, Vertices.size());
+    VertexCacheStatistics After = AnalyzeVertexCache(Optimized, Vertices.size());
+    std::printf("%-64s ACMR %.3f -> %.3f, ATVR %.3f -> %.3f (FIFO of %u)\n", (Prefix + "vertex cache").c_str(), Before.Acmr, After.Acmr, Before.Atvr, After.Atvr, VERTEX_CACHE_SIZE);
+  }
+
+  void RunMeshBenchmarks(BenchmarkRunner& Runner)
+  {
+    auto pSphere = CreateSphereMesh(256, 256);
+    RunConvertMeshBenchmark(Runner, "Mesh/ConvertMesh sphere 66k", pSphere.get());
+
+    std::vector<Vertex> Vertices;
+    std::vector<uint32_t> Indices;
+    ConvertMesh(pSphere.get(), Vertices, Indices);
+    RunVertexHashBenchmarks(Runner, "Mesh/Sphere 66k ", Vertices, Indices);
+    RunMeshOptimizerBenchmarks(Runner, "Mesh/Sphere 66k ", Vertices, Indices);
+
+    std::vector<CompactVertex> CompactVertices;
+    Runner.Run("Mesh/Sphere 66k QuantizeVertices", [&]()
+    {
+      glm::vec3 PositionScale, PositionOffset;
+      QuantizeVertices(Vertices, CompactVertices, PositionScale, PositionOffset);
+      return CompactVertices.size();
+    }, static_cast<double>(Vertices.size() * sizeof(Vertex)), static_cast<double>(Vertices.size()));
+
+    if(!FileExists(ModelPath))
+    {
+      Runner.Skip("Mesh/ConvertMesh " + ModelPath, "file not found");
+      return;
+    }
+
+    Assimp::Importer Import;
+    const aiScene* pScene = Import.ReadFile(ModelPath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_OptimizeMeshes);
+    if(!pScene || pScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !pScene->mRootNode)
+      throw std::runtime_error(Import.GetErrorString());
+
+    RunConvertMeshBenchmark(Runner, "Mesh/ConvertMesh " + ModelPath, pScene->mMeshes[0]);
+
+    ConvertMesh(pScene->mMeshes[0], Vertices, Indices);
+    RunVertexHashBenchmarks(Runner, "Mesh/" + ModelPath + " ", Vertices, Indices);
+    RunMeshOptimizerBenchmarks(Runner, "Mesh/" + ModelPath + " ", Vertices, Indices);
+  }
+
+  //The per frame CPU work of "App::UpdateUniformBuffer()" without the memory mapping.
+  void RunCameraBenchmarks(BenchmarkRunner& Runner)
+  {
+    Camera Camera;
+    Camera.SetResolution(static_cast<float>(WINDOW_INIT_WIDTH), static_cast<float>(WINDOW_INIT_HEIGH));
+
+    Runner.Run("Camera/RetriveData", [&]()
+    {
+      glm::vec3 Eye, Target, Up;
+      float NearZ, FarZ;
+      glm::vec2 Fov;
+
+      Camera.UpdateYaw(1.0f);
+      Camera.RetriveData(Target, Eye, Up, Fov, NearZ, FarZ);
+      return FloatBits(Eye.x);
+    });
+
+    Runner.Run("Camera/MVP (RetriveMatrices + inverse)", [&]()
+    {
+      glm::mat4 Model = glm::mat4(1.0f);
+      glm::mat4 ModelInvTranspose = glm::transpose(glm::inverse(Model));
+      glm::mat4 View, Projection;
+
+      Camera.UpdateYaw(1.0f);
+      Camera.RetriveMatrices(static_cast<float>(WINDOW_INIT_WIDTH) / static_cast<float>(WINDOW_INIT_HEIGH), View, Projection);
+      return FloatBits(ModelInvTranspose[0][0]) + FloatBits(View[3][0]) + FloatBits(Projection[1][1]);
+    });
+  }
+
+  void RunImageBenchmarks(BenchmarkRunner& Runner)
+  {
+    for(const auto& Path : ImagePaths)
+    {
+      if(!FileExists(Path))
+      {
+        Runner.Skip("Image/stbi_load " + Path, "file not found");
+        continue;
+      }
+
+      int Width = 0, Height = 0, Channels = 0;
+      if(!stbi_info(Path.c_str(), &Width, &Height, &Channels))
+        throw std::runtime_error("Failed to read the image header!");
+
+      //Throughput is measured in decoded RGBA bytes, the format the textures are uploaded with.
+      const double DecodedSize = static_cast<double>(Width) * static_cast<double>(Height) * 4.0;
+
+      Runner.Run("Image/stbi_load " + Path, [&]()
+      {
+        int TexWidth, TexHeight, TexChannels;
+        stbi_uc* pPixels = stbi_load(Path.c_str(), &TexWidth, &TexHeight, &TexChannels, STBI_rgb_alpha);
+        if(!pPixels)
+          throw std::runtime_error("Failed to load texture image!");
+
+        size_t Result = pPixels[0];
+        stbi_image_free(pPixels);
+        return Result;
+      }, DecodedSize);
+
+      //Decoding only, to separate the cost of the file access from the cost of the decoder.
+      const auto Encoded = ReadFile(Path);
+      Runner.Run("Image/stbi_load_from_memory " + Path, [&]()
+      {
+        int TexWidth, TexHeight, TexChannels;
+        stbi_uc* pPixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(Encoded.data()), static_cast<int>(Encoded.size()), &TexWidth, &TexHeight, &TexChannels, STBI_rgb_alpha);
+        if(!pPixels)
+          throw std::runtime_error("Failed to load texture image!");
+
+        size_t Result = pPixels[0];
+        stbi_image_free(pPixels);
+        return Result;
+      }, DecodedSize);
+
+      //The same file into a buffer that is allocated once, like the staging memory it is meant to be decoded into.
+      PngInfo Info;
+      if(!ReadPngInfo(Encoded.data(), Encoded.size(), Info) || !Info.bSupported)
+      {
+        Runner.Skip("Image/DecodePng " + Path, "not a PNG the decoder handles");
+        continue;
+      }
+
+      std::vector<uint8_t> Pixels(static_cast<size_t>(Info.Width) * Info.Height * 4);
+      Runner.Run("Image/DecodePng " + Path, [&]()
+      {
+        if(!DecodePng(Encoded.data(), Encoded.size(), Pixels.data(), static_cast<size_t>(Info.Width) * 4, PNG_LAYOUT_RGBA))
+          throw std::runtime_error("Failed to decode texture image!");
+
+        return static_cast<size_t>(Pixels[0]);
+      }, DecodedSize);
+    }
+  }
+
+  //A Vulkan device without a window and one queue that can blit and dispatch, for the benchmarks of GPU work.
+  struct HeadlessDevice
+  {
+    VkInstance Instance = VK_NULL_HANDLE;
+    VkPhysicalDevice PhysicalDevice = VK_NULL_HANDLE;
+    VkDevice Device = VK_NULL_HANDLE;
+    VkQueue Queue = VK_NULL_HANDLE;
+    VkCommandPool CommandPool = VK_NULL_HANDLE;
+    VkFence Fence = VK_NULL_HANDLE;
+
+    //False if there is no Vulkan driver or no device with such a queue.
+    bool Create()
+    {
+      VkApplicationInfo AppInfo = {};
+      AppInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+      AppInfo.pApplicationName = "VulkyBenchmark";
+      AppInfo.apiVersion = VK_API_VERSION_1_0;
+
+      VkInstanceCreateInfo InstanceInfo = {};
+      InstanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+      InstanceInfo.pApplicationInfo = &AppInfo;
+      if(vkCreateInstance(&InstanceInfo, nullptr, &Instance) != VK_SUCCESS)
+        return false;
+
+      uint32_t DeviceCount = 0;
+      vkEnumeratePhysicalDevices(Instance, &DeviceCount, nullptr);
+      std::vector<VkPhysicalDevice> Devices(DeviceCount);
+      vkEnumeratePhysicalDevices(Instance, &DeviceCount, Devices.data());
+
+      uint32_t QueueFamily = 0;
+      for(VkPhysicalDevice Candidate : Devices)
+      {
+        uint32_t FamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(Candidate, &FamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> Families(FamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(Candidate, &FamilyCount, Families.data());
+
+        for(uint32_t i = 0; i < FamilyCount && PhysicalDevice == VK_NULL_HANDLE; ++i)
+        {
+          if((Families[i].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))
+          {
+            PhysicalDevice = Candidate;
+            QueueFamily = i;
+          }
+        }
+      }
+
+      if(PhysicalDevice == VK_NULL_HANDLE)
+        return false;
+
+      const float Priority = 1.0f;
+      VkDeviceQueueCreateInfo QueueInfo = {};
+      QueueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+      QueueInfo.queueFamilyIndex = QueueFamily;
+      QueueInfo.queueCount = 1;
+      QueueInfo.pQueuePriorities = &Priority;
+
+      VkDeviceCreateInfo DeviceInfo = {};
+      DeviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+      DeviceInfo.queueCreateInfoCount = 1;
+      DeviceInfo.pQueueCreateInfos = &QueueInfo;
+      if(vkCreateDevice(PhysicalDevice, &DeviceInfo, nullptr, &Device) != VK_SUCCESS)
+        return false;
+
+      vkGetDeviceQueue(Device, QueueFamily, 0, &Queue);
+
+      VkCommandPoolCreateInfo PoolInfo = {};
+      PoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+      PoolInfo.queueFamilyIndex = QueueFamily;
+      if(vkCreateCommandPool(Device, &PoolInfo, nullptr, &CommandPool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create command pool!");
+
+      VkFenceCreateInfo FenceInfo = {};
+      FenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+      if(vkCreateFence(Device, &FenceInfo, nullptr, &Fence) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create fence!");
+
+      return true;
+    }
+
+    void Destroy()
+    {
+      if(Device != VK_NULL_HANDLE)
+      {
+        vkDestroyFence(Device, Fence, nullptr);
+        vkDestroyCommandPool(Device, CommandPool, nullptr);
+        vkDestroyDevice(Device, nullptr);
+      }
+
+      if(Instance != VK_NULL_HANDLE)
+        vkDestroyInstance(Instance, nullptr);
+    }
+
+    //Submit and wait until the queue has executed it.
+    void Execute(VkCommandBuffer CommandBuffer)
+    {
+      VkSubmitInfo SubmitInfo = {};
+      SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+      SubmitInfo.commandBufferCount = 1;
+      SubmitInfo.pCommandBuffers = &CommandBuffer;
+
+      if(vkQueueSubmit(Queue, 1, &SubmitInfo, Fence) != VK_SUCCESS)
+        throw std::runtime_error("Failed to submit command buffer!");
+      vkWaitForFences(Device, 1, &Fence, VK_TRUE, UINT64_MAX);
+      vkResetFences(Device, 1, &Fence);
+    }
+  };
+
+  /* The mip levels of a 4096 x 4096 RGBA8 image, blitted level by level and generated by the single dispatch of the compute
+   * path. Every iteration is one submission that the CPU waits for, which adds the same overhead to both paths. */
+  void RunMipDownsampleBenchmarks(BenchmarkRunner& Runner)
+  {
+    const std::string Size = std::to_string(DownsampleSize) + "x" + std::to_string(DownsampleSize);
+
+    HeadlessDevice Device;
+    if(!Device.Create())
+    {
+      Device.Destroy();
+      Runner.Skip("Gpu/Downsample blit " + Size, "no Vulkan device");
+      return;
+    }
+
+    MipDownsampler Downsampler;
+    Downsampler.Create(Device.PhysicalDevice, Device.Device, FileExists(DownsampleShaderPath) ? ReadFile(DownsampleShaderPath) : std::vector<char>());
+
+    const uint32_t MipLevels = static_cast<uint32_t>(std::log2(DownsampleSize)) + 1;
+    VkImage Image;
+    VkDeviceMemory ImageMemory;
+    CreateImage(Device.PhysicalDevice, Device.Device, DownsampleSize, DownsampleSize, MipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Image, ImageMemory);
+
+    VkCommandBufferAllocateInfo AllocInfo = {};
+    AllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    AllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    AllocInfo.commandPool = Device.CommandPool;
+    AllocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer CommandBuffer;
+    if(vkAllocateCommandBuffers(Device.Device, &AllocInfo, &CommandBuffer) != VK_SUCCESS)
+      throw std::runtime_error("Failed to allocate command buffer!");
+
+    VkImageMemoryBarrier Barrier = {};
+    Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.image = Image;
+    Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Barrier.subresourceRange.levelCount = MipLevels;
+    Barrier.subresourceRange.layerCount = 1;
+
+    //Level 0 gets content once, every iteration only moves the image back to where "Record()" expects it.
+    VkCommandBufferBeginInfo BeginInfo = {};
+    BeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(CommandBuffer, &BeginInfo);
+
+    Barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    Barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    Barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+
+    VkClearColorValue Color = {{0.25f, 0.5f, 0.75f, 1.0f}};
+    VkImageSubresourceRange Level0 = Barrier.subresourceRange;
+    Level0.levelCount = 1;
+    vkCmdClearColorImage(CommandBuffer, Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &Color, 1, &Level0);
+
+    Barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    Barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    Barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+
+    vkEndCommandBuffer(CommandBuffer);
+    Device.Execute(CommandBuffer);
+
+    //Throughput is measured in the bytes of level 0 that are filtered down.
+    const double Level0Size = static_cast<double>(DownsampleSize) * DownsampleSize * 4.0;
+
+    const std::pair<MIP_DOWNSAMPLE_PATH, const char*> Paths[] = {{MIP_DOWNSAMPLE_PATH_BLIT, "blit"}, {MIP_DOWNSAMPLE_PATH_COMPUTE, "compute"}};
+    for(const auto& Path : Paths)
+    {
+      const std::string Name = std::string("Gpu/Downsample ") + Path.second + " " + Size;
+      if(Path.first == MIP_DOWNSAMPLE_PATH_COMPUTE && !Downsampler.IsComputeSupported(VK_FORMAT_R8G8B8A8_UNORM, DownsampleSize, DownsampleSize, MipLevels))
+      {
+        Runner.Skip(Name, FileExists(DownsampleShaderPath) ? "not supported by the device" : "shader not found");
+        continue;
+      }
+
+      MipTarget Target;
+      Downsampler.CreateTarget(Image, VK_FORMAT_R8G8B8A8_UNORM, DownsampleSize, DownsampleSize, MipLevels, Path.first, Target);
+
+      vkBeginCommandBuffer(CommandBuffer, &BeginInfo);
+
+      Barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+      Barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      Barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+      Barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+      vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+
+      Downsampler.Record(CommandBuffer, Target);
+      vkEndCommandBuffer(CommandBuffer);
+
+      Runner.Run(Name, [&]()
+      {
+        Device.Execute(CommandBuffer);
+        return size_t(1);
+      }, Level0Size);
+
+      Downsampler.DestroyTarget(Target);
+    }
+
+    vkFreeCommandBuffers(Device.Device, Device.CommandPool, 1, &CommandBuffer);
+    vkDestroyImage(Device.Device, Image, nullptr);
+    FreeMemory(Device.Device, ImageMemory);
+    Downsampler.Destroy();
+    Device.Destroy();
+  }
+
+  void RunReadFileBenchmarks(BenchmarkRunner& Runner)
+  {
+    {
+      std::vector<char> Data(SyntheticFileSize);
+      for(size_t i = 0; i < Data.size(); ++i)
+        Data[i] = static_cast<char>(i * 2654435761u >> 24);
+
+      std::ofstream File(SyntheticFilePath, std::ios::binary);
+      if(!File.is_open())
+        throw std::runtime_error("Failed to create the synthetic file!");
+      File.write(Data.data(), Data.size());
+    }
+
+    std::vector<std::string> Paths = ShaderPaths;
+    Paths.insert(Paths.end(), ImagePaths.begin(), ImagePaths.end());
+    Paths.push_back(SyntheticFilePath);
+
+    for(const auto& Path : Paths)
+    {
+      if(!FileExists(Path))
+      {
+        Runner.Skip("File/ReadFile " + Path, "file not found");
+        continue;
+      }
+
+      const double FileSize = static_cast<double>(ReadFile(Path).size());
+      Runner.Run("File/ReadFile " + Path, [&]()
+      {
+        auto Buffer = ReadFile(Path);
+        return Buffer.size() + static_cast<unsigned char>(Buffer.empty() ? 0 : Buffer.back());
+      }, FileSize);
+    }
+
+    std::remove(SyntheticFilePath.c_str());
+  }
+
+  //A grid of textured quads with a shared normal, written row by row until the file has at least the given size.
+  void WriteSyntheticObj(const std::string& Path, size_t TargetSize)
+  {
+    const uint32_t Width = 1024;
+
+    std::ofstream File(Path, std::ios::binary);
+    if(!File.is_open())
+      throw std::runtime_error("Failed to create the synthetic OBJ file!");
+
+    std::string Buffer;
+    char Line[128];
+    size_t FileSize = 0;
+
+    Buffer += "vn 0 0 1\n";
+    for(uint32_t Row = 0; FileSize < TargetSize; ++Row)
+    {
+      for(uint32_t Column = 0; Column <= Width; ++Column)
+      {
+        float X = static_cast<float>(Column) * 0.01f, Y = static_cast<float>(Row) * 0.01f;
+        Buffer.append(Line, std::snprintf(Line, sizeof(Line), "v %.6f %.6f %.6f\nvt %.6f %.6f\n", X, Y, std::sin(X + Y) * 0.1f, X * 0.1f, Y * 0.1f));
+      }
+
+      for(uint32_t Column = 0; Row > 0 && Column < Width; ++Column)
+      {
+        uint64_t I0 = static_cast<uint64_t>(Row - 1) * (Width + 1) + Column + 1;
+        uint64_t I1 = I0 + Width + 1;
+        Buffer.append(Line, std::snprintf(Line, sizeof(Line), "f %llu/%llu/1 %llu/%llu/1 %llu/%llu/1 %llu/%llu/1\n",
+                                          static_cast<unsigned long long>(I0), static_cast<unsigned long long>(I0),
+                                          static_cast<unsigned long long>(I0 + 1), static_cast<unsigned long long>(I0 + 1),
+                                          static_cast<unsigned long long>(I1 + 1), static_cast<unsigned long long>(I1 + 1),
+                                          static_cast<unsigned long long>(I1), static_cast<unsigned long long>(I1)));
+      }
+
+      FileSize += Buffer.size();
+      File.write(Buffer.data(), Buffer.size());
+      Buffer.clear();
+    }
+  }
+
+  /* "LoadObj()" against Assimp on the model of the application and on a synthetic file of "ObjSize" bytes, or on "ObjPath".
+   * Benchmarking files beyond 1 GB needs a lot of memory for Assimp and takes long, e.g. "--obj-size-mb 1100 --samples 3 --warmup 0". */
+  void RunObjBenchmarks(BenchmarkRunner& Runner, size_t ObjSize, const std::string& ObjPath)
+  {
+    std::vector<std::string> Paths = {ModelPath};
+    if(!ObjPath.empty())
+      Paths.push_back(ObjPath);
+    else
+    {
+      WriteSyntheticObj(SyntheticObjPath, ObjSize);
+      Paths.push_back(SyntheticObjPath);
+    }
+
+    const uint32_t ThreadNum = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for(const auto& Path : Paths)
+    {
+      if(!FileExists(Path))
+      {
+        Runner.Skip("Obj/LoadObj " + Path, "file not found");
+        continue;
+      }
+
+      const double FileSize = static_cast<double>(std::ifstream(Path, std::ios::binary | std::ios::ate).tellg());
+
+      for(uint32_t Threads : {1u, ThreadNum})
+      {
+        Runner.Run("Obj/LoadObj " + std::to_string(Threads) + " threads " + Path, [&]()
+        {
+          ObjModel Model;
+          LoadObj(Path, Model, Threads);
+          return Model.Indices.size();
+        }, FileSize);
+
+        if(ThreadNum == 1)
+          break;
+      }
+
+      Runner.Run("Obj/Assimp ReadFile " + Path, [&]()
+      {
+        Assimp::Importer Import;
+        const aiScene* pScene = Import.ReadFile(Path, aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_OptimizeMeshes);
+        if(!pScene)
+          throw std::runtime_error(Import.GetErrorString());
+        return static_cast<size_t>(pScene->mNumMeshes);
+      }, FileSize);
+    }
+
+    std::remove(SyntheticObjPath.c_str());
+  }
+
+  void PrintUsage()
+  {
+    std::cout << "Usage: VulkyBenchmark [--samples N] [--warmup N] [--min-sample-ms MS] [--filter SUBSTRING] [--csv FILE] [--obj-size-mb MB] [--obj FILE]" << std::endl;
+  }
+}
+
+int main(int Argc, char** ppArgv)
+{
+  BenchmarkSettings Settings;
+  size_t ObjSize = 64 * 1024 * 1024;
+  std::string ObjPath;
+
+  try
+  {
+    for(int i = 1; i < Argc; ++i)
+    {
+      std::string Argument = ppArgv[i];
+      bool bHasValue = i + 1 < Argc;
+
+      if(Argument == "--samples" && bHasValue)
+        Settings.SampleNum = std::stoul(ppArgv[++i]);
+      else if(Argument == "--warmup" && bHasValue)
+        Settings.WarmupSampleNum = std::stoul(ppArgv[++i]);
+      else if(Argument == "--min-sample-ms" && bHasValue)
+        Settings.MinSampleTime = std::stod(ppArgv[++i]) * 1e-3;
+      else if(Argument == "--filter" && bHasValue)
+        Settings.Filter = ppArgv[++i];
+      else if(Argument == "--csv" && bHasValue)
+        Settings.CsvPath = ppArgv[++i];
+      else if(Argument == "--obj-size-mb" && bHasValue)
+        ObjSize = std::stoull(ppArgv[++i]) * 1024 * 1024;
+      else if(Argument == "--obj" && bHasValue)
+        ObjPath = ppArgv[++i];
+      else
+      {
+        PrintUsage();
+        return EXIT_FAILURE;
+      }
+    }
+
+    BenchmarkRunner Runner(Settings);
+    Runner.PrintHeader();
+
+    RunMeshBenchmarks(Runner);
+    RunObjBenchmarks(Runner, ObjSize, ObjPath);
+    RunCameraBenchmarks(Runner);
+    RunImageBenchmarks(Runner);
+    RunMipDownsampleBenchmarks(Runner);
+    RunReadFileBenchmarks(Runner);
+
+    Runner.WriteCsv();
+  }
+  catch(const std::exception& Ex)
+  {
+    std::cerr << Ex.what() << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
\ No newline at end of file